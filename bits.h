@@ -41,27 +41,97 @@ union long_double {
 #define getub(buf, off)	((uint8_t)buf[(off)-(GET_ORIGIN)])
 #define putbyte(buf,off,b) do {buf[(off)-(PUT_ORIGIN)] = (unsigned char)(b);} while (0)
 
+/*
+ * On targets where unaligned word access is cheap (x86, ARMv7 with
+ * the unaligned feature, AArch64), the multibyte accessors compile to
+ * a single unaligned load plus at most one byte-swap; the memcpy()
+ * never survives to runtime, the compilers we care about turn it into
+ * the load.  Define GPSD_NO_UNALIGNED (the unaligned=no build option)
+ * to force the portable per-byte assembly, which remains the fallback
+ * on everything else.
+ */
+#if !defined(GPSD_NO_UNALIGNED) && !defined(S_SPLINT_S) && \
+	defined(__GNUC__) && \
+	defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+	__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && \
+	(defined(__i386__) || defined(__x86_64__) || \
+	 defined(__aarch64__) || defined(__ARM_FEATURE_UNALIGNED))
+#define GPSD_UNALIGNED_LOADS 1
+
+#include <string.h>
+
+static inline uint16_t gpsd_load16(const void *p)
+{
+    uint16_t w;
+    (void)memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static inline uint32_t gpsd_load32(const void *p)
+{
+    uint32_t l;
+    (void)memcpy(&l, p, sizeof(l));
+    return l;
+}
+
+static inline uint64_t gpsd_load64(const void *p)
+{
+    uint64_t q;
+    (void)memcpy(&q, p, sizeof(q));
+    return q;
+}
+
+static inline uint16_t gpsd_swap16(uint16_t w)
+{
+    return (uint16_t)((w >> 8) | (w << 8));
+}
+
+#define GETPOS(buf, off) \
+	((const void *)((const unsigned char *)(buf) + (off) - (GET_ORIGIN)))
+#endif /* GPSD_UNALIGNED_LOADS */
+
 /* little-endian access */
+#ifdef GPSD_UNALIGNED_LOADS
+#define getles16(buf, off)	((int16_t)gpsd_load16(GETPOS(buf, off)))
+#define getleu16(buf, off)	((uint16_t)gpsd_load16(GETPOS(buf, off)))
+#define getles32(buf, off)	((int32_t)gpsd_load32(GETPOS(buf, off)))
+#define getleu32(buf, off)	((uint32_t)gpsd_load32(GETPOS(buf, off)))
+#else
 #define getles16(buf, off)	((int16_t)(((uint16_t)getub((buf),   (off)+1) << 8) | (uint16_t)getub((buf), (off))))
 #define getleu16(buf, off)	((uint16_t)(((uint16_t)getub((buf), (off)+1) << 8) | (uint16_t)getub((buf), (off))))
 #define getles32(buf, off)	((int32_t)(((uint16_t)getleu16((buf),  (off)+2) << 16) | (uint16_t)getleu16((buf), (off))))
 #define getleu32(buf, off)	((uint32_t)(((uint16_t)getleu16((buf),(off)+2) << 16) | (uint16_t)getleu16((buf), (off))))
+#endif /* GPSD_UNALIGNED_LOADS */
 
 #define putle16(buf, off, w) do {putbyte(buf, (off)+1, (uint)(w) >> 8); putbyte(buf, (off), (w));} while (0)
 #define putle32(buf, off, l) do {putle16(buf, (off)+2, (uint)(l) >> 16); putle16(buf, (off), (l));} while (0)
+#ifdef GPSD_UNALIGNED_LOADS
+#define getles64(buf, off)	((int64_t)gpsd_load64(GETPOS(buf, off)))
+#define getleu64(buf, off)	((uint64_t)gpsd_load64(GETPOS(buf, off)))
+#else
 #define getles64(buf, off)	((int64_t)(((uint64_t)getleu32(buf, (off)+4) << 32) | getleu32(buf, (off))))
 #define getleu64(buf, off)	((uint64_t)(((uint64_t)getleu32(buf, (off)+4) << 32) | getleu32(buf, (off))))
+#endif /* GPSD_UNALIGNED_LOADS */
 
 #define getlef(buf, off)	(i_f.i = getles32(buf, off), i_f.f)
 #define getled(buf, off)	(l_d.l = getles64(buf, off), l_d.d)
 
 /* SiRF and most other GPS protocols use big-endian (network byte order) */
+#ifdef GPSD_UNALIGNED_LOADS
+#define getbes16(buf, off)	((int16_t)gpsd_swap16(gpsd_load16(GETPOS(buf, off))))
+#define getbeu16(buf, off)	((uint16_t)gpsd_swap16(gpsd_load16(GETPOS(buf, off))))
+#define getbes32(buf, off)	((int32_t)__builtin_bswap32(gpsd_load32(GETPOS(buf, off))))
+#define getbeu32(buf, off)	((uint32_t)__builtin_bswap32(gpsd_load32(GETPOS(buf, off))))
+#define getbes64(buf, off)	((int64_t)__builtin_bswap64(gpsd_load64(GETPOS(buf, off))))
+#define getbeu64(buf, off)	((uint64_t)__builtin_bswap64(gpsd_load64(GETPOS(buf, off))))
+#else
 #define getbes16(buf, off)	((int16_t)(((uint16_t)getub(buf, (off)) << 8) | (uint16_t)getub(buf, (off)+1)))
 #define getbeu16(buf, off)	((uint16_t)(((uint16_t)getub(buf, (off)) << 8) | (uint16_t)getub(buf, (off)+1)))
 #define getbes32(buf, off)	((int32_t)(((uint16_t)getbeu16(buf, (off)) << 16) | getbeu16(buf, (off)+2)))
 #define getbeu32(buf, off)	((uint32_t)(((uint16_t)getbeu16(buf, (off)) << 16) | getbeu16(buf, (off)+2)))
 #define getbes64(buf, off)	((int64_t)(((uint64_t)getbeu32(buf, (off)) << 32) | getbeu32(buf, (off)+4)))
 #define getbeu64(buf, off)	((uint64_t)(((uint64_t)getbeu32(buf, (off)) << 32) | getbeu32(buf, (off)+4)))
+#endif /* GPSD_UNALIGNED_LOADS */
 
 #define putbe16(buf,off,w) do {putbyte(buf, (off) ,(w) >> 8); putbyte(buf, (off)+1, (w));} while (0)
 #define putbe32(buf,off,l) do {putbe16(buf, (off) ,(l) >> 16); putbe16(buf, (off)+2, (l));} while (0)
@@ -70,6 +140,131 @@ union long_double {
 #define getbed(buf, off)	(l_d.l = getbes64(buf, off), l_d.d)
 
 
+/*
+ * Single-window bitfield extraction.  Same results as ubits()/sbits()
+ * for fields up to 57 bits wide, but one big-endian load, a shift and
+ * a mask instead of a byte loop.  The caller must guarantee that the
+ * buffer stays readable for the full 8 bytes starting at the byte
+ * holding the field's first bit; that is why these stay separate from
+ * the general functions - they are for hot decode loops working out
+ * of generously-sized fixed buffers, like the AIS bit vector.
+ */
+#define ubits64(buf, start, width) \
+	((getbeu64(buf, (start) / 8) << ((start) % 8)) >> (64 - (width)))
+#define sbits64(buf, start, width) \
+	((int64_t)(getbeu64(buf, (start) / 8) << ((start) % 8)) >> (64 - (width)))
+
+/*
+ * Bit-cursor extraction.  Decoders that pull dozens of fields out of
+ * one message keep a cursor on the buffer and take fields through a
+ * cached 64-bit window, so the offset arithmetic and the memory load
+ * happen once per window instead of once per field.  Fields are
+ * limited to 57 bits, like ubits64()/sbits64(), and the caller must
+ * guarantee the same thing: the buffer stays readable for the full 8
+ * bytes starting at the byte holding any requested field's first bit.
+ */
+struct bits_cursor_t
+{
+    const unsigned char *base;
+    unsigned int nextbit;	/* stream position of the window start */
+    uint64_t window;		/* fetched but untaken bits, left-justified */
+    unsigned int avail;		/* number of valid bits in the window */
+};
+
+static inline uint64_t bits_cursor_fetch(const unsigned char *p)
+/* one big-endian window load; zero-origin, unlike the getbeu macros */
+{
+#ifdef GPSD_UNALIGNED_LOADS
+    return __builtin_bswap64(gpsd_load64((const void *)p));
+#else
+    uint64_t v = 0;
+    int i;
+
+    for (i = 0; i < 8; i++)
+	v = (v << 8) | p[i];
+    return v;
+#endif /* GPSD_UNALIGNED_LOADS */
+}
+
+static inline void bits_cursor_open(struct bits_cursor_t *bc,
+				    const void *buf, unsigned int start)
+{
+    bc->base = (const unsigned char *)buf;
+    bc->nextbit = start;
+    bc->window = 0;
+    bc->avail = 0;
+}
+
+static inline void bits_cursor_refill(struct bits_cursor_t *bc)
+/* append freshly loaded bits behind whatever the window still holds */
+{
+    unsigned int pos = bc->nextbit + bc->avail;
+    uint64_t chunk = bits_cursor_fetch(bc->base + pos / 8) << (pos % 8);
+    unsigned int got = 64 - pos % 8;
+
+    bc->window |= chunk >> bc->avail;
+    bc->avail += (got < 64 - bc->avail) ? got : 64 - bc->avail;
+}
+
+static inline uint64_t bits_cursor_utake(struct bits_cursor_t *bc,
+					 unsigned int width)
+/* take the next width bits (1..57) of the stream as an unsigned field */
+{
+    uint64_t fld;
+
+    if (bc->avail < width)
+	bits_cursor_refill(bc);
+    fld = bc->window >> (64 - width);
+    bc->window <<= width;
+    bc->avail -= width;
+    bc->nextbit += width;
+    return fld;
+}
+
+static inline int64_t bits_cursor_stake(struct bits_cursor_t *bc,
+					unsigned int width)
+/* as bits_cursor_utake(), sign-extending from the field's top bit */
+{
+    int64_t fld;
+
+    if (bc->avail < width)
+	bits_cursor_refill(bc);
+    fld = (int64_t)bc->window >> (64 - width);
+    bc->window <<= width;
+    bc->avail -= width;
+    bc->nextbit += width;
+    return fld;
+}
+
+static inline void bits_cursor_seek(struct bits_cursor_t *bc,
+				    unsigned int start, unsigned int width)
+/* reposition only when the requested field falls outside the window */
+{
+    if (start < bc->nextbit || start + width > bc->nextbit + bc->avail) {
+	bc->nextbit = start;
+	bc->window = 0;
+	bc->avail = 0;
+	bits_cursor_refill(bc);
+    }
+}
+
+static inline uint64_t bits_cursor_uget(struct bits_cursor_t *bc,
+					unsigned int start,
+					unsigned int width)
+/* random-access variant, served from the cached window when possible */
+{
+    bits_cursor_seek(bc, start, width);
+    return (bc->window << (start - bc->nextbit)) >> (64 - width);
+}
+
+static inline int64_t bits_cursor_sget(struct bits_cursor_t *bc,
+				       unsigned int start,
+				       unsigned int width)
+{
+    bits_cursor_seek(bc, start, width);
+    return (int64_t)(bc->window << (start - bc->nextbit)) >> (64 - width);
+}
+
 /* Zodiac protocol description uses 1-origin indexing by little-endian word */
 #define get16z(buf, n)	( (buf[2*(n)-2])	\
 		| (buf[2*(n)-1] << 8))
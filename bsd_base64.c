@@ -48,17 +48,54 @@
 #include <sys/types.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "bsd_base64.h"
 
+#if defined(__SSSE3__) && !defined(S_SPLINT_S)
+#include <tmmintrin.h>
+#endif
+
 #define Assert(Cond) if (!(Cond)) abort()
 
 static const char Base64[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static const char Pad64 = '=';
 
+/* reverse alphabet as value-plus-one; zero marks a non-base64 character */
+static const unsigned char Base64rev1[256] = {
+    ['A'] =  1, ['B'] =  2, ['C'] =  3, ['D'] =  4, ['E'] =  5, ['F'] =  6,
+    ['G'] =  7, ['H'] =  8, ['I'] =  9, ['J'] = 10, ['K'] = 11, ['L'] = 12,
+    ['M'] = 13, ['N'] = 14, ['O'] = 15, ['P'] = 16, ['Q'] = 17, ['R'] = 18,
+    ['S'] = 19, ['T'] = 20, ['U'] = 21, ['V'] = 22, ['W'] = 23, ['X'] = 24,
+    ['Y'] = 25, ['Z'] = 26,
+    ['a'] = 27, ['b'] = 28, ['c'] = 29, ['d'] = 30, ['e'] = 31, ['f'] = 32,
+    ['g'] = 33, ['h'] = 34, ['i'] = 35, ['j'] = 36, ['k'] = 37, ['l'] = 38,
+    ['m'] = 39, ['n'] = 40, ['o'] = 41, ['p'] = 42, ['q'] = 43, ['r'] = 44,
+    ['s'] = 45, ['t'] = 46, ['u'] = 47, ['v'] = 48, ['w'] = 49, ['x'] = 50,
+    ['y'] = 51, ['z'] = 52,
+    ['0'] = 53, ['1'] = 54, ['2'] = 55, ['3'] = 56, ['4'] = 57, ['5'] = 58,
+    ['6'] = 59, ['7'] = 60, ['8'] = 61, ['9'] = 62, ['+'] = 63, ['/'] = 64,
+};
+
+#if defined(__SSSE3__) && !defined(S_SPLINT_S)
+static inline __m128i b64_sextet_chars(__m128i indices)
+/* translate 16 sextet values into base64 alphabet characters */
+{
+    __m128i off = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i lt26 = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    const __m128i lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				      '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+				      '/' - 63, 'A', 0, 0);
+
+    off = _mm_or_si128(off, _mm_and_si128(lt26, _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(lut, off));
+}
+#endif
+
 /* (From RFC1521 and draft-ietf-dnssec-secext-03.txt)
    The following encoding technique is taken from RFC 1521 by Borenstein
    and Freed.  It is reproduced here in a slightly edited form for
@@ -132,27 +169,45 @@ b64_ntop(unsigned char const *src, size_t srclength, char *target,
     unsigned char output[4];
     size_t i;
 
-    while (2 < srclength) {
-	input[0] = *src++;
-	input[1] = *src++;
-	input[2] = *src++;
-	srclength -= 3;
+#if defined(__SSSE3__) && !defined(S_SPLINT_S)
+    /*
+     * Bulk lane: each step reads 16 bytes (consuming 12), splits them
+     * into 16 sextets with a shuffle and two masked multiplies, and
+     * translates the whole register at once.  The word-at-a-time loop
+     * below finishes whatever is left and does all the padding.
+     */
+    while (srclength >= 16 && datalength + 16 <= targsize) {
+	__m128i in = _mm_loadu_si128((const __m128i *)(const void *)src);
+	__m128i hi, lo;
+
+	in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+						7, 6, 8, 7, 10, 9, 11, 10));
+	hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+			     _mm_set1_epi32(0x04000040));
+	lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+			     _mm_set1_epi32(0x01000010));
+	_mm_storeu_si128((__m128i *)(void *)(target + datalength),
+			 b64_sextet_chars(_mm_or_si128(hi, lo)));
+	src += 12;
+	srclength -= 12;
+	datalength += 16;
+    }
+#endif
 
-	output[0] = input[0] >> 2;
-	output[1] = ((input[0] & 0x03) << 4) + (input[1] >> 4);
-	output[2] = ((input[1] & 0x0f) << 2) + (input[2] >> 6);
-	output[3] = input[2] & 0x3f;
-	Assert(output[0] < 64);
-	Assert(output[1] < 64);
-	Assert(output[2] < 64);
-	Assert(output[3] < 64);
+    while (2 < srclength) {
+	uint32_t group;
 
 	if (datalength + 4 > targsize)
 	    return (-1);
-	target[datalength++] = Base64[output[0]];
-	target[datalength++] = Base64[output[1]];
-	target[datalength++] = Base64[output[2]];
-	target[datalength++] = Base64[output[3]];
+	group = ((uint32_t)src[0] << 16) | ((uint32_t)src[1] << 8)
+	    | (uint32_t)src[2];
+	src += 3;
+	srclength -= 3;
+
+	target[datalength++] = Base64[(group >> 18) & 0x3f];
+	target[datalength++] = Base64[(group >> 12) & 0x3f];
+	target[datalength++] = Base64[(group >> 6) & 0x3f];
+	target[datalength++] = Base64[group & 0x3f];
     }
 
     /* Now we worry about padding. */
@@ -197,8 +252,7 @@ b64_ntop(unsigned char const *src, size_t srclength, char *target,
 int b64_pton(char const *src, unsigned char *target, size_t targsize)
 {
     size_t tarindex;
-    int state, ch;
-    char *pos;
+    int state, ch, val;
 
     state = 0;
     tarindex = 0;
@@ -210,15 +264,40 @@ int b64_pton(char const *src, unsigned char *target, size_t targsize)
 	if (ch == Pad64)
 	    break;
 
-	if ((pos = strchr(Base64, ch)) == NULL)	/* A non-base64 character. */
+	val = (int)Base64rev1[(unsigned char)ch] - 1;
+	if (val < 0)		/* A non-base64 character. */
 	    return (-1);
 
+	/*
+	 * Four plain alphabet characters in a row become three bytes
+	 * in one step.  src is NUL-terminated, so peeking at the next
+	 * three bytes is safe; a terminator, pad sign or whitespace
+	 * reads as invalid here and drops us into the stepwise code.
+	 */
+	if (state == 0 && target != NULL
+	    && Base64rev1[(unsigned char)src[0]] != 0
+	    && Base64rev1[(unsigned char)src[1]] != 0
+	    && Base64rev1[(unsigned char)src[2]] != 0) {
+	    uint32_t group = ((uint32_t)val << 18)
+		| ((uint32_t)(Base64rev1[(unsigned char)src[0]] - 1) << 12)
+		| ((uint32_t)(Base64rev1[(unsigned char)src[1]] - 1) << 6)
+		| (uint32_t)(Base64rev1[(unsigned char)src[2]] - 1);
+
+	    if (tarindex + 3 > targsize)
+		return (-1);
+	    target[tarindex++] = (unsigned char)(group >> 16);
+	    target[tarindex++] = (unsigned char)((group >> 8) & 0xff);
+	    target[tarindex++] = (unsigned char)(group & 0xff);
+	    src += 3;
+	    continue;
+	}
+
 	switch (state) {
 	case 0:
 	    if (target) {
 		if (tarindex >= targsize)
 		    return (-1);
-		target[tarindex] = (pos - Base64) << 2;
+		target[tarindex] = val << 2;
 	    }
 	    state = 1;
 	    break;
@@ -226,8 +305,8 @@ int b64_pton(char const *src, unsigned char *target, size_t targsize)
 	    if (target) {
 		if (tarindex + 1 >= targsize)
 		    return (-1);
-		target[tarindex] |= (pos - Base64) >> 4;
-		target[tarindex + 1] = ((pos - Base64) & 0x0f)
+		target[tarindex] |= val >> 4;
+		target[tarindex + 1] = (val & 0x0f)
 		    << 4;
 	    }
 	    tarindex++;
@@ -237,8 +316,8 @@ int b64_pton(char const *src, unsigned char *target, size_t targsize)
 	    if (target) {
 		if (tarindex + 1 >= targsize)
 		    return (-1);
-		target[tarindex] |= (pos - Base64) >> 2;
-		target[tarindex + 1] = ((pos - Base64) & 0x03)
+		target[tarindex] |= val >> 2;
+		target[tarindex + 1] = (val & 0x03)
 		    << 6;
 	    }
 	    tarindex++;
@@ -248,7 +327,7 @@ int b64_pton(char const *src, unsigned char *target, size_t targsize)
 	    if (target) {
 		if (tarindex >= targsize)
 		    return (-1);
-		target[tarindex] |= (pos - Base64);
+		target[tarindex] |= val;
 	    }
 	    tarindex++;
 	    state = 0;
@@ -550,18 +550,16 @@ static void update_gps_panel(struct gps_data_t *gpsdata)
 
     /* Fill in the latitude. */
     if (gpsdata->fix.mode >= MODE_2D && isnan(gpsdata->fix.latitude) == 0) {
-	(void)snprintf(scr, sizeof(scr), "%s %c",
-		       deg_to_str(deg_type, fabs(gpsdata->fix.latitude)),
-		       (gpsdata->fix.latitude < 0) ? 'S' : 'N');
+	(void)snprintf(scr, sizeof(scr), "%s",
+		       fmt_latlon(deg_type, gpsdata->fix.latitude, true));
     } else
 	(void)snprintf(scr, sizeof(scr), "n/a");
     (void)mvwprintw(datawin, 2, DATAWIN_VALUE_OFFSET, "%-*s", 27, scr);
 
     /* Fill in the longitude. */
     if (gpsdata->fix.mode >= MODE_2D && isnan(gpsdata->fix.longitude) == 0) {
-	(void)snprintf(scr, sizeof(scr), "%s %c",
-		       deg_to_str(deg_type, fabs(gpsdata->fix.longitude)),
-		       (gpsdata->fix.longitude < 0) ? 'W' : 'E');
+	(void)snprintf(scr, sizeof(scr), "%s",
+		       fmt_latlon(deg_type, gpsdata->fix.longitude, false));
     } else
 	(void)snprintf(scr, sizeof(scr), "n/a");
     (void)mvwprintw(datawin, 3, DATAWIN_VALUE_OFFSET, "%-*s", 27, scr);
@@ -576,8 +574,8 @@ static void update_gps_panel(struct gps_data_t *gpsdata)
 
     /* Fill in the speed. */
     if (gpsdata->fix.mode >= MODE_2D && isnan(gpsdata->fix.track) == 0)
-	(void)snprintf(scr, sizeof(scr), "%.1f %s",
-		       gpsdata->fix.speed * speedfactor, speedunits);
+	(void)snprintf(scr, sizeof(scr), "%s",
+		       fmt_speed(gpsdata->fix.speed, speedfactor, speedunits));
     else
 	(void)snprintf(scr, sizeof(scr), "n/a");
     (void)mvwprintw(datawin, 5, DATAWIN_VALUE_OFFSET, "%-*s", 27, scr);
@@ -875,8 +873,8 @@ int main(int argc, char *argv[])
 	} else {
 	    errno = 0;
 	    if (gps_read(&gpsdata) == -1) {
-		fprintf(stderr, "cgps: socket error 4\n");
-		die(errno == 0 ? GPS_GONE : GPS_ERROR);
+		/* daemon restarted under us; rejoin and replay the watch */
+		gpsd_reconnect(&gpsdata, &source, flags);
 	    } else {
 		/* Here's where updates go now that things are established. */
 #ifdef TRUENORTH
@@ -60,9 +60,26 @@ static void crc_init(unsigned table[256])
     }
 }
 
+unsigned sliced[8][256];
+
+static void crc_init_sliced(unsigned sliced[8][256])
+/* tables for slicing-by-8: sliced[k][b] is the CRC of byte b followed
+ * by k zero bytes, so eight lookups advance the hash by eight bytes */
+{
+    unsigned i, k;
+
+    for (i = 0; i < 256; i++)
+	sliced[0][i] = table[i] & 0xffffff;
+    for (k = 1; k < 8; k++)
+	for (i = 0; i < 256; i++)
+	    sliced[k][i] = ((sliced[k - 1][i] << 8) ^
+			    sliced[0][(sliced[k - 1][i] >> 16) & 0xff])
+		& 0xffffff;
+}
+
 int main(int argc, char *argv[])
 {
-    int i;
+    int i, k;
 
     crc_init(table);
 
@@ -72,6 +89,18 @@ int main(int argc, char *argv[])
 	    putchar('\n');
     }
 
+    crc_init_sliced(sliced);
+
+    for (k = 0; k < 8; k++) {
+	printf("    {\n");
+	for (i = 0; i < 256; i++) {
+	    printf("0x%08X, ", sliced[k][i]);
+	    if ((i % 4) == 3)
+		putchar('\n');
+	}
+	printf("    },\n");
+    }
+
     exit(0);
 }
 #endif
@@ -143,12 +172,561 @@ static const unsigned crc24q[256] = {
     0xFCD11CCE, 0xFD575035, 0xFE5BC9C3, 0xFFDD8538,
 };
 
-unsigned crc24q_hash(unsigned char *data, int len)
+static const unsigned crc24q_sliced[8][256] = {
+    {
+    0x00000000, 0x00864CFB, 0x008AD50D, 0x000C99F6,
+    0x0093E6E1, 0x0015AA1A, 0x001933EC, 0x009F7F17,
+    0x00A18139, 0x0027CDC2, 0x002B5434, 0x00AD18CF,
+    0x003267D8, 0x00B42B23, 0x00B8B2D5, 0x003EFE2E,
+    0x00C54E89, 0x00430272, 0x004F9B84, 0x00C9D77F,
+    0x0056A868, 0x00D0E493, 0x00DC7D65, 0x005A319E,
+    0x0064CFB0, 0x00E2834B, 0x00EE1ABD, 0x00685646,
+    0x00F72951, 0x007165AA, 0x007DFC5C, 0x00FBB0A7,
+    0x000CD1E9, 0x008A9D12, 0x008604E4, 0x0000481F,
+    0x009F3708, 0x00197BF3, 0x0015E205, 0x0093AEFE,
+    0x00AD50D0, 0x002B1C2B, 0x002785DD, 0x00A1C926,
+    0x003EB631, 0x00B8FACA, 0x00B4633C, 0x00322FC7,
+    0x00C99F60, 0x004FD39B, 0x00434A6D, 0x00C50696,
+    0x005A7981, 0x00DC357A, 0x00D0AC8C, 0x0056E077,
+    0x00681E59, 0x00EE52A2, 0x00E2CB54, 0x006487AF,
+    0x00FBF8B8, 0x007DB443, 0x00712DB5, 0x00F7614E,
+    0x0019A3D2, 0x009FEF29, 0x009376DF, 0x00153A24,
+    0x008A4533, 0x000C09C8, 0x0000903E, 0x0086DCC5,
+    0x00B822EB, 0x003E6E10, 0x0032F7E6, 0x00B4BB1D,
+    0x002BC40A, 0x00AD88F1, 0x00A11107, 0x00275DFC,
+    0x00DCED5B, 0x005AA1A0, 0x00563856, 0x00D074AD,
+    0x004F0BBA, 0x00C94741, 0x00C5DEB7, 0x0043924C,
+    0x007D6C62, 0x00FB2099, 0x00F7B96F, 0x0071F594,
+    0x00EE8A83, 0x0068C678, 0x00645F8E, 0x00E21375,
+    0x0015723B, 0x00933EC0, 0x009FA736, 0x0019EBCD,
+    0x008694DA, 0x0000D821, 0x000C41D7, 0x008A0D2C,
+    0x00B4F302, 0x0032BFF9, 0x003E260F, 0x00B86AF4,
+    0x002715E3, 0x00A15918, 0x00ADC0EE, 0x002B8C15,
+    0x00D03CB2, 0x00567049, 0x005AE9BF, 0x00DCA544,
+    0x0043DA53, 0x00C596A8, 0x00C90F5E, 0x004F43A5,
+    0x0071BD8B, 0x00F7F170, 0x00FB6886, 0x007D247D,
+    0x00E25B6A, 0x00641791, 0x00688E67, 0x00EEC29C,
+    0x003347A4, 0x00B50B5F, 0x00B992A9, 0x003FDE52,
+    0x00A0A145, 0x0026EDBE, 0x002A7448, 0x00AC38B3,
+    0x0092C69D, 0x00148A66, 0x00181390, 0x009E5F6B,
+    0x0001207C, 0x00876C87, 0x008BF571, 0x000DB98A,
+    0x00F6092D, 0x007045D6, 0x007CDC20, 0x00FA90DB,
+    0x0065EFCC, 0x00E3A337, 0x00EF3AC1, 0x0069763A,
+    0x00578814, 0x00D1C4EF, 0x00DD5D19, 0x005B11E2,
+    0x00C46EF5, 0x0042220E, 0x004EBBF8, 0x00C8F703,
+    0x003F964D, 0x00B9DAB6, 0x00B54340, 0x00330FBB,
+    0x00AC70AC, 0x002A3C57, 0x0026A5A1, 0x00A0E95A,
+    0x009E1774, 0x00185B8F, 0x0014C279, 0x00928E82,
+    0x000DF195, 0x008BBD6E, 0x00872498, 0x00016863,
+    0x00FAD8C4, 0x007C943F, 0x00700DC9, 0x00F64132,
+    0x00693E25, 0x00EF72DE, 0x00E3EB28, 0x0065A7D3,
+    0x005B59FD, 0x00DD1506, 0x00D18CF0, 0x0057C00B,
+    0x00C8BF1C, 0x004EF3E7, 0x00426A11, 0x00C426EA,
+    0x002AE476, 0x00ACA88D, 0x00A0317B, 0x00267D80,
+    0x00B90297, 0x003F4E6C, 0x0033D79A, 0x00B59B61,
+    0x008B654F, 0x000D29B4, 0x0001B042, 0x0087FCB9,
+    0x001883AE, 0x009ECF55, 0x009256A3, 0x00141A58,
+    0x00EFAAFF, 0x0069E604, 0x00657FF2, 0x00E33309,
+    0x007C4C1E, 0x00FA00E5, 0x00F69913, 0x0070D5E8,
+    0x004E2BC6, 0x00C8673D, 0x00C4FECB, 0x0042B230,
+    0x00DDCD27, 0x005B81DC, 0x0057182A, 0x00D154D1,
+    0x0026359F, 0x00A07964, 0x00ACE092, 0x002AAC69,
+    0x00B5D37E, 0x00339F85, 0x003F0673, 0x00B94A88,
+    0x0087B4A6, 0x0001F85D, 0x000D61AB, 0x008B2D50,
+    0x00145247, 0x00921EBC, 0x009E874A, 0x0018CBB1,
+    0x00E37B16, 0x006537ED, 0x0069AE1B, 0x00EFE2E0,
+    0x00709DF7, 0x00F6D10C, 0x00FA48FA, 0x007C0401,
+    0x0042FA2F, 0x00C4B6D4, 0x00C82F22, 0x004E63D9,
+    0x00D11CCE, 0x00575035, 0x005BC9C3, 0x00DD8538,
+    },
+    {
+    0x00000000, 0x00668F48, 0x00CD1E90, 0x00AB91D8,
+    0x001C71DB, 0x007AFE93, 0x00D16F4B, 0x00B7E003,
+    0x0038E3B6, 0x005E6CFE, 0x00F5FD26, 0x0093726E,
+    0x0024926D, 0x00421D25, 0x00E98CFD, 0x008F03B5,
+    0x0071C76C, 0x00174824, 0x00BCD9FC, 0x00DA56B4,
+    0x006DB6B7, 0x000B39FF, 0x00A0A827, 0x00C6276F,
+    0x004924DA, 0x002FAB92, 0x00843A4A, 0x00E2B502,
+    0x00555501, 0x0033DA49, 0x00984B91, 0x00FEC4D9,
+    0x00E38ED8, 0x00850190, 0x002E9048, 0x00481F00,
+    0x00FFFF03, 0x0099704B, 0x0032E193, 0x00546EDB,
+    0x00DB6D6E, 0x00BDE226, 0x001673FE, 0x0070FCB6,
+    0x00C71CB5, 0x00A193FD, 0x000A0225, 0x006C8D6D,
+    0x009249B4, 0x00F4C6FC, 0x005F5724, 0x0039D86C,
+    0x008E386F, 0x00E8B727, 0x004326FF, 0x0025A9B7,
+    0x00AAAA02, 0x00CC254A, 0x0067B492, 0x00013BDA,
+    0x00B6DBD9, 0x00D05491, 0x007BC549, 0x001D4A01,
+    0x0041514B, 0x0027DE03, 0x008C4FDB, 0x00EAC093,
+    0x005D2090, 0x003BAFD8, 0x00903E00, 0x00F6B148,
+    0x0079B2FD, 0x001F3DB5, 0x00B4AC6D, 0x00D22325,
+    0x0065C326, 0x00034C6E, 0x00A8DDB6, 0x00CE52FE,
+    0x00309627, 0x0056196F, 0x00FD88B7, 0x009B07FF,
+    0x002CE7FC, 0x004A68B4, 0x00E1F96C, 0x00877624,
+    0x00087591, 0x006EFAD9, 0x00C56B01, 0x00A3E449,
+    0x0014044A, 0x00728B02, 0x00D91ADA, 0x00BF9592,
+    0x00A2DF93, 0x00C450DB, 0x006FC103, 0x00094E4B,
+    0x00BEAE48, 0x00D82100, 0x0073B0D8, 0x00153F90,
+    0x009A3C25, 0x00FCB36D, 0x005722B5, 0x0031ADFD,
+    0x00864DFE, 0x00E0C2B6, 0x004B536E, 0x002DDC26,
+    0x00D318FF, 0x00B597B7, 0x001E066F, 0x00788927,
+    0x00CF6924, 0x00A9E66C, 0x000277B4, 0x0064F8FC,
+    0x00EBFB49, 0x008D7401, 0x0026E5D9, 0x00406A91,
+    0x00F78A92, 0x009105DA, 0x003A9402, 0x005C1B4A,
+    0x0082A296, 0x00E42DDE, 0x004FBC06, 0x0029334E,
+    0x009ED34D, 0x00F85C05, 0x0053CDDD, 0x00354295,
+    0x00BA4120, 0x00DCCE68, 0x00775FB0, 0x0011D0F8,
+    0x00A630FB, 0x00C0BFB3, 0x006B2E6B, 0x000DA123,
+    0x00F365FA, 0x0095EAB2, 0x003E7B6A, 0x0058F422,
+    0x00EF1421, 0x00899B69, 0x00220AB1, 0x004485F9,
+    0x00CB864C, 0x00AD0904, 0x000698DC, 0x00601794,
+    0x00D7F797, 0x00B178DF, 0x001AE907, 0x007C664F,
+    0x00612C4E, 0x0007A306, 0x00AC32DE, 0x00CABD96,
+    0x007D5D95, 0x001BD2DD, 0x00B04305, 0x00D6CC4D,
+    0x0059CFF8, 0x003F40B0, 0x0094D168, 0x00F25E20,
+    0x0045BE23, 0x0023316B, 0x0088A0B3, 0x00EE2FFB,
+    0x0010EB22, 0x0076646A, 0x00DDF5B2, 0x00BB7AFA,
+    0x000C9AF9, 0x006A15B1, 0x00C18469, 0x00A70B21,
+    0x00280894, 0x004E87DC, 0x00E51604, 0x0083994C,
+    0x0034794F, 0x0052F607, 0x00F967DF, 0x009FE897,
+    0x00C3F3DD, 0x00A57C95, 0x000EED4D, 0x00686205,
+    0x00DF8206, 0x00B90D4E, 0x00129C96, 0x007413DE,
+    0x00FB106B, 0x009D9F23, 0x00360EFB, 0x005081B3,
+    0x00E761B0, 0x0081EEF8, 0x002A7F20, 0x004CF068,
+    0x00B234B1, 0x00D4BBF9, 0x007F2A21, 0x0019A569,
+    0x00AE456A, 0x00C8CA22, 0x00635BFA, 0x0005D4B2,
+    0x008AD707, 0x00EC584F, 0x0047C997, 0x002146DF,
+    0x0096A6DC, 0x00F02994, 0x005BB84C, 0x003D3704,
+    0x00207D05, 0x0046F24D, 0x00ED6395, 0x008BECDD,
+    0x003C0CDE, 0x005A8396, 0x00F1124E, 0x00979D06,
+    0x00189EB3, 0x007E11FB, 0x00D58023, 0x00B30F6B,
+    0x0004EF68, 0x00626020, 0x00C9F1F8, 0x00AF7EB0,
+    0x0051BA69, 0x00373521, 0x009CA4F9, 0x00FA2BB1,
+    0x004DCBB2, 0x002B44FA, 0x0080D522, 0x00E65A6A,
+    0x006959DF, 0x000FD697, 0x00A4474F, 0x00C2C807,
+    0x00752804, 0x0013A74C, 0x00B83694, 0x00DEB9DC,
+    },
+    {
+    0x00000000, 0x008309D7, 0x00805F55, 0x00035682,
+    0x0086F251, 0x0005FB86, 0x0006AD04, 0x0085A4D3,
+    0x008BA859, 0x0008A18E, 0x000BF70C, 0x0088FEDB,
+    0x000D5A08, 0x008E53DF, 0x008D055D, 0x000E0C8A,
+    0x00911C49, 0x0012159E, 0x0011431C, 0x00924ACB,
+    0x0017EE18, 0x0094E7CF, 0x0097B14D, 0x0014B89A,
+    0x001AB410, 0x0099BDC7, 0x009AEB45, 0x0019E292,
+    0x009C4641, 0x001F4F96, 0x001C1914, 0x009F10C3,
+    0x00A47469, 0x00277DBE, 0x00242B3C, 0x00A722EB,
+    0x00228638, 0x00A18FEF, 0x00A2D96D, 0x0021D0BA,
+    0x002FDC30, 0x00ACD5E7, 0x00AF8365, 0x002C8AB2,
+    0x00A92E61, 0x002A27B6, 0x00297134, 0x00AA78E3,
+    0x00356820, 0x00B661F7, 0x00B53775, 0x00363EA2,
+    0x00B39A71, 0x003093A6, 0x0033C524, 0x00B0CCF3,
+    0x00BEC079, 0x003DC9AE, 0x003E9F2C, 0x00BD96FB,
+    0x00383228, 0x00BB3BFF, 0x00B86D7D, 0x003B64AA,
+    0x00CEA429, 0x004DADFE, 0x004EFB7C, 0x00CDF2AB,
+    0x00485678, 0x00CB5FAF, 0x00C8092D, 0x004B00FA,
+    0x00450C70, 0x00C605A7, 0x00C55325, 0x00465AF2,
+    0x00C3FE21, 0x0040F7F6, 0x0043A174, 0x00C0A8A3,
+    0x005FB860, 0x00DCB1B7, 0x00DFE735, 0x005CEEE2,
+    0x00D94A31, 0x005A43E6, 0x00591564, 0x00DA1CB3,
+    0x00D41039, 0x005719EE, 0x00544F6C, 0x00D746BB,
+    0x0052E268, 0x00D1EBBF, 0x00D2BD3D, 0x0051B4EA,
+    0x006AD040, 0x00E9D997, 0x00EA8F15, 0x006986C2,
+    0x00EC2211, 0x006F2BC6, 0x006C7D44, 0x00EF7493,
+    0x00E17819, 0x006271CE, 0x0061274C, 0x00E22E9B,
+    0x00678A48, 0x00E4839F, 0x00E7D51D, 0x0064DCCA,
+    0x00FBCC09, 0x0078C5DE, 0x007B935C, 0x00F89A8B,
+    0x007D3E58, 0x00FE378F, 0x00FD610D, 0x007E68DA,
+    0x00706450, 0x00F36D87, 0x00F03B05, 0x007332D2,
+    0x00F69601, 0x00759FD6, 0x0076C954, 0x00F5C083,
+    0x001B04A9, 0x00980D7E, 0x009B5BFC, 0x0018522B,
+    0x009DF6F8, 0x001EFF2F, 0x001DA9AD, 0x009EA07A,
+    0x0090ACF0, 0x0013A527, 0x0010F3A5, 0x0093FA72,
+    0x00165EA1, 0x00955776, 0x009601F4, 0x00150823,
+    0x008A18E0, 0x00091137, 0x000A47B5, 0x00894E62,
+    0x000CEAB1, 0x008FE366, 0x008CB5E4, 0x000FBC33,
+    0x0001B0B9, 0x0082B96E, 0x0081EFEC, 0x0002E63B,
+    0x008742E8, 0x00044B3F, 0x00071DBD, 0x0084146A,
+    0x00BF70C0, 0x003C7917, 0x003F2F95, 0x00BC2642,
+    0x00398291, 0x00BA8B46, 0x00B9DDC4, 0x003AD413,
+    0x0034D899, 0x00B7D14E, 0x00B487CC, 0x00378E1B,
+    0x00B22AC8, 0x0031231F, 0x0032759D, 0x00B17C4A,
+    0x002E6C89, 0x00AD655E, 0x00AE33DC, 0x002D3A0B,
+    0x00A89ED8, 0x002B970F, 0x0028C18D, 0x00ABC85A,
+    0x00A5C4D0, 0x0026CD07, 0x00259B85, 0x00A69252,
+    0x00233681, 0x00A03F56, 0x00A369D4, 0x00206003,
+    0x00D5A080, 0x0056A957, 0x0055FFD5, 0x00D6F602,
+    0x005352D1, 0x00D05B06, 0x00D30D84, 0x00500453,
+    0x005E08D9, 0x00DD010E, 0x00DE578C, 0x005D5E5B,
+    0x00D8FA88, 0x005BF35F, 0x0058A5DD, 0x00DBAC0A,
+    0x0044BCC9, 0x00C7B51E, 0x00C4E39C, 0x0047EA4B,
+    0x00C24E98, 0x0041474F, 0x004211CD, 0x00C1181A,
+    0x00CF1490, 0x004C1D47, 0x004F4BC5, 0x00CC4212,
+    0x0049E6C1, 0x00CAEF16, 0x00C9B994, 0x004AB043,
+    0x0071D4E9, 0x00F2DD3E, 0x00F18BBC, 0x0072826B,
+    0x00F726B8, 0x00742F6F, 0x007779ED, 0x00F4703A,
+    0x00FA7CB0, 0x00797567, 0x007A23E5, 0x00F92A32,
+    0x007C8EE1, 0x00FF8736, 0x00FCD1B4, 0x007FD863,
+    0x00E0C8A0, 0x0063C177, 0x006097F5, 0x00E39E22,
+    0x00663AF1, 0x00E53326, 0x00E665A4, 0x00656C73,
+    0x006B60F9, 0x00E8692E, 0x00EB3FAC, 0x0068367B,
+    0x00ED92A8, 0x006E9B7F, 0x006DCDFD, 0x00EEC42A,
+    },
+    {
+    0x00000000, 0x00360952, 0x006C12A4, 0x005A1BF6,
+    0x00D82548, 0x00EE2C1A, 0x00B437EC, 0x00823EBE,
+    0x0036066B, 0x00000F39, 0x005A14CF, 0x006C1D9D,
+    0x00EE2323, 0x00D82A71, 0x00823187, 0x00B438D5,
+    0x006C0CD6, 0x005A0584, 0x00001E72, 0x00361720,
+    0x00B4299E, 0x008220CC, 0x00D83B3A, 0x00EE3268,
+    0x005A0ABD, 0x006C03EF, 0x00361819, 0x0000114B,
+    0x00822FF5, 0x00B426A7, 0x00EE3D51, 0x00D83403,
+    0x00D819AC, 0x00EE10FE, 0x00B40B08, 0x0082025A,
+    0x00003CE4, 0x003635B6, 0x006C2E40, 0x005A2712,
+    0x00EE1FC7, 0x00D81695, 0x00820D63, 0x00B40431,
+    0x00363A8F, 0x000033DD, 0x005A282B, 0x006C2179,
+    0x00B4157A, 0x00821C28, 0x00D807DE, 0x00EE0E8C,
+    0x006C3032, 0x005A3960, 0x00002296, 0x00362BC4,
+    0x00821311, 0x00B41A43, 0x00EE01B5, 0x00D808E7,
+    0x005A3659, 0x006C3F0B, 0x003624FD, 0x00002DAF,
+    0x00367FA3, 0x000076F1, 0x005A6D07, 0x006C6455,
+    0x00EE5AEB, 0x00D853B9, 0x0082484F, 0x00B4411D,
+    0x000079C8, 0x0036709A, 0x006C6B6C, 0x005A623E,
+    0x00D85C80, 0x00EE55D2, 0x00B44E24, 0x00824776,
+    0x005A7375, 0x006C7A27, 0x003661D1, 0x00006883,
+    0x0082563D, 0x00B45F6F, 0x00EE4499, 0x00D84DCB,
+    0x006C751E, 0x005A7C4C, 0x000067BA, 0x00366EE8,
+    0x00B45056, 0x00825904, 0x00D842F2, 0x00EE4BA0,
+    0x00EE660F, 0x00D86F5D, 0x008274AB, 0x00B47DF9,
+    0x00364347, 0x00004A15, 0x005A51E3, 0x006C58B1,
+    0x00D86064, 0x00EE6936, 0x00B472C0, 0x00827B92,
+    0x0000452C, 0x00364C7E, 0x006C5788, 0x005A5EDA,
+    0x00826AD9, 0x00B4638B, 0x00EE787D, 0x00D8712F,
+    0x005A4F91, 0x006C46C3, 0x00365D35, 0x00005467,
+    0x00B46CB2, 0x008265E0, 0x00D87E16, 0x00EE7744,
+    0x006C49FA, 0x005A40A8, 0x00005B5E, 0x0036520C,
+    0x006CFF46, 0x005AF614, 0x0000EDE2, 0x0036E4B0,
+    0x00B4DA0E, 0x0082D35C, 0x00D8C8AA, 0x00EEC1F8,
+    0x005AF92D, 0x006CF07F, 0x0036EB89, 0x0000E2DB,
+    0x0082DC65, 0x00B4D537, 0x00EECEC1, 0x00D8C793,
+    0x0000F390, 0x0036FAC2, 0x006CE134, 0x005AE866,
+    0x00D8D6D8, 0x00EEDF8A, 0x00B4C47C, 0x0082CD2E,
+    0x0036F5FB, 0x0000FCA9, 0x005AE75F, 0x006CEE0D,
+    0x00EED0B3, 0x00D8D9E1, 0x0082C217, 0x00B4CB45,
+    0x00B4E6EA, 0x0082EFB8, 0x00D8F44E, 0x00EEFD1C,
+    0x006CC3A2, 0x005ACAF0, 0x0000D106, 0x0036D854,
+    0x0082E081, 0x00B4E9D3, 0x00EEF225, 0x00D8FB77,
+    0x005AC5C9, 0x006CCC9B, 0x0036D76D, 0x0000DE3F,
+    0x00D8EA3C, 0x00EEE36E, 0x00B4F898, 0x0082F1CA,
+    0x0000CF74, 0x0036C626, 0x006CDDD0, 0x005AD482,
+    0x00EEEC57, 0x00D8E505, 0x0082FEF3, 0x00B4F7A1,
+    0x0036C91F, 0x0000C04D, 0x005ADBBB, 0x006CD2E9,
+    0x005A80E5, 0x006C89B7, 0x00369241, 0x00009B13,
+    0x0082A5AD, 0x00B4ACFF, 0x00EEB709, 0x00D8BE5B,
+    0x006C868E, 0x005A8FDC, 0x0000942A, 0x00369D78,
+    0x00B4A3C6, 0x0082AA94, 0x00D8B162, 0x00EEB830,
+    0x00368C33, 0x00008561, 0x005A9E97, 0x006C97C5,
+    0x00EEA97B, 0x00D8A029, 0x0082BBDF, 0x00B4B28D,
+    0x00008A58, 0x0036830A, 0x006C98FC, 0x005A91AE,
+    0x00D8AF10, 0x00EEA642, 0x00B4BDB4, 0x0082B4E6,
+    0x00829949, 0x00B4901B, 0x00EE8BED, 0x00D882BF,
+    0x005ABC01, 0x006CB553, 0x0036AEA5, 0x0000A7F7,
+    0x00B49F22, 0x00829670, 0x00D88D86, 0x00EE84D4,
+    0x006CBA6A, 0x005AB338, 0x0000A8CE, 0x0036A19C,
+    0x00EE959F, 0x00D89CCD, 0x0082873B, 0x00B48E69,
+    0x0036B0D7, 0x0000B985, 0x005AA273, 0x006CAB21,
+    0x00D893F4, 0x00EE9AA6, 0x00B48150, 0x00828802,
+    0x0000B6BC, 0x0036BFEE, 0x006CA418, 0x005AAD4A,
+    },
+    {
+    0x00000000, 0x00D9FE8C, 0x0035B1E3, 0x00EC4F6F,
+    0x006B63C6, 0x00B29D4A, 0x005ED225, 0x00872CA9,
+    0x00D6C78C, 0x000F3900, 0x00E3766F, 0x003A88E3,
+    0x00BDA44A, 0x00645AC6, 0x008815A9, 0x0051EB25,
+    0x002BC3E3, 0x00F23D6F, 0x001E7200, 0x00C78C8C,
+    0x0040A025, 0x00995EA9, 0x007511C6, 0x00ACEF4A,
+    0x00FD046F, 0x0024FAE3, 0x00C8B58C, 0x00114B00,
+    0x009667A9, 0x004F9925, 0x00A3D64A, 0x007A28C6,
+    0x005787C6, 0x008E794A, 0x00623625, 0x00BBC8A9,
+    0x003CE400, 0x00E51A8C, 0x000955E3, 0x00D0AB6F,
+    0x0081404A, 0x0058BEC6, 0x00B4F1A9, 0x006D0F25,
+    0x00EA238C, 0x0033DD00, 0x00DF926F, 0x00066CE3,
+    0x007C4425, 0x00A5BAA9, 0x0049F5C6, 0x00900B4A,
+    0x001727E3, 0x00CED96F, 0x00229600, 0x00FB688C,
+    0x00AA83A9, 0x00737D25, 0x009F324A, 0x0046CCC6,
+    0x00C1E06F, 0x00181EE3, 0x00F4518C, 0x002DAF00,
+    0x00AF0F8C, 0x0076F100, 0x009ABE6F, 0x004340E3,
+    0x00C46C4A, 0x001D92C6, 0x00F1DDA9, 0x00282325,
+    0x0079C800, 0x00A0368C, 0x004C79E3, 0x0095876F,
+    0x0012ABC6, 0x00CB554A, 0x00271A25, 0x00FEE4A9,
+    0x0084CC6F, 0x005D32E3, 0x00B17D8C, 0x00688300,
+    0x00EFAFA9, 0x00365125, 0x00DA1E4A, 0x0003E0C6,
+    0x00520BE3, 0x008BF56F, 0x0067BA00, 0x00BE448C,
+    0x00396825, 0x00E096A9, 0x000CD9C6, 0x00D5274A,
+    0x00F8884A, 0x002176C6, 0x00CD39A9, 0x0014C725,
+    0x0093EB8C, 0x004A1500, 0x00A65A6F, 0x007FA4E3,
+    0x002E4FC6, 0x00F7B14A, 0x001BFE25, 0x00C200A9,
+    0x00452C00, 0x009CD28C, 0x00709DE3, 0x00A9636F,
+    0x00D34BA9, 0x000AB525, 0x00E6FA4A, 0x003F04C6,
+    0x00B8286F, 0x0061D6E3, 0x008D998C, 0x00546700,
+    0x00058C25, 0x00DC72A9, 0x00303DC6, 0x00E9C34A,
+    0x006EEFE3, 0x00B7116F, 0x005B5E00, 0x0082A08C,
+    0x00D853E3, 0x0001AD6F, 0x00EDE200, 0x00341C8C,
+    0x00B33025, 0x006ACEA9, 0x008681C6, 0x005F7F4A,
+    0x000E946F, 0x00D76AE3, 0x003B258C, 0x00E2DB00,
+    0x0065F7A9, 0x00BC0925, 0x0050464A, 0x0089B8C6,
+    0x00F39000, 0x002A6E8C, 0x00C621E3, 0x001FDF6F,
+    0x0098F3C6, 0x00410D4A, 0x00AD4225, 0x0074BCA9,
+    0x0025578C, 0x00FCA900, 0x0010E66F, 0x00C918E3,
+    0x004E344A, 0x0097CAC6, 0x007B85A9, 0x00A27B25,
+    0x008FD425, 0x00562AA9, 0x00BA65C6, 0x00639B4A,
+    0x00E4B7E3, 0x003D496F, 0x00D10600, 0x0008F88C,
+    0x005913A9, 0x0080ED25, 0x006CA24A, 0x00B55CC6,
+    0x0032706F, 0x00EB8EE3, 0x0007C18C, 0x00DE3F00,
+    0x00A417C6, 0x007DE94A, 0x0091A625, 0x004858A9,
+    0x00CF7400, 0x00168A8C, 0x00FAC5E3, 0x00233B6F,
+    0x0072D04A, 0x00AB2EC6, 0x004761A9, 0x009E9F25,
+    0x0019B38C, 0x00C04D00, 0x002C026F, 0x00F5FCE3,
+    0x00775C6F, 0x00AEA2E3, 0x0042ED8C, 0x009B1300,
+    0x001C3FA9, 0x00C5C125, 0x00298E4A, 0x00F070C6,
+    0x00A19BE3, 0x0078656F, 0x00942A00, 0x004DD48C,
+    0x00CAF825, 0x001306A9, 0x00FF49C6, 0x0026B74A,
+    0x005C9F8C, 0x00856100, 0x00692E6F, 0x00B0D0E3,
+    0x0037FC4A, 0x00EE02C6, 0x00024DA9, 0x00DBB325,
+    0x008A5800, 0x0053A68C, 0x00BFE9E3, 0x0066176F,
+    0x00E13BC6, 0x0038C54A, 0x00D48A25, 0x000D74A9,
+    0x0020DBA9, 0x00F92525, 0x00156A4A, 0x00CC94C6,
+    0x004BB86F, 0x009246E3, 0x007E098C, 0x00A7F700,
+    0x00F61C25, 0x002FE2A9, 0x00C3ADC6, 0x001A534A,
+    0x009D7FE3, 0x0044816F, 0x00A8CE00, 0x0071308C,
+    0x000B184A, 0x00D2E6C6, 0x003EA9A9, 0x00E75725,
+    0x00607B8C, 0x00B98500, 0x0055CA6F, 0x008C34E3,
+    0x00DDDFC6, 0x0004214A, 0x00E86E25, 0x003190A9,
+    0x00B6BC00, 0x006F428C, 0x00830DE3, 0x005AF36F,
+    },
+    {
+    0x00000000, 0x0036EB3D, 0x006DD67A, 0x005B3D47,
+    0x00DBACF4, 0x00ED47C9, 0x00B67A8E, 0x008091B3,
+    0x00311513, 0x0007FE2E, 0x005CC369, 0x006A2854,
+    0x00EAB9E7, 0x00DC52DA, 0x00876F9D, 0x00B184A0,
+    0x00622A26, 0x0054C11B, 0x000FFC5C, 0x00391761,
+    0x00B986D2, 0x008F6DEF, 0x00D450A8, 0x00E2BB95,
+    0x00533F35, 0x0065D408, 0x003EE94F, 0x00080272,
+    0x008893C1, 0x00BE78FC, 0x00E545BB, 0x00D3AE86,
+    0x00C4544C, 0x00F2BF71, 0x00A98236, 0x009F690B,
+    0x001FF8B8, 0x00291385, 0x00722EC2, 0x0044C5FF,
+    0x00F5415F, 0x00C3AA62, 0x00989725, 0x00AE7C18,
+    0x002EEDAB, 0x00180696, 0x00433BD1, 0x0075D0EC,
+    0x00A67E6A, 0x00909557, 0x00CBA810, 0x00FD432D,
+    0x007DD29E, 0x004B39A3, 0x001004E4, 0x0026EFD9,
+    0x00976B79, 0x00A18044, 0x00FABD03, 0x00CC563E,
+    0x004CC78D, 0x007A2CB0, 0x002111F7, 0x0017FACA,
+    0x000EE463, 0x00380F5E, 0x00633219, 0x0055D924,
+    0x00D54897, 0x00E3A3AA, 0x00B89EED, 0x008E75D0,
+    0x003FF170, 0x00091A4D, 0x0052270A, 0x0064CC37,
+    0x00E45D84, 0x00D2B6B9, 0x00898BFE, 0x00BF60C3,
+    0x006CCE45, 0x005A2578, 0x0001183F, 0x0037F302,
+    0x00B762B1, 0x0081898C, 0x00DAB4CB, 0x00EC5FF6,
+    0x005DDB56, 0x006B306B, 0x00300D2C, 0x0006E611,
+    0x008677A2, 0x00B09C9F, 0x00EBA1D8, 0x00DD4AE5,
+    0x00CAB02F, 0x00FC5B12, 0x00A76655, 0x00918D68,
+    0x00111CDB, 0x0027F7E6, 0x007CCAA1, 0x004A219C,
+    0x00FBA53C, 0x00CD4E01, 0x00967346, 0x00A0987B,
+    0x002009C8, 0x0016E2F5, 0x004DDFB2, 0x007B348F,
+    0x00A89A09, 0x009E7134, 0x00C54C73, 0x00F3A74E,
+    0x007336FD, 0x0045DDC0, 0x001EE087, 0x00280BBA,
+    0x00998F1A, 0x00AF6427, 0x00F45960, 0x00C2B25D,
+    0x004223EE, 0x0074C8D3, 0x002FF594, 0x00191EA9,
+    0x001DC8C6, 0x002B23FB, 0x00701EBC, 0x0046F581,
+    0x00C66432, 0x00F08F0F, 0x00ABB248, 0x009D5975,
+    0x002CDDD5, 0x001A36E8, 0x00410BAF, 0x0077E092,
+    0x00F77121, 0x00C19A1C, 0x009AA75B, 0x00AC4C66,
+    0x007FE2E0, 0x004909DD, 0x0012349A, 0x0024DFA7,
+    0x00A44E14, 0x0092A529, 0x00C9986E, 0x00FF7353,
+    0x004EF7F3, 0x00781CCE, 0x00232189, 0x0015CAB4,
+    0x00955B07, 0x00A3B03A, 0x00F88D7D, 0x00CE6640,
+    0x00D99C8A, 0x00EF77B7, 0x00B44AF0, 0x0082A1CD,
+    0x0002307E, 0x0034DB43, 0x006FE604, 0x00590D39,
+    0x00E88999, 0x00DE62A4, 0x00855FE3, 0x00B3B4DE,
+    0x0033256D, 0x0005CE50, 0x005EF317, 0x0068182A,
+    0x00BBB6AC, 0x008D5D91, 0x00D660D6, 0x00E08BEB,
+    0x00601A58, 0x0056F165, 0x000DCC22, 0x003B271F,
+    0x008AA3BF, 0x00BC4882, 0x00E775C5, 0x00D19EF8,
+    0x00510F4B, 0x0067E476, 0x003CD931, 0x000A320C,
+    0x00132CA5, 0x0025C798, 0x007EFADF, 0x004811E2,
+    0x00C88051, 0x00FE6B6C, 0x00A5562B, 0x0093BD16,
+    0x002239B6, 0x0014D28B, 0x004FEFCC, 0x007904F1,
+    0x00F99542, 0x00CF7E7F, 0x00944338, 0x00A2A805,
+    0x00710683, 0x0047EDBE, 0x001CD0F9, 0x002A3BC4,
+    0x00AAAA77, 0x009C414A, 0x00C77C0D, 0x00F19730,
+    0x00401390, 0x0076F8AD, 0x002DC5EA, 0x001B2ED7,
+    0x009BBF64, 0x00AD5459, 0x00F6691E, 0x00C08223,
+    0x00D778E9, 0x00E193D4, 0x00BAAE93, 0x008C45AE,
+    0x000CD41D, 0x003A3F20, 0x00610267, 0x0057E95A,
+    0x00E66DFA, 0x00D086C7, 0x008BBB80, 0x00BD50BD,
+    0x003DC10E, 0x000B2A33, 0x00501774, 0x0066FC49,
+    0x00B552CF, 0x0083B9F2, 0x00D884B5, 0x00EE6F88,
+    0x006EFE3B, 0x00581506, 0x00032841, 0x0035C37C,
+    0x008447DC, 0x00B2ACE1, 0x00E991A6, 0x00DF7A9B,
+    0x005FEB28, 0x00690015, 0x00323D52, 0x0004D66F,
+    },
+    {
+    0x00000000, 0x003B918C, 0x00772318, 0x004CB294,
+    0x00EE4630, 0x00D5D7BC, 0x00996528, 0x00A2F4A4,
+    0x005AC09B, 0x00615117, 0x002DE383, 0x0016720F,
+    0x00B486AB, 0x008F1727, 0x00C3A5B3, 0x00F8343F,
+    0x00B58136, 0x008E10BA, 0x00C2A22E, 0x00F933A2,
+    0x005BC706, 0x0060568A, 0x002CE41E, 0x00177592,
+    0x00EF41AD, 0x00D4D021, 0x009862B5, 0x00A3F339,
+    0x0001079D, 0x003A9611, 0x00762485, 0x004DB509,
+    0x00ED4E97, 0x00D6DF1B, 0x009A6D8F, 0x00A1FC03,
+    0x000308A7, 0x0038992B, 0x00742BBF, 0x004FBA33,
+    0x00B78E0C, 0x008C1F80, 0x00C0AD14, 0x00FB3C98,
+    0x0059C83C, 0x006259B0, 0x002EEB24, 0x00157AA8,
+    0x0058CFA1, 0x00635E2D, 0x002FECB9, 0x00147D35,
+    0x00B68991, 0x008D181D, 0x00C1AA89, 0x00FA3B05,
+    0x00020F3A, 0x00399EB6, 0x00752C22, 0x004EBDAE,
+    0x00EC490A, 0x00D7D886, 0x009B6A12, 0x00A0FB9E,
+    0x005CD1D5, 0x00674059, 0x002BF2CD, 0x00106341,
+    0x00B297E5, 0x00890669, 0x00C5B4FD, 0x00FE2571,
+    0x0006114E, 0x003D80C2, 0x00713256, 0x004AA3DA,
+    0x00E8577E, 0x00D3C6F2, 0x009F7466, 0x00A4E5EA,
+    0x00E950E3, 0x00D2C16F, 0x009E73FB, 0x00A5E277,
+    0x000716D3, 0x003C875F, 0x007035CB, 0x004BA447,
+    0x00B39078, 0x008801F4, 0x00C4B360, 0x00FF22EC,
+    0x005DD648, 0x006647C4, 0x002AF550, 0x001164DC,
+    0x00B19F42, 0x008A0ECE, 0x00C6BC5A, 0x00FD2DD6,
+    0x005FD972, 0x006448FE, 0x0028FA6A, 0x00136BE6,
+    0x00EB5FD9, 0x00D0CE55, 0x009C7CC1, 0x00A7ED4D,
+    0x000519E9, 0x003E8865, 0x00723AF1, 0x0049AB7D,
+    0x00041E74, 0x003F8FF8, 0x00733D6C, 0x0048ACE0,
+    0x00EA5844, 0x00D1C9C8, 0x009D7B5C, 0x00A6EAD0,
+    0x005EDEEF, 0x00654F63, 0x0029FDF7, 0x00126C7B,
+    0x00B098DF, 0x008B0953, 0x00C7BBC7, 0x00FC2A4B,
+    0x00B9A3AA, 0x00823226, 0x00CE80B2, 0x00F5113E,
+    0x0057E59A, 0x006C7416, 0x0020C682, 0x001B570E,
+    0x00E36331, 0x00D8F2BD, 0x00944029, 0x00AFD1A5,
+    0x000D2501, 0x0036B48D, 0x007A0619, 0x00419795,
+    0x000C229C, 0x0037B310, 0x007B0184, 0x00409008,
+    0x00E264AC, 0x00D9F520, 0x009547B4, 0x00AED638,
+    0x0056E207, 0x006D738B, 0x0021C11F, 0x001A5093,
+    0x00B8A437, 0x008335BB, 0x00CF872F, 0x00F416A3,
+    0x0054ED3D, 0x006F7CB1, 0x0023CE25, 0x00185FA9,
+    0x00BAAB0D, 0x00813A81, 0x00CD8815, 0x00F61999,
+    0x000E2DA6, 0x0035BC2A, 0x00790EBE, 0x00429F32,
+    0x00E06B96, 0x00DBFA1A, 0x0097488E, 0x00ACD902,
+    0x00E16C0B, 0x00DAFD87, 0x00964F13, 0x00ADDE9F,
+    0x000F2A3B, 0x0034BBB7, 0x00780923, 0x004398AF,
+    0x00BBAC90, 0x00803D1C, 0x00CC8F88, 0x00F71E04,
+    0x0055EAA0, 0x006E7B2C, 0x0022C9B8, 0x00195834,
+    0x00E5727F, 0x00DEE3F3, 0x00925167, 0x00A9C0EB,
+    0x000B344F, 0x0030A5C3, 0x007C1757, 0x004786DB,
+    0x00BFB2E4, 0x00842368, 0x00C891FC, 0x00F30070,
+    0x0051F4D4, 0x006A6558, 0x0026D7CC, 0x001D4640,
+    0x0050F349, 0x006B62C5, 0x0027D051, 0x001C41DD,
+    0x00BEB579, 0x008524F5, 0x00C99661, 0x00F207ED,
+    0x000A33D2, 0x0031A25E, 0x007D10CA, 0x00468146,
+    0x00E475E2, 0x00DFE46E, 0x009356FA, 0x00A8C776,
+    0x00083CE8, 0x0033AD64, 0x007F1FF0, 0x00448E7C,
+    0x00E67AD8, 0x00DDEB54, 0x009159C0, 0x00AAC84C,
+    0x0052FC73, 0x00696DFF, 0x0025DF6B, 0x001E4EE7,
+    0x00BCBA43, 0x00872BCF, 0x00CB995B, 0x00F008D7,
+    0x00BDBDDE, 0x00862C52, 0x00CA9EC6, 0x00F10F4A,
+    0x0053FBEE, 0x00686A62, 0x0024D8F6, 0x001F497A,
+    0x00E77D45, 0x00DCECC9, 0x00905E5D, 0x00ABCFD1,
+    0x00093B75, 0x0032AAF9, 0x007E186D, 0x004589E1,
+    },
+    {
+    0x00000000, 0x00F50BAF, 0x006C5BA5, 0x0099500A,
+    0x00D8B74A, 0x002DBCE5, 0x00B4ECEF, 0x0041E740,
+    0x0037226F, 0x00C229C0, 0x005B79CA, 0x00AE7265,
+    0x00EF9525, 0x001A9E8A, 0x0083CE80, 0x0076C52F,
+    0x006E44DE, 0x009B4F71, 0x00021F7B, 0x00F714D4,
+    0x00B6F394, 0x0043F83B, 0x00DAA831, 0x002FA39E,
+    0x005966B1, 0x00AC6D1E, 0x00353D14, 0x00C036BB,
+    0x0081D1FB, 0x0074DA54, 0x00ED8A5E, 0x001881F1,
+    0x00DC89BC, 0x00298213, 0x00B0D219, 0x0045D9B6,
+    0x00043EF6, 0x00F13559, 0x00686553, 0x009D6EFC,
+    0x00EBABD3, 0x001EA07C, 0x0087F076, 0x0072FBD9,
+    0x00331C99, 0x00C61736, 0x005F473C, 0x00AA4C93,
+    0x00B2CD62, 0x0047C6CD, 0x00DE96C7, 0x002B9D68,
+    0x006A7A28, 0x009F7187, 0x0006218D, 0x00F32A22,
+    0x0085EF0D, 0x0070E4A2, 0x00E9B4A8, 0x001CBF07,
+    0x005D5847, 0x00A853E8, 0x003103E2, 0x00C4084D,
+    0x003F5F83, 0x00CA542C, 0x00530426, 0x00A60F89,
+    0x00E7E8C9, 0x0012E366, 0x008BB36C, 0x007EB8C3,
+    0x00087DEC, 0x00FD7643, 0x00642649, 0x00912DE6,
+    0x00D0CAA6, 0x0025C109, 0x00BC9103, 0x00499AAC,
+    0x00511B5D, 0x00A410F2, 0x003D40F8, 0x00C84B57,
+    0x0089AC17, 0x007CA7B8, 0x00E5F7B2, 0x0010FC1D,
+    0x00663932, 0x0093329D, 0x000A6297, 0x00FF6938,
+    0x00BE8E78, 0x004B85D7, 0x00D2D5DD, 0x0027DE72,
+    0x00E3D63F, 0x0016DD90, 0x008F8D9A, 0x007A8635,
+    0x003B6175, 0x00CE6ADA, 0x00573AD0, 0x00A2317F,
+    0x00D4F450, 0x0021FFFF, 0x00B8AFF5, 0x004DA45A,
+    0x000C431A, 0x00F948B5, 0x006018BF, 0x00951310,
+    0x008D92E1, 0x0078994E, 0x00E1C944, 0x0014C2EB,
+    0x005525AB, 0x00A02E04, 0x00397E0E, 0x00CC75A1,
+    0x00BAB08E, 0x004FBB21, 0x00D6EB2B, 0x0023E084,
+    0x006207C4, 0x00970C6B, 0x000E5C61, 0x00FB57CE,
+    0x007EBF06, 0x008BB4A9, 0x0012E4A3, 0x00E7EF0C,
+    0x00A6084C, 0x005303E3, 0x00CA53E9, 0x003F5846,
+    0x00499D69, 0x00BC96C6, 0x0025C6CC, 0x00D0CD63,
+    0x00912A23, 0x0064218C, 0x00FD7186, 0x00087A29,
+    0x0010FBD8, 0x00E5F077, 0x007CA07D, 0x0089ABD2,
+    0x00C84C92, 0x003D473D, 0x00A41737, 0x00511C98,
+    0x0027D9B7, 0x00D2D218, 0x004B8212, 0x00BE89BD,
+    0x00FF6EFD, 0x000A6552, 0x00933558, 0x00663EF7,
+    0x00A236BA, 0x00573D15, 0x00CE6D1F, 0x003B66B0,
+    0x007A81F0, 0x008F8A5F, 0x0016DA55, 0x00E3D1FA,
+    0x009514D5, 0x00601F7A, 0x00F94F70, 0x000C44DF,
+    0x004DA39F, 0x00B8A830, 0x0021F83A, 0x00D4F395,
+    0x00CC7264, 0x003979CB, 0x00A029C1, 0x0055226E,
+    0x0014C52E, 0x00E1CE81, 0x00789E8B, 0x008D9524,
+    0x00FB500B, 0x000E5BA4, 0x00970BAE, 0x00620001,
+    0x0023E741, 0x00D6ECEE, 0x004FBCE4, 0x00BAB74B,
+    0x0041E085, 0x00B4EB2A, 0x002DBB20, 0x00D8B08F,
+    0x009957CF, 0x006C5C60, 0x00F50C6A, 0x000007C5,
+    0x0076C2EA, 0x0083C945, 0x001A994F, 0x00EF92E0,
+    0x00AE75A0, 0x005B7E0F, 0x00C22E05, 0x003725AA,
+    0x002FA45B, 0x00DAAFF4, 0x0043FFFE, 0x00B6F451,
+    0x00F71311, 0x000218BE, 0x009B48B4, 0x006E431B,
+    0x00188634, 0x00ED8D9B, 0x0074DD91, 0x0081D63E,
+    0x00C0317E, 0x00353AD1, 0x00AC6ADB, 0x00596174,
+    0x009D6939, 0x00686296, 0x00F1329C, 0x00043933,
+    0x0045DE73, 0x00B0D5DC, 0x002985D6, 0x00DC8E79,
+    0x00AA4B56, 0x005F40F9, 0x00C610F3, 0x00331B5C,
+    0x0072FC1C, 0x0087F7B3, 0x001EA7B9, 0x00EBAC16,
+    0x00F32DE7, 0x00062648, 0x009F7642, 0x006A7DED,
+    0x002B9AAD, 0x00DE9102, 0x0047C108, 0x00B2CAA7,
+    0x00C40F88, 0x00310427, 0x00A8542D, 0x005D5F82,
+    0x001CB8C2, 0x00E9B36D, 0x0070E367, 0x0085E8C8,
+    },
+};
+
+unsigned crc24q_resume(unsigned crc, unsigned char *data, int len)
+/* continue a hash across buffer fragments; start with crc == 0 */
 {
-    int i;
-    unsigned crc = 0;
+    int i = 0;
+
+    /*
+     * Slicing-by-8: eight table lookups advance the hash eight bytes.
+     * The three state bytes fold into the lookups for the first three
+     * data bytes; the rest are position-only.  Tiny frames never enter
+     * this loop and take the byte-wise path below unchanged.
+     */
+    crc &= 0x00ffffff;
+    for (; len - i >= 8; i += 8) {
+	crc = crc24q_sliced[7][data[i] ^ (unsigned char)(crc >> 16)]
+	    ^ crc24q_sliced[6][data[i + 1] ^ (unsigned char)(crc >> 8)]
+	    ^ crc24q_sliced[5][data[i + 2] ^ (unsigned char)crc]
+	    ^ crc24q_sliced[4][data[i + 3]]
+	    ^ crc24q_sliced[3][data[i + 4]]
+	    ^ crc24q_sliced[2][data[i + 5]]
+	    ^ crc24q_sliced[1][data[i + 6]]
+	    ^ crc24q_sliced[0][data[i + 7]];
+    }
 
-    for (i = 0; i < len; i++) {
+    for (; i < len; i++) {
 	crc = (crc << 8) ^ crc24q[data[i] ^ (unsigned char)(crc >> 16)];
     }
 
@@ -157,6 +735,11 @@ unsigned crc24q_hash(unsigned char *data, int len)
     return crc;
 }
 
+unsigned crc24q_hash(unsigned char *data, int len)
+{
+    return crc24q_resume(0, data, len);
+}
+
 #define LO(x)	(unsigned char)((x) & 0xff)
 #define MID(x)	(unsigned char)(((x) >> 8) & 0xff)
 #define HI(x)	(unsigned char)(((x) >> 16) & 0xff)
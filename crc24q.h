@@ -12,4 +12,6 @@ extern void crc24q_sign(unsigned char *data, int len);
 extern bool crc24q_check(unsigned char *data, int len);
 
 extern unsigned crc24q_hash(unsigned char *data, int len);
+
+extern unsigned crc24q_resume(unsigned crc, unsigned char *data, int len);
 #endif /* _CRC24Q_H_ */
@@ -3,12 +3,68 @@
  * BSD terms apply: see the file COPYING in the distribution root for details.
  */
 #include <sys/types.h>
+#include <stddef.h>
 #include "gpsd_config.h"
 #if defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S)
 #include "dbusexport.h"
 
 static DBusConnection *connection = NULL;
 
+/*
+ * Signal coalescing.  Fixes reported during one consume_packets() pass
+ * are queued here and flushed once at the end of the pass; a batch of
+ * two or more goes out as a single array-typed "fixes" signal instead
+ * of that many "fix" round-trips through the bus daemon.  A lone fix
+ * still goes out as the classic "fix" signal, so single-receiver
+ * setups see no wire change.
+ */
+#define DBUS_FIX_QUEUE	16
+
+struct dbus_fix_t
+{
+    double time;
+    dbus_int32_t mode;
+    double ept;
+    double latitude;
+    double longitude;
+    double eph;
+    double altitude;
+    double epv;
+    double track;
+    double epd;
+    double speed;
+    double eps;
+    double climb;
+    double epc;
+    char devname[GPS_PATH_MAX];
+};
+
+/* field order and types of the fix payload, fixed at compile time */
+static const struct
+{
+    int type;
+    size_t offset;
+} dbus_fix_layout[] = {
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, time)},
+    {DBUS_TYPE_INT32,  offsetof(struct dbus_fix_t, mode)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, ept)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, latitude)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, longitude)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, eph)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, altitude)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, epv)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, track)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, epd)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, speed)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, eps)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, climb)},
+    {DBUS_TYPE_DOUBLE, offsetof(struct dbus_fix_t, epc)},
+};
+#define DBUS_FIX_SIGNATURE	"(didddddddddddds)"
+
+static struct dbus_fix_t fix_queue[DBUS_FIX_QUEUE];
+static int fix_queued = 0;
+
 /*
  * Does what is required to initialize the dbus connection
  * This is pretty basic at this point, as we don't receive commands via dbus.
@@ -27,47 +83,112 @@ int initialize_dbus_connection(void)
     return 0;
 }
 
+static void dbus_fix_snapshot(/*@out@*/struct dbus_fix_t *fp,
+			      struct gps_device_t *channel)
+/* capture the fix fields the wire format carries */
+{
+    struct gps_fix_t *gpsfix = &channel->gpsdata.fix;
+
+    fp->time = gpsfix->time;
+    fp->mode = (dbus_int32_t)gpsfix->mode;
+    fp->ept = gpsfix->ept;
+    fp->latitude = gpsfix->latitude;
+    fp->longitude = gpsfix->longitude;
+    /* this packet format was designed before we split eph */
+    fp->eph = EMIX(gpsfix->epx, gpsfix->epy);
+    fp->altitude = gpsfix->altitude;
+    fp->epv = gpsfix->epv;
+    fp->track = gpsfix->track;
+    fp->epd = gpsfix->epd;
+    fp->speed = gpsfix->speed;
+    fp->eps = gpsfix->eps;
+    fp->climb = gpsfix->climb;
+    fp->epc = gpsfix->epc;
+    (void)strlcpy(fp->devname, channel->gpsdata.dev.path,
+		  sizeof(fp->devname));
+}
+
+static void dbus_fix_append(DBusMessageIter *iter,
+			    const struct dbus_fix_t *fp)
+/* marshal one snapshot, driven by the static layout table */
+{
+    const char *devname = fp->devname;
+    size_t i;
+
+    for (i = 0; i < sizeof(dbus_fix_layout)/sizeof(dbus_fix_layout[0]); i++)
+	(void)dbus_message_iter_append_basic(iter,
+					     dbus_fix_layout[i].type,
+					     (const char *)fp +
+					     dbus_fix_layout[i].offset);
+    (void)dbus_message_iter_append_basic(iter, DBUS_TYPE_STRING, &devname);
+}
+
 void send_dbus_fix(struct gps_device_t *channel)
 {
 /* sends the current fix data for this channel via dbus */
-    struct gps_data_t *gpsdata;
-    struct gps_fix_t *gpsfix;
+    struct dbus_fix_t snapshot;
     DBusMessage *message;
-    /*DBusMessageIter   iter; */
+    DBusMessageIter iter;
     dbus_uint32_t serial;	/* collected, but not used */
-    char *gpsd_devname;
-    /* this packet format was designed before we split eph */
-    double eph;
 
     /* if the connection is non existent, return without doing anything */
     if (connection == NULL)
 	return;
 
-    gpsdata = &(channel->gpsdata);
-    gpsfix = &(gpsdata->fix);
-    /* this packet format was designed before we split eph */
-    eph = EMIX(gpsfix->epx, gpsfix->epy);
-    gpsd_devname = gpsdata->dev.path;
+    dbus_fix_snapshot(&snapshot, channel);
 
     /* Send the named signel.  */
     message = dbus_message_new_signal("/org/gpsd", "org.gpsd", "fix");
-    dbus_message_append_args(message,
-			     DBUS_TYPE_DOUBLE, &(gpsfix->time),
-			     DBUS_TYPE_INT32, &(gpsfix->mode),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->ept),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->latitude),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->longitude),
-			     DBUS_TYPE_DOUBLE, &(eph),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->altitude),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->epv),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->track),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->epd),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->speed),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->eps),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->climb),
-			     DBUS_TYPE_DOUBLE, &(gpsfix->epc),
-			     DBUS_TYPE_STRING, &gpsd_devname,
-			     DBUS_TYPE_INVALID);
+    dbus_message_iter_init_append(message, &iter);
+    dbus_fix_append(&iter, &snapshot);
+    dbus_message_set_no_reply(message, TRUE);
+    dbus_connection_send(connection, message, &serial);
+    dbus_message_unref(message);
+}
+
+void queue_dbus_fix(struct gps_device_t *channel)
+/* queue a fix for the end-of-pass flush */
+{
+    if (connection == NULL)
+	return;
+    if (fix_queued >= DBUS_FIX_QUEUE)
+	flush_dbus_fixes();	/* shouldn't happen at sane cycle rates */
+    dbus_fix_snapshot(&fix_queue[fix_queued++], channel);
+}
+
+void flush_dbus_fixes(void)
+/* emit everything queued since the last flush */
+{
+    DBusMessage *message;
+    DBusMessageIter iter, array;
+    dbus_uint32_t serial;	/* collected, but not used */
+    int i;
+
+    if (connection == NULL || fix_queued == 0) {
+	fix_queued = 0;
+	return;
+    }
+    if (fix_queued == 1) {
+	/* no batch to amortize; keep the traditional signal */
+	message = dbus_message_new_signal("/org/gpsd", "org.gpsd", "fix");
+	dbus_message_iter_init_append(message, &iter);
+	dbus_fix_append(&iter, &fix_queue[0]);
+    } else {
+	message = dbus_message_new_signal("/org/gpsd", "org.gpsd", "fixes");
+	dbus_message_iter_init_append(message, &iter);
+	(void)dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY,
+					       DBUS_FIX_SIGNATURE, &array);
+	for (i = 0; i < fix_queued; i++) {
+	    DBusMessageIter element;
+
+	    (void)dbus_message_iter_open_container(&array, DBUS_TYPE_STRUCT,
+						   NULL, &element);
+	    dbus_fix_append(&element, &fix_queue[i]);
+	    (void)dbus_message_iter_close_container(&array, &element);
+	}
+	(void)dbus_message_iter_close_container(&iter, &array);
+    }
+    fix_queued = 0;
     dbus_message_set_no_reply(message, TRUE);
     dbus_connection_send(connection, message, &serial);
     dbus_message_unref(message);
@@ -29,6 +29,32 @@
 #define DAC1FID31_LEVEL_OFFSET			100
 #define DAC1FID31_WATERTEMP_OFFSET		100
 
+/*
+ * Payload de-armoring table: the six bits each ASCII payload
+ * character contributes, one entry per possible byte so the decode
+ * loop is a plain lookup.  Entries outside the armoring alphabet
+ * reproduce what the old arithmetic (subtract 48, subtract 8 above
+ * 87, keep the low six bits) yielded for garbage input.
+ */
+static const unsigned char sixarmor[256] = {
+     8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+    24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 32, 33, 34, 35, 36, 37, 38, 39,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63,  0,  1,  2,  3,  4,  5,  6,  7,
+     8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+    24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63,  0,  1,  2,  3,  4,  5,  6,  7,
+     8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+    24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63,  0,  1,  2,  3,  4,  5,  6,  7,
+};
+
 static void from_sixbit(char *bitvec, uint start, int count, char *to)
 {
     /*@ +type @*/
@@ -39,12 +65,14 @@ static void from_sixbit(char *bitvec, uint start, int count, char *to)
     const char sixchr[64] =
 	"@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^- !\"#$%&'()*+,-./0123456789:;<=>?";
 #endif /* S_SPLINT_S */
+    struct bits_cursor_t bc;
     int i;
     char newchar;
 
     /* six-bit to ASCII */
+    bits_cursor_open(&bc, bitvec, start);
     for (i = 0; i < count - 1; i++) {
-	newchar = sixchr[ubits(bitvec, start + 6 * i, 6U)];
+	newchar = sixchr[bits_cursor_utake(&bc, 6U)];
 	if (newchar == '@')
 	    break;
 	else
@@ -87,8 +115,9 @@ bool aivdm_decode(const char *buf, size_t buflen,
     unsigned char *field[NMEA_MAX*2];
     unsigned char fieldcopy[NMEA_MAX*2+1];
     unsigned char *data, *cp;
-    unsigned char ch, pad;
+    unsigned char pad;
     struct aivdm_context_t *ais_context;
+    struct bits_cursor_t bc;
     bool imo;
     int i;
     unsigned int u;
@@ -180,23 +209,33 @@ bool aivdm_decode(const char *buf, size_t buflen,
 
     /* wacky 6-bit encoding, shades of FIELDATA */
     /*@ +charint @*/
-    for (cp = data; cp < data + strlen((char *)data); cp++) {
-	ch = *cp;
-	ch -= 48;
-	if (ch >= 40)
-	    ch -= 8;
+    {
+	/*
+	 * Pack through a bit accumulator, flushing whole bytes, rather
+	 * than setting one bit at a time.  Fragments append at bit
+	 * offsets that are multiples of 6, so the partial byte left by
+	 * a previous fragment is folded in by seeding the accumulator.
+	 */
+	size_t b = ais_context->bitlen / 8;
+	unsigned int acc = 0;
+	unsigned int accbits = (unsigned int)(ais_context->bitlen % 8);
+
+	if (accbits != 0)
+	    acc = (unsigned int)ais_context->bits[b] >> (8 - accbits);
+	for (cp = data; *cp != '\0'; cp++) {
+	    acc = (acc << 6) | sixarmor[*cp];
+	    accbits += 6;
+	    ais_context->bitlen += 6;
 #ifdef __UNUSED_DEBUG__
-	gpsd_report(LOG_RAW, "%c: %s\n", *cp, sixbits[ch]);
+	    gpsd_report(LOG_RAW, "%c: %s\n", *cp, sixbits[sixarmor[*cp]]);
 #endif /* __UNUSED_DEBUG__ */
-	/*@ -shiftnegative @*/
-	for (i = 5; i >= 0; i--) {
-	    if ((ch >> i) & 0x01) {
-		ais_context->bits[ais_context->bitlen / 8] |=
-		    (1 << (7 - ais_context->bitlen % 8));
+	    if (accbits >= 8) {
+		accbits -= 8;
+		ais_context->bits[b++] = (unsigned char)(acc >> accbits);
 	    }
-	    ais_context->bitlen++;
 	}
-	/*@ +shiftnegative @*/
+	if (accbits != 0)
+	    ais_context->bits[b] = (unsigned char)(acc << (8 - accbits));
     }
     if (isdigit(pad))
 	ais_context->bitlen -= (pad - '0');	/* ASCII assumption */
@@ -211,12 +250,16 @@ bool aivdm_decode(const char *buf, size_t buflen,
 			gpsd_hexdump((char *)ais_context->bits, clen));
 	}
 
-        /* clear waiting fragments count */
+        /* clear waiting fragments count and the fragment-1 peek */
         ais_context->decoded_frags = 0;
+        ais_context->frag_type = ais_context->frag_mmsi = 0;
 
+	/* fields decode in roughly ascending order, so nearly every
+	 * extraction below is served from the cursor's cached window */
+	bits_cursor_open(&bc, ais_context->bits, 0);
 #define BITS_PER_BYTE	8
-#define UBITS(s, l)	ubits((char *)ais_context->bits, s, l)
-#define SBITS(s, l)	sbits((char *)ais_context->bits, s, l)
+#define UBITS(s, l)	bits_cursor_uget(&bc, s, l)
+#define SBITS(s, l)	bits_cursor_sget(&bc, s, l)
 #define UCHARS(s, to)	from_sixbit((char *)ais_context->bits, s, sizeof(to), to)
 	ais->type = UBITS(0, 6);
 	ais->repeat = UBITS(6, 2);
@@ -1107,7 +1150,20 @@ bool aivdm_decode(const char *buf, size_t buflen,
 	return true;
     }
 
-    /* we're still waiting on another sentence */
+    /*
+     * We're still waiting on another sentence.  Peek the type and
+     * MMSI out of fragment 1 - the leading 38 bits always land whole
+     * in the first fragment - so a latency-sensitive consumer can
+     * decide whether the sequence interests it before the rest of
+     * the fragments arrive.
+     */
+    if (ifrag == 1 && ais_context->bitlen >= 38) {
+	ais_context->frag_type = (unsigned int)ubits64(ais_context->bits, 0, 6);
+	ais_context->frag_mmsi = (unsigned int)ubits64(ais_context->bits, 8, 30);
+	gpsd_report(LOG_PROG,
+		    "AIVDM fragment 1 of %d: early type %u, MMSI %09u\n",
+		    nfrags, ais_context->frag_type, ais_context->frag_mmsi);
+    }
     ais_context->decoded_frags++;
     return false;
 }
@@ -162,13 +162,30 @@ gps_mask_t evermore_parse(struct gps_device_t * session, unsigned char *buf,
     /*@ -usedef @*/
     buf2[0] = '\0';	/* prevent 'Assigned value is garbage or undefined' from scan-build */
     tp = buf2;
-    for (i = 0; i < (size_t) datalen; i++) {
+    /*
+     * Unstuff just enough to see the message type first; three bytes
+     * also covers the command id the 0x38 ACK case logs.
+     */
+    for (i = 0; i < (size_t) datalen && i < 3; i++) {
 	*tp = *cp++;
 	if (*tp == 0x10)
 	    cp++;
 	tp++;
     }
     type = (unsigned char)getub(buf2, 1);
+    if (type == 0x02 || type == 0x04 || type == 0x06 || type == 0x08) {
+	/*
+	 * Only these EIDs carry data that can alter the fix; the
+	 * ID/ACK/log chatter is disposed of below without paying for
+	 * unstuffing of its whole payload.
+	 */
+	for (; i < (size_t) datalen; i++) {
+	    *tp = *cp++;
+	    if (*tp == 0x10)
+		cp++;
+	    tp++;
+	}
+    }
     /*@ +usedef @*/
 
     /*@ -usedef -compdef @*/
@@ -614,7 +631,7 @@ const struct gps_type_t evermore_binary =
     .probe_detect   = NULL,			/* no probe */
     .get_packet     = generic_get,		/* use generic one */
     .parse_packet   = evermore_parse_input,	/* parse message packets */
-    .rtcm_writer    = gpsd_write,		/* send RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,		/* send RTCM data straight */
     .event_hook     = evermore_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = evermore_speed,		/* we can change baud rates */
@@ -995,9 +995,12 @@ gps_mask_t garmin_ser_parse(struct gps_device_t *session)
 	gpsd_report(LOG_RAW + 1, "Garmin: serial too short: %zd\n", len);
 	return 0;
     }
-    /* debug */
-    for (i = 0; i < (int)len; i++) {
-	gpsd_report(LOG_RAW + 1, "Garmin: Char: %#02x\n", buf[i]);
+    /* debug - only format when the bytes will actually be logged,
+     * this loop fires for every byte of every packet otherwise */
+    if (session->context->debug >= LOG_RAW + 1) {
+	for (i = 0; i < (int)len; i++) {
+	    gpsd_report(LOG_RAW + 1, "Garmin: Char: %#02x\n", buf[i]);
+	}
     }
 
     if ('\x10' != buf[0]) {
@@ -1096,8 +1099,10 @@ gps_mask_t garmin_ser_parse(struct gps_device_t *session)
 
     /* debug */
     /*@ -usedef -compdef @*/
-    for (i = 0; i < data_index; i++) {
-	gpsd_report(LOG_RAW + 1, "Garmin: Char: %#02x\n", data_buf[i]);
+    if (session->context->debug >= LOG_RAW + 1) {
+	for (i = 0; i < data_index; i++) {
+	    gpsd_report(LOG_RAW + 1, "Garmin: Char: %#02x\n", data_buf[i]);
+	}
     }
 
 
@@ -1221,7 +1226,9 @@ static int GetPacket(struct gps_device_t *session)
     int cnt = 0;
     // int x = 0; // for debug dump
 
-    memset(session->driver.garmin.Buffer, 0, sizeof(Packet_t));
+    /* only the USB header needs clearing; the payload is bounded by
+     * BufferLen, so zeroing all of Packet_t per packet is wasted work */
+    memset(session->driver.garmin.Buffer, 0, 12);
     memset(&delay, 0, sizeof(delay));
     session->driver.garmin.BufferLen = 0;
     session->packet.outbuflen = 0;
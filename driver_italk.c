@@ -185,6 +185,7 @@ static gps_mask_t decode_itk_utcionomodel(struct gps_device_t *session,
     leap = (int)getleu16(buf, 7 + 24);
     if (session->context->leap_seconds < leap)
 	session->context->leap_seconds = leap;
+    session->context->valid |= LEAP_SECOND_VALID;
 
     session->newdata.time = gpsd_gpstime_resolve(session,
 	(unsigned short) getleu16(buf, 7 + 36),
@@ -410,7 +411,7 @@ const struct gps_type_t italk_binary =
     .probe_detect   = NULL,		/* how to detect at startup time */
     .get_packet     = generic_get,	/* use generic packet grabber */
     .parse_packet   = italk_parse_input,/* parse message packets */
-    .rtcm_writer    = gpsd_write,	/* send RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* send RTCM data straight */
     .event_hook     = NULL,		/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
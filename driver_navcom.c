@@ -45,23 +45,19 @@
 #include "bits.h"
 
 /* Have data which is 24 bits long */
-#define getles3224(buf,off)  (int32_t)(((uint32_t)getub((buf), (off)+2)<<24 | (uint32_t)getub((buf), (off)+1)<<16 | (uint32_t)getub((buf), (off))<<8)>>8)
-#define getleu3224(buf,off) (uint32_t)(((uint32_t)getub((buf), (off)+2)<<24 | (uint32_t)getub((buf), (off)+1)<<16 | (uint32_t)getub((buf), (off))<<8)>>8)
+#define getles3224(buf,off)  (int32_t)((((uint32_t)getub((buf), (off)+2)<<24 | (uint32_t)getleu16((buf), (off))<<8))>>8)
+#define getleu3224(buf,off) (uint32_t)(((uint32_t)getub((buf), (off)+2)<<16 | (uint32_t)getleu16((buf), (off))))
 
 /* And just to be difficult, Navcom is little endian but the GPS data stream
-   is big endian.  Some messages contain raw GPS data */
-#define getles16_be(buf, off)	(int16_t)((((uint16_t)getub(buf, (off)) << 8) \
-				    | (uint16_t)getub(buf, (off)+1)))
-#define getleu16_be(buf, off)	(uint16_t)((((uint16_t)getub(buf, (off)) << 8) \
-				    | (uint16_t)getub(buf, (off)+1)))
-#define getles32_be(buf, off)	(int32_t)((((uint16_t)getleu16_be(buf, (off)) << 16) \
-				    | getleu16_be(buf, (off)+2)))
-#define getleu32_be(buf, off)	(uint32_t)((((uint16_t)getleu16_be(buf, (off)) << 16) \
-				    | getleu16_be(buf, (off)+2)))
-#define getles64_be(buf, off)	(int64_t)((((uint64_t)getleu32_be(buf, (off)) << 32) \
-				    | getleu32_be(buf, (off)+4)))
-#define getleu64_be(buf, off)	(uint64_t)((((uint64_t)getleu32_be(buf, (off)) << 32) \
-				    | getleu32_be(buf, (off)+4)))
+   is big endian.  Some messages contain raw GPS data.  These are plain
+   big-endian fetches; route them through bits.h so they pick up the
+   single-load fast path where it exists */
+#define getles16_be(buf, off)	getbes16(buf, off)
+#define getleu16_be(buf, off)	getbeu16(buf, off)
+#define getles32_be(buf, off)	getbes32(buf, off)
+#define getleu32_be(buf, off)	getbeu32(buf, off)
+#define getles64_be(buf, off)	getbes64(buf, off)
+#define getleu64_be(buf, off)	getbeu64(buf, off)
 #define getles3224_be(buf,off)     (int32_t)(((uint32_t)getub((buf), (off))<<24 \
 				    | (uint32_t)getub((buf), (off)+1)<<16 \
 				    | (uint32_t)getub((buf), (off)+2)<<8)>>8)
@@ -272,6 +268,7 @@ static gps_mask_t handle_0x83(struct gps_device_t *session)
 	/* Effectivity time is not in the future, use dtlsf */
 	session->context->leap_seconds = (int)dtlsf;
     }
+    session->context->valid |= LEAP_SECOND_VALID;
     /*@ -relaxtypes -charint @*/
 
     gpsd_report(LOG_PROG,
@@ -1289,7 +1286,7 @@ const struct gps_type_t navcom_binary =
     .probe_detect   = NULL,			/* no probe */
     .get_packet     = generic_get,		/* use generic one */
     .parse_packet   = navcom_parse_input,	/* parse message packets */
-    .rtcm_writer    = gpsd_write,		/* send RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,		/* send RTCM data straight */
     .event_hook     = navcom_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = navcom_speed,		/* we do change baud rates */
@@ -12,6 +12,23 @@
 
 #include "gpsd.h"
 
+/*
+ * Vector kernels for the sentence hot loops.  One NMEA sentence is
+ * small, but fleets of talkers at 100+ sentences per second add up;
+ * scanning for delimiters and folding the XOR checksum go 16 bytes at
+ * a stride where SSE2 or NEON is available, with the byte loops kept
+ * as tail and fallback.
+ */
+#if !defined(S_SPLINT_S)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NMEA_VECTOR
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NMEA_VECTOR
+#endif
+#endif /* !defined(S_SPLINT_S) */
+
 #ifdef NMEA_ENABLE
 /**************************************************************************
  *
@@ -19,28 +36,71 @@
  *
  **************************************************************************/
 
+/* exact powers of ten for the fixed-format parser below;
+ * plain [+-]ddd[.ddd] fields go through safe_atof() in gpsutils.c */
+static const double pow10d[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+static bool nmea_deg_atof(const char *str, /*@out@*/double *out)
+/* convert an NMEA ddmm.mmmm field straight to decimal degrees */
+{
+    const char *p = str;
+    unsigned long ipart = 0;
+    unsigned long long fpart = 0;
+    int idigits = 0, fdigits = 0;
+
+    for (; *p >= '0' && *p <= '9'; ++p) {
+	ipart = ipart * 10 + (unsigned long)(*p - '0');
+	idigits++;
+    }
+    if (*p == '.')
+	for (++p; *p >= '0' && *p <= '9'; ++p) {
+	    fpart = fpart * 10 + (unsigned long long)(*p - '0');
+	    fdigits++;
+	}
+    if (*p != '\0' || idigits == 0 || idigits > 9 || fdigits > 9)
+	return false;
+    /*
+     * The two low integer digits and the fraction are minutes; what's
+     * left above them is whole degrees.  Both the minutes numerator
+     * and the denominator are exact, so the value is as good as the
+     * field allows in one division and one addition.
+     */
+    *out = (double)(ipart / 100) +
+	(double)((unsigned long long)(ipart % 100) *
+		 (unsigned long long)pow10d[fdigits] + fpart) /
+	(pow10d[fdigits] * 60.0);
+    return true;
+}
+
 static void do_lat_lon(char *field[], struct gps_fix_t *out)
 /* process a pair of latitude/longitude fields starting at field index BEGIN */
 {
     double lat, lon, d, m;
-    char str[20], *p;
+    char *p;
 
     if (*(p = field[0]) != '\0') {
-	(void)strlcpy(str, p, sizeof(str));
-	(void)sscanf(p, "%lf", &lat);
-	m = 100.0 * modf(lat / 100.0, &d);
-	lat = d + m / 60.0;
+	if (!nmea_deg_atof(p, &lat)) {
+	    /* not the rigid shape; fall back to the old slow path */
+	    lat = 0.0;
+	    (void)sscanf(p, "%lf", &lat);
+	    m = 100.0 * modf(lat / 100.0, &d);
+	    lat = d + m / 60.0;
+	}
 	p = field[1];
 	if (*p == 'S')
 	    lat = -lat;
 	out->latitude = lat;
     }
     if (*(p = field[2]) != '\0') {
-	(void)strlcpy(str, p, sizeof(str));
-	(void)sscanf(p, "%lf", &lon);
-	m = 100.0 * modf(lon / 100.0, &d);
-	lon = d + m / 60.0;
-
+	if (!nmea_deg_atof(p, &lon)) {
+	    lon = 0.0;
+	    (void)sscanf(p, "%lf", &lon);
+	    m = 100.0 * modf(lon / 100.0, &d);
+	    lon = d + m / 60.0;
+	}
 	p = field[3];
 	if (*p == 'W')
 	    lon = -lon;
@@ -105,7 +165,7 @@ static void merge_hhmmss(char *hhmmss, struct gps_device_t *session)
     session->driver.nmea.date.tm_min = DD(hhmmss + 2);
     session->driver.nmea.date.tm_sec = DD(hhmmss + 4);
     session->driver.nmea.subseconds =
-	atof(hhmmss + 4) - session->driver.nmea.date.tm_sec;
+	safe_atof(hhmmss + 4) - session->driver.nmea.date.tm_sec;
 }
 
 static void register_fractional_time(const char *tag, const char *fld,
@@ -114,7 +174,7 @@ static void register_fractional_time(const char *tag, const char *fld,
     if (fld[0] != '\0') {
 	session->driver.nmea.last_frac_time =
 	    session->driver.nmea.this_frac_time;
-	session->driver.nmea.this_frac_time = atof(fld);
+	session->driver.nmea.this_frac_time = safe_atof(fld);
 	session->driver.nmea.latch_frac_time = true;
 	gpsd_report(LOG_DATA, "%s: registers fractional time %.2f\n",
 		    tag, session->driver.nmea.this_frac_time);
@@ -187,8 +247,8 @@ static gps_mask_t processGPRMC(int count, char *field[],
 	}
 	do_lat_lon(&field[3], &session->newdata);
 	mask |= LATLON_SET;
-	session->newdata.speed = atof(field[7]) * KNOTS_TO_MPS;
-	session->newdata.track = atof(field[8]);
+	session->newdata.speed = safe_atof(field[7]) * KNOTS_TO_MPS;
+	session->newdata.track = safe_atof(field[8]);
 	mask |= (TRACK_SET | SPEED_SET);
 	/*
 	 * This copes with GPSes like the Magellan EC-10X that *only* emit
@@ -373,7 +433,7 @@ static gps_mask_t processGPGGA(int c UNUSED, char *field[],
 		mask |= MODE_SET;
 	    }
 	} else {
-	    session->newdata.altitude = atof(altitude);
+	    session->newdata.altitude = safe_atof(altitude);
 	    mask |= ALTITUDE_SET;
 	    /*
 	     * This is a bit dodgy.  Technically we shouldn't set the mode
@@ -388,7 +448,7 @@ static gps_mask_t processGPGGA(int c UNUSED, char *field[],
 	    }
 	}
 	if (strlen(field[11]) > 0) {
-	    session->gpsdata.separation = atof(field[11]);
+	    session->gpsdata.separation = safe_atof(field[11]);
 	} else {
 	    session->gpsdata.separation =
 		wgs84_separation(session->newdata.latitude,
@@ -426,7 +486,7 @@ static gps_mask_t processGPGST(int count, char *field[], struct gps_device_t *se
       return 0;
     }
 
-#define PARSE_FIELD(n) (*field[n]!='\0' ? atof(field[n]) : NAN)
+#define PARSE_FIELD(n) (*field[n]!='\0' ? safe_atof(field[n]) : NAN)
     session->gpsdata.gst.utctime             = PARSE_FIELD(1);
     session->gpsdata.gst.rms_deviation       = PARSE_FIELD(2);
     session->gpsdata.gst.smajor_deviation    = PARSE_FIELD(3);
@@ -497,9 +557,9 @@ static gps_mask_t processGPGSA(int count, char *field[],
 	else
 	    mask = MODE_SET;
 	gpsd_report(LOG_PROG, "GPGSA sets mode %d\n", session->newdata.mode);
-	session->gpsdata.dop.pdop = atof(field[15]);
-	session->gpsdata.dop.hdop = atof(field[16]);
-	session->gpsdata.dop.vdop = atof(field[17]);
+	session->gpsdata.dop.pdop = safe_atof(field[15]);
+	session->gpsdata.dop.hdop = safe_atof(field[16]);
+	session->gpsdata.dop.vdop = safe_atof(field[17]);
 	session->gpsdata.satellites_used = 0;
 	memset(session->gpsdata.used, 0, sizeof(session->gpsdata.used));
 	/* the magic 6 here counts the tag, two mode fields, and the DOP fields */
@@ -647,11 +707,11 @@ static gps_mask_t processPGRME(int c UNUSED, char *field[],
 	mask = 0;
     } else {
 	session->newdata.epx = session->newdata.epy =
-	    atof(field[1]) * (1 / sqrt(2)) * (GPSD_CONFIDENCE / CEP50_SIGMA);
+	    safe_atof(field[1]) * (1 / sqrt(2)) * (GPSD_CONFIDENCE / CEP50_SIGMA);
 	session->newdata.epv =
-	    atof(field[3]) * (GPSD_CONFIDENCE / CEP50_SIGMA);
+	    safe_atof(field[3]) * (GPSD_CONFIDENCE / CEP50_SIGMA);
 	session->gpsdata.epe =
-	    atof(field[5]) * (GPSD_CONFIDENCE / CEP50_SIGMA);
+	    safe_atof(field[5]) * (GPSD_CONFIDENCE / CEP50_SIGMA);
 	mask = HERR_SET | VERR_SET | PERR_IS;
     }
 
@@ -686,9 +746,9 @@ static gps_mask_t processGPGBS(int c UNUSED, char *field[],
     if (session->driver.nmea.date.tm_hour == DD(field[1])
 	&& session->driver.nmea.date.tm_min == DD(field[1] + 2)
 	&& session->driver.nmea.date.tm_sec == DD(field[1] + 4)) {
-	session->newdata.epy = atof(field[2]);
-	session->newdata.epx = atof(field[3]);
-	session->newdata.epv = atof(field[4]);
+	session->newdata.epy = safe_atof(field[2]);
+	session->newdata.epx = safe_atof(field[3]);
+	session->newdata.epv = safe_atof(field[4]);
 	gpsd_report(LOG_DATA, "GBS: epx=%.2f epy=%.2f epv=%.2f\n",
 		    session->newdata.epx,
 		    session->newdata.epy,
@@ -786,7 +846,7 @@ static gps_mask_t processHDT(int c UNUSED, char *field[],
     gps_mask_t mask;
     mask = ONLINE_SET;
 
-    session->gpsdata.attitude.heading = atof(field[1]);
+    session->gpsdata.attitude.heading = safe_atof(field[1]);
     session->gpsdata.attitude.mag_st = '\0';
     session->gpsdata.attitude.pitch = NAN;
     session->gpsdata.attitude.pitch_st = '\0';
@@ -850,17 +910,17 @@ static gps_mask_t processTNTHTM(int c UNUSED, char *field[],
     gps_mask_t mask;
     mask = ONLINE_SET;
 
-    session->gpsdata.attitude.heading = atof(field[1]);
+    session->gpsdata.attitude.heading = safe_atof(field[1]);
     session->gpsdata.attitude.mag_st = *field[2];
-    session->gpsdata.attitude.pitch = atof(field[3]);
+    session->gpsdata.attitude.pitch = safe_atof(field[3]);
     session->gpsdata.attitude.pitch_st = *field[4];
-    session->gpsdata.attitude.roll = atof(field[5]);
+    session->gpsdata.attitude.roll = safe_atof(field[5]);
     session->gpsdata.attitude.roll_st = *field[6];
     session->gpsdata.attitude.yaw = NAN;
     session->gpsdata.attitude.yaw_st = '\0';
-    session->gpsdata.attitude.dip = atof(field[7]);
+    session->gpsdata.attitude.dip = safe_atof(field[7]);
     session->gpsdata.attitude.mag_len = NAN;
-    session->gpsdata.attitude.mag_x = atof(field[8]);
+    session->gpsdata.attitude.mag_x = safe_atof(field[8]);
     session->gpsdata.attitude.mag_y = NAN;
     session->gpsdata.attitude.mag_z = NAN;
     session->gpsdata.attitude.acc_len = NAN;
@@ -906,27 +966,27 @@ static gps_mask_t processOHPR(int c UNUSED, char *field[],
     gps_mask_t mask;
     mask = ONLINE_SET;
 
-    session->gpsdata.attitude.heading = atof(field[1]);
+    session->gpsdata.attitude.heading = safe_atof(field[1]);
     session->gpsdata.attitude.mag_st = '\0';
-    session->gpsdata.attitude.pitch = atof(field[2]);
+    session->gpsdata.attitude.pitch = safe_atof(field[2]);
     session->gpsdata.attitude.pitch_st = '\0';
-    session->gpsdata.attitude.roll = atof(field[3]);
+    session->gpsdata.attitude.roll = safe_atof(field[3]);
     session->gpsdata.attitude.roll_st = '\0';
     session->gpsdata.attitude.yaw = NAN;
     session->gpsdata.attitude.yaw_st = '\0';
     session->gpsdata.attitude.dip = NAN;
-    session->gpsdata.attitude.temp = atof(field[4]);
-    session->gpsdata.attitude.depth = atof(field[5]) / METERS_TO_FEET;
-    session->gpsdata.attitude.mag_len = atof(field[6]);
-    session->gpsdata.attitude.mag_x = atof(field[7]);
-    session->gpsdata.attitude.mag_y = atof(field[8]);
-    session->gpsdata.attitude.mag_z = atof(field[9]);
-    session->gpsdata.attitude.acc_len = atof(field[10]);
-    session->gpsdata.attitude.acc_x = atof(field[11]);
-    session->gpsdata.attitude.acc_y = atof(field[12]);
-    session->gpsdata.attitude.acc_z = atof(field[13]);
-    session->gpsdata.attitude.gyro_x = atof(field[15]);
-    session->gpsdata.attitude.gyro_y = atof(field[16]);
+    session->gpsdata.attitude.temp = safe_atof(field[4]);
+    session->gpsdata.attitude.depth = safe_atof(field[5]) / METERS_TO_FEET;
+    session->gpsdata.attitude.mag_len = safe_atof(field[6]);
+    session->gpsdata.attitude.mag_x = safe_atof(field[7]);
+    session->gpsdata.attitude.mag_y = safe_atof(field[8]);
+    session->gpsdata.attitude.mag_z = safe_atof(field[9]);
+    session->gpsdata.attitude.acc_len = safe_atof(field[10]);
+    session->gpsdata.attitude.acc_x = safe_atof(field[11]);
+    session->gpsdata.attitude.acc_y = safe_atof(field[12]);
+    session->gpsdata.attitude.acc_z = safe_atof(field[13]);
+    session->gpsdata.attitude.gyro_x = safe_atof(field[15]);
+    session->gpsdata.attitude.gyro_y = safe_atof(field[16]);
     mask |= (ALTITUDE_SET);
 
     gpsd_report(LOG_RAW, "Heading %lf.\n", session->gpsdata.attitude.heading);
@@ -965,14 +1025,14 @@ static gps_mask_t processPASHR(int c UNUSED, char *field[],
 	    merge_hhmmss(field[4], session);
 	    register_fractional_time(field[0], field[4], session);
 	    do_lat_lon(&field[5], &session->newdata);
-	    session->newdata.altitude = atof(field[9]);
-	    session->newdata.track = atof(field[11]);
-	    session->newdata.speed = atof(field[12]) / MPS_TO_KPH;
-	    session->newdata.climb = atof(field[13]);
-	    session->gpsdata.dop.pdop = atof(field[14]);
-	    session->gpsdata.dop.hdop = atof(field[15]);
-	    session->gpsdata.dop.vdop = atof(field[16]);
-	    session->gpsdata.dop.tdop = atof(field[17]);
+	    session->newdata.altitude = safe_atof(field[9]);
+	    session->newdata.track = safe_atof(field[11]);
+	    session->newdata.speed = safe_atof(field[12]) / MPS_TO_KPH;
+	    session->newdata.climb = safe_atof(field[13]);
+	    session->gpsdata.dop.pdop = safe_atof(field[14]);
+	    session->gpsdata.dop.hdop = safe_atof(field[15]);
+	    session->gpsdata.dop.vdop = safe_atof(field[16]);
+	    session->gpsdata.dop.tdop = safe_atof(field[17]);
 	    mask |= (TIME_SET | LATLON_SET | ALTITUDE_SET);
 	    mask |= (SPEED_SET | TRACK_SET | CLIMB_SET);
 	    mask |= DOP_SET;
@@ -994,7 +1054,7 @@ static gps_mask_t processPASHR(int c UNUSED, char *field[],
 	    session->gpsdata.PRN[i] = p = atoi(field[3 + i * 5 + 0]);
 	    session->gpsdata.azimuth[i] = atoi(field[3 + i * 5 + 1]);
 	    session->gpsdata.elevation[i] = atoi(field[3 + i * 5 + 2]);
-	    session->gpsdata.ss[i] = atof(field[3 + i * 5 + 3]);
+	    session->gpsdata.ss[i] = safe_atof(field[3 + i * 5 + 3]);
 	    if (field[3 + i * 5 + 4][0] == 'U')
 		session->gpsdata.used[u++] = p;
 	}
@@ -1015,6 +1075,45 @@ static gps_mask_t processPASHR(int c UNUSED, char *field[],
  **************************************************************************/
 
 /*@ -mayaliasunique @*/
+static size_t nmea_clear_run(const char *p, const char *limit)
+/* length of the run at p containing no comma, star, or control char */
+{
+    const char *q = p;
+
+#ifdef NMEA_VECTOR
+#if defined(__SSE2__)
+    while (q + 16 <= limit) {
+	__m128i chunk = _mm_loadu_si128((__m128i const *)q);
+	__m128i hits = _mm_or_si128(_mm_or_si128(
+		_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')),
+		_mm_cmpeq_epi8(chunk, _mm_set1_epi8('*'))),
+	    _mm_cmplt_epi8(chunk, _mm_set1_epi8(' ')));
+	unsigned int mask = (unsigned int)_mm_movemask_epi8(hits);
+
+	if (mask != 0)
+	    return (size_t)(q - p) + (size_t)__builtin_ctz(mask);
+	q += 16;
+    }
+#else
+    while (q + 16 <= limit) {
+	int8x16_t chunk = vld1q_s8((const int8_t *)q);
+	uint8x16_t hits = vorrq_u8(vorrq_u8(
+		vceqq_s8(chunk, vdupq_n_s8(',')),
+		vceqq_s8(chunk, vdupq_n_s8('*'))),
+	    vcltq_s8(chunk, vdupq_n_s8(' ')));
+	uint8x8_t fold = vorr_u8(vget_low_u8(hits), vget_high_u8(hits));
+
+	if (vget_lane_u64(vreinterpret_u64_u8(fold), 0) != 0)
+	    break;		/* hit in this block; pin it down below */
+	q += 16;
+    }
+#endif /* defined(__SSE2__) */
+#endif /* NMEA_VECTOR */
+    while (q < limit && *q != ',' && *q != '*' && *q >= ' ')
+	++q;
+    return (size_t)(q - p);
+}
+
 gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
 /* parse an NMEA sentence, unpack it into a session structure */
 {
@@ -1025,6 +1124,7 @@ gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
 	char *name;
 	int nf;			/* minimum number of fields required to parse */
 	nmea_decoder decoder;
+	unsigned int tag;	/* 3-char name packed into a word, or 0 */
     } nmea_phrase[] = {
 	/*@ -nullassign @*/
 	{"PGRMC", 0, NULL},	/* ignore Garmin Sensor Config */
@@ -1067,11 +1167,11 @@ gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
 	    /*@ +nullassign @*/
     };
 
+    static bool tags_packed = false;
     int count;
     gps_mask_t retval = 0;
-    unsigned int i, thistag;
+    unsigned int i, thistag, tailpack;
     char *p, *s, *e;
-    volatile char *t;
 
     /*
      * We've had reports that on the Garmin GPS-10 the device sometimes
@@ -1090,30 +1190,39 @@ gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
     /*@ -usedef @*//* splint 3.1.1 seems to have a bug here */
     /* make an editable copy of the sentence */
     (void)strlcpy((char *)session->driver.nmea.fieldcopy, sentence, NMEA_MAX);
-    /* discard the checksum part */
-    for (p = (char *)session->driver.nmea.fieldcopy;
-	 (*p != '*') && (*p >= ' ');)
-	++p;
-    if (*p == '*')
-	*p++ = ',';		/* otherwise we drop the last field */
-    *p = '\0';
-    e = p;
 
-    /* split sentence copy on commas, filling the field array */
+    /*
+     * Split the copy on commas and locate the checksum introducer in
+     * a single left-to-right scan.  The '*' closes the last field just
+     * as a comma would -- otherwise we'd drop it -- and ends the data,
+     * as does any control character; the checksum digits themselves
+     * were already verified by the packet lexer.
+     */
     count = 0;
-    t = p;			/* end of sentence */
     p = (char *)session->driver.nmea.fieldcopy + 1;	/* beginning of tag, 'G' not '$' */
-    /* while there is a search string and we haven't run off the buffer... */
-    while ((p != NULL) && (p <= t)) {
-	session->driver.nmea.field[count] = p;	/* we have a field. record it */
-	/*@ -compdef @*/
-	if ((p = strchr(p, ',')) != NULL) {	/* search for the next delimiter */
-	    *p = '\0';		/* replace it with a NUL */
-	    count++;		/* bump the counters and continue */
-	    p++;
+    session->driver.nmea.field[count] = p;	/* we have a field. record it */
+    /*@ -compdef @*/
+    for (;;) {
+	/* the copy is NUL-terminated, so the run always ends in bounds */
+	p += nmea_clear_run(p, (const char *)session->driver.nmea.fieldcopy +
+			    sizeof(session->driver.nmea.fieldcopy));
+	if (*p == ',') {
+	    *p++ = '\0';	/* close this field, open the next */
+	    count++;
+	    session->driver.nmea.field[count] = p;
+	} else if (*p == '*') {
+	    *p++ = '\0';	/* close the last field */
+	    count++;
+	    *p = '\0';
+	    session->driver.nmea.field[count] = p;	/* empty */
+	    break;
+	} else {		/* control character or the trailing NUL */
+	    *p = '\0';
+	    break;
 	}
-	/*@ +compdef @*/
     }
+    /*@ +compdef @*/
+    e = p;
 
     /* point remaining fields at empty string, just in case */
     for (i = (unsigned int)count;
@@ -1125,13 +1234,39 @@ gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
     /* sentences handlers will tell us whren they have fractional time */
     session->driver.nmea.latch_frac_time = false;
 
-    /* dispatch on field zero, the sentence tag */
+    /*
+     * Dispatch on field zero, the sentence tag.  Basic sentences are
+     * matched sans talker ID, and far outnumber the proprietary ones,
+     * so their three-character names are packed into a word once and
+     * dispatched on an integer compare per table entry; only entries
+     * of other lengths pay for a strcmp().  The packing is exact: a
+     * three-character name can only match a five-character tag.
+     */
+    if (!tags_packed) {
+	for (i = 0;
+	     i < (unsigned)(sizeof(nmea_phrase) / sizeof(nmea_phrase[0]));
+	     ++i)
+	    if (strlen(nmea_phrase[i].name) == 3)
+		nmea_phrase[i].tag =
+		    ((unsigned int)nmea_phrase[i].name[0] << 16) |
+		    ((unsigned int)nmea_phrase[i].name[1] << 8) |
+		    (unsigned int)nmea_phrase[i].name[2];
+	tags_packed = true;
+    }
+    s = session->driver.nmea.field[0];
+    tailpack = 0;
+    if (strlen(s) == 5)
+	tailpack = ((unsigned int)s[2] << 16) |
+	    ((unsigned int)s[3] << 8) | (unsigned int)s[4];
     for (thistag = i = 0;
 	 i < (unsigned)(sizeof(nmea_phrase) / sizeof(nmea_phrase[0])); ++i) {
-	s = session->driver.nmea.field[0];
-	if (strlen(nmea_phrase[i].name) == 3)
-	    s += 2;		/* skip talker ID */
-	if (strcmp(nmea_phrase[i].name, s) == 0) {
+	bool matched;
+
+	if (nmea_phrase[i].tag != 0)
+	    matched = (nmea_phrase[i].tag == tailpack);
+	else
+	    matched = (strcmp(nmea_phrase[i].name, s) == 0);
+	if (matched) {
 	    if (nmea_phrase[i].decoder != NULL
 		&& (count >= nmea_phrase[i].nf)) {
 		retval =
@@ -1236,6 +1371,55 @@ gps_mask_t nmea_parse(char *sentence, struct gps_device_t * session)
 /*@ +mayaliasunique @*/
 #endif /* NMEA_ENABLE */
 
+#ifdef NMEA_VECTOR
+static const char *nmea_sum_blocks(const char *p, size_t len,
+				   unsigned char *sum)
+/* XOR whole 16-byte blocks free of '*' into *sum, return the new position */
+{
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    const __m128i star = _mm_set1_epi8('*');
+
+    while (len >= 16) {
+	__m128i chunk = _mm_loadu_si128((__m128i const *)p);
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, star)) != 0)
+	    break;		/* '*' in this block; finish by bytes */
+	acc = _mm_xor_si128(acc, chunk);
+	p += 16;
+	len -= 16;
+    }
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+    *sum ^= (unsigned char)_mm_cvtsi128_si32(acc);
+#else
+    uint8x16_t acc = vdupq_n_u8(0);
+    const uint8x16_t star = vdupq_n_u8((uint8_t)'*');
+    uint8x8_t fold;
+
+    while (len >= 16) {
+	uint8x16_t chunk = vld1q_u8((const uint8_t *)p);
+	uint8x16_t hits = vceqq_u8(chunk, star);
+
+	fold = vorr_u8(vget_low_u8(hits), vget_high_u8(hits));
+	if (vget_lane_u64(vreinterpret_u64_u8(fold), 0) != 0)
+	    break;		/* '*' in this block; finish by bytes */
+	acc = veorq_u8(acc, chunk);
+	p += 16;
+	len -= 16;
+    }
+    fold = veor_u8(vget_low_u8(acc), vget_high_u8(acc));
+    fold = veor_u8(fold, vext_u8(fold, fold, 4));
+    fold = veor_u8(fold, vext_u8(fold, fold, 2));
+    fold = veor_u8(fold, vext_u8(fold, fold, 1));
+    *sum ^= vget_lane_u8(fold, 0);
+#endif /* defined(__SSE2__) */
+    return p;
+}
+#endif /* NMEA_VECTOR */
+
 void nmea_add_checksum(char *sentence)
 /* add NMEA checksum to a possibly  *-terminated sentence */
 {
@@ -1247,6 +1431,10 @@ void nmea_add_checksum(char *sentence)
     } else {
 	gpsd_report(LOG_ERROR, "Bad NMEA sentence: '%s'\n", sentence);
     }
+#ifdef NMEA_VECTOR
+    /* strlen() keeps the block loads inside the caller's buffer */
+    p = (char *)nmea_sum_blocks(p, strlen(p), &sum);
+#endif /* NMEA_VECTOR */
     while (((c = *p) != '*') && (c != '\0')) {
 	sum ^= c;
 	p++;
@@ -420,6 +420,21 @@ void rtcm3_unpack( /*@out@*/ struct rtcm3_t *rtcm, char *buf)
     /*@ +evalorder +sefparams +mayaliasunique @*/
 }
 
+void rtcm3_unpack_header( /*@out@*/ struct rtcm3_t *rtcm, char *buf)
+/* cheap pass for the forwarding path: type and length only */
+{
+    /*
+     * Enough for clients that take the frame verbatim; the full
+     * field extraction in rtcm3_unpack() is deferred until some
+     * consumer actually wants the scaled report structure.
+     */
+    rtcm->length = (uint)ubits(buf, 14, 10);
+    rtcm->type = (uint)ubits(buf, 24, 12);
+
+    gpsd_report(LOG_RAW, "RTCM3: type %d payload length %d\n",
+		rtcm->type, rtcm->length);
+}
+
 /* *INDENT-ON* */
 /*@ +type @*/
 
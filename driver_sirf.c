@@ -120,7 +120,8 @@ static unsigned char enablemid52[] = {
 #endif /* RECONFIGURE_ENABLE */
 
 
-static gps_mask_t sirf_msg_debug(unsigned char *, size_t);
+static gps_mask_t sirf_msg_debug(struct gps_device_t *,
+				 unsigned char *, size_t);
 static gps_mask_t sirf_msg_errors(unsigned char *, size_t);
 
 static gps_mask_t sirf_msg_navdata(struct gps_device_t *, unsigned char *,
@@ -311,29 +312,32 @@ static ssize_t sirf_get(struct gps_device_t *session)
     return len;
 }
 
-static gps_mask_t sirf_msg_debug(unsigned char *buf, size_t len)
+static gps_mask_t sirf_msg_debug(struct gps_device_t *session,
+				 unsigned char *buf, size_t len)
 {
     char msgbuf[MAX_PACKET_LENGTH * 3 + 2];
+    char *cp = msgbuf;
     int i;
 
+    /* don't format a string nobody will see */
+    if (session->context->debug < LOG_PROG)
+	return 0;
+
     bzero(msgbuf, (int)sizeof(msgbuf));
 
     /*@ +charint @*/
     if (0xe1 == buf[0]) {	/* Development statistics messages */
-	for (i = 2; i < (int)len; i++)
-	    (void)snprintf(msgbuf + strlen(msgbuf),
-			   sizeof(msgbuf) - strlen(msgbuf),
-			   "%c", buf[i] ^ 0xff);
+	for (i = 2; i < (int)len && cp < msgbuf + sizeof(msgbuf) - 1; i++)
+	    *cp++ = (char)(buf[i] ^ 0xff);
 	gpsd_report(LOG_PROG, "SiRF: DEV 0xe1: %s\n", msgbuf);
     } else if (0xff == (unsigned char)buf[0]) {	/* Debug messages */
-	for (i = 1; i < (int)len; i++)
+	for (i = 1; i < (int)len && cp < msgbuf + sizeof(msgbuf) - 5; i++)
 	    if (isprint(buf[i]))
-		(void)snprintf(msgbuf + strlen(msgbuf),
-			       sizeof(msgbuf) - strlen(msgbuf), "%c", buf[i]);
-	    else
-		(void)snprintf(msgbuf + strlen(msgbuf),
-			       sizeof(msgbuf) - strlen(msgbuf),
-			       "\\x%02x", (unsigned int)buf[i]);
+		*cp++ = (char)buf[i];
+	    else {
+		(void)snprintf(cp, 5, "\\x%02x", (unsigned int)buf[i]);
+		cp += 4;
+	    }
 	gpsd_report(LOG_PROG, "SiRF: DBG 0xff: %s\n", msgbuf);
     }
     /*@ -charint @*/
@@ -1134,11 +1138,11 @@ gps_mask_t sirf_parse(struct gps_device_t * session, unsigned char *buf,
     case 0xe1:			/* Development statistics messages MID 225 */
 	/* FALLTHROUGH */
     case 0xff:			/* Debug messages MID 255 */
-	(void)sirf_msg_debug(buf, len);
+	(void)sirf_msg_debug(session, buf, len);
 	return 0;
 
     default:
-	gpsd_report(LOG_WARN, "SiRF: Unknown packet id %d length %zd\n", 
+	gpsd_report(LOG_WARN, "SiRF: Unknown packet id %d length %zd\n",
 		    buf[0], len);
 	return 0;
     }
@@ -1333,7 +1337,7 @@ const struct gps_type_t sirf_binary =
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = sirf_get,		/* be prepared for SiRF or NMEA */
     .parse_packet   = sirfbin_parse_input,/* parse message packets */
-    .rtcm_writer    = gpsd_write,	/* send RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* send RTCM data straight */
     .event_hook     = sirfbin_event_hook,/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = sirfbin_speed,	/* we can change baud rate */
@@ -267,6 +267,7 @@ superstar2_msg_timing(struct gps_device_t *session, unsigned char *buf,
 	tm.tm_sec = (int)d;
 	session->newdata.time = (timestamp_t)timegm(&tm);
 	session->context->leap_seconds = (int)getsb(buf, 20);
+	session->context->valid |= LEAP_SECOND_VALID;
 	mask = TIME_SET | PPSTIME_IS;
     }
     gpsd_report(LOG_DATA, "TIMING: time=%.2f mask={TIME}\n",
@@ -558,7 +559,7 @@ const struct gps_type_t superstar2_binary = {
     /* Parse message packets */
     .parse_packet	= superstar2_parse_input,
     /* RTCM handler (using default routine) */
-    .rtcm_writer	= gpsd_write,
+    .rtcm_writer	= gpsd_write_rtcm,
     /* Fire on various lifetime events */
     .event_hook		= superstar2_event_hook,
 #ifdef RECONFIGURE_ENABLE
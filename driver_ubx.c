@@ -174,8 +174,10 @@ ubx_msg_nav_timegps(struct gps_device_t *session, unsigned char *buf,
     tow = (unsigned int)getleu32(buf, 0);
     gw = (unsigned int)getles16(buf, 8);
     flags = (unsigned int)getub(buf, 11);
-    if ((flags & 0x7) != 0)
+    if ((flags & 0x7) != 0) {
 	session->context->leap_seconds = (int)getub(buf, 10);
+	session->context->valid |= LEAP_SECOND_VALID;
+    }
     session->newdata.time = gpsd_gpstime_resolve(session, 
 					      (unsigned short int)gw, 
 					      (double)tow / 1000.0);
@@ -209,21 +211,26 @@ ubx_msg_nav_svinfo(struct gps_device_t *session, unsigned char *buf,
     /*@ -charint @*/
     gpsd_zero_satellites(&session->gpsdata);
     nsv = 0;
+    /* walk the 12-byte channel blocks with a moving base pointer */
     for (i = j = st = 0; i < nchan; i++) {
-	unsigned int off = 8 + 12 * i;
-	if ((int)getub(buf, off + 4) == 0)
+	unsigned char *chan = buf + 8 + 12 * i;
+	unsigned int ss = (unsigned int)getub(chan, 4);
+	int prn;
+
+	if (ss == 0)
 	    continue;		/* LEA-5H seems to have a bug reporting sats it does not see or hear */
-	session->gpsdata.PRN[j] = (int)getub(buf, off + 1);
-	session->gpsdata.ss[j] = (float)getub(buf, off + 4);
-	session->gpsdata.elevation[j] = (int)getsb(buf, off + 5);
-	session->gpsdata.azimuth[j] = (int)getles16(buf, off + 6);
-	if (session->gpsdata.PRN[j])
+	prn = (int)getub(chan, 1);
+	session->gpsdata.PRN[j] = prn;
+	session->gpsdata.ss[j] = (float)ss;
+	session->gpsdata.elevation[j] = (int)getsb(chan, 5);
+	session->gpsdata.azimuth[j] = (int)getles16(chan, 6);
+	if (prn)
 	    st++;
 	/*@ -predboolothers */
-	if (getub(buf, off + 2) & 0x01)
-	    session->gpsdata.used[nsv++] = session->gpsdata.PRN[j];
-	if (session->gpsdata.PRN[j] == (int)session->driver.ubx.sbas_in_use)
-	    session->gpsdata.used[nsv++] = session->gpsdata.PRN[j];
+	if (getub(chan, 2) & 0x01)
+	    session->gpsdata.used[nsv++] = prn;
+	if (prn == (int)session->driver.ubx.sbas_in_use)
+	    session->gpsdata.used[nsv++] = prn;
 	/*@ +predboolothers */
 	j++;
     }
@@ -756,7 +763,7 @@ const struct gps_type_t ubx_binary = {
     .probe_detect     = NULL,           /* Startup-time device detector */
     .get_packet       = generic_get,    /* Packet getter (using default routine) */
     .parse_packet     = parse_input,    /* Parse message packets */
-    .rtcm_writer      = gpsd_write,      /* RTCM handler (using default routine) */
+    .rtcm_writer      = gpsd_write_rtcm,      /* RTCM handler (using default routine) */
     .event_hook       = ubx_event_hook,	/* Fiew in variious lifetime events */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher   = ubx_speed,      /* Speed (baudrate) switch */
@@ -379,12 +379,15 @@ static gps_mask_t zodiac_analyze(struct gps_device_t *session)
 	return 0;
     }
 
-    buf[0] = '\0';
-    for (i = 0; i < (int)session->packet.outbuflen; i++)
-	(void)snprintf(buf + strlen(buf), sizeof(buf) - strlen(buf),
-		       "%02x", (unsigned int)session->packet.outbuffer[i]);
-    gpsd_report(LOG_RAW, "Raw Zodiac packet type %d length %zd: %s\n",
-		id, session->packet.outbuflen, buf);
+    if (session->context->debug >= LOG_RAW) {
+	buf[0] = '\0';
+	for (i = 0; i < (int)session->packet.outbuflen
+	     && i * 2 < (int)sizeof(buf) - 2; i++)
+	    (void)snprintf(buf + i * 2, 3, "%02x",
+			   (unsigned int)session->packet.outbuffer[i]);
+	gpsd_report(LOG_RAW, "Raw Zodiac packet type %d length %zd: %s\n",
+		    id, session->packet.outbuflen, buf);
+    }
 
     if (session->packet.outbuflen < 10)
 	return 0;
@@ -266,7 +266,7 @@ const struct gps_type_t nmea = {
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = generic_get,	/* use generic packet getter */
     .parse_packet   = generic_parse_input,	/* how to interpret a packet */
-    .rtcm_writer    = gpsd_write,	/* write RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* write RTCM data straight */
     .event_hook     = nmea_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
@@ -434,7 +434,7 @@ const struct gps_type_t ashtech = {
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = generic_get,	/* how to get a packet */
     .parse_packet   = generic_parse_input,	/* how to interpret a packet */
-    .rtcm_writer    = gpsd_write,	/* write RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* write RTCM data straight */
     .event_hook     = ashtech_event_hook, /* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
@@ -485,7 +485,7 @@ const struct gps_type_t fv18 = {
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = generic_get,	/* how to get a packet */
     .parse_packet   = generic_parse_input,	/* how to interpret a packet */
-    .rtcm_writer    = gpsd_write,	/* write RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* write RTCM data straight */
     .event_hook     = fv18_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
@@ -538,7 +538,7 @@ const struct gps_type_t gpsclock = {
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = generic_get,	/* how to get a packet */
     .parse_packet   = generic_parse_input,	/* how to interpret a packet */
-    .rtcm_writer    = gpsd_write,	/* write RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* write RTCM data straight */
     .event_hook     = gpsclock_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
@@ -593,7 +593,7 @@ static const struct gps_type_t tripmate = {
     .probe_detect  = NULL,			/* no probe */
     .get_packet    = generic_get,		/* how to get a packet */
     .parse_packet  = generic_parse_input,		/* how to interpret a packet */
-    .rtcm_writer   = gpsd_write,			/* send RTCM data straight */
+    .rtcm_writer   = gpsd_write_rtcm,			/* send RTCM data straight */
     .event_hook    = tripmate_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher= NULL,			/* no speed switcher */
@@ -924,10 +924,22 @@ static const struct gps_type_t rtcm104v2 = {
 
 static gps_mask_t rtcm104v3_analyze(struct gps_device_t *session)
 {
-    uint16_t type = getbeu16(session->packet.inbuffer, 3) >> 4;
+    /*
+     * Read from the output buffer; now that accepting a packet no
+     * longer leaves a copy behind at the front of the input buffer,
+     * that is the only place the frame is guaranteed to be.
+     */
+    uint16_t type = getbeu16(session->packet.outbuffer, 3) >> 4;
 
     gpsd_report(LOG_RAW, "RTCM 3.x packet %d\n", type);
-    rtcm3_unpack(&session->gpsdata.rtcm3, (char *)session->packet.outbuffer);
+    /*
+     * Just the type and length here; most of the time the daemon only
+     * forwards the frame verbatim, so the full field extraction is
+     * left to whoever needs the decoded structure.
+     */
+    rtcm3_unpack_header(&session->gpsdata.rtcm3,
+			(char *)session->packet.outbuffer);
+    session->rtcm3_payload_decoded = false;
     session->cycle_end_reliable = true;
     return RTCM3_SET;
 }
@@ -1104,7 +1116,7 @@ const struct gps_type_t mtk3301 = {
     .probe_detect   = NULL,		/* no probe */
     .get_packet     = generic_get,	/* how to get a packet */
     .parse_packet   = processMTK3301,	/* how to interpret a packet */
-    .rtcm_writer    = gpsd_write,	/* write RTCM data straight */
+    .rtcm_writer    = gpsd_write_rtcm,	/* write RTCM data straight */
     .event_hook     = mtk3301_event_hook,	/* lifetime event handler */
 #ifdef RECONFIGURE_ENABLE
     .speed_switcher = NULL,		/* no speed switcher */
@@ -1196,7 +1208,7 @@ static void path_rewrite(struct gps_device_t *session, char *prefix)
 	 prefloc < (char *)session->packet.outbuffer+session->packet.outbuflen;
 	 prefloc++)
 	if (strncmp(prefloc, prefix, strlen(prefix)) == 0) {
-	    char copy[sizeof(session->packet.outbuffer)];
+	    char copy[sizeof(session->packet.outstash)];
 	    (void)strlcpy(copy, 
 			  (char *)session->packet.outbuffer, 
 			  sizeof(copy));
@@ -1205,10 +1217,10 @@ static void path_rewrite(struct gps_device_t *session, char *prefix)
 			  session->gpsdata.dev.path,
 			  sizeof(session->gpsdata.dev.path));
 	    (void)strlcat((char *)session->packet.outbuffer, "#", 
-			  sizeof(session->packet.outbuffer));
+			  sizeof(session->packet.outstash));
 	    (void)strlcat((char *)session->packet.outbuffer, 
 			  copy + (prefloc-(char *)session->packet.outbuffer), 
-			  sizeof(session->packet.outbuffer));
+			  sizeof(session->packet.outstash));
 	}
     session->packet.outbuflen = strlen((char *)session->packet.outbuffer);
 }
@@ -1229,12 +1241,12 @@ static gps_mask_t json_pass_packet(struct gps_device_t *session UNUSED)
 	|| strstr((char *)session->packet.outbuffer, "DEVICES") != NULL) {
 	session->packet.outbuffer[session->packet.outbuflen] = '\0';	
 	(void)strlcat((char *)session->packet.outbuffer, ",\"remote\":\"", 
-		      sizeof(session->packet.outbuffer));
+		      sizeof(session->packet.outstash));
 	(void)strlcat((char *)session->packet.outbuffer,
 		      session->gpsdata.dev.path,
-		      sizeof(session->packet.outbuffer));
+		      sizeof(session->packet.outstash));
 	(void)strlcat((char *)session->packet.outbuffer, "\"}", 
-		      sizeof(session->packet.outbuffer));
+		      sizeof(session->packet.outstash));
     }
 
     gpsd_report (LOG_PROG, 
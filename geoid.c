@@ -13,26 +13,6 @@
 
 static double fix_minuz(double d);
 
-static double bilinear(double x1, double y1, double x2, double y2, double x,
-		       double y, double z11, double z12, double z21,
-		       double z22)
-{
-    double delta;
-
-    if (y1 == y2 && x1 == x2)
-	return (z11);
-    if (y1 == y2 && x1 != x2)
-	return (z22 * (x - x1) + z11 * (x2 - x)) / (x2 - x1);
-    if (x1 == x2 && y1 != y2)
-	return (z22 * (y - y1) + z11 * (y2 - y)) / (y2 - y1);
-
-    delta = (y2 - y1) * (x2 - x1);
-
-    return (z22 * (y - y1) * (x - x1) + z12 * (y2 - y) * (x - x1) +
-	    z21 * (y - y1) * (x2 - x) + z11 * (y2 - y) * (x2 - x)) / delta;
-}
-
-
 /* return geoid separtion (MSL - WGS84) in meters, given a lat/lot in degrees */
 double wgs84_separation(double lat, double lon)
 {
@@ -40,7 +20,9 @@ double wgs84_separation(double lat, double lon)
 #define GEOID_COL	37
     /* *INDENT-OFF* */
     /*@ +charint @*/
-    const char geoid_delta[GEOID_COL*GEOID_ROW]={
+    /* static so the grid lives in .rodata instead of being copied
+     * onto the stack at every call */
+    static const char geoid_delta[GEOID_COL*GEOID_ROW]={
 	/* 90S */ -30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30, -30,-30,-30,-30,-30,-30,-30,-30,-30,-30,-30,
 	/* 80S */ -53,-54,-55,-52,-48,-42,-38,-38,-29,-26,-26,-24,-23,-21,-19,-16,-12, -8, -4, -1,  1,  4,  4,  6,  5,  4,   2, -6,-15,-24,-33,-40,-48,-50,-53,-52,-53,
 	/* 70S */ -61,-60,-61,-55,-49,-44,-38,-31,-25,-16, -6,  1,  4,  5,  4,  2,  6, 12, 16, 16, 17, 21, 20, 26, 26, 22,  16, 10, -1,-16,-29,-36,-46,-55,-54,-59,-61,
@@ -63,11 +45,24 @@ double wgs84_separation(double lat, double lon)
     }; 
     /*@ -charint @*/
     /* *INDENT-ON* */
+    /*
+     * Cache of the last grid cell we interpolated in, reduced to the
+     * coefficients of z = c00 + c10*u + c01*v + c11*u*v with u and v
+     * the fractional position inside the cell.  The grid spacing is
+     * folded in as the 0.1 reciprocal below, so the steady-state path
+     * for a receiver sitting inside one cell - which is where any
+     * receiver sits for hours at a time - is two floor()s, a compare
+     * and three multiply-adds, with no division at all.
+     */
+    static int clat = -9999, clon = -9999;
+    static double c00, c10, c01, c11;
+    double ulon, vlat;
     int ilat, ilon;
-    int ilat1, ilat2, ilon1, ilon2;
 
-    ilat = (int)floor((90. + lat) / 10);
-    ilon = (int)floor((180. + lon) / 10);
+    ulon = (180. + lon) * 0.1;
+    vlat = (90. + lat) * 0.1;
+    ilat = (int)floor(vlat);
+    ilon = (int)floor(ulon);
 
     /* sanity checks to prevent segfault on bad data */
     if ((ilat > 90) || (ilat < -90)) {
@@ -77,19 +72,25 @@ double wgs84_separation(double lat, double lon)
 	return 0.0;
     }
 
-    ilat1 = ilat;
-    ilon1 = ilon;
-    ilat2 = (ilat < GEOID_ROW - 1) ? ilat + 1 : ilat;
-    ilon2 = (ilon < GEOID_COL - 1) ? ilon + 1 : ilon;
+    if (ilat != clat || ilon != clon) {
+	int ilat2 = (ilat < GEOID_ROW - 1) ? ilat + 1 : ilat;
+	int ilon2 = (ilon < GEOID_COL - 1) ? ilon + 1 : ilon;
+	double z11 = (double)geoid_delta[ilon + ilat * GEOID_COL];
+	double z12 = (double)geoid_delta[ilon2 + ilat * GEOID_COL];
+	double z21 = (double)geoid_delta[ilon + ilat2 * GEOID_COL];
+	double z22 = (double)geoid_delta[ilon2 + ilat2 * GEOID_COL];
+
+	c00 = z11;
+	c10 = z12 - z11;
+	c01 = z21 - z11;
+	c11 = z22 - z21 - z12 + z11;
+	clat = ilat;
+	clon = ilon;
+    }
 
-    return bilinear(ilon1 * 10. - 180., ilat1 * 10. - 90.,
-		    ilon2 * 10. - 180., ilat2 * 10. - 90.,
-		    lon, lat,
-		    (double)geoid_delta[ilon1 + ilat1 * GEOID_COL],
-		    (double)geoid_delta[ilon2 + ilat1 * GEOID_COL],
-		    (double)geoid_delta[ilon1 + ilat2 * GEOID_COL],
-		    (double)geoid_delta[ilon2 + ilat2 * GEOID_COL]
-	);
+    ulon -= ilon;
+    vlat -= ilat;
+    return c00 + c10 * ulon + c01 * vlat + c11 * ulon * vlat;
 }
 
 
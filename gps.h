@@ -38,7 +38,7 @@ extern "C" {
  *       gps_poll() removed in favor of gps_read().  The raw hook is gone.
  */
 #define GPSD_API_MAJOR_VERSION	5	/* bump on incompatible changes */
-#define GPSD_API_MINOR_VERSION	0	/* bump on compatible changes */
+#define GPSD_API_MINOR_VERSION	1	/* bump on compatible changes */
 
 #define MAXTAGLEN	8	/* maximum length of sentence tag name */
 #define MAXCHANNELS	72	/* must be > 12 GPS + 12 GLONASS + 2 WAAS */
@@ -1563,8 +1563,11 @@ struct policy_t {
     bool json;				/* requesting JSON? */
     bool nmea;				/* requesting dumping as NMEA? */
     int raw;				/* requesting raw data? */
-    bool scaled;			/* requesting report scaling? */ 
+    bool scaled;			/* requesting report scaling? */
     bool timing;			/* requesting timing info */
+    bool binary;			/* requesting packed binary reports? */
+    gps_mask_t classmask;		/* report classes wanted (0 = all) */
+    double interval;			/* min seconds between reports (0 = all) */
     int loglevel;			/* requested log level of messages */
     char devpath[GPS_PATH_MAX];		/* specific device to watch */
     char remote[GPS_PATH_MAX];		/* ...if this was passthrough */
@@ -1585,9 +1588,11 @@ typedef int socket_t;
 #define WATCH_NMEA	0x000020u	/* output in NMEA */
 #define WATCH_RARE	0x000040u	/* output of packets in hex */
 #define WATCH_RAW	0x000080u	/* output of raw packets */
-#define WATCH_SCALED	0x000100u	/* scale output to floats */ 
+#define WATCH_SCALED	0x000100u	/* scale output to floats */
 #define WATCH_TIMING	0x000200u	/* timing information */
+#define WATCH_BINARY	0x000400u	/* packed binary reports */
 #define WATCH_DEVICE	0x000800u	/* watch specific device */
+#define WATCH_DEDUPE	0x001000u	/* drop epochs repeated across transports */
 #define WATCH_NEWSTYLE	0x010000u	/* force JSON streaming */
 #define WATCH_OLDSTYLE	0x020000u	/* force old-style streaming */
 
@@ -1677,6 +1682,36 @@ struct gps_data_t {
     /* should be moved to privdata sometday */
     char tag[MAXTAGLEN+1];	/* tag of last sentence processed */
 
+    /*
+     * Opt-in borrowed-view mode: set string_views before streaming
+     * and the view pointers below will reference the device and tag
+     * strings inside the response buffer instead of the copies being
+     * refreshed on every report.  The views are valid for the
+     * duration of a gps_dispatch() callback, or until the next read
+     * call; test the class flags in the set member to detect change.
+     */
+    bool string_views;		/* borrow strings instead of copying */
+    /*@null@*/const char *device_view;	/* view of the device path */
+    /*@null@*/const char *tag_view;	/* view of the sentence tag */
+
+    /*
+     * Client-side epoch deduplication (WATCH_DEDUPE): aggregated
+     * deployments can see the same device epoch over both the shared
+     * memory and socket transports; with this enabled, gps_read()
+     * and gps_dispatch() drop a report whose device and timestamp
+     * match the previously accepted one.
+     */
+    bool dedupe;		/* drop repeated device+time epochs */
+    timestamp_t dedup_time;	/* time of last accepted epoch */
+    char dedup_device[GPS_PATH_MAX];	/* device of last accepted epoch */
+
+    /*
+     * Set when gps_open() picked the shared-memory export on its own
+     * because the daemon is co-located; the first command reopens the
+     * socket transport transparently, since SHM is read-only.
+     */
+    bool shm_implicit;
+
     /* pack things never reported together to reduce structure size */ 
 #define UNION_SET	(RTCM2_SET|RTCM3_SET|SUBFRAME_SET|AIS_SET|ATTITUDE_SET|VERSION_SET|DEVICELIST_SET|LOGMESSAGE_SET|ERROR_SET|GST_SET|VERSION_SET)
     union {
@@ -1702,24 +1737,59 @@ struct gps_data_t {
     void *privdata;
 };
 
+/*
+ * Framing for the binary report stream negotiated with
+ * ?WATCH={"binary":true}.  A frame is this header followed by a leading
+ * slice of struct gps_data_t, in host byte order; the trailing union is
+ * shipped only when a UNION_SET bit is on.  Like the shared-memory
+ * export, this assumes daemon and client run on the same host --
+ * remote clients should stick to JSON.  Bump the version whenever the
+ * layout of the shipped slice changes.
+ */
+#define GPS_BINARY_MAGIC	"\001GPB"  /* SOH never begins JSON or NMEA */
+#define GPS_BINARY_VERSION	1
+struct gps_binary_header_t {
+    char magic[4];		/* GPS_BINARY_MAGIC */
+    unsigned char version;	/* GPS_BINARY_VERSION */
+    unsigned char pad[3];	/* must be zero */
+    unsigned int length;	/* payload bytes following this header */
+};
+#define GPS_BINARY_BASE_LENGTH(gdp) \
+	(size_t)((const char *)&(gdp)->rtcm2 - (const char *)(gdp))
+#define GPS_BINARY_FULL_LENGTH(gdp) \
+	(size_t)((const char *)&(gdp)->privdata - (const char *)(gdp))
+
 extern int gps_open(/*@null@*/const char *, /*@null@*/const char *, 
 		      /*@out@*/struct gps_data_t *);
 extern int gps_close(struct gps_data_t *);
 extern int gps_send(struct gps_data_t *, const char *, ... );
 extern int gps_read(/*@out@*/struct gps_data_t *);
+extern int gps_dispatch(struct gps_data_t *,
+			void (*)(struct gps_data_t *, void *),
+			/*@null@*/void *);
 extern int gps_unpack(char *, struct gps_data_t *);
 extern bool gps_waiting(const struct gps_data_t *, int);
 extern int gps_stream(struct gps_data_t *, unsigned int, /*@null@*/void *);
+extern int gps_flush(struct gps_data_t *, int);
 extern const char /*@observer@*/ *gps_data(const struct gps_data_t *);
 extern const char /*@observer@*/ *gps_errstr(const int);
 
 extern int gps_sock_open(/*@null@*/const char *, /*@null@*/const char *, 
 		      /*@out@*/struct gps_data_t *);
 extern int gps_sock_read(/*@out@*/struct gps_data_t *);
+extern int gps_sock_dispatch(struct gps_data_t *,
+			     void (*)(struct gps_data_t *, void *),
+			     /*@null@*/void *);
+extern int gps_sock_flush(struct gps_data_t *, int);
 extern int gps_sock_close(struct gps_data_t *);
 extern int gps_shm_open(/*@out@*/struct gps_data_t *);
 extern int gps_shm_read(struct gps_data_t *);
+extern int gps_shm_read_next(struct gps_data_t *,
+			     /*@null@*/unsigned int *);
 extern void gps_shm_close(struct gps_data_t *);
+extern int gps_dbus_open(/*@out@*/struct gps_data_t *);
+extern int gps_dbus_read(struct gps_data_t *);
+extern void gps_dbus_close(struct gps_data_t *);
 
 extern void libgps_trace(int errlevel, const char *, ...);
 
@@ -1735,13 +1805,16 @@ extern /*@observer@*/const char *gps_maskdump(gps_mask_t);
 
 extern time_t mkgmtime(register struct tm *);
 extern timestamp_t timestamp(void);
+extern timestamp_t monotime(void);
 extern timestamp_t iso8601_to_unix(char *);
 extern /*@observer@*/char *unix_to_iso8601(timestamp_t t, /*@ out @*/char[], size_t len);
 extern double earth_distance(double, double, double, double);
+extern double earth_distance_fast(double, double, double, double);
 extern double earth_distance_and_bearings(double, double, double, double, 
 					  /*@null@*//*@out@*/double *, 
 					  /*@null@*//*@out@*/double *);
 extern double wgs84_separation(double, double);
+extern double safe_atof(const char *);
 
 /* some multipliers for interpreting GPS output */
 #define METERS_TO_FEET	3.2808399	/* Meters to U.S./British feet */
@@ -1773,12 +1846,14 @@ extern double wgs84_separation(double, double);
 #define NL_NOCONNECT	-6	/* can't connect to host/socket pair */
 #define SHM_NOSHARED	-7	/* shared-memory segment not available */
 #define SHM_NOATTACH	-8	/* shared-memory attach failed */
+#define DBUS_NOBUS	-9	/* can't subscribe on the system D-Bus */
 
 #define DEFAULT_GPSD_PORT	"2947"	/* IANA assignment */
 #define DEFAULT_RTCM_PORT	"2101"	/* IANA assignment */
 
-/* special host values for non-socket exports */ 
+/* special host values for non-socket exports */
 #define GPSD_SHARED_MEMORY	"shared memory"
+#define GPSD_DBUS_EXPORT	"dbus export"
 
 /*
  * Platform-specific declarations
@@ -64,7 +64,7 @@ To allow for adding and removing clients while the test is running,
 run in threaded mode by calling the start() method.  This simply calls
 the run method in a subthread, with locking of critical regions.
 """
-import sys, os, time, signal, pty, termios # fcntl, array, struct
+import sys, os, time, signal, pty, termios, fcntl, errno # array, struct
 import exceptions, threading, socket
 import gps
 import packet as sniffer
@@ -171,10 +171,52 @@ class FakeGPS:
         self.go_predicate = lambda: True
         self.readers = 0
         self.index = 0
+        self.firehose = False
+        self.bitrate = 0
+        self.virtual_time = 0.0
+        self.pending = None
         self.progress("gpsfake: %s provides %d sentences\n" % (self.testload.name, len(self.testload.sentences)))
 
+    def start_firehose(self):
+        "Replay as fast as the daemon consumes, on a virtual clock."
+        self.firehose = True
+
+    def feed_firehose(self):
+        "Pour sentences until the transport back-pressures."
+        # No sleeps anywhere on this path.  Declared delays and serial
+        # transmission times are billed to the virtual clock instead,
+        # so a capture's timeline stays deterministic while wall-clock
+        # replay runs at whatever rate the daemon can swallow.
+        while True:
+            if self.pending is not None:
+                line = self.pending
+                self.pending = None
+            else:
+                if not self.go_predicate(self.index, self):
+                    break
+                line = self.testload.sentences[self.index % len(self.testload.sentences)]
+                self.index += 1
+                if "%Delay:" in line:
+                    self.virtual_time += int(line.split()[1])
+                if self.bitrate:
+                    # 8N1 framing: ten baud times per byte
+                    self.virtual_time += len(line) * 10.0 / self.bitrate
+            try:
+                written = self.write(line)
+            except OSError, e:
+                if e.errno in (errno.EAGAIN, errno.EWOULDBLOCK):
+                    self.pending = line
+                    break
+                raise
+            if written is not None and written < len(line):
+                self.pending = line[written:]
+                break
+
     def feed(self):
         "Feed a line from the contents of the GPS log to the daemon."
+        if self.firehose:
+            self.feed_firehose()
+            return
         line = self.testload.sentences[self.index % len(self.testload.sentences)]
         if "%Delay:" in line:
             # Delay specified number of seconds
@@ -243,6 +285,14 @@ class FakePTY(FakeGPS):
         ispeed = ospeed = speed
         termios.tcsetattr(self.slave_fd, termios.TCSANOW,
                           [iflag, oflag, cflag, lflag, ispeed, ospeed, cc])
+
+    def start_firehose(self):
+        "Let the pty buffer, not the wall clock, pace the replay."
+        FakeGPS.start_firehose(self)
+        self.bitrate = self.speed
+        flags = fcntl.fcntl(self.fd, fcntl.F_GETFL)
+        fcntl.fcntl(self.fd, fcntl.F_SETFL, flags | os.O_NONBLOCK)
+
     def read(self):
         "Discard control strings written by gpsd."
         # A tcflush implementation works on Linux but fails on OpenBSD 4.
@@ -257,7 +307,7 @@ class FakePTY(FakeGPS):
         #    pass
 
     def write(self, line):
-        os.write(self.fd, line)
+        return os.write(self.fd, line)
 
     def drain(self):
         "Wait for the associated device to drain (e.g. before closing)."
@@ -279,7 +329,7 @@ class FakeUDP(FakeGPS):
         pass
 
     def write(self, line):
-        self.sock.sendto(line, (self.ipaddr, int(self.port)))
+        return self.sock.sendto(line, (self.ipaddr, int(self.port)))
 
     def drain(self):
         "Wait for the associated device to drain (e.g. before closing)."
@@ -403,7 +453,7 @@ class TestSessionError(exceptions.Exception):
 
 class TestSession:
     "Manage a session including a daemon with fake GPSes and clients."
-    def __init__(self, prefix=None, port=None, options=None, verbose=0, predump=False, udp=False):
+    def __init__(self, prefix=None, port=None, options=None, verbose=0, predump=False, udp=False, firehose=False):
         "Initialize the test session by launching the daemon."
         self.prefix = prefix
         self.port = port
@@ -411,6 +461,7 @@ class TestSession:
         self.verbose = verbose
         self.predump = predump
         self.udp = udp
+        self.firehose = firehose
         self.daemon = DaemonInstance()
         self.fakegpslist = {}
         self.client_id = 0
@@ -450,6 +501,8 @@ class TestSession:
                 newgps.go_predicate = pred
             elif self.default_predicate:
                 newgps.go_predicate = self.default_predicate
+            if self.firehose:
+                newgps.start_firehose()
             self.fakegpslist[newgps.byname] = newgps
             self.append(newgps)
             newgps.exhausted = 0
@@ -296,6 +296,11 @@ class gps(gpsdata, gpsjson):
         elif self.data.get("class") == "TIMING":
             self.data["c_recv"] = self.received
             self.data["c_decode"] = time.time()
+            # older daemons don't break out the render/write phases
+            if "rend" not in self.data:
+                self.data["rend"] = self.data["emit"]
+            if "write" not in self.data:
+                self.data["write"] = self.data["emit"]
             self.timings = self.data
 
     def read(self):
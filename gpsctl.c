@@ -14,6 +14,7 @@
 #include <signal.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <termios.h>
 #ifndef S_SPLINT_S
 #include <unistd.h>
@@ -227,20 +228,22 @@ static char /*@observer@*/ *gpsd_id( /*@in@ */ struct gps_device_t *session)
 int main(int argc, char **argv)
 {
     int option, status, devcount;
-    char *device = NULL, *devtype = NULL; 
+    char *device = NULL, *devtype = NULL;
     char *speed = NULL, *control = NULL, *rate = NULL;
-    bool to_binary = false, to_nmea = false, reset = false; 
-    bool lowlevel=false, echo=false;
+    bool to_binary = false, to_nmea = false, reset = false;
+    bool lowlevel=false, echo=false, parallel=false;
     struct gps_data_t gpsdata;
     const struct gps_type_t *forcetype = NULL;
     const struct gps_type_t **dp;
 #ifdef CONTROLSEND_ENABLE
-    char cooked[BUFSIZ];
-    ssize_t cooklen = 0;
+#define MAX_CONTROLS	8
+    char cooked[MAX_CONTROLS][BUFSIZ];
+    ssize_t cooklen[MAX_CONTROLS];
+    int ncontrols = 0;
 #endif /* RECONFIGURE_ENABLE */
 
-#define USAGE	"usage: gpsctl [-l] [-b | -n | -r] [-D n] [-s speed] [-c rate] [-T timeout] [-V] [-t devtype] [-x control] [-e] <device>\n"
-    while ((option = getopt(argc, argv, "bec:fhlnrs:t:x:D:T:V")) != -1) {
+#define USAGE	"usage: gpsctl [-l] [-b | -n | -r] [-D n] [-s speed] [-c rate] [-T timeout] [-V] [-t devtype] [-x control]... [-e] [-p] <device>...\n"
+    while ((option = getopt(argc, argv, "bec:fhlnprs:t:x:D:T:V")) != -1) {
 	switch (option) {
 	case 'b':		/* switch to vendor binary mode */
 	    to_binary = true;
@@ -252,15 +255,24 @@ int main(int argc, char **argv)
 	    gpsd_report(LOG_ERROR, "cycle-change capability has been conditioned out.\n");
 #endif /* RECONFIGURE_ENABLE */
 	    break;
-	case 'x':		/* ship specified control string */
+	case 'x':		/* ship specified control string(s), in order */
 #ifdef CONTROLSEND_ENABLE
 	    control = optarg;
 	    lowlevel = true;
-	    if ((cooklen = hex_escapes(cooked, control)) <= 0) {
-		gpsd_report(LOG_ERROR, 
-			    "invalid escape string (error %d)\n", (int)cooklen);
+	    if (ncontrols >= MAX_CONTROLS) {
+		gpsd_report(LOG_ERROR,
+			    "too many control strings (max %d)\n",
+			    MAX_CONTROLS);
+		exit(1);
+	    }
+	    if ((cooklen[ncontrols] = hex_escapes(cooked[ncontrols],
+						  control)) <= 0) {
+		gpsd_report(LOG_ERROR,
+			    "invalid escape string (error %d)\n",
+			    (int)cooklen[ncontrols]);
 		exit(1);
 	    }
+	    ncontrols++;
 #else
 	    gpsd_report(LOG_ERROR, "control_send capability has been conditioned out.\n");	    
 #endif /* CONTROLSEND_ENABLE */
@@ -297,6 +309,9 @@ int main(int argc, char **argv)
 		(void)puts((*dp)->type_name);
 	    }
 	    exit(0);
+	case 'p':		/* apply the sequence to devices in parallel */
+	    parallel = true;
+	    break;
 	case 'n':		/* switch to NMEA mode */
 #ifdef RECONFIGURE_ENABLE
 	    to_nmea = true;
@@ -370,6 +385,42 @@ int main(int argc, char **argv)
 	exit(0);
     }
 
+    /*
+     * Multiple device operands get the same command sequence applied
+     * to each in a worker process; -p runs the workers concurrently
+     * rather than one at a time, so provisioning a rack of ports
+     * costs one device's worth of identification time rather than
+     * the sum.  Exit status is the worst any worker reported.
+     */
+    if (argc - optind > 1) {
+	int i, wstatus, worst = 0;
+	pid_t pid = -1;
+
+	for (i = optind; i < argc; i++) {
+	    pid = fork();
+	    if (pid == -1) {
+		gpsd_report(LOG_ERROR, "fork failed: %s\n", strerror(errno));
+		exit(1);
+	    } else if (pid == 0) {
+		/* worker: fall through to the single-device code */
+		device = argv[i];
+		break;
+	    }
+	    if (!parallel) {
+		if (waitpid(pid, &wstatus, 0) > 0 && WIFEXITED(wstatus)
+		    && WEXITSTATUS(wstatus) > worst)
+		    worst = WEXITSTATUS(wstatus);
+	    }
+	}
+	if (pid != 0) {
+	    /* the dispatching parent: reap any concurrent workers */
+	    while (wait(&wstatus) > 0)
+		if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) > worst)
+		    worst = WEXITSTATUS(wstatus);
+	    exit(worst);
+	}
+    }
+
     (void) signal(SIGINT, onsig);
     (void) signal(SIGTERM, onsig);
     (void) signal(SIGQUIT, onsig);
@@ -768,20 +819,24 @@ int main(int argc, char **argv)
 	/*@ -compdef @*/
 	if (control) {
 	    bool write_enable = context.readonly;
+	    int cn;
 	    context.readonly = false;
 	    if (session.device_type->control_send == NULL) {
-		gpsd_report(LOG_ERROR, 
+		gpsd_report(LOG_ERROR,
 			      "%s devices have no control sender.\n",
 			      session.device_type->type_name);
 		status = 1;
 	    } else {
-		if (session.device_type->control_send(&session, 
-						      cooked, 
-						      (size_t)cooklen) == -1) {
-		    gpsd_report(LOG_ERROR, "control transmission failed.\n");
-		    status = 1;
+		for (cn = 0; cn < ncontrols; cn++) {
+		    if (session.device_type->control_send(&session,
+							  cooked[cn],
+							  (size_t)cooklen[cn]) == -1) {
+			gpsd_report(LOG_ERROR, "control transmission failed.\n");
+			status = 1;
+			break;
+		    }
+		    settle(&session);
 		}
-		settle(&session);
 	    }
 	    context.readonly = write_enable;
 	}
@@ -9,6 +9,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/time.h>		/* for select() */
+#include <sys/uio.h>		/* for writev() */
+#include <sys/ioctl.h>		/* for TIOCOUTQ */
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
@@ -34,6 +36,7 @@
 #ifndef INADDR_ANY
 #include <netinet/in.h>
 #endif /* INADDR_ANY */
+#include <netinet/tcp.h>	/* for TCP_NODELAY */
 #include <sys/un.h>
 #include <arpa/inet.h>     /* for htons() and friends */
 #endif /* S_SPLINT_S */
@@ -49,6 +52,7 @@
 
 #include "gpsd.h"
 #include "sockaddr.h"
+#include "crc24q.h"
 #include "gps_json.h"
 #include "revision.h"
 
@@ -56,6 +60,13 @@
 #include "sd_socket.h"
 #endif
 
+#if defined(EPOLL_ENABLE)
+#include <sys/epoll.h>
+#endif /* EPOLL_ENABLE */
+#if defined(KQUEUE_ENABLE)
+#include <sys/event.h>
+#endif /* KQUEUE_ENABLE */
+
 /*
  * The name of a tty device from which to pick up whatever the local
  * owning group for tty devices is.  Used when we drop privileges.
@@ -179,65 +190,217 @@ static void visibilize(/*@out@*/char *buf2, size_t len, const char *buf)
 			   0x00ff & (unsigned)*sp);
 }
 
+#ifndef SQUELCH_ENABLE
+static void log_emit(int errlevel, const char *buf)
+/* sanitize an assembled message and hand it to syslog or stderr */
+{
+    char buf2[BUFSIZ];
+
+    visibilize(buf2, sizeof(buf2), buf);
+
+    if (in_background)
+	syslog((errlevel == 0) ? LOG_ERR : LOG_NOTICE, "%s", buf2);
+    else
+	(void)fputs(buf2, stderr);
+}
+
+static /*@observer@*/ const char *log_levelstr(int errlevel)
+/* log level to message prefix */
+{
+    switch ( errlevel ) {
+    case LOG_ERROR:
+	return "ERROR: ";
+    case LOG_SHOUT:
+	return "SHOUT: ";
+    case LOG_WARN:
+	return "WARN: ";
+    case LOG_INF:
+	return "INFO: ";
+    case LOG_DATA:
+	return "DATA: ";
+    case LOG_PROG:
+	return "PROG: ";
+    case LOG_IO:
+	return "IO: ";
+    case LOG_SPIN:
+	return "SPIN: ";
+    case LOG_RAW:
+	return "RAW: ";
+    default:
+	return "UNK: ";
+    }
+}
+
+#ifdef ASYNC_LOG_ENABLE
+/*
+ * Asynchronous logging.  visibilize() and the syslog/stderr write used
+ * to run inline in the packet-processing path, which at debug levels
+ * above 2 measurably inflates fix latency.  Messages now go through a
+ * lock-free multi-producer ring drained by a background thread, and a
+ * token bucket keyed on the format string (a good proxy for the call
+ * site) caps how fast any one diagnostic can flood the ring.  Both
+ * structures tolerate benign races: worst case a message is counted
+ * dropped a little early or a bucket refills slightly off schedule.
+ */
+#define LOG_RING_SIZE	128	/* must be a power of two */
+#define LOG_LINE_MAX	512
+
+static struct {
+    struct {
+	volatile int ready;
+	int level;
+	char text[LOG_LINE_MAX];
+    } ring[LOG_RING_SIZE];
+    volatile unsigned int head;	/* producers reserve slots here */
+    volatile unsigned int tail;	/* drain thread consumes from here */
+    volatile unsigned int dropped;
+    volatile bool running;
+} logq;
+
+#define LOG_BUCKET_SLOTS 64
+#define LOG_BUCKET_BURST 100.0	/* messages of headroom per call site */
+#define LOG_BUCKET_RATE  100.0	/* sustained messages/sec per call site */
+
+static struct {
+    const char *fmt;
+    double tokens;
+    timestamp_t last;
+    unsigned int suppressed;
+} log_buckets[LOG_BUCKET_SLOTS];
+
+static bool log_admit(int errlevel, const char *fmt,
+		      /*@out@*/unsigned int *suppressed)
+/* token-bucket admission per call site; errors always pass */
+{
+    timestamp_t now = timestamp();
+    int slot = (int)(((uintptr_t)fmt >> 4) % LOG_BUCKET_SLOTS);
+
+    *suppressed = 0;
+    if (errlevel <= LOG_WARN)
+	return true;
+    if (log_buckets[slot].fmt != fmt) {
+	/* new or recycled slot; start with a full bucket */
+	log_buckets[slot].fmt = fmt;
+	log_buckets[slot].tokens = LOG_BUCKET_BURST;
+	log_buckets[slot].suppressed = 0;
+    } else {
+	log_buckets[slot].tokens += (now - log_buckets[slot].last)
+	    * LOG_BUCKET_RATE;
+	if (log_buckets[slot].tokens > LOG_BUCKET_BURST)
+	    log_buckets[slot].tokens = LOG_BUCKET_BURST;
+    }
+    log_buckets[slot].last = now;
+    if (log_buckets[slot].tokens < 1.0) {
+	log_buckets[slot].suppressed++;
+	return false;
+    }
+    log_buckets[slot].tokens -= 1.0;
+    *suppressed = log_buckets[slot].suppressed;
+    log_buckets[slot].suppressed = 0;
+    return true;
+}
+
+static /*@null@*/ void *log_drain(void *arg UNUSED)
+/* background thread: pull messages off the ring and emit them */
+{
+    while (logq.running || logq.tail != logq.head) {
+	unsigned int dropped;
+
+	while (logq.tail != logq.head) {
+	    unsigned int i = logq.tail % LOG_RING_SIZE;
+
+	    if (!logq.ring[i].ready)
+		break;	/* producer still filling this slot in */
+	    log_emit(logq.ring[i].level, logq.ring[i].text);
+	    logq.ring[i].ready = 0;
+	    __sync_synchronize();
+	    logq.tail++;
+	}
+	dropped = logq.dropped;
+	if (dropped > 0) {
+	    char dbuf[64];
+	    (void)__sync_fetch_and_sub(&logq.dropped, dropped);
+	    (void)snprintf(dbuf, sizeof(dbuf),
+			   "gpsd:WARN: %u log messages dropped\n", dropped);
+	    log_emit(LOG_WARN, dbuf);
+	}
+	(void)usleep(10000);
+    }
+    return NULL;
+}
+
+static void log_thread_start(void)
+/* called once the daemon has forked; threads don't survive daemon(3) */
+{
+    pthread_t tid;
+    pthread_attr_t attr;
+
+    logq.running = true;
+    (void)pthread_attr_init(&attr);
+    (void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&tid, &attr, log_drain, NULL) != 0) {
+	log_emit(LOG_ERROR, "gpsd:ERROR: log thread create failed\n");
+	logq.running = false;
+    }
+    (void)pthread_attr_destroy(&attr);
+}
+#endif /* ASYNC_LOG_ENABLE */
+#endif /* !SQUELCH_ENABLE */
+
 void gpsd_report(int errlevel, const char *fmt, ...)
 /* assemble command in printf(3) style, use stderr or syslog */
 {
 #ifndef SQUELCH_ENABLE
     if (errlevel <= context.debug) {
-	char buf[BUFSIZ], buf2[BUFSIZ];
-	char *err_str;
+	char buf[BUFSIZ];
 	va_list ap;
+#ifdef ASYNC_LOG_ENABLE
+	unsigned int slot, suppressed;
+
+	if (!log_admit(errlevel, fmt, &suppressed))
+	    return;
+
+	if (logq.running) {
+	    if (logq.head - logq.tail >= LOG_RING_SIZE - 1) {
+		(void)__sync_fetch_and_add(&logq.dropped, 1);
+		return;
+	    }
+	    slot = __sync_fetch_and_add(&logq.head, 1) % LOG_RING_SIZE;
+	    (void)strlcpy(logq.ring[slot].text, "gpsd:", LOG_LINE_MAX);
+	    (void)strlcat(logq.ring[slot].text, log_levelstr(errlevel),
+			  LOG_LINE_MAX);
+	    if (suppressed > 0)
+		(void)snprintf(logq.ring[slot].text
+			       + strlen(logq.ring[slot].text),
+			       LOG_LINE_MAX - strlen(logq.ring[slot].text),
+			       "(%u suppressed) ", suppressed);
+	    va_start(ap, fmt);
+	    (void)vsnprintf(logq.ring[slot].text
+			    + strlen(logq.ring[slot].text),
+			    LOG_LINE_MAX - strlen(logq.ring[slot].text),
+			    fmt, ap);
+	    va_end(ap);
+	    logq.ring[slot].level = errlevel;
+	    __sync_synchronize();
+	    logq.ring[slot].ready = 1;
+	    return;
+	}
+#endif /* ASYNC_LOG_ENABLE */
 
 #if defined(PPS_ENABLE)
 	/*@ -unrecog  (splint has no pthread declarations as yet) @*/
 	(void)pthread_mutex_lock(&report_mutex);
 	/* +unrecog */
 #endif /* PPS_ENABLE */
-	switch ( errlevel ) {
-	case LOG_ERROR:
-		err_str = "ERROR: ";
-		break;
-	case LOG_SHOUT:
-		err_str = "SHOUT: ";
-		break;
-	case LOG_WARN:
-		err_str = "WARN: ";
-		break;
-	case LOG_INF:
-		err_str = "INFO: ";
-		break;
-	case LOG_DATA:
-		err_str = "DATA: ";
-		break;
-	case LOG_PROG:
-		err_str = "PROG: ";
-		break;
-	case LOG_IO:
-		err_str = "IO: ";
-		break;
-	case LOG_SPIN:
-		err_str = "SPIN: ";
-		break;
-	case LOG_RAW:
-		err_str = "RAW: ";
-		break;
-	default:
-		err_str = "UNK: ";
-	}
 
 	(void)strlcpy(buf, "gpsd:", BUFSIZ);
-	(void)strncat(buf, err_str, BUFSIZ - strlen(buf) );
+	(void)strncat(buf, log_levelstr(errlevel), BUFSIZ - strlen(buf) );
 	va_start(ap, fmt);
 	(void)vsnprintf(buf + strlen(buf), sizeof(buf) - strlen(buf), fmt,
 			ap);
 	va_end(ap);
 
-	visibilize(buf2, sizeof(buf2), buf);
-
-	if (in_background)
-	    syslog((errlevel == 0) ? LOG_ERR : LOG_NOTICE, "%s", buf2);
-	else
-	    (void)fputs(buf2, stderr);
+	log_emit(errlevel, buf);
 #if defined(PPS_ENABLE)
 	/*@ -unrecog (splint has no pthread declarations as yet) @*/
 	(void)pthread_mutex_unlock(&report_mutex);
@@ -251,14 +414,17 @@ static void usage(void)
 {
     const struct gps_type_t **dp;
 
-    (void)printf("usage: gpsd [-b] [-n] [-N] [-D n] [-F sockfile] [-G] [-P pidfile] [-S port] [-h] device...\n\
+    (void)printf("usage: gpsd [-a] [-b] [-n] [-N] [-D n] [-F sockfile] [-G] [-P pidfile] [-S port] [-h] device...\n\
   Options include: \n\
+  -a		     	    = don't block on serial speed changes\n\
   -b		     	    = bluetooth-safe: open data sources read-only\n\
   -n			    = don't wait for client connects to poll GPS\n\
   -N			    = don't go into background\n\
   -F sockfile		    = specify control socket location\n\
   -G         		    = make gpsd listen on INADDR_ANY\n\
+  -M group:port		    = also multicast JSON reports to this group \n\
   -P pidfile	      	    = set file to record process ID \n\
+  -r spooldir	      	    = archive raw packets to mmap'ed spools there \n\
   -D integer (default 0)    = set debug level \n\
   -S integer (default %s) = set port for daemon \n\
   -h		     	    = help message \n\
@@ -301,24 +467,167 @@ static int filesock(char *filename)
 
 /*
  * This hackery is intended to support SBCs that are resource-limited
- * and only need to support one or a few devices each.  It avoids the
- * space overhead of allocating thousands of unused device structures.
- * This array fills from the bottom, so as an extreme case you could
- * reduce LIMITED_MAX_DEVICES to 1.
+ * and only need to support one or a few devices each, and at the other
+ * extreme aggregators owning dozens of receivers.  The table is sparse:
+ * just pointers, with gps_device_t slots calloc'd on first use and
+ * recycled thereafter, so a generous cap no longer costs the 14MB of
+ * core that a static FD_SETSIZE array of device structures once did.
  */
 #ifdef LIMITED_MAX_DEVICES
 #define MAXDEVICES	LIMITED_MAX_DEVICES
 #else
-/* we used to make this FD_SETSIZE, but that cost 14MB of wasted core! */
-#define MAXDEVICES	4
+#define MAXDEVICES	FD_SETSIZE
 #endif
 
 #define sub_index(s) (int)((s) - subscribers)
-#define allocated_device(devp)	 ((devp)->gpsdata.dev.path[0] != '\0')
+#define allocated_device(devp)	 ((devp) != NULL && (devp)->gpsdata.dev.path[0] != '\0')
 #define free_device(devp)	 (devp)->gpsdata.dev.path[0] = '\0'
-#define initialized_device(devp) ((devp)->context != NULL)
+#define initialized_device(devp) ((devp) != NULL && (devp)->context != NULL)
 
-static struct gps_device_t devices[MAXDEVICES];
+static struct gps_device_t *devices[MAXDEVICES];	/* sparse device table */
+
+static int device_index(const struct gps_device_t *devp)
+/* return the table index of a device slot, mainly for logging */
+{
+    int i;
+
+    for (i = 0; i < MAXDEVICES; i++)
+	if (devices[i] == devp)
+	    return i;
+    return -1;
+}
+
+static /*@null@*/struct gps_device_t *next_device(int *dpi)
+/* scan the sparse device table, returning each live slot in turn */
+{
+    while (*dpi < MAXDEVICES) {
+	struct gps_device_t *devp = devices[(*dpi)++];
+
+	if (devp != NULL)
+	    return devp;
+    }
+    return NULL;
+}
+
+static /*@null@*/struct gps_device_t *allocate_device(void)
+/* get a device slot, recycling a freed one before growing the pool */
+{
+    int i;
+
+    for (i = 0; i < MAXDEVICES; i++)
+	if (devices[i] != NULL && !allocated_device(devices[i]))
+	    return devices[i];
+    for (i = 0; i < MAXDEVICES; i++)
+	if (devices[i] == NULL) {
+	    devices[i] = (struct gps_device_t *)calloc(1,
+					  sizeof(struct gps_device_t));
+	    if (devices[i] == NULL)
+		gpsd_report(LOG_ERROR,
+			    "out of memory allocating device slot\n");
+	    return devices[i];
+	}
+    return NULL;
+}
+
+static void consume_packets(struct gps_device_t *device);
+
+#ifdef DEVICE_THREADS_ENABLE
+/*
+ * One service thread per attached device.  Each thread waits on its own
+ * descriptor and runs consume_packets() when data arrives, so a device
+ * stalled in a slow kernel read path or a long decode can no longer
+ * delay servicing of the others.  Decode and report fanout are still
+ * serialized by service_mutex -- the subscriber table, the devices
+ * array, and the shared context are not otherwise thread-safe -- so
+ * this buys I/O concurrency, not parse parallelism.  The main loop
+ * keeps ownership of listeners, the control socket, and all clients.
+ */
+static pthread_mutex_t service_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define report_lock()	(void)pthread_mutex_lock(&service_mutex)
+#define report_unlock()	(void)pthread_mutex_unlock(&service_mutex)
+
+static struct devthread_t
+{
+    pthread_t tid;
+    volatile bool running;	/* cleared to ask the thread to exit */
+} devthreads[MAXDEVICES];
+
+static /*@null@*/ void *device_service(void *arg)
+/* thread body: wait for and consume packets from a single device */
+{
+    struct gps_device_t *device = (struct gps_device_t *)arg;
+    struct devthread_t *dt = &devthreads[device_index(device)];
+
+    while (dt->running) {
+	fd_set rfds;
+	struct timeval tv;
+	int dfd = device->gpsdata.gps_fd;
+
+	if (dfd < 0 || !allocated_device(device))
+	    break;
+	FD_ZERO(&rfds);
+	FD_SET(dfd, &rfds);
+	tv.tv_sec = 1;
+	tv.tv_usec = 0;
+	if (select(dfd + 1, &rfds, NULL, NULL, &tv) == -1) {
+	    if (errno == EINTR)
+		continue;
+	    break;
+	}
+	if (!FD_ISSET(dfd, &rfds))
+	    continue;
+	report_lock();
+	if (dt->running && allocated_device(device)
+	    && device->gpsdata.gps_fd >= 0)
+	    consume_packets(device);
+	report_unlock();
+	/* honor the zero-length-read backoff without the event loop */
+	if (device->reawake > 0) {
+	    (void)usleep((useconds_t) (DEVICE_REAWAKE * 1000000));
+	    device->reawake = (timestamp_t)0;
+	    device->zerokill = true;
+	}
+    }
+    dt->running = false;
+    return NULL;
+}
+
+static void watch_device(struct gps_device_t *device)
+/* start servicing an activated device */
+{
+    struct devthread_t *dt;
+    pthread_attr_t attr;
+    int idx = device_index(device);
+
+    if (idx < 0)
+	return;
+    dt = &devthreads[idx];
+    if (dt->running)
+	return;
+    dt->running = true;
+    (void)pthread_attr_init(&attr);
+    (void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&dt->tid, &attr, device_service, device) != 0) {
+	gpsd_report(LOG_ERROR, "device thread create failed on %s\n",
+		    device->gpsdata.dev.path);
+	dt->running = false;
+    }
+    (void)pthread_attr_destroy(&attr);
+}
+
+static void unwatch_device(struct gps_device_t *device)
+/* stop servicing a device; its thread notices and winds down */
+{
+    int idx = device_index(device);
+
+    if (idx >= 0)
+	devthreads[idx].running = false;
+}
+#else
+#define report_lock()		/* no threads, no lock */
+#define report_unlock()
+#endif /* DEVICE_THREADS_ENABLE */
 
 static void adjust_max_fd(int fd, bool on)
 /* track the largest fd currently in use */
@@ -348,6 +657,159 @@ static void adjust_max_fd(int fd, bool on)
 #endif /* !defined(LIMITED_MAX_DEVICES) && !defined(LIMITED_MAX_CLIENT_FD) */
 }
 
+/*
+ * Descriptor event monitoring.  Historically the daemon multiplexed all
+ * I/O through select(2), which walks the whole fd_set on every call; with
+ * hundreds of subscribers that linear scan (and the FD_SETSIZE rescan in
+ * adjust_max_fd()) dominates CPU.  When the epoll or kqueue build options
+ * are set we register descriptors with the kernel once, in fd_watch() and
+ * fd_unwatch(), and let fd_monitor_wait() translate the kernel's ready
+ * list back into an fd_set so the dispatch code below needs no changes.
+ * We deliberately use level-triggered notification: the dispatchers read
+ * at most one bufferload per wakeup and rely on being re-notified if more
+ * data is pending.  all_fds stays authoritative in every backend, both
+ * for the select(2) fallback and for the LOG_SPIN descriptor dump.
+ */
+
+#ifdef EPOLL_ENABLE
+static int monitor_fd = -1;
+
+static void fd_monitor_init(void)
+{
+    monitor_fd = epoll_create(MAXDEVICES + 8);
+    if (monitor_fd == -1) {
+	gpsd_report(LOG_ERROR, "epoll_create: %s\n", strerror(errno));
+	exit(2);
+    }
+}
+
+static void fd_watch(int fd)
+/* begin monitoring fd for read-readiness */
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(monitor_fd, EPOLL_CTL_ADD, fd, &ev) == -1
+	&& errno != EEXIST)
+	gpsd_report(LOG_ERROR, "epoll_ctl(ADD, %d): %s\n",
+		    fd, strerror(errno));
+    FD_SET(fd, &all_fds);
+    adjust_max_fd(fd, true);
+}
+
+static void fd_unwatch(int fd)
+/* stop monitoring fd */
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    if (epoll_ctl(monitor_fd, EPOLL_CTL_DEL, fd, &ev) == -1
+	&& errno != ENOENT && errno != EBADF)
+	gpsd_report(LOG_ERROR, "epoll_ctl(DEL, %d): %s\n",
+		    fd, strerror(errno));
+    FD_CLR(fd, &all_fds);
+    adjust_max_fd(fd, false);
+}
+
+static int fd_monitor_wait(fd_set * rfds, struct timeval *tv)
+/* await readiness; fill rfds with the descriptors that are readable */
+{
+    struct epoll_event events[64];
+    int nevents, i;
+
+    nevents = epoll_wait(monitor_fd, events, (int)NITEMS(events),
+			 (int)(tv->tv_sec * 1000 + tv->tv_usec / 1000));
+    FD_ZERO(rfds);
+    if (nevents > 0)
+	for (i = 0; i < nevents; i++)
+	    FD_SET(events[i].data.fd, rfds);
+    return nevents;
+}
+#elif defined(KQUEUE_ENABLE)
+static int monitor_fd = -1;
+
+static void fd_monitor_init(void)
+{
+    monitor_fd = kqueue();
+    if (monitor_fd == -1) {
+	gpsd_report(LOG_ERROR, "kqueue: %s\n", strerror(errno));
+	exit(2);
+    }
+}
+
+static void fd_watch(int fd)
+/* begin monitoring fd for read-readiness */
+{
+    struct kevent kev;
+
+    EV_SET(&kev, fd, EVFILT_READ, EV_ADD, 0, 0, NULL);
+    if (kevent(monitor_fd, &kev, 1, NULL, 0, NULL) == -1)
+	gpsd_report(LOG_ERROR, "kevent(EV_ADD, %d): %s\n",
+		    fd, strerror(errno));
+    FD_SET(fd, &all_fds);
+    adjust_max_fd(fd, true);
+}
+
+static void fd_unwatch(int fd)
+/* stop monitoring fd */
+{
+    struct kevent kev;
+
+    EV_SET(&kev, fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    if (kevent(monitor_fd, &kev, 1, NULL, 0, NULL) == -1
+	&& errno != ENOENT && errno != EBADF)
+	gpsd_report(LOG_ERROR, "kevent(EV_DELETE, %d): %s\n",
+		    fd, strerror(errno));
+    FD_CLR(fd, &all_fds);
+    adjust_max_fd(fd, false);
+}
+
+static int fd_monitor_wait(fd_set * rfds, struct timeval *tv)
+/* await readiness; fill rfds with the descriptors that are readable */
+{
+    struct kevent events[64];
+    struct timespec ts;
+    int nevents, i;
+
+    ts.tv_sec = tv->tv_sec;
+    ts.tv_nsec = tv->tv_usec * 1000;
+    nevents = kevent(monitor_fd, NULL, 0, events, (int)NITEMS(events), &ts);
+    FD_ZERO(rfds);
+    if (nevents > 0)
+	for (i = 0; i < nevents; i++)
+	    FD_SET((int)events[i].ident, rfds);
+    return nevents;
+}
+#else
+static void fd_monitor_init(void)
+{
+    /* nothing to do for the select(2) backend */
+}
+
+static void fd_watch(int fd)
+/* begin monitoring fd for read-readiness */
+{
+    FD_SET(fd, &all_fds);
+    adjust_max_fd(fd, true);
+}
+
+static void fd_unwatch(int fd)
+/* stop monitoring fd */
+{
+    FD_CLR(fd, &all_fds);
+    adjust_max_fd(fd, false);
+}
+
+static int fd_monitor_wait(fd_set * rfds, struct timeval *tv)
+/* await readiness; fill rfds with the descriptors that are readable */
+{
+    (void)memcpy((char *)rfds, (char *)&all_fds, sizeof(fd_set));
+    return select(maxfd + 1, rfds, NULL, NULL, tv);
+}
+#endif /* event backends */
+
 #ifdef SOCKET_EXPORT_ENABLE
 static int passivesock_af(int af, char *service, char *tcp_or_udp, int qlen)
 /* bind a passive command socket for the daemon */
@@ -498,17 +960,31 @@ static int passivesocks(char *service, char *tcp_or_udp,
 }
 /* *INDENT-ON* */
 
+/*
+ * Hold the reports generated for one subscriber during a single
+ * consume_packets() pass here, so the whole epoch's worth can be pushed
+ * out with one writev(2) instead of one syscall per report.  A queue
+ * one report buffer deep is enough; oversized reports bypass it.
+ */
+#define CLIENT_OBUF_MAX	GPS_JSON_RESPONSE_MAX
+
 struct subscriber_t
 {
     int fd;			/* client file descriptor. -1 if unused */
     timestamp_t active;		/* when subscriber last polled for data */
     struct policy_t policy;	/* configurable bits */
+    timestamp_t last_report;	/* when we last shipped a decimated report */
+    int last_mode;		/* fix mode as of that report */
+    char obuf[CLIENT_OBUF_MAX];	/* reports awaiting batched flush */
+    size_t obuflen;		/* bytes of obuf in use */
+    struct subscriber_t *next;	/* chain, on the active or free list */
+    struct subscriber_t *prev;	/* back pointer while on the active list */
 };
 
 #ifdef LIMITED_MAX_CLIENTS
 #define MAXSUBSCRIBERS LIMITED_MAX_CLIENTS
 #else
-/* subscriber structure is small enough that there's no need to limit this */
+/* subscriber structure is a few KB; FD_SETSIZE of them is acceptable */
 #define MAXSUBSCRIBERS	FD_SETSIZE
 #endif
 
@@ -516,23 +992,36 @@ struct subscriber_t
 
 static struct subscriber_t subscribers[MAXSUBSCRIBERS];	/* indexed by client file descriptor */
 
+/*
+ * Subscriber slots are kept on two intrusive lists so that connection
+ * churn and per-event fanout never scan all MAXSUBSCRIBERS entries:
+ * allocation pops the free list, and every loop over connected clients
+ * walks the doubly-linked active list instead of the whole array.
+ */
+static /*@null@*/struct subscriber_t *active_subs;	/* connected clients */
+static /*@null@*/struct subscriber_t *free_subs;	/* recycled slots */
+
 #define UNALLOCATED_FD	-1
 
 static /*@null@*//*@observer@ */ struct subscriber_t *allocate_client(void)
 /* return the address of a subscriber structure allocated for a new session */
 {
-    int si;
+    struct subscriber_t *sub;
 
 #if UNALLOCATED_FD == 0
 #error client allocation code will fail horribly
 #endif
-    for (si = 0; si < NITEMS(subscribers); si++) {
-	if (subscribers[si].fd == UNALLOCATED_FD) {
-	    subscribers[si].fd = 0;	/* mark subscriber as allocated */
-	    return &subscribers[si];
-	}
-    }
-    return NULL;
+    sub = free_subs;
+    if (sub == NULL)
+	return NULL;
+    free_subs = sub->next;
+    sub->fd = 0;	/* mark subscriber as allocated */
+    sub->prev = NULL;
+    sub->next = active_subs;
+    if (active_subs != NULL)
+	active_subs->prev = sub;
+    active_subs = sub;
+    return sub;
 }
 
 static void detach_client(struct subscriber_t *sub)
@@ -547,8 +1036,7 @@ static void detach_client(struct subscriber_t *sub)
     (void)close(sub->fd);
     gpsd_report(LOG_INF, "detaching %s (sub %d, fd %d) in detach_client\n",
 		c_ip, sub_index(sub), sub->fd);
-    FD_CLR(sub->fd, &all_fds);
-    adjust_max_fd(sub->fd, false);
+    fd_unwatch(sub->fd);
     sub->active = (timestamp_t)0;
     sub->policy.watcher = false;
     sub->policy.json = false;
@@ -556,33 +1044,104 @@ static void detach_client(struct subscriber_t *sub)
     sub->policy.raw = 0;
     sub->policy.scaled = false;
     sub->policy.timing = false;
+    sub->policy.binary = false;
+    sub->policy.classmask = 0;
+    sub->policy.interval = 0;
     sub->policy.devpath[0] = '\0';
+    sub->last_report = (timestamp_t)0;
+    sub->last_mode = 0;
+    sub->obuflen = 0;
     sub->fd = UNALLOCATED_FD;
+    /* move the slot from the active list back to the free list */
+    if (sub->prev != NULL)
+	sub->prev->next = sub->next;
+    else
+	active_subs = sub->next;
+    if (sub->next != NULL)
+	sub->next->prev = sub->prev;
+    sub->prev = NULL;
+    sub->next = free_subs;
+    free_subs = sub;
     /*@+mustfreeonly@*/
 }
 
-static ssize_t throttled_write(struct subscriber_t *sub, char *buf,
-			       size_t len)
+static bool batching = false;	/* true during the per-epoch report fanout */
+
+/*
+ * Fleet broadcast mode: with -M group:port every rendered JSON report
+ * is also sent once to a multicast group, so any number of same-LAN
+ * consumers costs the daemon a single send per report instead of one
+ * throttled_write() per subscriber.
+ */
+static socket_t mcast_fd = -1;		/* broadcast socket, -1 = off */
+static struct sockaddr_in mcast_dest;
+static struct policy_t mcast_policy;	/* render policy for broadcast */
+
+static int mcast_open(char *spec)
+/* open the fleet-broadcast socket; spec is multicast-group:port */
+{
+    char *colon;
+    int sock, one = 1;
+    unsigned char ttl = 1;
+
+    if ((colon = strrchr(spec, ':')) == NULL) {
+	gpsd_report(LOG_ERROR, "missing port in multicast spec %s\n", spec);
+	return -1;
+    }
+    *colon = '\0';
+    memset(&mcast_dest, 0, sizeof(mcast_dest));
+    mcast_dest.sin_family = AF_INET;
+    mcast_dest.sin_port = htons((in_port_t)atoi(colon + 1));
+    if (inet_pton(AF_INET, spec, &mcast_dest.sin_addr) != 1) {
+	gpsd_report(LOG_ERROR, "invalid multicast group %s\n", spec);
+	return -1;
+    }
+    if ((sock = socket(AF_INET, SOCK_DGRAM, 0)) == -1) {
+	gpsd_report(LOG_ERROR, "multicast socket creation failed\n");
+	return -1;
+    }
+    (void)setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL,
+		     &ttl, sizeof(ttl));
+    (void)setsockopt(sock, SOL_SOCKET, SO_REUSEADDR,
+		     (char *)&one, sizeof(one));
+    memset(&mcast_policy, 0, sizeof(mcast_policy));
+    mcast_policy.watcher = mcast_policy.json = true;
+    gpsd_report(LOG_INF, "multicast report feed to %s:%s on fd %d\n",
+		spec, colon + 1, sock);
+    return sock;
+}
+
+static ssize_t client_write(struct subscriber_t *sub,
+			    const struct iovec *iov, int iovcnt)
 /* write to client -- throttle if it's gone or we're close to buffer overrun */
 {
     ssize_t status;
+    size_t len = 0;
+    int i;
+
+    for (i = 0; i < iovcnt; i++)
+	len += iov[i].iov_len;
 
     if (context.debug >= 3) {
-	if (isprint(buf[0]))
-	    gpsd_report(LOG_IO, "=> client(%d): %s\n", sub_index(sub), buf);
-	else {
-	    char *cp, buf2[MAX_PACKET_LENGTH * 3];
-	    buf2[0] = '\0';
-	    for (cp = buf; cp < buf + len; cp++)
-		(void)snprintf(buf2 + strlen(buf2),
-			       sizeof(buf2) - strlen(buf2),
-			       "%02x", (unsigned int)(*cp & 0xff));
-	    gpsd_report(LOG_IO, "=> client(%d): =%s\n", sub_index(sub),
-			buf2);
+	for (i = 0; i < iovcnt; i++) {
+	    char *buf = (char *)iov[i].iov_base;
+	    if (isprint(buf[0]))
+		gpsd_report(LOG_IO, "=> client(%d): %s\n",
+			    sub_index(sub), buf);
+	    else {
+		char *cp, buf2[MAX_PACKET_LENGTH * 3];
+		buf2[0] = '\0';
+		for (cp = buf; cp < buf + iov[i].iov_len; cp++)
+		    (void)snprintf(buf2 + strlen(buf2),
+				   sizeof(buf2) - strlen(buf2),
+				   "%02x", (unsigned int)(*cp & 0xff));
+		gpsd_report(LOG_IO, "=> client(%d): =%s\n", sub_index(sub),
+			    buf2);
+	    }
 	}
     }
 
-    status = send(sub->fd, buf, len, 0);
+    status = writev(sub->fd, iov, iovcnt);
     if (status == (ssize_t) len)
 	return status;
     else if (status > -1) {
@@ -604,34 +1163,97 @@ static ssize_t throttled_write(struct subscriber_t *sub, char *buf,
     return status;
 }
 
+static ssize_t throttled_write(struct subscriber_t *sub, char *buf,
+			       size_t len)
+/* queue a report for the client, writing immediately when not batching */
+{
+    struct iovec iov[2];
+
+    if (!batching) {
+	iov[0].iov_base = buf;
+	iov[0].iov_len = len;
+	return client_write(sub, iov, 1);
+    }
+
+    if (len > sizeof(sub->obuf) - sub->obuflen) {
+	if (len >= sizeof(sub->obuf)) {
+	    /* report can never fit; flush queue and report together */
+	    int iovcnt = 0;
+	    if (sub->obuflen > 0) {
+		iov[iovcnt].iov_base = sub->obuf;
+		iov[iovcnt].iov_len = sub->obuflen;
+		iovcnt++;
+	    }
+	    iov[iovcnt].iov_base = buf;
+	    iov[iovcnt].iov_len = len;
+	    iovcnt++;
+	    sub->obuflen = 0;
+	    return client_write(sub, iov, iovcnt);
+	}
+	/*
+	 * High-water mark: the client isn't draining fast enough.
+	 * Drop the stale queued reports in favor of the fresh one
+	 * rather than stall the whole epoch on one slow consumer.
+	 */
+	gpsd_report(LOG_INF,
+		    "client(%d) falling behind, dropped %zu queued bytes\n",
+		    sub_index(sub), sub->obuflen);
+	sub->obuflen = 0;
+    }
+    memcpy(sub->obuf + sub->obuflen, buf, len);
+    sub->obuflen += len;
+    return (ssize_t) len;
+}
+
+static void flush_subscriber(struct subscriber_t *sub)
+/* push a subscriber's queued reports out in a single syscall */
+{
+    struct iovec iov;
+
+    if (sub->obuflen == 0)
+	return;
+    iov.iov_base = sub->obuf;
+    iov.iov_len = sub->obuflen;
+    if (client_write(sub, &iov, 1) > 0)
+	sub->obuflen = 0;
+}
+
 static void notify_watchers(struct gps_device_t *device, const char *sentence, ...)
 /* notify all clients watching a given device of an event */
 {
     va_list ap;
     char buf[BUFSIZ];
-    struct subscriber_t *sub;
+    struct subscriber_t *sub, *subnext;
 
     va_start(ap, sentence);
     (void)vsnprintf(buf, sizeof(buf), sentence, ap);
     va_end(ap);
 
-    for (sub = subscribers; sub < subscribers + MAXSUBSCRIBERS; sub++)
+    for (sub = active_subs; sub != NULL; sub = subnext) {
+	subnext = sub->next;	/* throttled_write() may detach sub */
 	if (sub->active != 0 && subscribed(sub, device))
 	    (void)throttled_write(sub, buf, strlen(buf));
+    }
 }
 #endif /* SOCKET_EXPORT_ENABLE */
 
 static void deactivate_device(struct gps_device_t *device)
 /* deactivate device, but leave it in the pool (do not free it) */
 {
+#ifdef RAWSPOOL_ENABLE
+    rawspool_close(device);
+#endif /* RAWSPOOL_ENABLE */
 #ifdef SOCKET_EXPORT_ENABLE
     notify_watchers(device,
 		    "{\"class\":\"DEVICE\",\"path\":\"%s\",\"activated\":0}\r\n",
 		    device->gpsdata.dev.path);
 #endif /* SOCKET_EXPORT_ENABLE */
     if (device->gpsdata.gps_fd != -1) {
-	FD_CLR(device->gpsdata.gps_fd, &all_fds);
-	adjust_max_fd(device->gpsdata.gps_fd, false);
+#ifdef DEVICE_THREADS_ENABLE
+	unwatch_device(device);
+#else
+	fd_unwatch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
 #ifdef NTPSHM_ENABLE
 	ntpd_link_deactivate(device);
 #endif /* NTPSHM_ENABLE */
@@ -646,8 +1268,9 @@ static void deactivate_device(struct gps_device_t *device)
 /* find the device block for an existing device name */
 {
     struct gps_device_t *devp;
+    int dpi = 0;
 
-    for (devp = devices; devp < devices + MAXDEVICES; devp++)
+    while ((devp = next_device(&dpi)) != NULL)
     {
         if (allocated_device(devp) && NULL != device_name &&
             strcmp(devp->gpsdata.dev.path, device_name) == 0)
@@ -665,19 +1288,21 @@ static bool open_device( /*@null@*/struct gps_device_t *device)
     }
     gpsd_report(LOG_INF, "device %s activated\n",
 		device->gpsdata.dev.path);
-    FD_SET(device->gpsdata.gps_fd, &all_fds);
-    adjust_max_fd(device->gpsdata.gps_fd, true);
+#ifdef DEVICE_THREADS_ENABLE
+    watch_device(device);
+#else
+    fd_watch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
     return true;
 }
 
-static bool add_device(const char *device_name)
-/* add a device to the pool; open it right away if in nowait mode */
+static bool add_device(const char *device_name, bool deferred)
+/* add a device to the pool; open it right away unless deferral was asked */
 {
     struct gps_device_t *devp;
     bool ret = false;
     /* stash devicename away for probing when the first client connects */
-    for (devp = devices; devp < devices + MAXDEVICES; devp++)
-	if (!allocated_device(devp)) {
+    if ((devp = allocate_device()) != NULL) {
 	    gpsd_init(devp, &context, device_name);
 #ifdef NTPSHM_ENABLE
 	    /*
@@ -695,20 +1320,31 @@ static bool add_device(const char *device_name)
 
 #endif /* NTPSHM_ENABLE */
 	    gpsd_report(LOG_INF, "stashing device %s at slot %d\n",
-			device_name, (int)(devp - devices));
+			device_name, device_index(devp));
+#ifndef SOCKET_EXPORT_ENABLE
+	    /* the deferred-open machinery lives in the subscriber loop */
+	    deferred = false;
+#endif /* SOCKET_EXPORT_ENABLE */
 #ifndef FORCE_NOWAIT
-	    if (!nowait) {
+	    if (!nowait)
+		deferred = true;
+#endif /* FORCE_NOWAIT */
+	    if (deferred) {
+		/*
+		 * Stash the device for the main loop's reconnection
+		 * pass to probe on its next cycle.  A hotplug storm
+		 * of adds then costs one cycle, not one synchronous
+		 * serial open apiece.
+		 */
 		devp->gpsdata.gps_fd = -1;
 		ret = true;
 	    } else
-#endif /* FORCE_NOWAIT */
 		ret = open_device(devp);
 #ifdef SOCKET_EXPORT_ENABLE
 	    notify_watchers(devp,
 			    "{\"class\":\"DEVICE\",\"path\":\"%s\",\"activated\":%lf}\r\n",
 			    devp->gpsdata.dev.path, timestamp());
 #endif /* SOCKET_EXPORT_ENABLE */
-	    break;
 	}
     return ret;
 }
@@ -763,7 +1399,7 @@ static void handle_control(int sfd, char *buf)
 	    ignore_return(write(sfd, "ERROR\n", 6));
 	} else {
 	    gpsd_report(LOG_INF, "<= control(%d): adding %s\n", sfd, stash);
-	    if (add_device(stash))
+	    if (add_device(stash, true))
 		ignore_return(write(sfd, "OK\n", 3));
 	    else
 		ignore_return(write(sfd, "ERROR\n", 6));
@@ -850,7 +1486,8 @@ static void handle_control(int sfd, char *buf)
 	}
     } else if (strcmp(buf, "?devices")==0) {
 	/* write back devices list followed by OK */
-	for (devp = devices; devp < devices + MAXDEVICES; devp++) {
+	int dpi = 0;
+	while ((devp = next_device(&dpi)) != NULL) {
 	    char *path = devp->gpsdata.dev.path;
 	    ignore_return(write(sfd, path, strlen(path)));
 	    ignore_return(write(sfd, "\n", 1));
@@ -882,7 +1519,7 @@ static bool awaken(struct gps_device_t *device)
     if (device->gpsdata.gps_fd != -1) {
 	gpsd_report(LOG_PROG,
 		    "device %d (fd=%d, path %s) already active.\n",
-		    (int)(device - devices),
+		    device_index(device),
 		    device->gpsdata.gps_fd, device->gpsdata.dev.path);
 	return true;
     } else {
@@ -894,8 +1531,11 @@ static bool awaken(struct gps_device_t *device)
 	    gpsd_report(LOG_RAW,
 			"flagging descriptor %d in assign_channel()\n",
 			device->gpsdata.gps_fd);
-	    FD_SET(device->gpsdata.gps_fd, &all_fds);
-	    adjust_max_fd(device->gpsdata.gps_fd, true);
+#ifdef DEVICE_THREADS_ENABLE
+	    watch_device(device);
+#else
+	    fd_watch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
 	    return true;
 	}
     }
@@ -908,7 +1548,7 @@ static bool privileged_user(struct gps_device_t *device)
     /* grant user privilege if he's the only one listening to the device */
     struct subscriber_t *sub;
     int subcount = 0;
-    for (sub = subscribers; sub < subscribers + MAXSUBSCRIBERS; sub++) {
+    for (sub = active_subs; sub != NULL; sub = sub->next) {
 	if (sub->active == 0)
 	    continue;
 	else if (subscribed(sub, device))
@@ -974,8 +1614,9 @@ static void set_serial(struct gps_device_t *device,
 static void json_devicelist_dump(char *reply, size_t replylen)
 {
     struct gps_device_t *devp;
+    int dpi = 0;
     (void)strlcpy(reply, "{\"class\":\"DEVICES\",\"devices\":[", replylen);
-    for (devp = devices; devp < devices + MAXDEVICES; devp++)
+    while ((devp = next_device(&dpi)) != NULL)
 	if (allocated_device(devp)
 	    && strlen(reply) + strlen(devp->gpsdata.dev.path) + 3 <
 	    replylen - 1) {
@@ -992,6 +1633,73 @@ static void json_devicelist_dump(char *reply, size_t replylen)
 	reply[strlen(reply) - 1] = '\0';
     (void)strlcat(reply, "]}\r\n", replylen);
 }
+
+#ifdef TIMING_ENABLE
+static void record_latency(struct gps_device_t *device)
+/* fold one receipt-to-write latency sample into the device histogram */
+{
+    /* microsecond buckets need the precise clock, not the coarse one */
+    double lag = monotime() - device->m_recv_time;
+    unsigned long us;
+    int n = 0;
+
+    if (lag < 0)
+	return;			/* clock stepped under us */
+    device->latency.count++;
+    device->latency.sum += lag;
+    if (device->latency.count == 1 || lag < device->latency.min)
+	device->latency.min = lag;
+    if (lag > device->latency.max)
+	device->latency.max = lag;
+    for (us = (unsigned long)(lag * 1e6); us > 1; us >>= 1)
+	if (++n >= LATENCY_BUCKETS - 1)
+	    break;
+    device->latency.bucket[n]++;
+}
+
+static void json_stats_dump(char *reply, size_t replylen)
+/* dump the per-device latency histograms in response to ?STATS */
+{
+    struct gps_device_t *devp;
+    int dpi = 0;
+
+    (void)strlcpy(reply, "{\"class\":\"STATS\",\"devices\":[", replylen);
+    while ((devp = next_device(&dpi)) != NULL)
+	if (allocated_device(devp)) {
+	    int n;
+
+	    (void)snprintf(reply + strlen(reply), replylen - strlen(reply),
+			   "{\"path\":\"%s\",\"samples\":%lu",
+			   devp->gpsdata.dev.path, devp->latency.count);
+	    if (devp->latency.count > 0)
+		(void)snprintf(reply + strlen(reply),
+			       replylen - strlen(reply),
+			       ",\"min\":%.6f,\"max\":%.6f,\"mean\":%.6f",
+			       devp->latency.min, devp->latency.max,
+			       devp->latency.sum / devp->latency.count);
+	    if (devp->decode.count > 0)
+		(void)snprintf(reply + strlen(reply),
+			       replylen - strlen(reply),
+			       ",\"decode\":{\"samples\":%lu,"
+			       "\"min\":%.6f,\"max\":%.6f,\"mean\":%.6f}",
+			       devp->decode.count,
+			       devp->decode.min, devp->decode.max,
+			       devp->decode.sum / devp->decode.count);
+	    (void)strlcat(reply, ",\"lg2us\":[", replylen);
+	    for (n = 0; n < LATENCY_BUCKETS; n++)
+		(void)snprintf(reply + strlen(reply),
+			       replylen - strlen(reply),
+			       "%lu,", devp->latency.bucket[n]);
+	    if (reply[strlen(reply) - 1] == ',')
+		reply[strlen(reply) - 1] = '\0';
+	    (void)strlcat(reply, "]},", replylen);
+	}
+
+    if (reply[strlen(reply) - 1] == ',')
+	reply[strlen(reply) - 1] = '\0';
+    (void)strlcat(reply, "]}\r\n", replylen);
+}
+#endif /* TIMING_ENABLE */
 #endif /* SOCKET_EXPORT_ENABLE */
 
 static void rstrip(char *str)
@@ -1010,6 +1718,7 @@ static void handle_request(struct subscriber_t *sub,
 			   char *reply, size_t replylen)
 {
     struct gps_device_t *devp;
+    int dpi;
     const char *end = NULL;
 
     /*
@@ -1050,7 +1759,7 @@ static void handle_request(struct subscriber_t *sub,
 	    } else if (sub->policy.watcher) {
 		if (sub->policy.devpath[0] == '\0') {
 		    /* awaken all devices */
-		    for (devp = devices; devp < devices + MAXDEVICES; devp++)
+		    for (dpi = 0; (devp = next_device(&dpi)) != NULL;)
 			if (allocated_device(devp)) {
 			    (void)awaken(devp);
 			    if (devp->sourcetype == source_gpsd) {
@@ -1127,7 +1836,7 @@ static void handle_request(struct subscriber_t *sub,
 		} else {
 		    /* no path specified */
 		    int devcount = 0;
-		    for (devp = devices; devp < devices + MAXDEVICES; devp++)
+		    for (dpi = 0; (devp = next_device(&dpi)) != NULL;)
 			if (allocated_device(devp)) {
 			    device = devp;
 			    devcount++;
@@ -1200,7 +1909,7 @@ static void handle_request(struct subscriber_t *sub,
 #endif /* RECONFIGURE_ENABLE */
 	}
 	/* dump a response for each selected channel */
-	for (devp = devices; devp < devices + MAXDEVICES; devp++)
+	for (dpi = 0; (devp = next_device(&dpi)) != NULL;)
 	    if (!allocated_device(devp))
 		continue;
 	    else if (devconf.path[0] != '\0' && devp != NULL
@@ -1211,23 +1920,62 @@ static void handle_request(struct subscriber_t *sub,
 				 reply + strlen(reply),
 				 replylen - strlen(reply));
 	    }
-    } else if (strncmp(buf, "POLL;", 5) == 0) {
+    } else if (strncmp(buf, "POLL", 4) == 0
+	       && (buf[4] == ';' || buf[4] == '=')) {
 	char tbuf[JSON_DATE_MAX+1];
 	int active = 0;
-	buf += 5;
-	for (devp = devices; devp < devices + MAXDEVICES; devp++)
+	unsigned int depth = 1;
+	if (buf[4] == '=') {
+	    /* ?POLL=n: replay up to n recent epochs per device */
+	    char *end;
+	    long n = strtol(buf + 5, &end, 10);
+	    if (n > 1)
+		depth = (n > FIX_HISTORY_DEPTH)
+		    ? (unsigned int)FIX_HISTORY_DEPTH : (unsigned int)n;
+	    buf = (*end == ';') ? end + 1 : end;
+	} else
+	    buf += 5;
+	for (dpi = 0; (devp = next_device(&dpi)) != NULL;)
 	    if (allocated_device(devp) && subscribed(sub, devp))
 		if ((devp->observed & GPS_TYPEMASK) != 0)
 		    active++;
 	(void)snprintf(reply, replylen,
 		       "{\"class\":\"POLL\",\"time\":\"%s\",\"active\":%d,\"tpv\":[",
 		       unix_to_iso8601(timestamp(), tbuf, sizeof(tbuf)), active);
-	for (devp = devices; devp < devices + MAXDEVICES; devp++) {
+	for (dpi = 0; (devp = next_device(&dpi)) != NULL;) {
 	    if (allocated_device(devp) && subscribed(sub, devp)) {
 		if ((devp->observed & GPS_TYPEMASK) != 0) {
-		    json_tpv_dump(&devp->gpsdata,
-				  reply + strlen(reply),
-				  replylen - strlen(reply));
+		    unsigned int n = depth;
+
+		    if (n > devp->fix_head)
+			n = devp->fix_head;
+		    if (n <= 1)
+			json_tpv_dump(&devp->gpsdata,
+				      reply + strlen(reply),
+				      replylen - strlen(reply));
+		    else {
+			/* oldest first, ending on the current epoch */
+			static struct gps_data_t replay;
+			unsigned int i;
+
+			replay = devp->gpsdata;
+			for (i = devp->fix_head - n;
+			     i != devp->fix_head; i++) {
+			    char tpvbuf[GPS_JSON_RESPONSE_MAX];
+
+			    replay.fix =
+				devp->fix_history[i % FIX_HISTORY_DEPTH];
+			    json_tpv_dump(&replay, tpvbuf, sizeof(tpvbuf));
+			    rstrip(tpvbuf);
+			    if (strlen(reply) + strlen(tpvbuf) + 1
+				>= replylen)
+				break;	/* keep the JSON well-formed */
+			    (void)strlcat(reply, tpvbuf, replylen);
+			    (void)strlcat(reply, ",", replylen);
+			}
+			if (reply[strlen(reply) - 1] == ',')
+			    reply[strlen(reply) - 1] = '\0';
+		    }
 		    rstrip(reply);
 		    (void)strlcat(reply, ",", replylen);
 		}
@@ -1236,7 +1984,7 @@ static void handle_request(struct subscriber_t *sub,
 	if (reply[strlen(reply) - 1] == ',')
 	    reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
 	(void)strlcat(reply, "],\"gst\":[", replylen);
-	for (devp = devices; devp < devices + MAXDEVICES; devp++) {
+	for (dpi = 0; (devp = next_device(&dpi)) != NULL;) {
 	    if (allocated_device(devp) && subscribed(sub, devp)) {
 		if ((devp->observed & GPS_TYPEMASK) != 0) {
 		    json_noise_dump(&devp->gpsdata,
@@ -1250,7 +1998,7 @@ static void handle_request(struct subscriber_t *sub,
 	if (reply[strlen(reply) - 1] == ',')
 	    reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
 	(void)strlcat(reply, "],\"sky\":[", replylen);
-	for (devp = devices; devp < devices + MAXDEVICES; devp++) {
+	for (dpi = 0; (devp = next_device(&dpi)) != NULL;) {
 	    if (allocated_device(devp) && subscribed(sub, devp)) {
 		if ((devp->observed & GPS_TYPEMASK) != 0) {
 		    json_sky_dump(&devp->gpsdata,
@@ -1264,6 +2012,14 @@ static void handle_request(struct subscriber_t *sub,
 	if (reply[strlen(reply) - 1] == ',')
 	    reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
 	(void)strlcat(reply, "]}\r\n", replylen);
+    } else if (strncmp(buf, "STATS;", 6) == 0) {
+	buf += 6;
+#ifdef TIMING_ENABLE
+	json_stats_dump(reply, replylen);
+#else
+	(void)snprintf(reply, replylen,
+		       "{\"class\":\"ERROR\",\"message\":\"STATS requires timing instrumentation\"}\r\n");
+#endif /* TIMING_ENABLE */
     } else if (strncmp(buf, "VERSION;", 8) == 0) {
 	buf += 8;
 	json_version_dump(reply, replylen);
@@ -1318,59 +2074,180 @@ static void raw_report(struct subscriber_t *sub, struct gps_device_t *device)
      * Maybe the user wants a binary packet hexdumped.
      */
     if (sub->policy.raw == 1) {
-	char *hd =
-	    gpsd_hexdump((char *)device->packet.outbuffer,
-			 device->packet.outbuflen);
-	/*
-	 * Ugh...depends on knowing the length of gpsd_hexdump's
-	 * buffer.
-	 */
-	(void)strlcat(hd, "\r\n", MAX_PACKET_LENGTH * 2 + 1);
-	(void)throttled_write(sub, hd, strlen(hd));
+	char hexbuf[MAX_PACKET_LENGTH * 2 + 3];
+	size_t hexlen =
+	    gpsd_hexdump_buf((const char *)device->packet.outbuffer,
+			     device->packet.outbuflen,
+			     hexbuf, sizeof(hexbuf) - 2);
+	hexbuf[hexlen++] = '\r';
+	hexbuf[hexlen++] = '\n';
+	hexbuf[hexlen] = '\0';
+	(void)throttled_write(sub, hexbuf, hexlen);
     }
 #endif /* BINARY_ENABLE */
 }
 
 static void pseudonmea_report(struct subscriber_t *sub,
 			  gps_mask_t changed,
-			  struct gps_device_t *device)
+			  struct gps_device_t *device,
+			  char bufs[][MAX_PACKET_LENGTH * 3 + 2],
+			  bool rendered[])
 /* report pseudo-NMEA in appropriate circumstances */
 {
+    /*
+     * The sentences are identical for every nmea-mode subscriber, so
+     * each flavor is rendered at most once per epoch into the caller's
+     * cache and the same text fanned out to all of them.
+     */
     if (GPS_PACKET_TYPE(device->packet.type)
 	&& !TEXTUAL_PACKET_TYPE(device->packet.type)) {
-	char buf[MAX_PACKET_LENGTH * 3 + 2];
 
 	if ((changed & REPORT_IS) != 0) {
-	    nmea_tpv_dump(device, buf, sizeof(buf));
-	    gpsd_report(LOG_IO, "<= GPS (binary tpv) %s: %s\n",
-			device->gpsdata.dev.path, buf);
-	    (void)throttled_write(sub, buf, strlen(buf));
+	    if (!rendered[0]) {
+		nmea_tpv_dump(device, bufs[0], sizeof(bufs[0]));
+		gpsd_report(LOG_IO, "<= GPS (binary tpv) %s: %s\n",
+			    device->gpsdata.dev.path, bufs[0]);
+		rendered[0] = true;
+	    }
+	    (void)throttled_write(sub, bufs[0], strlen(bufs[0]));
 	}
 
 	if ((changed & SATELLITE_SET) != 0) {
-	    nmea_sky_dump(device, buf, sizeof(buf));
-	    gpsd_report(LOG_IO, "<= GPS (binary sky) %s: %s\n",
-			device->gpsdata.dev.path, buf);
-	    (void)throttled_write(sub, buf, strlen(buf));
+	    if (!rendered[1]) {
+		nmea_sky_dump(device, bufs[1], sizeof(bufs[1]));
+		gpsd_report(LOG_IO, "<= GPS (binary sky) %s: %s\n",
+			    device->gpsdata.dev.path, bufs[1]);
+		rendered[1] = true;
+	    }
+	    (void)throttled_write(sub, bufs[1], strlen(bufs[1]));
 	}
 
 	if ((changed & SUBFRAME_SET) != 0) {
-	    nmea_subframe_dump(device, buf, sizeof(buf));
-	    gpsd_report(LOG_IO, "<= GPS (binary subframe) %s: %s\n",
-			device->gpsdata.dev.path, buf);
-	    (void)throttled_write(sub, buf, strlen(buf));
+	    if (!rendered[2]) {
+		nmea_subframe_dump(device, bufs[2], sizeof(bufs[2]));
+		gpsd_report(LOG_IO, "<= GPS (binary subframe) %s: %s\n",
+			    device->gpsdata.dev.path, bufs[2]);
+		rendered[2] = true;
+	    }
+	    (void)throttled_write(sub, bufs[2], strlen(bufs[2]));
 	}
     }
 }
+
+static void binary_report(struct subscriber_t *sub,
+			  gps_mask_t changed,
+			  struct gps_device_t *device)
+/* ship a versioned packed snapshot of the device state */
+{
+    char frame[sizeof(struct gps_binary_header_t) + sizeof(struct gps_data_t)];
+    struct gps_binary_header_t hdr;
+    size_t length;
+
+    /*
+     * The trailing union is only meaningful (and only worth the wire
+     * space) when one of its occupants was refreshed this cycle.
+     */
+    if ((changed & UNION_SET) != 0)
+	length = GPS_BINARY_FULL_LENGTH(&device->gpsdata);
+    else
+	length = GPS_BINARY_BASE_LENGTH(&device->gpsdata);
+    memcpy(hdr.magic, GPS_BINARY_MAGIC, sizeof(hdr.magic));
+    hdr.version = GPS_BINARY_VERSION;
+    memset(hdr.pad, 0, sizeof(hdr.pad));
+    hdr.length = (unsigned int)length;
+    memcpy(frame, &hdr, sizeof(hdr));
+    memcpy(frame + sizeof(hdr), &device->gpsdata, length);
+    /* the set mask a client sees must be this cycle's change mask */
+    memcpy(frame + sizeof(hdr), &changed, sizeof(changed));
+    (void)throttled_write(sub, frame, sizeof(hdr) + length);
+}
 #endif /* SOCKET_EXPORT_ENABLE */
 
+#define NTRIP_RETRY_MIN	5	/* seconds, initial reconnect holdoff */
+#define NTRIP_RETRY_MAX	300	/* seconds, reconnect holdoff ceiling */
+
+static void ntrip_retry_schedule(struct gps_device_t *device)
+/* back off exponentially so a dead caster can't make us spin */
+{
+    if (device->ntrip.retry_backoff < NTRIP_RETRY_MIN)
+	device->ntrip.retry_backoff = NTRIP_RETRY_MIN;
+    else if (device->ntrip.retry_backoff < NTRIP_RETRY_MAX)
+	device->ntrip.retry_backoff *= 2;
+    if (device->ntrip.retry_backoff > NTRIP_RETRY_MAX)
+	device->ntrip.retry_backoff = NTRIP_RETRY_MAX;
+    device->ntrip.retry_time = timestamp() + device->ntrip.retry_backoff;
+    gpsd_report(LOG_INF, "ntrip reconnect to %s in %d seconds\n",
+		device->gpsdata.dev.path, device->ntrip.retry_backoff);
+}
+
+#define RTCM_HOLDOFF	2.0	/* seconds to back off a congested sink */
+#define RTCM_OUTQ_MAX	4096	/* pending tty bytes beyond which we defer */
+
+static void rtcm_relay(struct gps_device_t *device)
+/* ship the stashed correction to one device, with backpressure */
+{
+    if (device->device_type == NULL
+	|| device->device_type->rtcm_writer == NULL
+	|| device->gpsdata.gps_fd == -1)
+	return;
+    /* a wedged port must not delay corrections to the rest of the pool */
+    if (device->rtcm_deferred > timestamp())
+	return;
+#ifdef TIOCOUTQ
+    {
+	int outq = 0;
+	if (ioctl(device->gpsdata.gps_fd, TIOCOUTQ, &outq) == 0
+	    && outq > RTCM_OUTQ_MAX) {
+	    gpsd_report(LOG_PROG,
+			"%s has %d bytes queued, correction deferred\n",
+			device->gpsdata.dev.path, outq);
+	    device->rtcm_deferred = timestamp() + RTCM_HOLDOFF;
+	    return;
+	}
+    }
+#endif /* TIOCOUTQ */
+    if (device->device_type->rtcm_writer(device,
+					 device->context->rtcmbuf,
+					 device->context->rtcmbytes) == 0) {
+	gpsd_report(LOG_ERROR, "Write to RTCM sink failed\n");
+	device->rtcm_deferred = timestamp() + RTCM_HOLDOFF;
+    } else {
+	device->rtcmtime = timestamp();
+	gpsd_report(LOG_IO, "<= DGPS: %zd bytes of RTCM relayed.\n",
+		    device->context->rtcmbytes);
+    }
+}
+
+static void rtcm_fanout(struct gps_device_t *source)
+/* relay a freshly validated correction to all attached receivers */
+{
+    struct gps_device_t *device;
+    int dpi;
+
+    for (dpi = 0; (device = next_device(&dpi)) != NULL;) {
+	if (!allocated_device(device) || device == source)
+	    continue;
+	rtcm_relay(device);
+    }
+}
+
 static void consume_packets(struct gps_device_t *device)
 /* consume and report packets from a specified device */
 {
     gps_mask_t changed;
     int fragments;
 #ifdef SOCKET_EXPORT_ENABLE
-    struct subscriber_t *sub;
+    struct subscriber_t *sub, *subnext;
+    bool was_batching;
+    /* per-epoch JSON render cache, unscaled and scaled flavors */
+    static char jsonbufs[2][GPS_JSON_RESPONSE_MAX * 4];
+    bool rendered[2];
+    /* per-epoch pseudo-NMEA render cache: tpv, sky, subframe */
+    static char nmeabufs[3][MAX_PACKET_LENGTH * 3 + 2];
+    bool nmea_rendered[3];
+#ifdef TIMING_ENABLE
+    bool json_written;
+#endif /* TIMING_ENABLE */
 #endif /* SOCKET_EXPORT_ENABLE */
 
     gpsd_report(LOG_RAW + 1, "polling %d\n",
@@ -1386,21 +2263,27 @@ static void consume_packets(struct gps_device_t *device)
 
 	/* the socket descriptor might change during connection */
 	if (device->gpsdata.gps_fd != -1) {
-	    FD_CLR(device->gpsdata.gps_fd, &all_fds);
+	    fd_unwatch(device->gpsdata.gps_fd);
 	}
 	(void)ntrip_open(device, "");
 	if (device->ntrip.conn_state == ntrip_conn_err) {
 	    gpsd_report(LOG_WARN,
 		    "connection to ntrip server failed\n");
 	    device->ntrip.conn_state = ntrip_conn_init;
+	    ntrip_retry_schedule(device);
 	    deactivate_device(device);
-	} else {
-	    FD_SET(device->gpsdata.gps_fd, &all_fds);
+	} else if (device->gpsdata.gps_fd != -1) {
+	    fd_watch(device->gpsdata.gps_fd);
 	}
 	return;
     }
 #endif /* NETFEED_ENABLE */
 
+#ifdef SOCKET_EXPORT_ENABLE
+    was_batching = batching;
+    batching = true;
+#endif /* SOCKET_EXPORT_ENABLE */
+
     for (fragments = 0; ; fragments++) {
 	changed = gpsd_poll(device);
 
@@ -1427,9 +2310,14 @@ static void consume_packets(struct gps_device_t *device)
 			device->ntrip.works = false; // reset so we try this once only
 			if (gpsd_activate(device) < 0) {
 			    gpsd_report(LOG_WARN, "reconnect to ntrip server failed\n");
+			    ntrip_retry_schedule(device);
 			} else {
 			    gpsd_report(LOG_INFO, "reconnecting to ntrip server\n");
-			    FD_SET(device->gpsdata.gps_fd, &all_fds);
+#ifdef DEVICE_THREADS_ENABLE
+			    watch_device(device);
+#else
+			    fd_watch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
 			}
 		    }
 		} else {
@@ -1441,8 +2329,9 @@ static void consume_packets(struct gps_device_t *device)
 				"%s will be repolled in %f seconds\n",
 				device->gpsdata.dev.path, DEVICE_REAWAKE);
 		    device->reawake = timestamp() + DEVICE_REAWAKE;
-		    FD_CLR(device->gpsdata.gps_fd, &all_fds);
-		    adjust_max_fd(device->gpsdata.gps_fd, false);
+#ifndef DEVICE_THREADS_ENABLE
+		    fd_unwatch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
 		}
 	    }
 	    /*
@@ -1469,12 +2358,17 @@ static void consume_packets(struct gps_device_t *device)
 			device->gpsdata.dev.path,
 			gps_maskdump(device->gpsdata.set));
 
+#ifdef RAWSPOOL_ENABLE
+	if (context.rawspool_dir != NULL)
+	    rawspool_write(device, (const char *)device->packet.outbuffer,
+			   device->packet.outbuflen);
+#endif /* RAWSPOOL_ENABLE */
+
 #ifdef SOCKET_EXPORT_ENABLE
 	/* add any just-identified device to watcher lists */
 	if ((changed & DRIVER_IS) != 0) {
 	    bool listeners = false;
-	    for (sub = subscribers;
-		 sub < subscribers + MAXSUBSCRIBERS; sub++)
+	    for (sub = active_subs; sub != NULL; sub = sub->next)
 		if (sub->active != 0
 		    && sub->policy.watcher
 		    && subscribed(sub, device))
@@ -1503,12 +2397,24 @@ static void consume_packets(struct gps_device_t *device)
 		gpsd_report(LOG_ERROR,
 			    "overlong RTCM packet (%zd bytes)\n",
 			    device->packet.outbuflen);
+	    } else if ((changed & RTCM3_SET) != 0
+		       && !crc24q_check(device->packet.outbuffer,
+					(int)device->packet.outbuflen)) {
+		/*
+		 * Validate the frame once here rather than letting each
+		 * sink discover the damage; RTCM2 was already parity-
+		 * checked word by word in the ISGPS layer.
+		 */
+		gpsd_report(LOG_ERROR,
+			    "RTCM3 packet with bad CRC discarded\n");
 	    } else {
 		context.rtcmbytes = device->packet.outbuflen;
 		memcpy(context.rtcmbuf,
 		       device->packet.outbuffer,
 		       context.rtcmbytes);
 		context.rtcmtime = timestamp();
+		/* single pass over the pool, no per-sink re-copy of state */
+		rtcm_fanout(device);
 	    }
 	}
 
@@ -1562,31 +2468,86 @@ static void consume_packets(struct gps_device_t *device)
 #ifdef NETFEED_ENABLE
 	    if (device->gpsdata.fix.mode == MODE_3D) {
 		struct gps_device_t *dgnss;
+		int dgi;
 		/*
 		 * Pass the fix to every potential caster, here.
 		 * netgnss_report() individual caster types get to
 		 * make filtering decisiona.
 		 */
-		for (dgnss = devices; dgnss < devices + MAXDEVICES; dgnss++)
+		for (dgi = 0; (dgnss = next_device(&dgi)) != NULL;)
 		    if (dgnss != device)
 			netgnss_report(&context, device, dgnss);
 	    }
 #endif /* NETFEED_ENABLE */
 #if defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S)
 	    if (device->gpsdata.fix.mode > MODE_NO_FIX)
-		send_dbus_fix(device);
+		queue_dbus_fix(device);
 #endif /* defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S) */
 	}
 
 #ifdef SHM_EXPORT_ENABLE
 	if ((changed & (REPORT_IS|GST_SET|SATELLITE_SET|SUBFRAME_SET|
-			ATTITUDE_SET|RTCM2_SET|RTCM3_SET|AIS_SET)) != 0)
+			ATTITUDE_SET|RTCM2_SET|RTCM3_SET|AIS_SET)) != 0) {
+#ifdef RTCM104V3_ENABLE
+	    /* the SHM segment carries the decoded structure */
+	    if ((changed & RTCM3_SET) != 0
+		&& !device->rtcm3_payload_decoded) {
+		rtcm3_unpack(&device->gpsdata.rtcm3,
+			     (char *)device->packet.outbuffer);
+		device->rtcm3_payload_decoded = true;
+	    }
+#endif /* RTCM104V3_ENABLE */
 	    shm_update(&context, &device->gpsdata);
+	}
 #endif /* SHM_EXPORT_ENABLE */
 
 #ifdef SOCKET_EXPORT_ENABLE
+	/* remember the epoch for ?POLL=n backfill */
+	if ((changed & REPORT_IS) != 0
+	    && device->gpsdata.fix.mode > MODE_NO_FIX) {
+	    device->fix_history[device->fix_head % FIX_HISTORY_DEPTH] =
+		device->gpsdata.fix;
+	    device->fix_head++;
+	}
+#endif /* SOCKET_EXPORT_ENABLE */
+
+#ifdef SOCKET_EXPORT_ENABLE
+	/*
+	 * Report rendering is the daemon's hottest code with many
+	 * watchers, and the JSON text depends only on the device state
+	 * and the subscriber's scaled flag.  So render each flavor at
+	 * most once per epoch, on first demand, and fan the same buffer
+	 * out to every matching subscriber.
+	 */
+	jsonbufs[0][0] = jsonbufs[1][0] = '\0';
+	rendered[0] = rendered[1] = false;
+	nmeabufs[0][0] = nmeabufs[1][0] = nmeabufs[2][0] = '\0';
+	nmea_rendered[0] = nmea_rendered[1] = nmea_rendered[2] = false;
+#ifdef TIMING_ENABLE
+	json_written = false;
+#endif /* TIMING_ENABLE */
+
+	/*
+	 * Fleet broadcast: ship the rendered report once to the
+	 * multicast group; the LAN replicates it to any number of
+	 * consumers at no further cost to us.  Shares the unscaled
+	 * render cache with the subscriber fanout below.
+	 */
+	if (mcast_fd != -1 && (changed & DATA_IS) != 0) {
+	    if (!rendered[0]) {
+		json_data_report(changed, &device->gpsdata, &mcast_policy,
+				 jsonbufs[0], sizeof(jsonbufs[0]));
+		rendered[0] = true;
+	    }
+	    if (jsonbufs[0][0] != '\0')
+		(void)sendto(mcast_fd, jsonbufs[0], strlen(jsonbufs[0]), 0,
+			     (struct sockaddr *)&mcast_dest,
+			     (socklen_t)sizeof(mcast_dest));
+	}
+
 	/* update all subscribers associated with this device */
-	for (sub = subscribers; sub < subscribers + MAXSUBSCRIBERS; sub++) {
+	for (sub = active_subs; sub != NULL; sub = subnext) {
+	    subnext = sub->next;	/* writes may detach sub */
 	    /*@-nullderef@*/
 	    if (sub == NULL || sub->active == 0 || !subscribed(sub, device))
 		continue;
@@ -1596,7 +2557,7 @@ static void consume_packets(struct gps_device_t *device)
 	    if ((changed & PASSTHROUGH_IS) != 0) {
 		(void)strlcat((char *)device->packet.outbuffer, 
 			      "\r\n",
-			      sizeof(device->packet.outbuffer));
+			      sizeof(device->packet.outstash));
 		(void)throttled_write(sub, 
 				      (char *)device->packet.outbuffer, 
 				      device->packet.outbuflen+2);
@@ -1609,6 +2570,21 @@ static void consume_packets(struct gps_device_t *device)
 
 	    /* some listeners may be in watcher mode */
 	    if (sub->policy.watcher) {
+		if (sub->policy.interval > 0 && (changed & DATA_IS) != 0) {
+		    /*
+		     * Sampled decimation for low-rate display clients:
+		     * ship at most one report per requested interval,
+		     * except that a fix-mode transition is always
+		     * worth an immediate wakeup.
+		     */
+		    double now = timestamp();
+
+		    if (device->gpsdata.fix.mode == sub->last_mode
+			&& now - sub->last_report < sub->policy.interval)
+			continue;
+		    sub->last_report = (timestamp_t)now;
+		    sub->last_mode = device->gpsdata.fix.mode;
+		}
 		if (changed & DATA_IS) {
 		    /* guard keeps mask dumper from eating CPU */
 		    if (context.debug >= LOG_PROG)
@@ -1620,33 +2596,88 @@ static void consume_packets(struct gps_device_t *device)
 			gpsd_report(LOG_PROG, "time to report a fix\n");
 
 		    if (sub->policy.nmea)
-			pseudonmea_report(sub, changed, device);
+			pseudonmea_report(sub, changed, device,
+					  nmeabufs, nmea_rendered);
+
+		    if (sub->policy.binary)
+			binary_report(sub, changed, device);
 
 		    if (sub->policy.json)
 		    {
-			char buf[GPS_JSON_RESPONSE_MAX * 4];
+			int flavor = sub->policy.scaled ? 1 : 0;
+			char *buf = jsonbufs[flavor];
+#ifdef TIMING_ENABLE
+			double t_rend = 0.0, t_write = 0.0;
+#endif /* TIMING_ENABLE */
 
-			json_data_report(changed,
-					 &device->gpsdata, &sub->policy,
-					 buf, sizeof(buf));
-			if (buf[0] != '\0')
+#ifdef RTCM104V3_ENABLE
+			/*
+			 * RTCM3 frames get only a header-only decode in
+			 * the driver; fill in the report structure the
+			 * first time a watcher actually wants it as JSON.
+			 */
+			if ((changed & RTCM3_SET) != 0
+			    && !device->rtcm3_payload_decoded
+			    && (sub->policy.classmask == 0
+				|| (sub->policy.classmask & RTCM3_SET) != 0)) {
+			    rtcm3_unpack(&device->gpsdata.rtcm3,
+					 (char *)device->packet.outbuffer);
+			    device->rtcm3_payload_decoded = true;
+			}
+#endif /* RTCM104V3_ENABLE */
+			if (sub->policy.classmask != 0 &&
+			    (sub->policy.classmask & WATCH_CLASSES)
+				!= WATCH_CLASSES) {
+			    /*
+			     * This watcher filtered out some report
+			     * classes, so it can't share the cached
+			     * render; give it a private one holding
+			     * only the classes it asked for.  The
+			     * skipped classes cost nothing to format.
+			     */
+			    static char filtbuf[sizeof(jsonbufs[0])];
+
+			    buf = filtbuf;
+			    json_data_report(changed,
+					     &device->gpsdata, &sub->policy,
+					     buf, sizeof(filtbuf));
+			} else if (!rendered[flavor]) {
+			    json_data_report(changed,
+					     &device->gpsdata, &sub->policy,
+					     buf, sizeof(jsonbufs[flavor]));
+			    rendered[flavor] = true;
+			}
+#ifdef TIMING_ENABLE
+			/* JSON now rendered (or pulled from cache) */
+			if (sub->policy.timing)
+			    t_rend = timestamp();
+#endif /* TIMING_ENABLE */
+			if (buf[0] != '\0') {
 			    (void)throttled_write(sub, buf, strlen(buf));
+#ifdef TIMING_ENABLE
+			    json_written = true;
+#endif /* TIMING_ENABLE */
+			}
 
 #ifdef TIMING_ENABLE
 			if (buf[0] != '\0' && sub->policy.timing) {
-			    (void)snprintf(buf, sizeof(buf),
+			    char tbuf[GPS_JSON_RESPONSE_MAX];
+			    t_write = timestamp();
+			    (void)snprintf(tbuf, sizeof(tbuf),
 					   "{\"class\":\"TIMING\","
 					   "\"tag\":\"%s\",\"len\":%d,"
 					   "\"xmit\":%lf,\"recv\":%lf,"
 					   "\"decode\":%lf,"
+					   "\"rend\":%lf,\"write\":%lf,"
 					   "\"emit\":%lf}\r\n",
 					   device->gpsdata.tag,
 					   (int)device->packet.outbuflen,
 					   device->d_xmit_time,
 					   device->d_recv_time,
 					   device->d_decode_time,
+					   t_rend, t_write,
 					   timestamp());
-			    (void)throttled_write(sub, buf, strlen(buf));
+			    (void)throttled_write(sub, tbuf, strlen(tbuf));
 			}
 #endif /* TIMING_ENABLE */
 		    }
@@ -1654,15 +2685,44 @@ static void consume_packets(struct gps_device_t *device)
 	    }
 	    /*@+nullderef@*/
 	} /* subscribers */
+
+#ifdef TIMING_ENABLE
+	/* one latency sample per accepted packet that reached a client */
+	if (json_written)
+	    record_latency(device);
+#endif /* TIMING_ENABLE */
 #endif /* SOCKET_EXPORT_ENABLE */
     }
+
+#if defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S)
+    /* one signal carries all the fixes this pass queued */
+    flush_dbus_fixes();
+#endif /* defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S) */
+
+#ifdef SOCKET_EXPORT_ENABLE
+    /*
+     * One flush per client pushes out the whole epoch's reports -- but
+     * when the main loop is already batching the dispatch pass, leave
+     * the queues to its end-of-iteration flush so notifications from
+     * several devices coalesce too.
+     */
+    if (!was_batching) {
+	batching = false;
+	for (sub = active_subs; sub != NULL; sub = subnext) {
+	    subnext = sub->next;	/* the flush may detach sub */
+	    if (sub->active != 0)
+		flush_subscriber(sub);
+	}
+    }
+#endif /* SOCKET_EXPORT_ENABLE */
 }
 
 #ifdef SOCKET_EXPORT_ENABLE
 static int handle_gpsd_request(struct subscriber_t *sub, const char *buf)
 /* execute GPSD requests from a buffer */
 {
-    char reply[GPS_JSON_RESPONSE_MAX + 1];
+    /* sized so a full ?POLL=n backfill fits without truncation */
+    static char reply[GPS_JSON_RESPONSE_MAX * 4 + 1];
 
     reply[0] = '\0';
     if (buf[0] == '?') {
@@ -1695,57 +2755,126 @@ static int srvcmp(const void *s, const void *t)
     return (int)(((const struct dgps_server_t *)s)->dist - ((const struct dgps_server_t *)t)->dist);	/* fixes: warning: cast discards qualifiers from pointer target type */
 }
 
+/*
+ * The ranked result is persisted beside the server list, keyed by the
+ * fix position.  Parsing and ranking thousands of list lines falls in
+ * the time-to-first-correction window, and the ranking only changes
+ * when the receiver has moved materially - so a restart in the same
+ * place costs a cache hit instead.
+ */
+#define DGPS_CACHE_MOVE	0.5	/* deg; re-rank when the fix moves this far */
+
+static bool netgnss_ranking_read(const char *cachepath,
+				 double lat, double lon,
+				 struct dgps_server_t keep[], int n)
+/* load a previously ranked server set, if it's for (almost) here */
+{
+    double clat, clon;
+    char buf[BUFSIZ];
+    int i;
+    FILE *cfp = fopen(cachepath, "r");
+
+    if (cfp == NULL)
+	return false;
+    if (fgets(buf, (int)sizeof(buf), cfp) == NULL
+	|| sscanf(buf, "%lf %lf", &clat, &clon) != 2
+	|| fabs(clat - lat) > DGPS_CACHE_MOVE
+	|| fabs(clon - lon) > DGPS_CACHE_MOVE) {
+	(void)fclose(cfp);
+	return false;
+    }
+    for (i = 0; i < n; i++) {
+	keep[i].dist = DGPS_THRESHOLD;
+	keep[i].server[0] = '\0';
+    }
+    i = 0;
+    while (i < n && fgets(buf, (int)sizeof(buf), cfp))
+	if (sscanf(buf, "%lf %lf %256s %lf",
+		   &keep[i].lat, &keep[i].lon, keep[i].server,
+		   &keep[i].dist) == 4)
+	    i++;
+    (void)fclose(cfp);
+    if (i > 0)
+	gpsd_report(LOG_INF, "using cached DGPS server ranking (%d entries)\n",
+		    i);
+    return i > 0;
+}
+
+static void netgnss_ranking_write(const char *cachepath,
+				  double lat, double lon,
+				  struct dgps_server_t keep[], int n)
+/* persist the ranked server set for the next startup here */
+{
+    int i;
+    FILE *cfp = fopen(cachepath, "w");
+
+    if (cfp == NULL)
+	return;
+    (void)fprintf(cfp, "%f %f\n", lat, lon);
+    for (i = 0; i < n; i++)
+	if (keep[i].server[0] != '\0')
+	    (void)fprintf(cfp, "%f %f %s %f\n",
+			  keep[i].lat, keep[i].lon, keep[i].server,
+			  keep[i].dist);
+    (void)fclose(cfp);
+}
+
 static void netgnss_autoconnect(struct gps_context_t *context,
 			double lat, double lon, const char *serverlist)
 /* tell the library to talk to the nearest DGPSIP server */
 {
     struct dgps_server_t keep[SERVER_SAMPLE], hold, *sp, *tp;
-    char buf[BUFSIZ];
-    FILE *sfp = fopen(serverlist, "r");
+    char buf[BUFSIZ], cachepath[GPS_PATH_MAX];
+    FILE *sfp;
+
+    (void)snprintf(cachepath, sizeof(cachepath), "%s.cache", serverlist);
+    if (!netgnss_ranking_read(cachepath, lat, lon, keep, SERVER_SAMPLE)) {
+	sfp = fopen(serverlist, "r");
+	if (sfp == NULL) {
+	    gpsd_report(LOG_ERROR, "no DGPS server list found.\n");
+	    return;
+	}
 
-    if (sfp == NULL) {
-	gpsd_report(LOG_ERROR, "no DGPS server list found.\n");
-	return;
-    }
+	for (sp = keep; sp < keep + SERVER_SAMPLE; sp++) {
+	    sp->dist = DGPS_THRESHOLD;
+	    sp->server[0] = '\0';
+	}
+	/*@ -usedef @*/
+	while (fgets(buf, (int)sizeof(buf), sfp)) {
+	    char *cp = strchr(buf, '#');
+	    if (cp != NULL)
+		*cp = '\0';
+	    if (sscanf(buf, "%lf %lf %256s", &hold.lat, &hold.lon, hold.server) ==
+		3) {
+		hold.dist = earth_distance_fast(lat, lon, hold.lat, hold.lon);
+		tp = NULL;
+		/*
+		 * The idea here is to look for a server in the sample array
+		 * that is (a) closer than the one we're checking, and (b)
+		 * furtherest away of all those that are closer.  Replace it.
+		 * In this way we end up with the closest possible set.
+		 */
+		for (sp = keep; sp < keep + SERVER_SAMPLE; sp++)
+		    if (hold.dist < sp->dist
+			&& (tp == NULL || hold.dist > tp->dist))
+			tp = sp;
+		if (tp != NULL)
+		    memcpy(tp, &hold, sizeof(struct dgps_server_t));
+	    }
+	}
+	(void)fclose(sfp);
 
-    for (sp = keep; sp < keep + SERVER_SAMPLE; sp++) {
-	sp->dist = DGPS_THRESHOLD;
-	sp->server[0] = '\0';
-    }
-    /*@ -usedef @*/
-    while (fgets(buf, (int)sizeof(buf), sfp)) {
-	char *cp = strchr(buf, '#');
-	if (cp != NULL)
-	    *cp = '\0';
-	if (sscanf(buf, "%lf %lf %256s", &hold.lat, &hold.lon, hold.server) ==
-	    3) {
-	    hold.dist = earth_distance(lat, lon, hold.lat, hold.lon);
-	    tp = NULL;
-	    /*
-	     * The idea here is to look for a server in the sample array
-	     * that is (a) closer than the one we're checking, and (b)
-	     * furtherest away of all those that are closer.  Replace it.
-	     * In this way we end up with the closest possible set.
-	     */
-	    for (sp = keep; sp < keep + SERVER_SAMPLE; sp++)
-		if (hold.dist < sp->dist
-		    && (tp == NULL || hold.dist > tp->dist))
-		    tp = sp;
-	    if (tp != NULL)
-		memcpy(tp, &hold, sizeof(struct dgps_server_t));
+	if (keep[0].server[0] == '\0') {
+	    gpsd_report(LOG_ERROR, "no DGPS servers within %dm.\n",
+			(int)(DGPS_THRESHOLD / 1000));
+	    return;
 	}
-    }
-    (void)fclose(sfp);
+	/*@ +usedef @*/
 
-    if (keep[0].server[0] == '\0') {
-	gpsd_report(LOG_ERROR, "no DGPS servers within %dm.\n",
-		    (int)(DGPS_THRESHOLD / 1000));
-	return;
+	/* sort them and try the closest first */
+	qsort((void *)keep, SERVER_SAMPLE, sizeof(struct dgps_server_t), srvcmp);
+	netgnss_ranking_write(cachepath, lat, lon, keep, SERVER_SAMPLE);
     }
-    /*@ +usedef @*/
-
-    /* sort them and try the closest first */
-    qsort((void *)keep, SERVER_SAMPLE, sizeof(struct dgps_server_t), srvcmp);
     for (sp = keep; sp < keep + SERVER_SAMPLE; sp++) {
 	if (sp->server[0] != '\0') {
 	    gpsd_report(LOG_INF, "%s is %dkm away.\n", sp->server,
@@ -1763,7 +2892,7 @@ int main(int argc, char *argv[])
     /* some of these statics suppress -W warnings due to longjmp() */
 #ifdef SOCKET_EXPORT_ENABLE
     static char *gpsd_service = NULL;	/* this static pacifies splint */
-    struct subscriber_t *sub;
+    struct subscriber_t *sub, *subnext;
 #endif /* SOCKET_EXPORT_ENABLE */
 #ifdef CONTROL_SOCKET_ENABLE
     static int csock = -1;
@@ -1775,9 +2904,10 @@ int main(int argc, char *argv[])
     sockaddr_t fsin;
 #endif /* defined(SOCKET_EXPORT_ENABLE) || defined(CONTROL_SOCKET_ENABLE) */
     static char *pid_file = NULL;
+    static double start_time;
     struct gps_device_t *device;
     fd_set rfds;
-    int i, option, msocks[2], dfd;
+    int i, option, msocks[2], dfd, dpi;
     bool go_background = true;
     struct timeval tv;
     const struct gps_type_t **dp;
@@ -1789,10 +2919,23 @@ int main(int argc, char *argv[])
 #endif /* PPS_ENABLE */
 
     (void)setlocale(LC_NUMERIC, "C");
+    start_time = timestamp();
     context.debug = 0;
     gps_context_init(&context);
-    while ((option = getopt(argc, argv, "F:D:S:bGhlNnP:V")) != -1) {
+    while ((option = getopt(argc, argv, "aF:D:M:S:bGhlNnP:r:V")) != -1) {
 	switch (option) {
+	case 'a':
+	    /* defer speed-settle delays so activation can't stall the
+	     * select loop; experimental, hence not the default */
+	    context.async_settle = true;
+	    break;
+	case 'M':
+#ifdef SOCKET_EXPORT_ENABLE
+	    mcast_fd = mcast_open(optarg);
+	    if (mcast_fd == -1)
+		exit(1);
+#endif /* SOCKET_EXPORT_ENABLE */
+	    break;
 	case 'D':
 	    context.debug = (int)strtol(optarg, 0, 0);
 #ifdef CLIENTDEBUG_ENABLE
@@ -1842,6 +2985,14 @@ int main(int argc, char *argv[])
 	    nowait = true;
 #endif /* FORCE_NOWAIT */
 	    break;
+	case 'r':
+#ifdef RAWSPOOL_ENABLE
+	    context.rawspool_dir = optarg;
+#else
+	    gpsd_report(LOG_WARN,
+			"-r ignored, raw spooling not compiled in\n");
+#endif /* RAWSPOOL_ENABLE */
+	    break;
 	case 'P':
 	    pid_file = optarg;
 	    break;
@@ -1882,6 +3033,9 @@ int main(int argc, char *argv[])
 	exit(1);
     }
 
+    /* must be up before anything calls fd_watch() */
+    fd_monitor_init();
+
     /*
      * Control socket has to be created before we go background in order to
      * avoid a race condition in which hotplug scripts can try opening
@@ -1890,8 +3044,7 @@ int main(int argc, char *argv[])
 #ifdef SYSTEMD_ENABLE
     if (sd_socket_count > 0) {
         csock = SD_SOCKET_FDS_START;
-        FD_SET(csock, &all_fds);
-        adjust_max_fd(csock, true);
+        fd_watch(csock);
     }
 #endif
 #ifdef CONTROL_SOCKET_ENABLE
@@ -1905,8 +3058,7 @@ int main(int argc, char *argv[])
 	} else
 	    gpsd_report(LOG_SPIN, "control socket %s is fd %d\n",
 			control_socket, csock);
-	FD_SET(csock, &all_fds);
-	adjust_max_fd(csock, true);
+	fd_watch(csock);
 	gpsd_report(LOG_PROG, "control socket opened at %s\n",
 		    control_socket);
     }
@@ -1928,6 +3080,11 @@ int main(int argc, char *argv[])
 	    gpsd_report(LOG_ERROR,"demonization failed: %s\n",strerror(errno));
     }
 
+#if !defined(SQUELCH_ENABLE) && defined(ASYNC_LOG_ENABLE)
+    /* after the fork, so the drain thread lives in the daemon process */
+    log_thread_start();
+#endif /* ASYNC_LOG_ENABLE */
+
     if (pid_file) {
 	FILE *fp;
 
@@ -2030,16 +3187,19 @@ int main(int argc, char *argv[])
     gpsd_report(LOG_INF, "running with effective user ID %d\n", geteuid());
 
 #ifdef SOCKET_EXPORT_ENABLE
-    for (i = 0; i < NITEMS(subscribers); i++)
+    for (i = 0; i < NITEMS(subscribers); i++) {
 	subscribers[i].fd = UNALLOCATED_FD;
+	subscribers[i].next = free_subs;
+	free_subs = &subscribers[i];
+    }
 #endif /* SOCKET_EXPORT_ENABLE*/
 
     /* daemon got termination or interrupt signal */
     if (setjmp(restartbuf) > 0) {
 	/* try to undo all device configurations */
 	for (dfd = 0; dfd < MAXDEVICES; dfd++) {
-	    if (allocated_device(&devices[dfd]))
-		(void)gpsd_wrap(&devices[dfd]);
+	    if (allocated_device(devices[dfd]))
+		(void)gpsd_wrap(devices[dfd]);
 	}
 	gpsd_report(LOG_WARN, "gpsd restarted by SIGHUP\n");
     }
@@ -2054,8 +3214,7 @@ int main(int argc, char *argv[])
 
     for (i = 0; i < AFCOUNT; i++)
 	if (msocks[i] >= 0) {
-	    FD_SET(msocks[i], &all_fds);
-	    adjust_max_fd(msocks[i], true);
+	    fd_watch(msocks[i]);
 	}
 #ifdef CONTROL_SOCKET_ENABLE
     FD_ZERO(&control_fds);
@@ -2064,8 +3223,17 @@ int main(int argc, char *argv[])
     /* initialize the GPS context's time fields */
     gpsd_time_init(&context, time(NULL));
 
+    /*
+     * The hotplug flow spawns us on first device insert, so time from
+     * exec to a listening control interface is on the critical path.
+     * Stamp it before device opens, which can block on slow serial
+     * hardware and aren't part of the readiness budget.
+     */
+    gpsd_report(LOG_INF, "ready to accept commands %.3f sec after launch\n",
+		timestamp() - start_time);
+
     for (i = optind; i < argc; i++) {
-	if (!add_device(argv[i])) {
+	if (!add_device(argv[i], false)) {
 	    gpsd_report(LOG_ERROR,
 			"GPS device %s open failed\n",
 			argv[i]);
@@ -2073,29 +3241,41 @@ int main(int argc, char *argv[])
     }
 
     while (0 == signalled) {
-	(void)memcpy((char *)&rfds, (char *)&all_fds, sizeof(rfds));
-
-	gpsd_report(LOG_RAW + 2, "select waits\n");
+	gpsd_report(LOG_RAW + 2, "fd_monitor_wait() waits\n");
 	/*
 	 * Poll for user commands or GPS data.  The timeout doesn't
-	 * actually matter here since select returns whenever one of
-	 * the file descriptors in the set goes ready.  The point
+	 * actually matter here since fd_monitor_wait() returns whenever
+	 * one of the monitored file descriptors goes ready.  The point
 	 * of tracking maxfd is to keep the set of descriptors that
-	 * select(2) has to poll here as small as possible (for
-	 * low-clock-rate SBCs and the like).
+	 * the select(2) backend has to poll here as small as possible
+	 * (for low-clock-rate SBCs and the like).
 	 */
 	/*@ -usedef @*/
 	tv.tv_sec = 1;
 	tv.tv_usec = 0;
 	errno = 0;
-	if (select(maxfd + 1, &rfds, NULL, NULL, &tv) == -1) {
+	if (fd_monitor_wait(&rfds, &tv) == -1) {
 	    if (errno == EINTR)
 		continue;
-	    gpsd_report(LOG_ERROR, "select: %s\n", strerror(errno));
+	    gpsd_report(LOG_ERROR, "fd_monitor_wait: %s\n", strerror(errno));
 	    exit(2);
 	}
 	/*@ +usedef @*/
 
+	/* serialize against the per-device service threads */
+	report_lock();
+
+#ifdef SOCKET_EXPORT_ENABLE
+	/*
+	 * Coalesce everything generated in this dispatch pass -- DEVICE
+	 * and WATCH notifications from a hotplug storm, command replies,
+	 * report fanout -- into a single flush per client at the bottom
+	 * of the loop.  A USB hub reset used to trigger one write per
+	 * notification per watcher.
+	 */
+	batching = true;
+#endif /* SOCKET_EXPORT_ENABLE */
+
 	if (context.debug >= LOG_SPIN) {
 	    char dbuf[BUFSIZ];
 	    dbuf[0] = '\0';
@@ -2151,8 +3331,19 @@ int main(int argc, char *argv[])
 			(void)close(ssock);
 		    } else {
 			char announce[GPS_JSON_RESPONSE_MAX];
-			FD_SET(ssock, &all_fds);
-			adjust_max_fd(ssock, true);
+			int one = 1;
+
+			/*
+			 * The per-epoch batching means each client gets
+			 * at most one writev() per cycle, so there is
+			 * nothing for Nagle to coalesce - it would only
+			 * add up to 40ms of delay per report.
+			 */
+			if (setsockopt(ssock, IPPROTO_TCP, TCP_NODELAY,
+				       (char *)&one, sizeof(one)) == -1)
+			    gpsd_report(LOG_ERROR,
+					"Error: SETSOCKOPT TCP_NODELAY\n");
+			fd_watch(ssock);
 			client->fd = ssock;
 			client->active = timestamp();
 			gpsd_report(LOG_SPIN,
@@ -2181,9 +3372,8 @@ int main(int argc, char *argv[])
 	    else {
 		gpsd_report(LOG_INF, "control socket connect on fd %d\n",
 			    ssock);
-		FD_SET(ssock, &all_fds);
+		fd_watch(ssock);
 		FD_SET(ssock, &control_fds);
-		adjust_max_fd(ssock, true);
 	    }
 	    FD_CLR(csock, &rfds);
 	}
@@ -2192,49 +3382,99 @@ int main(int argc, char *argv[])
 	for (cfd = 0; cfd < FD_SETSIZE; cfd++)
 	    if (FD_ISSET(cfd, &control_fds)) {
 		char buf[BUFSIZ];
+		size_t filled = 0;
+		ssize_t rd;
+
+		while ((rd = read(cfd, buf + filled,
+				  sizeof(buf) - 1 - filled)) > 0) {
+		    char *bufp, *eol;
 
-		while (read(cfd, buf, sizeof(buf) - 1) > 0) {
+		    filled += (size_t)rd;
+		    buf[filled] = '\0';
+		    /*
+		     * A hotplug storm delivers a burst of
+		     * newline-separated commands on one connection;
+		     * handle each of them, holding back a trailing
+		     * partial line for the next read.
+		     */
+		    for (bufp = buf; (eol = strchr(bufp, '\n')) != NULL;
+			 bufp = eol) {
+			*eol++ = '\0';
+			if (*bufp != '\0') {
+			    gpsd_report(LOG_IO, "<= control(%d): %s\n",
+					cfd, bufp);
+			    handle_control(cfd, bufp);
+			}
+		    }
+		    filled = strlen(bufp);
+		    (void)memmove(buf, bufp, filled + 1);
+		    if (filled >= sizeof(buf) - 1)
+			filled = 0;	/* oversized command; drop it */
+		}
+		if (filled > 0) {
+		    /* last command arrived without a trailing newline */
 		    gpsd_report(LOG_IO, "<= control(%d): %s\n", cfd, buf);
 		    handle_control(cfd, buf);
 		}
 		gpsd_report(LOG_SPIN, "close(%d) of control socket\n", cfd);
 		(void)close(cfd);
-		FD_CLR(cfd, &all_fds);
+		fd_unwatch(cfd);
 		FD_CLR(cfd, &control_fds);
-		adjust_max_fd(cfd, false);
 	    }
 #endif /* CONTROL_SOCKET_ENABLE */
 
 	/* poll all active devices */
-	for (device = devices; device < devices + MAXDEVICES; device++) {
+	for (dpi = 0; (device = next_device(&dpi)) != NULL;) {
 	    if (!allocated_device(device))
 		continue;
 
-/* *INDENT-OFF* */
-	    /* pass the current RTCM correction to the GPS if new */
-	    if (device->device_type != NULL) {
-		if (device->gpsdata.gps_fd != -1
-		    && device->context->rtcmbytes > 0
-		    && device->rtcmtime < device->context->rtcmtime
-		    && device->device_type->rtcm_writer != NULL) {
-		    if (device->device_type->rtcm_writer(device,
-							  device->context->rtcmbuf,
-							  device->context->rtcmbytes) ==
-			0)
-			gpsd_report(LOG_ERROR, "Write to RTCM sink failed\n");
+	    /*
+	     * Catch-up pass for the current RTCM correction: devices
+	     * that missed the fan-out (activated late, or deferred by
+	     * backpressure) pick it up here.
+	     */
+	    if (device->context->rtcmbytes > 0
+		&& device->rtcmtime < device->context->rtcmtime)
+		rtcm_relay(device);
+
+#ifdef NETFEED_ENABLE
+	    if (device->servicetype == service_ntrip) {
+		if (device->gpsdata.gps_fd >= 0
+		    && (device->ntrip.conn_state == ntrip_conn_connecting_probe
+			|| device->ntrip.conn_state == ntrip_conn_connecting_get)) {
+		    /*
+		     * A connect in progress signals completion by becoming
+		     * writable, which we don't watch for; nudge the state
+		     * machine from the timer tick instead.
+		     */
+		    consume_packets(device);
+		    continue;
+		}
+		if (device->gpsdata.gps_fd < 0
+		    && device->ntrip.retry_time > 0
+		    && timestamp() >= device->ntrip.retry_time) {
+		    device->ntrip.retry_time = (timestamp_t)0;
+		    gpsd_report(LOG_INF, "retrying ntrip caster %s\n",
+				device->gpsdata.dev.path);
+		    if (gpsd_activate(device) < 0)
+			ntrip_retry_schedule(device);
 		    else {
-			device->rtcmtime = timestamp();
-			gpsd_report(LOG_IO, "<= DGPS: %zd bytes of RTCM relayed.\n",
-				    device->context->rtcmbytes);
+#ifdef DEVICE_THREADS_ENABLE
+			watch_device(device);
+#else
+			fd_watch(device->gpsdata.gps_fd);
+#endif /* DEVICE_THREADS_ENABLE */
 		    }
+		    continue;
 		}
 	    }
-/* *INDENT-ON* */
+#endif /* NETFEED_ENABLE */
 
 	    if (device->gpsdata.gps_fd >= 0) {
 		if (FD_ISSET(device->gpsdata.gps_fd, &rfds))
 		    /* get data from the device */
 		    consume_packets(device);
+#ifndef DEVICE_THREADS_ENABLE
 	        else if (device->reawake>0 && timestamp()>device->reawake) {
 		    /* device may have had a zero-length read */
 		    gpsd_report(LOG_DATA,
@@ -2242,15 +3482,20 @@ int main(int argc, char *argv[])
 				device->gpsdata.dev.path);
 		    device->reawake = (timestamp_t)0;
 		    device->zerokill = true;
-		    FD_SET(device->gpsdata.gps_fd, &all_fds);
-		    adjust_max_fd(device->gpsdata.gps_fd, true);
+		    fd_watch(device->gpsdata.gps_fd);
 		}
+#endif /* DEVICE_THREADS_ENABLE */
 	    }
 	} /* devices */
 
+#ifdef NTPSHM_ENABLE
+	/* drain staged time samples into the NTP SHM segments */
+	ntpshm_flush(&context);
+#endif /* NTPSHM_ENABLE */
+
 #ifdef __UNUSED_AUTOCONNECT__
 	if (context.fixcnt > 0 && !context.autconnect) {
-	    for (device = devices; device < devices + MAXDEVICES; device++) {
+	    for (dpi = 0; (device = next_device(&dpi)) != NULL;) {
 		if (device->gpsdata.fix.mode > MODE_NO_FIX) {
 		    netgnss_autoconnect(&context,
 					device->gpsdata.fix.latitude,
@@ -2264,7 +3509,8 @@ int main(int argc, char *argv[])
 
 #ifdef SOCKET_EXPORT_ENABLE
 	/* accept and execute commands for all clients */
-	for (sub = subscribers; sub < subscribers + MAXSUBSCRIBERS; sub++) {
+	for (sub = active_subs; sub != NULL; sub = subnext) {
+	    subnext = sub->next;	/* command handling may detach sub */
 	    if (sub->active == 0)
 		continue;
 
@@ -2313,7 +3559,7 @@ int main(int argc, char *argv[])
 	 * Re-poll devices that are disconnected, but have potential
 	 * subscribers in the same cycle.
 	 */
-	for (device = devices; device < devices + MAXDEVICES; device++) {
+	for (dpi = 0; (device = next_device(&dpi)) != NULL;) {
 #ifdef FORCE_NOWAIT
 	    bool device_needed = true;
 #else
@@ -2324,7 +3570,7 @@ int main(int argc, char *argv[])
 		continue;
 
 	    if (!device_needed)
-		for (sub=subscribers; sub<subscribers+MAXSUBSCRIBERS; sub++) {
+		for (sub = active_subs; sub != NULL; sub = sub->next) {
 		    if (sub->active == 0)
 			continue;
 		    device_needed = subscribed(sub, device);
@@ -2337,12 +3583,12 @@ int main(int argc, char *argv[])
 		if (device->releasetime == 0) {
 		    device->releasetime = timestamp();
 		    gpsd_report(LOG_PROG, "device %d (fd %d) released\n",
-			(int)(device - devices),
+			device_index(device),
 			device->gpsdata.gps_fd);
 		} else if (timestamp() - device->releasetime >
 			RELEASE_TIMEOUT) {
 		    gpsd_report(LOG_PROG, "device %d closed\n",
-			(int)(device - devices));
+			device_index(device));
 		    gpsd_report(LOG_RAW, "unflagging descriptor %d\n",
 			device->gpsdata.gps_fd);
 		    deactivate_device(device);
@@ -2354,11 +3600,20 @@ int main(int argc, char *argv[])
 		    timestamp() - device->opentime > DEVICE_RECONNECT)) {
 		device->opentime = timestamp();
 		gpsd_report(LOG_INF, "reconnection attempt on device %d\n",
-		    (int)(device - devices));
+		    device_index(device));
 		(void)awaken(device);
 	    }
 	}
+
+	batching = false;
+	for (sub = active_subs; sub != NULL; sub = subnext) {
+	    subnext = sub->next;	/* the flush may detach sub */
+	    if (sub->active != 0)
+		flush_subscriber(sub);
+	}
 #endif /* SOCKET_EXPORT_ENABLE */
+
+	report_unlock();
     }
 
     /* if we make it here, we got a signal... deal with it */
@@ -2370,8 +3625,8 @@ int main(int argc, char *argv[])
 
     /* try to undo all device configurations */
     for (dfd = 0; dfd < MAXDEVICES; dfd++) {
-	if (allocated_device(&devices[dfd]))
-	    (void)gpsd_wrap(&devices[dfd]);
+	if (allocated_device(devices[dfd]))
+	    (void)gpsd_wrap(devices[dfd]);
     }
 
     gpsd_report(LOG_WARN, "exiting.\n");
@@ -2383,7 +3638,8 @@ int main(int argc, char *argv[])
      * This is an attempt to avoid the sporadic race errors at the ends
      * of our regression tests.
      */
-    for (sub = subscribers; sub < subscribers + MAXSUBSCRIBERS; sub++) {
+    for (sub = active_subs; sub != NULL; sub = subnext) {
+	subnext = sub->next;	/* detaching moves sub off this list */
 	if (sub->active != 0)
 	    detach_client(sub);
     }
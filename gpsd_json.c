@@ -14,7 +14,9 @@ PERMISSIONS
 
 ***************************************************************************/
 
+#include <stddef.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <math.h>
 #include <assert.h>
 #include <string.h>
@@ -66,7 +68,29 @@ char *json_stringify( /*@out@*/ char *to,
      * each character to generate an up to 6-character Java-style
      * escape
      */
-    for (sp = from; *sp != '\0' && ((tp - to) < ((int)len - 6)); sp++) {
+    sp = from;
+    while (*sp != '\0' && ((tp - to) < ((int)len - 6))) {
+	/*
+	 * Fast path: almost everything we stringify (device paths,
+	 * driver names, NMEA tags) needs no escaping at all, so
+	 * bulk-copy the run of clean characters instead of testing
+	 * them one at a time.  A NUL always ends the run because
+	 * iscntrl() catches it.
+	 */
+	size_t avail = (size_t)(((int)len - 6) - (tp - to));
+	size_t run = 0;
+
+	while (run < avail
+	       && isascii((unsigned char)sp[run])
+	       && !iscntrl((unsigned char)sp[run])
+	       && sp[run] != '"' && sp[run] != '\\')
+	    run++;
+	if (run > 0) {
+	    memcpy(tp, sp, run);
+	    tp += run;
+	    sp += run;
+	    continue;
+	}
 	if (!isascii((unsigned char) *sp) || iscntrl((unsigned char) *sp)) {
 	    *tp++ = '\\';
 	    switch (*sp) {
@@ -94,10 +118,11 @@ char *json_stringify( /*@out@*/ char *to,
 		tp += strlen(tp);
 	    }
 	} else {
-	    if (*sp == '"' || *sp == '\\')
-		*tp++ = '\\';
+	    /* only '"' and '\\' reach here; clean runs were copied above */
+	    *tp++ = '\\';
 	    *tp++ = *sp;
 	}
+	sp++;
     }
     *tp = '\0';
 
@@ -105,18 +130,217 @@ char *json_stringify( /*@out@*/ char *to,
     /*@+temptrans@*/
 }
 
+static /*@null@*/ char *json_format_fixed(/*@out@*/ char numbuf[32],
+					  double value, int prec)
+/* render value with prec fixed decimal places; NULL if libc must do it */
+{
+    static const double pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    };
+    char *cp = numbuf + 32;
+    double scaled = fabs(value) * pow10[prec];
+    double eps = scaled * 1e-15 + 1e-9;
+    unsigned long long units;
+    int i;
+
+    /*
+     * Fixed-point rendering of a known, small precision is much cheaper
+     * than the general binary-to-decimal conversion inside libc's %f.
+     * The one multiply can disagree with correctly rounded output when
+     * the scaled value sits on a rounding tie (x.5), and can't cover
+     * huge or non-finite values at all; make the caller hand those rare
+     * cases back to libc so the output stays bit-identical with %.*f.
+     */
+    if (!(scaled < 9e15) || fabs(scaled - floor(scaled) - 0.5) <= eps)
+	return NULL;
+    units = (unsigned long long)(scaled + 0.5);
+    *--cp = '\0';
+    for (i = 0; i < prec; i++) {
+	*--cp = (char)('0' + (int)(units % 10));
+	units /= 10;
+    }
+    if (prec > 0)
+	*--cp = '.';
+    do {
+	*--cp = (char)('0' + (int)(units % 10));
+	units /= 10;
+    } while (units > 0);
+    if (signbit(value) != 0)
+	*--cp = '-';
+    return cp;
+}
+
+/*
+ * Cursor-based append primitives for the dump functions.  The old
+ * snprintf/strlcat append style rescanned the output with strlen for
+ * every attribute, which goes quadratic on multi-KB SKY, RTCM3 and
+ * AIS reports; the writer carries the cursor instead.  Truncation
+ * behavior matches the old appends: output is silently cut at the
+ * buffer end and always NUL-terminated.
+ */
+struct json_writer_t {
+    char *cur;			/* next byte to be written */
+    char *end;			/* last usable byte + 1 (the NUL slot) */
+};
+
+static void json_wr_init(struct json_writer_t *wr, char *buf, size_t buflen)
+{
+    wr->cur = buf;
+    wr->end = buf + buflen - 1;
+    buf[0] = '\0';
+}
+
+static void json_wr_puts(struct json_writer_t *wr, const char *s)
+{
+    while (*s != '\0' && wr->cur < wr->end)
+	*wr->cur++ = *s++;
+    *wr->cur = '\0';
+}
+
+__attribute__((__format__(__printf__, 2, 3)))
+static void json_wr_printf(struct json_writer_t *wr, const char *fmt, ...)
+{
+    size_t space = (size_t)(wr->end - wr->cur) + 1;
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(wr->cur, space, fmt, ap);
+    va_end(ap);
+    if (n > 0)
+	wr->cur += ((size_t)n < space) ? (size_t)n : space - 1;
+}
+
+static void json_wr_trim(struct json_writer_t *wr, char c)
+/* drop a trailing instance of c (usually a separating comma) */
+{
+    if (wr->cur[-1] == c)
+	*--wr->cur = '\0';
+}
+
+static void json_wr_fixed(struct json_writer_t *wr,
+			  const char *attr, double value, int prec)
+/* append "attr":value, rendering value with prec fixed decimal places */
+{
+    char numbuf[32];
+    char *cp = json_format_fixed(numbuf, value, prec);
+
+    if (cp == NULL)
+	json_wr_printf(wr, "\"%s\":%.*f,", attr, prec, value);
+    else
+	json_wr_printf(wr, "\"%s\":%s,", attr, cp);
+}
+
+static void json_wr_uint(struct json_writer_t *wr, unsigned long value)
+/* append an unsigned decimal integer */
+{
+    char numbuf[24];
+    char *cp = numbuf + sizeof(numbuf);
+
+    *--cp = '\0';
+    do {
+	*--cp = (char)('0' + (int)(value % 10));
+	value /= 10;
+    } while (value > 0);
+    json_wr_puts(wr, cp);
+}
+
+static void json_wr_int(struct json_writer_t *wr, long value)
+/* append a signed decimal integer */
+{
+    if (value < 0) {
+	json_wr_puts(wr, "-");
+	json_wr_uint(wr, (unsigned long)(-value));
+    } else
+	json_wr_uint(wr, (unsigned long)value);
+}
+
 void json_version_dump( /*@out@*/ char *reply, size_t replylen)
 {
-    (void)snprintf(reply, replylen,
+    struct json_writer_t wr;
+    json_wr_init(&wr, reply, replylen);
+    json_wr_printf(&wr,
 		   "{\"class\":\"VERSION\",\"release\":\"%s\",\"rev\":\"%s\",\"proto_major\":%d,\"proto_minor\":%d}\r\n",
 		   VERSION, REVISION,
 		   GPSD_PROTO_MAJOR_VERSION, GPSD_PROTO_MINOR_VERSION);
 }
 
-void json_tpv_dump(const struct gps_data_t *gpsdata,
-		   /*@out@*/ char *reply, size_t replylen)
+
+static void json_add_fixed(char *reply, size_t replylen,
+			   const char *attr, double value, int prec)
+/* append "attr":value, rendering value with prec fixed decimal places */
+{
+    char numbuf[32];
+    char *cp = json_format_fixed(numbuf, value, prec);
+    size_t len = strlen(reply);
+
+    if (cp == NULL)
+	(void)snprintf(reply + len, replylen - len,
+		       "\"%s\":%.*f,", attr, prec, value);
+    else
+	(void)snprintf(reply + len, replylen - len, "\"%s\":%s,", attr, cp);
+}
+
+/*
+ * The numeric TPV attributes, in emission order.  Driving both the full
+ * render and the incremental patcher below from one table keeps the two
+ * paths from drifting apart.
+ */
+static const struct tpv_field_t {
+    const char *attr;
+    size_t fldoff;		/* offset of the value in gps_fix_t */
+    int prec;			/* decimal places */
+    int minmode;		/* minimum fix mode for emission */
+} tpv_fields[] = {
+    { "ept",   offsetof(struct gps_fix_t, ept),       3, MODE_NOT_SEEN },
+    { "lat",   offsetof(struct gps_fix_t, latitude),  9, MODE_2D },
+    { "lon",   offsetof(struct gps_fix_t, longitude), 9, MODE_2D },
+    { "alt",   offsetof(struct gps_fix_t, altitude),  3, MODE_3D },
+    { "epx",   offsetof(struct gps_fix_t, epx),       3, MODE_2D },
+    { "epy",   offsetof(struct gps_fix_t, epy),       3, MODE_2D },
+    { "epv",   offsetof(struct gps_fix_t, epv),       3, MODE_3D },
+    { "track", offsetof(struct gps_fix_t, track),     4, MODE_2D },
+    { "speed", offsetof(struct gps_fix_t, speed),     3, MODE_2D },
+    { "climb", offsetof(struct gps_fix_t, climb),     3, MODE_3D },
+    { "epd",   offsetof(struct gps_fix_t, epd),       4, MODE_2D },
+    { "eps",   offsetof(struct gps_fix_t, eps),       2, MODE_2D },
+    { "epc",   offsetof(struct gps_fix_t, epc),       2, MODE_3D },
+};
+#define TPV_NFIELDS	(sizeof(tpv_fields) / sizeof(tpv_fields[0]))
+
+#define tpv_fix_field(fix, fp) \
+	(*(const double *)(const void *)((const char *)(fix) + (fp)->fldoff))
+
+/*
+ * Between epochs most of a TPV is textually unchanged, so the report
+ * path keeps the last rendering per device and patches only the value
+ * spans whose numbers actually moved.  Any change of shape - a field
+ * appearing or vanishing, a value needing a different digit count, a
+ * new tag or fix mode - falls back to a full rebuild.
+ */
+struct tpv_cache_t {
+    char path[GPS_PATH_MAX];
+    char tag[MAXTAGLEN + 1];
+    int mode;
+    unsigned int present;		/* emitted fields, bit per table slot */
+    struct gps_fix_t fix;		/* values the text was rendered from */
+    unsigned short off[TPV_NFIELDS];	/* value spans in text */
+    unsigned short len[TPV_NFIELDS];
+    unsigned short time_off, time_len;
+    size_t textlen;
+    char text[GPS_JSON_RESPONSE_MAX];
+};
+#define TPV_CACHE_SLOTS	4
+
+static struct tpv_cache_t tpv_caches[TPV_CACHE_SLOTS];
+
+static void json_tpv_render(const struct gps_data_t *gpsdata,
+			    /*@out@*/ char *reply, size_t replylen,
+			    /*@null@*/ struct tpv_cache_t *cache)
+/* render a TPV from scratch, optionally recording patchable spans */
 {
     char tbuf[JSON_DATE_MAX+1];
+    unsigned int i;
 
     assert(replylen > 2);
     (void)strlcpy(reply, "{\"class\":\"TPV\",", replylen);
@@ -131,15 +355,15 @@ void json_tpv_dump(const struct gps_data_t *gpsdata,
     (void)snprintf(reply + strlen(reply),
 		   replylen - strlen(reply),
 		   "\"mode\":%d,", gpsdata->fix.mode);
-    if (isnan(gpsdata->fix.time) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"time\":\"%s\",", 
-		       unix_to_iso8601(gpsdata->fix.time, tbuf, sizeof(tbuf)));
-    if (isnan(gpsdata->fix.ept) == 0)
+    if (isnan(gpsdata->fix.time) == 0) {
+	(void)unix_to_iso8601(gpsdata->fix.time, tbuf, sizeof(tbuf));
+	if (cache != NULL) {
+	    cache->time_off = (unsigned short)(strlen(reply) + 8);
+	    cache->time_len = (unsigned short)strlen(tbuf);
+	}
 	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"ept\":%.3f,", gpsdata->fix.ept);
+		       replylen - strlen(reply), "\"time\":\"%s\",", tbuf);
+    }
     /*
      * Suppressing TPV fields that would be invalid because the fix
      * quality doesn't support them is nice for cutting down on the
@@ -150,85 +374,155 @@ void json_tpv_dump(const struct gps_data_t *gpsdata,
      * in the regression tests.  Rgus effect has been seen on SiRF-II
      * chips, which are quite common.
      */
-    if (gpsdata->fix.mode >= MODE_2D) {
-	if (isnan(gpsdata->fix.latitude) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"lat\":%.9f,", gpsdata->fix.latitude);
-	if (isnan(gpsdata->fix.longitude) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"lon\":%.9f,", gpsdata->fix.longitude);
-	if (gpsdata->fix.mode >= MODE_3D && isnan(gpsdata->fix.altitude) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"alt\":%.3f,", gpsdata->fix.altitude);
-	if (isnan(gpsdata->fix.epx) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"epx\":%.3f,", gpsdata->fix.epx);
-	if (isnan(gpsdata->fix.epy) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"epy\":%.3f,", gpsdata->fix.epy);
-	if ((gpsdata->fix.mode >= MODE_3D) && isnan(gpsdata->fix.epv) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"epv\":%.3f,", gpsdata->fix.epv);
-	if (isnan(gpsdata->fix.track) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"track\":%.4f,", gpsdata->fix.track);
-	if (isnan(gpsdata->fix.speed) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"speed\":%.3f,", gpsdata->fix.speed);
-	if ((gpsdata->fix.mode >= MODE_3D) && isnan(gpsdata->fix.climb) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"climb\":%.3f,", gpsdata->fix.climb);
-	if (isnan(gpsdata->fix.epd) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"epd\":%.4f,", gpsdata->fix.epd);
-	if (isnan(gpsdata->fix.eps) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"eps\":%.2f,", gpsdata->fix.eps);
-	if ((gpsdata->fix.mode >= MODE_3D) && isnan(gpsdata->fix.epc) == 0)
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
-			   "\"epc\":%.2f,", gpsdata->fix.epc);
+    for (i = 0; i < TPV_NFIELDS; i++) {
+	const struct tpv_field_t *fp = &tpv_fields[i];
+	double value = tpv_fix_field(&gpsdata->fix, fp);
+	size_t before;
+
+	if (gpsdata->fix.mode < fp->minmode || isnan(value) != 0)
+	    continue;
+	before = strlen(reply);
+	json_add_fixed(reply, replylen, fp->attr, value, fp->prec);
+	if (cache != NULL) {
+	    cache->present |= 1u << i;
+	    cache->off[i] = (unsigned short)(before + strlen(fp->attr) + 3);
+	    cache->len[i] =
+		(unsigned short)(strlen(reply) - cache->off[i] - 1);
+	}
     }
     if (reply[strlen(reply) - 1] == ',')
 	reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-    (void)strlcat(reply, "}\r\n", sizeof(reply) - strlen(reply));
+    (void)strlcat(reply, "}\r\n", replylen);
+}
+
+static /*@null@*/ struct tpv_cache_t *tpv_cache_slot(const char *path)
+/* find or claim the render cache slot for a device */
+{
+    struct tpv_cache_t *cache;
+
+    for (cache = tpv_caches; cache < tpv_caches + TPV_CACHE_SLOTS; cache++)
+	if (strcmp(cache->path, path) == 0)
+	    return cache;
+    for (cache = tpv_caches; cache < tpv_caches + TPV_CACHE_SLOTS; cache++)
+	if (cache->path[0] == '\0') {
+	    (void)strlcpy(cache->path, path, sizeof(cache->path));
+	    return cache;
+	}
+    return NULL;	/* more devices than slots; those render in full */
+}
+
+static bool json_tpv_patch(const struct gps_data_t *gpsdata,
+			   struct tpv_cache_t *cache)
+/* patch changed values into the cached text; false forces a rebuild */
+{
+    char tbuf[JSON_DATE_MAX+1], numbuf[32];
+    unsigned int i, present = 0;
+
+    if (gpsdata->fix.mode != cache->mode
+	|| strcmp(cache->tag,
+		  gpsdata->tag[0] != '\0' ? gpsdata->tag : "-") != 0)
+	return false;
+    for (i = 0; i < TPV_NFIELDS; i++) {
+	const struct tpv_field_t *fp = &tpv_fields[i];
+
+	if (gpsdata->fix.mode >= fp->minmode
+	    && isnan(tpv_fix_field(&gpsdata->fix, fp)) == 0)
+	    present |= 1u << i;
+    }
+    if (present != cache->present
+	|| (isnan(gpsdata->fix.time) == 0) != (cache->time_len > 0))
+	return false;
+    if (cache->time_len > 0 && gpsdata->fix.time != cache->fix.time) {
+	(void)unix_to_iso8601(gpsdata->fix.time, tbuf, sizeof(tbuf));
+	if (strlen(tbuf) != (size_t)cache->time_len)
+	    return false;
+	memcpy(cache->text + cache->time_off, tbuf, (size_t)cache->time_len);
+    }
+    for (i = 0; i < TPV_NFIELDS; i++) {
+	const struct tpv_field_t *fp = &tpv_fields[i];
+	char *cp;
+
+	if ((present & (1u << i)) == 0)
+	    continue;
+	/* bytewise compare so -0.0 and 0.0 rerender as they should */
+	if (memcmp((const char *)&gpsdata->fix + fp->fldoff,
+		   (const char *)&cache->fix + fp->fldoff,
+		   sizeof(double)) == 0)
+	    continue;
+	cp = json_format_fixed(numbuf, tpv_fix_field(&gpsdata->fix, fp),
+			       fp->prec);
+	if (cp == NULL) {
+	    (void)snprintf(numbuf, sizeof(numbuf), "%.*f",
+			   fp->prec, tpv_fix_field(&gpsdata->fix, fp));
+	    cp = numbuf;
+	}
+	if (strlen(cp) != (size_t)cache->len[i])
+	    return false;	/* digit count changed; rebuild */
+	memcpy(cache->text + cache->off[i], cp, (size_t)cache->len[i]);
+    }
+    cache->fix = gpsdata->fix;
+    return true;
+}
+
+static void json_tpv_dump_cached(const struct gps_data_t *gpsdata,
+				 /*@out@*/ char *reply, size_t replylen)
+/* as json_tpv_dump(), but reusing the per-device render cache */
+{
+    struct tpv_cache_t *cache = NULL;
+
+    if (gpsdata->dev.path[0] != '\0')
+	cache = tpv_cache_slot(gpsdata->dev.path);
+    if (cache == NULL) {
+	json_tpv_render(gpsdata, reply, replylen, NULL);
+	return;
+    }
+    if (cache->textlen == 0 || !json_tpv_patch(gpsdata, cache)) {
+	cache->present = 0;
+	cache->time_len = 0;
+	json_tpv_render(gpsdata, cache->text, sizeof(cache->text), cache);
+	cache->textlen = strlen(cache->text);
+	cache->mode = gpsdata->fix.mode;
+	cache->fix = gpsdata->fix;
+	(void)strlcpy(cache->tag,
+		      gpsdata->tag[0] != '\0' ? gpsdata->tag : "-",
+		      sizeof(cache->tag));
+    }
+    if (cache->textlen >= replylen) {
+	/* caller's buffer is smaller than the cache; render directly */
+	json_tpv_render(gpsdata, reply, replylen, NULL);
+	return;
+    }
+    memcpy(reply, cache->text, cache->textlen + 1);
+}
+
+void json_tpv_dump(const struct gps_data_t *gpsdata,
+		   /*@out@*/ char *reply, size_t replylen)
+{
+    json_tpv_render(gpsdata, reply, replylen, NULL);
 }
 
 void json_noise_dump(const struct gps_data_t *gpsdata,
 		   /*@out@*/ char *reply, size_t replylen)
 {
+    struct json_writer_t wr;
     char tbuf[JSON_DATE_MAX+1];
 
     assert(replylen > 2);
-    (void)strlcpy(reply, "{\"class\":\"GST\",", replylen);
-    (void)snprintf(reply + strlen(reply),
-		   replylen - strlen(reply),
+    json_wr_init(&wr, reply, replylen);
+    json_wr_puts(&wr, "{\"class\":\"GST\",");
+    json_wr_printf(&wr,
 		   "\"tag\":\"%s\",",
 		   gpsdata->tag[0] != '\0' ? gpsdata->tag : "-");
     if (gpsdata->dev.path[0] != '\0')
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", gpsdata->dev.path);
-    (void)snprintf(reply + strlen(reply),
-		   replylen - strlen(reply),
+    json_wr_printf(&wr,
 		   "\"time\":\"%s\",",
 		   unix_to_iso8601(gpsdata->gst.utctime, tbuf, sizeof(tbuf)));
 #define ADD_GST_FIELD(tag, field) do {                     \
     if (isnan(gpsdata->gst.field) == 0)              \
-	(void)snprintf(reply + strlen(reply),                \
-		       replylen - strlen(reply),             \
-		       "\"" tag "\":%.3f,", gpsdata->gst.field); \
+	json_wr_fixed(&wr, tag,             \
+		       gpsdata->gst.field, 3);           \
     } while(0)
 
     ADD_GST_FIELD("rms",    rms_deviation);
@@ -241,89 +535,162 @@ void json_noise_dump(const struct gps_data_t *gpsdata,
 
 #undef ADD_GST_FIELD
 
-    if (reply[strlen(reply) - 1] == ',')
-	reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-    (void)strlcat(reply, "}\r\n", sizeof(reply) - strlen(reply));
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
+}
+
+/*
+ * Satellite-array render cache.  Constellation geometry changes on the
+ * order of minutes while SKY can be emitted at the full device rate,
+ * so the "satellites" array is re-emitted verbatim until the skyview
+ * data actually changes.  Slots are claimed per device, like the TPV
+ * render cache.
+ */
+struct sky_cache_t {
+    char path[GPS_PATH_MAX];	/* claiming device, empty = free */
+    int satellites_visible;	/* inputs the cached text depends on */
+    int satellites_used;
+    int PRN[MAXCHANNELS];
+    int elevation[MAXCHANNELS];
+    int azimuth[MAXCHANNELS];
+    double ss[MAXCHANNELS];
+    int used[MAXCHANNELS];
+    size_t textlen;		/* 0 = nothing cached yet */
+    char text[GPS_JSON_RESPONSE_MAX];
+};
+
+#define SKY_CACHE_SLOTS	4
+
+static struct sky_cache_t sky_caches[SKY_CACHE_SLOTS];
+
+static /*@null@*/ struct sky_cache_t *sky_cache_slot(const char *path)
+/* find or claim the satellite-array cache slot for a device */
+{
+    struct sky_cache_t *cache;
+
+    for (cache = sky_caches; cache < sky_caches + SKY_CACHE_SLOTS; cache++)
+	if (strcmp(cache->path, path) == 0)
+	    return cache;
+    for (cache = sky_caches; cache < sky_caches + SKY_CACHE_SLOTS; cache++)
+	if (cache->path[0] == '\0') {
+	    (void)strlcpy(cache->path, path, sizeof(cache->path));
+	    return cache;
+	}
+    return NULL;	/* more devices than slots; those render in full */
+}
+
+static bool sky_cache_valid(const struct sky_cache_t *cache,
+			    const struct gps_data_t *datap)
+/* does the cached satellite array still match the skyview? */
+{
+    size_t n = (size_t)datap->satellites_visible;
+
+    return cache->textlen > 0
+	&& cache->satellites_visible == datap->satellites_visible
+	&& cache->satellites_used == datap->satellites_used
+	&& memcmp(cache->PRN, datap->PRN,
+		  n * sizeof(cache->PRN[0])) == 0
+	&& memcmp(cache->elevation, datap->elevation,
+		  n * sizeof(cache->elevation[0])) == 0
+	&& memcmp(cache->azimuth, datap->azimuth,
+		  n * sizeof(cache->azimuth[0])) == 0
+	&& memcmp(cache->ss, datap->ss, n * sizeof(cache->ss[0])) == 0
+	&& memcmp(cache->used, datap->used,
+		  (size_t)datap->satellites_used * sizeof(cache->used[0])) == 0;
+}
+
+static void json_sky_render_satellites(const struct gps_data_t *datap,
+				       int reported,
+				       struct json_writer_t *wr)
+/* append the "satellites" array for a skyview with reported entries */
+{
+    int i, j, used;
+
+    json_wr_puts(wr, "\"satellites\":[");
+    for (i = 0; i < reported; i++) {
+	used = 0;
+	for (j = 0; j < datap->satellites_used; j++)
+	    if (datap->used[j] == datap->PRN[i]) {
+		used = 1;
+		break;
+	    }
+	if (datap->PRN[i]) {
+	    json_wr_printf(wr,
+			   "{\"PRN\":%d,\"el\":%d,\"az\":%d,\"ss\":%.0f,\"used\":%s},",
+			   datap->PRN[i],
+			   datap->elevation[i], datap->azimuth[i],
+			   datap->ss[i], used ? "true" : "false");
+	}
+    }
+    json_wr_trim(wr, ',');
+    json_wr_puts(wr, "]");
 }
 
 void json_sky_dump(const struct gps_data_t *datap,
 		   /*@out@*/ char *reply, size_t replylen)
 {
-    int i, j, used, reported = 0;
+    struct json_writer_t wr;
+    int i, reported = 0;
     char tbuf[JSON_DATE_MAX+1];
 
     assert(replylen > 2);
-    (void)strlcpy(reply, "{\"class\":\"SKY\",", replylen);
-    (void)snprintf(reply + strlen(reply),
-		   replylen - strlen(reply),
+    json_wr_init(&wr, reply, replylen);
+    json_wr_puts(&wr, "{\"class\":\"SKY\",");
+    json_wr_printf(&wr,
 		   "\"tag\":\"%s\",",
 		   datap->tag[0] != '\0' ? datap->tag : "-");
     if (datap->dev.path[0] != '\0')
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", datap->dev.path);
     if (isnan(datap->skyview_time) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"time\":\"%s\",", 
 		       unix_to_iso8601(datap->skyview_time, tbuf, sizeof(tbuf)));
     if (isnan(datap->dop.xdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"xdop\":%.2f,", datap->dop.xdop);
+	json_wr_fixed(&wr, "xdop", datap->dop.xdop, 2);
     if (isnan(datap->dop.ydop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"ydop\":%.2f,", datap->dop.ydop);
+	json_wr_fixed(&wr, "ydop", datap->dop.ydop, 2);
     if (isnan(datap->dop.vdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"vdop\":%.2f,", datap->dop.vdop);
+	json_wr_fixed(&wr, "vdop", datap->dop.vdop, 2);
     if (isnan(datap->dop.tdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"tdop\":%.2f,", datap->dop.tdop);
+	json_wr_fixed(&wr, "tdop", datap->dop.tdop, 2);
     if (isnan(datap->dop.hdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"hdop\":%.2f,", datap->dop.hdop);
+	json_wr_fixed(&wr, "hdop", datap->dop.hdop, 2);
     if (isnan(datap->dop.gdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"gdop\":%.2f,", datap->dop.gdop);
+	json_wr_fixed(&wr, "gdop", datap->dop.gdop, 2);
     if (isnan(datap->dop.pdop) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
-		       "\"pdop\":%.2f,", datap->dop.pdop);
+	json_wr_fixed(&wr, "pdop", datap->dop.pdop, 2);
     /* insurance against flaky drivers */
     for (i = 0; i < datap->satellites_visible; i++)
 	if (datap->PRN[i])
 	    reported++;
     if (reported) {
-	(void)strlcat(reply, "\"satellites\":[", replylen);
-	for (i = 0; i < reported; i++) {
-	    used = 0;
-	    for (j = 0; j < datap->satellites_used; j++)
-		if (datap->used[j] == datap->PRN[i]) {
-		    used = 1;
-		    break;
-		}
-	    if (datap->PRN[i]) {
-		(void)snprintf(reply + strlen(reply),
-			       replylen - strlen(reply),
-			       "{\"PRN\":%d,\"el\":%d,\"az\":%d,\"ss\":%.0f,\"used\":%s},",
-			       datap->PRN[i],
-			       datap->elevation[i], datap->azimuth[i],
-			       datap->ss[i], used ? "true" : "false");
+	struct sky_cache_t *cache = sky_cache_slot(datap->dev.path);
+
+	if (cache == NULL)
+	    json_sky_render_satellites(datap, reported, &wr);
+	else {
+	    if (!sky_cache_valid(cache, datap)) {
+		struct json_writer_t cw;
+
+		json_wr_init(&cw, cache->text, sizeof(cache->text));
+		json_sky_render_satellites(datap, reported, &cw);
+		cache->textlen = (size_t)(cw.cur - cache->text);
+		cache->satellites_visible = datap->satellites_visible;
+		cache->satellites_used = datap->satellites_used;
+		memcpy(cache->PRN, datap->PRN, sizeof(cache->PRN));
+		memcpy(cache->elevation, datap->elevation,
+		       sizeof(cache->elevation));
+		memcpy(cache->azimuth, datap->azimuth,
+		       sizeof(cache->azimuth));
+		memcpy(cache->ss, datap->ss, sizeof(cache->ss));
+		memcpy(cache->used, datap->used, sizeof(cache->used));
 	    }
+	    json_wr_puts(&wr, cache->text);
 	}
-	if (reply[strlen(reply) - 1] == ',')
-	    reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-	(void)strlcat(reply, "]", replylen);
     }
-    if (reply[strlen(reply) - 1] == ',')
-	reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-    (void)strlcat(reply, "}\r\n", replylen);
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
     if (datap->satellites_visible != reported)
 	gpsd_report(LOG_WARN, "Satellite count %d != PRN count %d\n",
 		    datap->satellites_visible, reported);
@@ -332,13 +699,15 @@ void json_sky_dump(const struct gps_data_t *datap,
 void json_device_dump(const struct gps_device_t *device,
 		      /*@out@*/ char *reply, size_t replylen)
 {
+    struct json_writer_t wr;
     char buf1[JSON_VAL_MAX * 2 + 1];
     struct classmap_t *cmp;
-    (void)strlcpy(reply, "{\"class\":\"DEVICE\",\"path\":\"", replylen);
-    (void)strlcat(reply, device->gpsdata.dev.path, replylen);
-    (void)strlcat(reply, "\",", replylen);
+    json_wr_init(&wr, reply, replylen);
+    json_wr_puts(&wr, "{\"class\":\"DEVICE\",\"path\":\"");
+    json_wr_puts(&wr, device->gpsdata.dev.path);
+    json_wr_puts(&wr, "\",");
     if (device->gpsdata.online > 0) {	
-	(void)snprintf(reply + strlen(reply), replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"activated\":\"%s\",", 
 		       unix_to_iso8601(device->gpsdata.online, buf1, sizeof(buf1)));
 	if (device->observed != 0) {
@@ -347,22 +716,19 @@ void json_device_dump(const struct gps_device_t *device,
 		if ((device->observed & cmp->packetmask) != 0)
 		    mask |= cmp->typemask;
 	    if (mask != 0)
-		(void)snprintf(reply + strlen(reply),
-			       replylen - strlen(reply), "\"flags\":%d,",
+		json_wr_printf(&wr, "\"flags\":%d,",
 			       mask);
 	}
 	if (device->device_type != NULL) {
-	    (void)strlcat(reply, "\"driver\":\"", replylen);
-	    (void)strlcat(reply, device->device_type->type_name, replylen);
-	    (void)strlcat(reply, "\",", replylen);
+	    json_wr_puts(&wr, "\"driver\":\"");
+	    json_wr_puts(&wr, device->device_type->type_name);
+	    json_wr_puts(&wr, "\",");
 	}
 	/*@-mustfreefresh@*/
 	if (device->subtype[0] != '\0') {
-	    (void)strlcat(reply, "\"subtype\":\"", replylen);
-	    (void)strlcat(reply,
-			  json_stringify(buf1, sizeof(buf1), device->subtype),
-			  replylen);
-	    (void)strlcat(reply, "\",", replylen);
+	    json_wr_puts(&wr, "\"subtype\":\"");
+	    json_wr_puts(&wr, json_stringify(buf1, sizeof(buf1), device->subtype));
+	    json_wr_puts(&wr, "\",");
 	}
 	/*@+mustfreefresh@*/
 	/*
@@ -370,7 +736,7 @@ void json_device_dump(const struct gps_device_t *device,
 	 * a serial device with the usual control parameters.
 	 */
 	if (device->servicetype == service_sensor) {
-	    (void)snprintf(reply + strlen(reply), replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"native\":%d,\"bps\":%d,\"parity\":\"%c\",\"stopbits\":%u,\"cycle\":%2.2f",
 			   device->gpsdata.dev.driver_mode,
 			   (int)gpsd_get_speed(&device->ttyset),
@@ -380,36 +746,52 @@ void json_device_dump(const struct gps_device_t *device,
 #ifdef RECONFIGURE_ENABLE
 	    if (device->device_type != NULL
 		&& device->device_type->rate_switcher != NULL)
-		(void)snprintf(reply + strlen(reply),
-			       replylen - strlen(reply),
+		json_wr_printf(&wr,
 			       ",\"mincycle\":%2.2f",
 			       device->device_type->min_cycle);
 #endif /* RECONFIGURE_ENABLE */
 	}
     }
-    if (reply[strlen(reply) - 1] == ',')
-	reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-    (void)strlcat(reply, "}\r\n", replylen);
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
 }
 
 void json_watch_dump(const struct policy_t *ccp,
 		     /*@out@*/ char *reply, size_t replylen)
 {
+    struct json_writer_t wr;
     /*@-compdef@*/
-    (void)snprintf(reply, replylen,
-		   "{\"class\":\"WATCH\",\"enable\":%s,\"json\":%s,\"nmea\":%s,\"raw\":%d,\"scaled\":%s,\"timing\":%s,",
+    json_wr_init(&wr, reply, replylen);
+    json_wr_printf(&wr,
+		   "{\"class\":\"WATCH\",\"enable\":%s,\"json\":%s,\"nmea\":%s,\"raw\":%d,\"scaled\":%s,\"timing\":%s,\"binary\":%s,",
 		   ccp->watcher ? "true" : "false",
 		   ccp->json ? "true" : "false",
 		   ccp->nmea ? "true" : "false",
 		   ccp->raw,
 		   ccp->scaled ? "true" : "false",
-		   ccp->timing ? "true" : "false");
+		   ccp->timing ? "true" : "false",
+		   ccp->binary ? "true" : "false");
+    /* only echo the class flags when the watcher restricted them */
+    if (ccp->classmask != 0
+	&& (ccp->classmask & WATCH_CLASSES) != WATCH_CLASSES)
+	json_wr_printf(&wr,
+		       "\"tpv\":%s,\"gst\":%s,\"sky\":%s,\"subframes\":%s,"
+		       "\"attitude\":%s,\"rtcm2\":%s,\"rtcm3\":%s,\"ais\":%s,",
+		       (ccp->classmask & REPORT_IS) != 0 ? "true" : "false",
+		       (ccp->classmask & GST_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & SATELLITE_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & SUBFRAME_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & ATTITUDE_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & RTCM2_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & RTCM3_SET) != 0 ? "true" : "false",
+		       (ccp->classmask & AIS_SET) != 0 ? "true" : "false");
+    if (ccp->interval > 0)
+	json_wr_printf(&wr, "\"interval\":%.2f,", ccp->interval);
     if (ccp->devpath[0] != '\0')
-	(void)snprintf(reply + strlen(reply), replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", ccp->devpath);
-    if (reply[strlen(reply) - 1] == ',')
-	reply[strlen(reply) - 1] = '\0';
-    (void)strlcat(reply, "}\r\n", replylen - strlen(reply));
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
     /*@+compdef@*/
 }
 
@@ -723,6 +1105,7 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 		     /*@out@*/char buf[], size_t buflen)
 /* dump the contents of a parsed RTCM104 message as JSON */
 {
+    struct json_writer_t wr;
     /*@-mustfreefresh@*/
     char buf1[JSON_VAL_MAX * 2 + 1];
     /*
@@ -734,42 +1117,49 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 
     unsigned int n;
 
-    (void)snprintf(buf, buflen, "{\"class\":\"RTCM2\",");
+    json_wr_init(&wr, buf, buflen);
+    json_wr_printf(&wr, "{\"class\":\"RTCM2\",");
     if (device != NULL && device[0] != '\0')
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", device);
-    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-		   "\"type\":%u,\"station_id\":%u,\"zcount\":%0.1f,\"seqnum\":%u,\"length\":%u,\"station_health\":%u,",
-		   rtcm->type, rtcm->refstaid, rtcm->zcount, rtcm->seqnum,
-		   rtcm->length, rtcm->stathlth);
+    json_wr_printf(&wr,
+		   "\"type\":%u,\"station_id\":%u,",
+		   rtcm->type, rtcm->refstaid);
+    json_wr_fixed(&wr, "zcount", rtcm->zcount, 1);
+    json_wr_printf(&wr,
+		   "\"seqnum\":%u,\"length\":%u,\"station_health\":%u,",
+		   rtcm->seqnum, rtcm->length, rtcm->stathlth);
 
     switch (rtcm->type) {
     case 1:
     case 9:
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (n = 0; n < rtcm->gps_ranges.nentries; n++) {
 	    const struct gps_rangesat_t *rsp = &rtcm->gps_ranges.sat[n];
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-			   "{\"ident\":%u,\"udre\":%u,\"iod\":%u,\"prc\":%0.3f,\"rrc\":%0.3f},",
-			   rsp->ident,
-			   rsp->udre, rsp->iod, 
-			   rsp->prc, rsp->rrc);
+	    /* fixed-point renders keep libc float formatting off
+	     * the per-satellite path */
+	    json_wr_printf(&wr,
+			   "{\"ident\":%u,\"udre\":%u,\"iod\":%u,",
+			   rsp->ident, rsp->udre, rsp->iod);
+	    json_wr_fixed(&wr, "prc", rsp->prc, 3);
+	    json_wr_fixed(&wr, "rrc", rsp->rrc, 3);
+	    json_wr_trim(&wr, ',');
+	    json_wr_puts(&wr, "},");
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 3:
 	if (rtcm->ecef.valid)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"x\":%.2f,\"y\":%.2f,\"z\":%.2f,",
 			   rtcm->ecef.x, rtcm->ecef.y, rtcm->ecef.z);
 	break;
 
     case 4:
 	if (rtcm->reference.valid) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"system\":\"%s\",\"sense\":%1d,\"datum\":\"%s\",\"dx\":%.1f,\"dy\":%.1f,\"dz\":%.1f,",
 			   rtcm->reference.system >= NITEMS(navsysnames)
 			   ? "UNKNOWN"
@@ -782,10 +1172,10 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 	break;
 
     case 5:
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (n = 0; n < rtcm->conhealth.nentries; n++) {
 	    const struct consat_t *csp = &rtcm->conhealth.sat[n];
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"iodl\":%s,\"health\":%1u,\"snr\":%d,\"health_en\":%s,\"new_data\":%s,\"los_warning\":%s,\"tou\":%u},",
 			   csp->ident,
 			   JSON_BOOL(csp->iodl),
@@ -795,19 +1185,18 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 			   JSON_BOOL(csp->new_data),
 			   JSON_BOOL(csp->los_warning), csp->tou);
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 6:			/* NOP msg */
 	break;
 
     case 7:
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (n = 0; n < rtcm->almanac.nentries; n++) {
 	    const struct station_t *ssp = &rtcm->almanac.station[n];
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"lat\":%.4f,\"lon\":%.4f,\"range\":%u,\"frequency\":%.1f,\"health\":%u,\"station_id\":%u,\"bitrate\":%u},",
 			   ssp->latitude,
 			   ssp->longitude,
@@ -815,13 +1204,12 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 			   ssp->frequency,
 			   ssp->health, ssp->station_id, ssp->bitrate);
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 13:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"status\":%s,\"rangeflag\":%s,"
 		       "\"lat\":%.2f,\"lon\":%.2f,\"range\":%u,",
 		       JSON_BOOL(rtcm->xmitter.status), 
@@ -832,7 +1220,7 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 	break;
 
     case 14:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"week\":%u,\"hour\":%u,\"leapsecs\":%u,",
 		       rtcm->gpstime.week, 
 		       rtcm->gpstime.hour,
@@ -840,43 +1228,43 @@ void json_rtcm2_dump(const struct rtcm2_t *rtcm,
 	break;
 
     case 16:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"message\":\"%s\"", json_stringify(buf1,
 							    sizeof(buf1),
 							    rtcm->message));
 	break;
 
     case 31:
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (n = 0; n < rtcm->glonass_ranges.nentries; n++) {
 	    const struct glonass_rangesat_t *rsp = &rtcm->glonass_ranges.sat[n];
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-			   "{\"ident\":%u,\"udre\":%u,\"change\":%s,\"tod\":%u,\"prc\":%0.3f,\"rrc\":%0.3f},",
+	    json_wr_printf(&wr,
+			   "{\"ident\":%u,\"udre\":%u,\"change\":%s,\"tod\":%u,",
 			   rsp->ident,
 			   rsp->udre,
 			   JSON_BOOL(rsp->change),
-			   rsp->tod, 
-			   rsp->prc, rsp->rrc);
+			   rsp->tod);
+	    json_wr_fixed(&wr, "prc", rsp->prc, 3);
+	    json_wr_fixed(&wr, "rrc", rsp->rrc, 3);
+	    json_wr_trim(&wr, ',');
+	    json_wr_puts(&wr, "},");
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     default:
-	(void)strlcat(buf, "\"data\":[", buflen);
+	json_wr_puts(&wr, "\"data\":[");
 	for (n = 0; n < rtcm->length; n++)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"0x%08x\",", rtcm->words[n]);
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
     }
 
-    if (buf[strlen(buf) - 1] == ',')
-	buf[strlen(buf) - 1] = '\0';
-    (void)strlcat(buf, "}\r\n", buflen);
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
     /*@+mustfreefresh@*/
 }
 #endif /* defined(RTCM104V2_ENABLE) */
@@ -887,25 +1275,27 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		     /*@out@*/char buf[], size_t buflen)
 /* dump the contents of a parsed RTCM104v3 message as JSON */
 {
+    struct json_writer_t wr;
     /*@-mustfreefresh@*/
     char buf1[JSON_VAL_MAX * 2 + 1];
     unsigned short i;
     unsigned int n;
 
-    (void)snprintf(buf, buflen, "{\"class\":\"RTCM3\",");
+    json_wr_init(&wr, buf, buflen);
+    json_wr_printf(&wr, "{\"class\":\"RTCM3\",");
     if (device != NULL && device[0] != '\0')
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", device);
-    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+    json_wr_printf(&wr,
 		   "\"type\":%u,", rtcm->type);
-    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+    json_wr_printf(&wr,
 		   "\"length\":%u,", rtcm->length);
 
 #define CODE(x) (unsigned int)(x)
 #define INT(x) (unsigned int)(x)
     switch (rtcm->type) {
     case 1001:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1001.header.station_id,
@@ -913,10 +1303,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1001.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1001.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1001.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1001.header.satcount; i++) {
 #define R1001 rtcm->rtcmtypes.rtcm3_1001.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"ind\":%u,\"prange\":%8.2f,"
 			   "\"delta\":%6.4f,\"lockt\":%u},",
 			   R1001.ident,
@@ -926,13 +1316,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   INT(R1001.L1.locktime));
 #undef R1001
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1002:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1002.header.station_id,
@@ -940,10 +1329,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1002.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1002.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1002.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1002.header.satcount; i++) {
 #define R1002 rtcm->rtcmtypes.rtcm3_1002.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"ind\":%u,\"prange\":%8.2f,"
 			   "\"delta\":%6.4f,\"lockt\":%u,\"amb\":%u,"
 			   "\"CNR\":%.2f},",
@@ -956,13 +1345,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   R1002.L1.CNR);
 #undef R1002
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1003:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1003.header.station_id,
@@ -970,10 +1358,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1003.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1003.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1003.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1003.header.satcount; i++) {
 #define R1003 rtcm->rtcmtypes.rtcm3_1003.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,"
 			   "\"L1\":{\"ind\":%u,\"prange\":%8.2f,"
 			   "\"delta\":%6.4f,\"lockt\":%u},"
@@ -991,13 +1379,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   INT(R1003.L2.locktime));
 #undef R1003
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1004:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1004.header.station_id,
@@ -1005,10 +1392,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1004.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1004.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1004.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1004.header.satcount; i++) {
 #define R1004 rtcm->rtcmtypes.rtcm3_1004.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,"
 			   "\"L1\":{\"ind\":%u,\"prange\":%8.2f,"
 			   "\"delta\":%6.4f,\"lockt\":%u,"
@@ -1031,24 +1418,22 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   R1004.L2.CNR);
 #undef R1004
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1005:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"system\":[",
 		       rtcm->rtcmtypes.rtcm3_1005.station_id);
 	if ((rtcm->rtcmtypes.rtcm3_1005.system & 0x04)!=0)
-	    (void)strlcat(buf, "\"GPS\",", buflen - strlen(buf));
+	    json_wr_puts(&wr, "\"GPS\",");
 	if ((rtcm->rtcmtypes.rtcm3_1005.system & 0x02)!=0)
-	    (void)strlcat(buf, "\"GLONASS\",", buflen - strlen(buf));
+	    json_wr_puts(&wr, "\"GLONASS\",");
 	if ((rtcm->rtcmtypes.rtcm3_1005.system & 0x01)!=0)
-	    (void)strlcat(buf, "\"GALILEO\",", buflen - strlen(buf));
-	if (buf[strlen(buf)-1] == ',')
-	    buf[strlen(buf)-1] = '\0';
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_puts(&wr, "\"GALILEO\",");
+	json_wr_trim(&wr, ',');
+	json_wr_printf(&wr,
 		       "],\"refstation\":%s,\"sro\":%s,"
 		       "\"x\":%.4f,\"y\":%.4f,\"z\":%.4f,",
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1005.reference_station),
@@ -1059,18 +1444,17 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     case 1006:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"system\":[",
 		       rtcm->rtcmtypes.rtcm3_1006.station_id);
 	if ((rtcm->rtcmtypes.rtcm3_1006.system & 0x04)!=0)
-	    (void)strlcat(buf, "\"GPS\",", buflen - strlen(buf));
+	    json_wr_puts(&wr, "\"GPS\",");
 	if ((rtcm->rtcmtypes.rtcm3_1006.system & 0x02)!=0)
-	    (void)strlcat(buf, "\"GLONASS\",", buflen - strlen(buf));
+	    json_wr_puts(&wr, "\"GLONASS\",");
 	if ((rtcm->rtcmtypes.rtcm3_1006.system & 0x01)!=0)
-	    (void)strlcat(buf, "\"GALILEO\",", buflen - strlen(buf));
-	if (buf[strlen(buf)-1] == ',')
-	    buf[strlen(buf)-1] = '\0';
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_puts(&wr, "\"GALILEO\",");
+	json_wr_trim(&wr, ',');
+	json_wr_printf(&wr,
 		       "],\"refstation\":%s,\"sro\":%s,"
 		       "\"x\":%.4f,\"y\":%.4f,\"z\":%.4f,",
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1006.reference_station),
@@ -1078,13 +1462,13 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       rtcm->rtcmtypes.rtcm3_1006.ecef_x,
 		       rtcm->rtcmtypes.rtcm3_1006.ecef_y,
 		       rtcm->rtcmtypes.rtcm3_1006.ecef_z);
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"h\":%.4f,",
 		       rtcm->rtcmtypes.rtcm3_1006.height);
 	break;
 
     case 1007:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"desc\":\"%s\",\"setup-id\":%u",
 		       rtcm->rtcmtypes.rtcm3_1007.station_id,
 		       rtcm->rtcmtypes.rtcm3_1007.descriptor,
@@ -1092,7 +1476,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     case 1008:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"desc\":\"%s\","
 		       "\"setup-id\":%u,\"serial\":\"%s\"",
 		       rtcm->rtcmtypes.rtcm3_1008.station_id,
@@ -1102,7 +1486,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     case 1009:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\","
 		       "\"satcount\":\"%u\",",
@@ -1112,10 +1496,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1009.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1009.header.interval,
 		       rtcm->rtcmtypes.rtcm3_1009.header.satcount);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1009.header.satcount; i++) {
 #define R1009 rtcm->rtcmtypes.rtcm3_1009.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"ind\":%u,\"channel\":%hd,"
 			   "\"prange\":%8.2f,\"delta\":%6.4f,\"lockt\":%u},",
 			   R1009.ident,
@@ -1126,13 +1510,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   INT(R1009.L1.locktime));
 #undef R1009 
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1010:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1010.header.station_id,
@@ -1140,10 +1523,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1010.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1010.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1010.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1010.header.satcount; i++) {
 #define R1010 rtcm->rtcmtypes.rtcm3_1010.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"ind\":%u,\"channel\":%hd,"
 			   "\"prange\":%8.2f,\"delta\":%6.4f,\"lockt\":%u,"
 			   "\"amb\":%u,\"CNR\":%.2f},",
@@ -1157,13 +1540,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   R1010.L1.CNR);
 #undef R1010 
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1011:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1011.header.station_id,
@@ -1171,10 +1553,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1011.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1011.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1011.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1011.header.satcount; i++) {
 #define R1011 rtcm->rtcmtypes.rtcm3_1011.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"channel\":%hd,"
 			   "\"L1\":{\"ind\":%u,"
 			   "\"prange\":%8.2f,\"delta\":%6.4f,\"lockt\":%u},"
@@ -1192,13 +1574,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   INT(R1011.L2.locktime));
 #undef R1011
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1012:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"tow\":%d,\"sync\":\"%s\","
 		       "\"smoothing\":\"%s\",\"interval\":\"%u\",",
 		       rtcm->rtcmtypes.rtcm3_1012.header.station_id,
@@ -1206,10 +1587,10 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1012.header.sync),
 		       JSON_BOOL(rtcm->rtcmtypes.rtcm3_1012.header.smoothing),
 		       rtcm->rtcmtypes.rtcm3_1012.header.interval);
-	(void)strlcat(buf, "\"satellites\":[", buflen);
+	json_wr_puts(&wr, "\"satellites\":[");
 	for (i = 0; i < rtcm->rtcmtypes.rtcm3_1012.header.satcount; i++) {
 #define R1012 rtcm->rtcmtypes.rtcm3_1012.rtk_data[i]
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"ident\":%u,\"channel\":%hd,"
 			   "\"L1\":{\"ind\":%u,\"prange\":%8.2f,"
 			   "\"delta\":%6.4f,\"lockt\":%u,\"amb\":%u,"
@@ -1233,13 +1614,12 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 			   R1012.L2.CNR);
 #undef R1012
 	}
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
 
     case 1013:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"mjd\":%u,\"sec\":%u,"
 		       "\"leapsecs\":%u,",
 		       rtcm->rtcmtypes.rtcm3_1013.station_id,
@@ -1247,7 +1627,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 		       rtcm->rtcmtypes.rtcm3_1013.sod,
 		       INT(rtcm->rtcmtypes.rtcm3_1013.leapsecs));
 	for (i = 0; i < (unsigned short)rtcm->rtcmtypes.rtcm3_1013.ncount; i++)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "{\"id\":%u,\"sync\":\"%s\",\"interval\":%u}",
 			   rtcm->rtcmtypes.rtcm3_1013.announcements[i].id,
 			   JSON_BOOL(rtcm->rtcmtypes.rtcm3_1013.
@@ -1257,7 +1637,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     case 1014:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"netid\":%u,\"subnetid\":%u,\"statcount\":%u"
 		       "\"master\":%u,\"aux\":%u,\"lat\":%f,\"lon\":%f,\"alt\":%f,",
 		       rtcm->rtcmtypes.rtcm3_1014.network_id,
@@ -1290,7 +1670,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 
     case 1029:
 	/*@-formatcode@*//* splint has a bug */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"mjd\":%u,\"sec\":%u,"
 		       "\"len\":%zd,\"units\":%zd,\"msg\":\"%s\",",
 		       rtcm->rtcmtypes.rtcm3_1029.station_id,
@@ -1304,7 +1684,7 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     case 1033:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"station_id\":%u,\"desc\":\"%s\","
 		       "\"setup-id\":%u,\"serial\":\"%s\","
 		       "\"receiver\":%s,\"firmware\":\"%s\"",
@@ -1317,19 +1697,17 @@ void json_rtcm3_dump(const struct rtcm3_t *rtcm,
 	break;
 
     default:
-	(void)strlcat(buf, "\"data\":[", buflen);
+	json_wr_puts(&wr, "\"data\":[");
 	for (n = 0; n < rtcm->length; n++)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"0x%02x\",",(unsigned int)rtcm->rtcmtypes.data[n]);
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "]", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "]");
 	break;
     }
 
-    if (buf[strlen(buf) - 1] == ',')
-	buf[strlen(buf) - 1] = '\0';
-    (void)strlcat(buf, "}\r\n", buflen);
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
     /*@+mustfreefresh@*/
 #undef CODE
 #undef INT
@@ -1341,6 +1719,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 		     /*@null@*/const char *device, bool scaled,
 		     /*@out@*/char *buf, size_t buflen)
 {
+    struct json_writer_t wr;
     char buf1[JSON_VAL_MAX * 2 + 1];
     char buf2[JSON_VAL_MAX * 2 + 1];
     char buf3[JSON_VAL_MAX * 2 + 1];
@@ -1602,11 +1981,12 @@ void json_aivdm_dump(const struct ais_t *ais,
 	"other",
     };
 
-    (void)snprintf(buf, buflen, "{\"class\":\"AIS\",");
+    json_wr_init(&wr, buf, buflen);
+    json_wr_printf(&wr, "{\"class\":\"AIS\",");
     if (device != NULL && device[0] != '\0')
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"device\":\"%s\",", device);
-    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+    json_wr_printf(&wr,
 		   "\"type\":%u,\"repeat\":%u,\"mmsi\":%u,\"scaled\":%s,",
 		   ais->type, ais->repeat, ais->mmsi, JSON_BOOL(scaled));
     /*@ -formatcode -mustfreefresh @*/
@@ -1647,46 +2027,54 @@ void json_aivdm_dump(const struct ais_t *ais,
 		(void)snprintf(speedlegend, sizeof(speedlegend),
 			       "%.1f", ais->type1.speed / 10.0);
 
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"status\":\"%s\",\"turn\":%s,\"speed\":%s,"
-			   "\"accuracy\":%s,\"lon\":%.4f,\"lat\":%.4f,"
-			   "\"course\":%u,\"heading\":%u,\"second\":%u,"
-			   "\"maneuver\":%u,\"raim\":%s,\"radio\":%u}\r\n",
+			   "\"accuracy\":%s,",
 			   nav_legends[ais->type1.status],
 			   turnlegend,
 			   speedlegend,
-			   JSON_BOOL(ais->type1.accuracy),
-			   ais->type1.lon / AIS_LATLON_SCALE,
-			   ais->type1.lat / AIS_LATLON_SCALE,
-			   ais->type1.course,
-			   ais->type1.heading,
-			   ais->type1.second,
-			   ais->type1.maneuver,
-			   JSON_BOOL(ais->type1.raim), ais->type1.radio);
+			   JSON_BOOL(ais->type1.accuracy));
+	    json_wr_fixed(&wr, "lon", ais->type1.lon / AIS_LATLON_SCALE, 4);
+	    json_wr_fixed(&wr, "lat", ais->type1.lat / AIS_LATLON_SCALE, 4);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-			   "\"status\":%u,\"turn\":%d,\"speed\":%u,"
-			   "\"accuracy\":%s,\"lon\":%d,\"lat\":%d,"
-			   "\"course\":%u,\"heading\":%u,\"second\":%u,"
-			   "\"maneuver\":%u,\"raim\":%s,\"radio\":%u}\r\n",
-			   ais->type1.status,
-			   ais->type1.turn,
-			   ais->type1.speed,
-			   JSON_BOOL(ais->type1.accuracy),
-			   ais->type1.lon,
-			   ais->type1.lat,
-			   ais->type1.course,
-			   ais->type1.heading,
-			   ais->type1.second,
-			   ais->type1.maneuver,
-			   JSON_BOOL(ais->type1.raim), ais->type1.radio);
+	    /*
+	     * Position reports are the bulk of any live feed, so the
+	     * lossless render is constant segments and direct integer
+	     * appends - no format-string interpretation at all.
+	     */
+	    json_wr_puts(&wr, "\"status\":");
+	    json_wr_uint(&wr, ais->type1.status);
+	    json_wr_puts(&wr, ",\"turn\":");
+	    json_wr_int(&wr, ais->type1.turn);
+	    json_wr_puts(&wr, ",\"speed\":");
+	    json_wr_uint(&wr, ais->type1.speed);
+	    json_wr_puts(&wr, ",\"accuracy\":");
+	    json_wr_puts(&wr, JSON_BOOL(ais->type1.accuracy));
+	    json_wr_puts(&wr, ",\"lon\":");
+	    json_wr_int(&wr, ais->type1.lon);
+	    json_wr_puts(&wr, ",\"lat\":");
+	    json_wr_int(&wr, ais->type1.lat);
+	    json_wr_puts(&wr, ",");
 	}
+	json_wr_puts(&wr, "\"course\":");
+	json_wr_uint(&wr, ais->type1.course);
+	json_wr_puts(&wr, ",\"heading\":");
+	json_wr_uint(&wr, ais->type1.heading);
+	json_wr_puts(&wr, ",\"second\":");
+	json_wr_uint(&wr, ais->type1.second);
+	json_wr_puts(&wr, ",\"maneuver\":");
+	json_wr_uint(&wr, ais->type1.maneuver);
+	json_wr_puts(&wr, ",\"raim\":");
+	json_wr_puts(&wr, JSON_BOOL(ais->type1.raim));
+	json_wr_puts(&wr, ",\"radio\":");
+	json_wr_uint(&wr, ais->type1.radio);
+	json_wr_puts(&wr, "}\r\n");
 	break;
     case 4:			/* Base Station Report */
     case 11:			/* UTC/Date Response */
 	/* some fields have beem merged to an ISO8601 date */
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"timestamp\":\"%4u-%02u-%02uT%02u:%02u:%02uZ\","
 			   "\"accuracy\":%s,\"lon\":%.4f,\"lat\":%.4f,"
 			   "\"epfd\":\"%s\",\"raim\":%s,\"radio\":%u}\r\n",
@@ -1702,7 +2090,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   epfd_legends[ais->type4.epfd],
 			   JSON_BOOL(ais->type4.raim), ais->type4.radio);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"timestamp\":\"%04u-%02u-%02uT%02u:%02u:%02uZ\","
 			   "\"accuracy\":%s,\"lon\":%d,\"lat\":%d,"
 			   "\"epfd\":%u,\"raim\":%s,\"radio\":%u}\r\n",
@@ -1723,57 +2111,61 @@ void json_aivdm_dump(const struct ais_t *ais,
 	/* some fields have beem merged to an ISO8601 partial date */
 	if (scaled) {
             /* *INDENT-OFF* */
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-			   "\"imo\":%u,\"ais_version\":%u,\"callsign\":\"%s\","
-			   "\"shipname\":\"%s\",\"shiptype\":\"%s\","
-			   "\"to_bow\":%u,\"to_stern\":%u,\"to_port\":%u,"
-			   "\"to_starboard\":%u,\"epfd\":\"%s\","
-			   "\"eta\":\"%02u-%02uT%02u:%02uZ\","
-			   "\"draught\":%.1f,\"destination\":\"%s\","
-			   "\"dte\":%u}\r\n",
+	    json_wr_printf(&wr,
+			   "\"imo\":%u,\"ais_version\":%u,\"callsign\":\"",
 			   ais->type5.imo,
-			   ais->type5.ais_version,
-			   json_stringify(buf1, sizeof(buf1),
-					  ais->type5.callsign),
-			   json_stringify(buf2, sizeof(buf2),
-					  ais->type5.shipname),
-			   SHIPTYPE_DISPLAY(ais->type5.shiptype),
+			   ais->type5.ais_version);
+	    json_wr_puts(&wr, json_stringify(buf1, sizeof(buf1),
+					     ais->type5.callsign));
+	    json_wr_puts(&wr, "\",\"shipname\":\"");
+	    json_wr_puts(&wr, json_stringify(buf2, sizeof(buf2),
+					     ais->type5.shipname));
+	    json_wr_puts(&wr, "\",\"shiptype\":\"");
+	    json_wr_puts(&wr, SHIPTYPE_DISPLAY(ais->type5.shiptype));
+	    json_wr_printf(&wr,
+			   "\",\"to_bow\":%u,\"to_stern\":%u,\"to_port\":%u,"
+			   "\"to_starboard\":%u,\"epfd\":\"",
 			   ais->type5.to_bow, ais->type5.to_stern,
-			   ais->type5.to_port, ais->type5.to_starboard,
-			   epfd_legends[ais->type5.epfd], ais->type5.month,
+			   ais->type5.to_port, ais->type5.to_starboard);
+	    json_wr_puts(&wr, epfd_legends[ais->type5.epfd]);
+	    json_wr_printf(&wr,
+			   "\",\"eta\":\"%02u-%02uT%02u:%02uZ\","
+			   "\"draught\":%.1f,\"destination\":\"",
+			   ais->type5.month,
 			   ais->type5.day, ais->type5.hour, ais->type5.minute,
-			   ais->type5.draught / 10.0,
-			   json_stringify(buf3, sizeof(buf3),
-					  ais->type5.destination),
-			   ais->type5.dte);
+			   ais->type5.draught / 10.0);
+	    json_wr_puts(&wr, json_stringify(buf3, sizeof(buf3),
+					     ais->type5.destination));
+	    json_wr_printf(&wr, "\",\"dte\":%u}\r\n", ais->type5.dte);
             /* *INDENT-ON* */
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
-			   "\"imo\":%u,\"ais_version\":%u,\"callsign\":\"%s\","
-			   "\"shipname\":\"%s\",\"shiptype\":%u,"
+	    json_wr_printf(&wr,
+			   "\"imo\":%u,\"ais_version\":%u,\"callsign\":\"",
+			   ais->type5.imo,
+			   ais->type5.ais_version);
+	    json_wr_puts(&wr, json_stringify(buf1, sizeof(buf1),
+					     ais->type5.callsign));
+	    json_wr_puts(&wr, "\",\"shipname\":\"");
+	    json_wr_puts(&wr, json_stringify(buf2, sizeof(buf2),
+					     ais->type5.shipname));
+	    json_wr_printf(&wr,
+			   "\",\"shiptype\":%u,"
 			   "\"to_bow\":%u,\"to_stern\":%u,\"to_port\":%u,"
 			   "\"to_starboard\":%u,\"epfd\":%u,"
 			   "\"eta\":\"%02u-%02uT%02u:%02uZ\","
-			   "\"draught\":%u,\"destination\":\"%s\","
-			   "\"dte\":%u}\r\n",
-			   ais->type5.imo,
-			   ais->type5.ais_version,
-			   json_stringify(buf1, sizeof(buf1),
-					  ais->type5.callsign),
-			   json_stringify(buf2, sizeof(buf2),
-					  ais->type5.shipname),
+			   "\"draught\":%u,\"destination\":\"",
 			   ais->type5.shiptype, ais->type5.to_bow,
 			   ais->type5.to_stern, ais->type5.to_port,
 			   ais->type5.to_starboard, ais->type5.epfd,
 			   ais->type5.month, ais->type5.day, ais->type5.hour,
-			   ais->type5.minute, ais->type5.draught,
-			   json_stringify(buf3, sizeof(buf3),
-					  ais->type5.destination),
-			   ais->type5.dte);
+			   ais->type5.minute, ais->type5.draught);
+	    json_wr_puts(&wr, json_stringify(buf3, sizeof(buf3),
+					     ais->type5.destination));
+	    json_wr_printf(&wr, "\",\"dte\":%u}\r\n", ais->type5.dte);
 	}
 	break;
     case 6:			/* Binary Message */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"seqno\":%u,\"dest_mmsi\":%u,"
 		       "\"retransmit\":%s,\"dac\":%u,\"fid\":%u,",
 		       ais->type6.seqno,
@@ -1786,7 +2178,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	    switch (ais->type6.fid) {
 	    case 12:	/* IMO236 -Dangerous cargo indication */
 		/* some fields have beem merged to an ISO8601 partial date */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"lastport\":\"%s\",\"departure\":\"%02u-%02uT%02u:%02uZ\","
 			       "\"nextport\":\"%s\",\"eta\":\"%02u-%02uT%02u:%02uZ\","
 			       "\"dangerous\":\"%s\",\"imdcat\":\"%s\","
@@ -1808,17 +2200,17 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type6.dac1fid12.unit);
 		break;
 	    case 15:	/* IMO236 - Extended Ship Static and Voyage Related Data */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		    "\"airdraught\":%u}\r\n",
 		    ais->type6.dac1fid15.airdraught);
 		break;
 	    case 16:	/* IMO236 - Number of persons on board */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"persons\":%u}\t\n", ais->type6.dac1fid16.persons);
 		imo = true;
 		break;
 	    case 18:	/* IMO289 - Clearance time to enter port */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"linkage\":%u,\"arrival\":\"%u-%uT%u:%uZ\",\"portname\":\"%s\",\"destination\":\"%s\",",
 			       ais->type6.dac1fid18.linkage,
 			       ais->type6.dac1fid18.month,
@@ -1828,18 +2220,18 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type6.dac1fid18.portname,
 			       ais->type6.dac1fid18.destination);
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"lon\":%.3f,\"lat\":%.3f}\r\n",
 				   ais->type6.dac1fid18.lon/AIS_LATLON3_SCALE,
 				   ais->type6.dac1fid18.lat/AIS_LATLON3_SCALE);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			       "\"lon\":%d,\"lat\":%d}\r\n",
 			       ais->type6.dac1fid18.lon,
 			       ais->type6.dac1fid18.lat);
 		break;
 	    case 20:        /* IMO289 - Berthing Data */
-                (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+                json_wr_printf(&wr,
 			       "\"linkage\":%u,\"berth_length\":%u,"
 			       "\"position\":%u,\"arrival\":\"%u-%uT%u:%u\","
 			       "\"availability\":%u,"
@@ -1891,7 +2283,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type6.dac1fid20.future2,
 			       ais->type6.dac1fid20.berth_name);
             if (scaled)
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"berth_lon\":%.3f,"
 			       "\"berth_lat\":%.3f,"
 			       "\"berth_depth\":%.1f}\r\n",
@@ -1899,7 +2291,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type6.dac1fid20.berth_lat / AIS_LATLON3_SCALE,
 			       ais->type6.dac1fid20.berth_depth * 0.1);
             else
-                (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+                json_wr_printf(&wr,
 			       "\"berth_lon\":%d,"
 			       "\"berth_lat\":%d,"
 			       "\"berth_depth\":%u}\r\n",
@@ -1910,34 +2302,33 @@ void json_aivdm_dump(const struct ais_t *ais,
 	    case 23:    /* IMO289 - Area notice - addressed */
 		break;
 	    case 25:	/* IMO289 - Dangerous cargo indication */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"unit\":%u,\"amount\":%u,\"cargos\":[",
 			       ais->type6.dac1fid25.unit,
 			       ais->type6.dac1fid25.amount);
 		for (i = 0; i < (int)ais->type6.dac1fid25.ncargos; i++)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "{\"code\":%u,\"subtype\":%u},",
 
 				   ais->type6.dac1fid25.cargos[i].code,
 				   ais->type6.dac1fid25.cargos[i].subtype);
-		if (buf[strlen(buf) - 1] == ',')
-		    buf[strlen(buf) - 1] = '\0';
-		(void)strlcat(buf, "]}\r\n,", buflen - strlen(buf));
+		json_wr_trim(&wr, ',');
+		json_wr_puts(&wr, "]}\r\n,");
 		break;
 	    case 28:	/* IMO289 - Route info - addressed */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		    "\"linkage\":%u,\"sender\":%u,",
 		    ais->type6.dac1fid28.linkage,
 		    ais->type6.dac1fid28.sender);
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"rtype\":\"%s\",",
 				   route_type[ais->type6.dac1fid28.rtype]);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"rtype\":%u,",
 			ais->type6.dac1fid28.rtype);
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		    "\"start\":\"%02u-%02uT%02u:%02uZ\",\"duration\":%u,\"waypoints:[",
 		    ais->type6.dac1fid28.month,
 		    ais->type6.dac1fid28.day,
@@ -1946,22 +2337,21 @@ void json_aivdm_dump(const struct ais_t *ais,
 		    ais->type6.dac1fid28.duration);
 		for (i = 0; i < ais->type6.dac1fid28.waycount; i++) {
 		    if (scaled)
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"lon\":%.4f,\"lat\":%.4f},",
 			    ais->type6.dac1fid28.waypoints[i].lon / AIS_LATLON4_SCALE,
 			    ais->type6.dac1fid28.waypoints[i].lat / AIS_LATLON4_SCALE);
 		    else
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"lon\":%d,\"lat\":%d},",
 			    ais->type6.dac1fid28.waypoints[i].lon,
 			    ais->type6.dac1fid28.waypoints[i].lat);
 		}
-		if (buf[strlen(buf) - 1] == ',')
-		    buf[strlen(buf)-1] = '\0';
-		(void)strlcat(buf, "]}\r\n,", buflen - strlen(buf));
+		json_wr_trim(&wr, ',');
+		json_wr_puts(&wr, "]}\r\n,");
 		break;
 	    case 30:	/* IMO289 - Text description - addressed */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		       "\"linkage\":%u,\"text\":\"%s\"}\r\n",
 		       ais->type6.dac1fid30.linkage,
 		       json_stringify(buf1, sizeof(buf1), 
@@ -1969,23 +2359,23 @@ void json_aivdm_dump(const struct ais_t *ais,
 		break;
 	    case 14:	/* IMO236 - Tidal Window */
 	    case 32:	/* IMO289 - Tidal Window */
-	      (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	      json_wr_printf(&wr,
 		  "\"month\":%u,\"day\":%u,\"tidals\":[",
 		  ais->type6.dac1fid32.month,
 		  ais->type6.dac1fid32.day);
 	      for (i = 0; i < ais->type6.dac1fid32.ntidals; i++) {
 		  const struct tidal_t *tp =  &ais->type6.dac1fid32.tidals[i];
 		  if (scaled)
-		      (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		      json_wr_printf(&wr,
 			  "{\"lon\":%.3f,\"lat\":%.3f,",
 			  tp->lon / AIS_LATLON3_SCALE,
 			  tp->lat / AIS_LATLON3_SCALE);
 		  else
-		      (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		      json_wr_printf(&wr,
 			  "{\"lon\":%d,\"lat\":%d,",
 			  tp->lon,
 			  tp->lat);
-		  (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		  json_wr_printf(&wr,
 		      "\"from_hour\":%u,\"from_min\":%u,\"to_hour\":%u,\"to_min\":%u,\"cdir\":%u",
 		      tp->from_hour,
 		      tp->from_min,
@@ -1993,21 +2383,20 @@ void json_aivdm_dump(const struct ais_t *ais,
 		      tp->to_min,
 		      tp->cdir);
 		  if (scaled)
-		      (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		      json_wr_printf(&wr,
 			  "\"cspeed\":%.1f},",
 			  tp->cspeed / 10.0);
 		  else
-		      (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		      json_wr_printf(&wr,
 			  "\"cspeed\":%u},",
 			  tp->cspeed);
 	      }
-	      if (buf[strlen(buf) - 1] == ',')
-		  buf[strlen(buf)-1] = '\0';
-	      (void)strlcat(buf, "]}\r\n,", buflen - strlen(buf));
+	      json_wr_trim(&wr, ',');
+	      json_wr_puts(&wr, "]}\r\n,");
 	      break;
 	    }
 	if (!imo)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"data\":\"%zd:%s\"}\r\n",
 			   ais->type6.bitcount,
 			   gpsd_hexdump((char *)ais->type6.bitdata,
@@ -2015,14 +2404,14 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 7:			/* Binary Acknowledge */
     case 13:			/* Safety Related Acknowledge */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"mmsi1\":%u,\"mmsi2\":%u,\"mmsi3\":%u,\"mmsi4\":%u}\r\n",
 		       ais->type7.mmsi1,
 		       ais->type7.mmsi2, ais->type7.mmsi3, ais->type7.mmsi4);
 	break;
     case 8:			/* Binary Broadcast Message */
 	imo = false;
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"dac\":%u,\"fid\":%u,",ais->type8.dac,ais->type8.fid);
 	if (ais->type8.dac == 1) {
 	    const char *trends[] = {
@@ -2037,20 +2426,20 @@ void json_aivdm_dump(const struct ais_t *ais,
 		/* some fields have beem merged to an ISO8601 partial date */
 		/* layout is almost identical to FID=31 from IMO289 */
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "{\"lat\":%.3f,\"lon\":%.3f,",
 				   ais->type8.dac1fid31.lat / AIS_LATLON3_SCALE,
 				   ais->type8.dac1fid31.lon / AIS_LATLON3_SCALE);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "{\"lat\":%d,\"lon\":%d,",
 				   ais->type8.dac1fid31.lat,
 				   ais->type8.dac1fid31.lon);
 		if (ais->type8.fid == 31)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"accuracy\":%s,",
 				   JSON_BOOL(ais->type8.dac1fid31.accuracy));
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"timestamp\":\"%02uT%02u:%02uZ\","
 			       "\"wapeed\":%u,\"wgust\":%u,\"wdir\":%u,"
 			       "\"wgustdir\":%u,\"humidity\":%u",
@@ -2063,7 +2452,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type8.dac1fid31.wgustdir,
 			       ais->type8.dac1fid31.humidity);
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"airtemp\":%1f,\"dewpoint\":%1f,"
 				   "\"pressure\":%u,\"pressuretend\":\"%s\",",
 				   ais->type8.dac1fid31.airtemp * 0.1,
@@ -2071,7 +2460,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 				   ais->type8.dac1fid31.pressure,
 				   trends[ais->type8.dac1fid31.pressuretend]);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"airtemp\":%d,\"dewpoint\":%d,"
 				   "\"pressure\":%u,\"pressuretend\":%u,"
 				   "\"visgreater\":%s,",
@@ -2082,23 +2471,23 @@ void json_aivdm_dump(const struct ais_t *ais,
 				   JSON_BOOL(ais->type8.dac1fid31.visgreater));
 
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"visibility\":%1f,",
 				   ais->type8.dac1fid31.visibility * 0.1);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"visibility\":%u,:",
 				   ais->type8.dac1fid31.visibility);
 		if (!scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"waterlevel\":%d,",
 				   ais->type8.dac1fid31.waterlevel);
 		else if (ais->type8.fid == 31)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"waterlevel\":%.1f,:",
 				   ais->type8.dac1fid31.waterlevel * 0.01);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"waterlevel\":%.1f,:",
 				   ais->type8.dac1fid31.waterlevel * 0.1);
 
@@ -2113,7 +2502,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			"reserved",
 			"N/A",
 		    };
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"leveltrend\":\"%s\","
 				   "\"cspeed\":%.1f,\"cdir\":%u"
 				   "\"cspeed2\":%.1f,\"cdir2\":%u,\"cdepth2\":%u,"
@@ -2143,7 +2532,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 				   ais->type8.dac1fid31.salinity * 0.1,
 				   JSON_BOOL(ais->type8.dac1fid31.ice));
 		} else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 				   "\"leveltrend\":%u,"
 				   "\"cspeed\":%u,\"cdir\":%u"
 				   "\"cspeed2\":%u,\"cdir2\":%u,\"cdepth2\":%u,"
@@ -2172,11 +2561,11 @@ void json_aivdm_dump(const struct ais_t *ais,
 				   ais->type8.dac1fid31.preciptype,
 				   ais->type8.dac1fid31.salinity,
 				   JSON_BOOL(ais->type8.dac1fid31.ice));
-		(void)strlcat(buf, "}\r\n", buflen - strlen(buf));
+		json_wr_puts(&wr, "}\r\n");
 		imo = true;
 		break;
 	    case 13:        /* IMO236 - Fairway closed */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"reason\":\"%s\",\"closefrom\":\"%s\","
 			       "\"closeto\":\"%s\",\"radius\":%u,"
 			       "\"extunit\":%u,"
@@ -2197,69 +2586,68 @@ void json_aivdm_dump(const struct ais_t *ais,
 			       ais->type8.dac1fid13.tminute);
 		break;
 	    case 15:        /* IMO236 - Extended ship and voyage */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			       "\"airdraught\":%u}\r\n",
 			       ais->type8.dac1fid15.airdraught);
 		break;
 	    case 17:        /* IMO289 - VTS-generated/synthetic targets */
-		(void)strlcat(buf, "\"targets\":[", buflen - strlen(buf));
+		json_wr_puts(&wr, "\"targets\":[");
 		for (i = 0; i < ais->type8.dac1fid17.ntargets; i++) {
 		    if (scaled)
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"idtype\":\"%s\",",
 			    idtypes[ais->type8.dac1fid17.targets[i].idtype]);
 		    else
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"idtype\":%u,",
 			    ais->type8.dac1fid17.targets[i].idtype);
 		    switch (ais->type8.dac1fid17.targets[i].idtype) {
 		    case DAC1FID17_IDTYPE_MMSI:
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"%s\":\"%u\",",
 			    idtypes[ais->type8.dac1fid17.targets[i].idtype],
 			    ais->type8.dac1fid17.targets[i].id.mmsi);
 			break;
 		    case DAC1FID17_IDTYPE_IMO:
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"%s\":\"%u\",",
 			    idtypes[ais->type8.dac1fid17.targets[i].idtype],
 			    ais->type8.dac1fid17.targets[i].id.imo);
 			break;
 		    case DAC1FID17_IDTYPE_CALLSIGN:
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"%s\":\"%s\",",
 			    idtypes[ais->type8.dac1fid17.targets[i].idtype],
 			    ais->type8.dac1fid17.targets[i].id.callsign);
 			break;
 		    default:
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"%s\":\"%s\",",
 			    idtypes[ais->type8.dac1fid17.targets[i].idtype],
 			    ais->type8.dac1fid17.targets[i].id.other);
 		    }
 		    if (scaled)
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"lat\":%.3f,\"lon\":%.3f,",
 			    ais->type8.dac1fid17.targets[i].lat / AIS_LATLON3_SCALE,
 			    ais->type8.dac1fid17.targets[i].lon / AIS_LATLON3_SCALE);
 		    else
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "\"lat\":%d,\"lon\":%d,",
 			    ais->type8.dac1fid17.targets[i].lat,
 			    ais->type8.dac1fid17.targets[i].lon);
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"course\":%u,\"second\":%u,\"speed\":%u},",
 			ais->type8.dac1fid17.targets[i].course,
 			ais->type8.dac1fid17.targets[i].second,
 			ais->type8.dac1fid17.targets[i].speed);
 		}
-		if (buf[strlen(buf) - 1] == ',')
-		    buf[strlen(buf) - 1] = '\0';
-		(void)strlcat(buf, "]}\r\n,", buflen - strlen(buf));
+		json_wr_trim(&wr, ',');
+		json_wr_puts(&wr, "]}\r\n,");
 		break;
 	    case 19:        /* IMO289 - Marine Traffic Signal */
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"linkage\":%u,\"station\":\"%s\",\"lon\":%.3f,\"lat\":%.3f,\"status\":%u,\"signal\":\"%s\",\"hour\":%u,\"minute\":%u,\"nextsignal\":\"%s\"}\r\n",
 			ais->type8.dac1fid19.linkage,
 			ais->type8.dac1fid19.station,
@@ -2271,7 +2659,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			ais->type8.dac1fid19.minute,
 			SIGNAL_DISPLAY(ais->type8.dac1fid19.nextsignal));
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"linkage\":%u,\"station\":\"%s\",\"lon\":%d,\"lat\":%d,\"status\":%u,\"signal\":%u,\"hour\":%u,\"minute\":%u,\"nextsignal\":%u}\r\n",
 			ais->type8.dac1fid19.linkage,
 			ais->type8.dac1fid19.station,
@@ -2292,19 +2680,19 @@ void json_aivdm_dump(const struct ais_t *ais,
 	    case 25:        /* IMO289 - Dangerous Cargo Indication */
 		break;
 	    case 27:        /* IMO289 - Route information - broadcast */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		    "\"linkage\":%u,\"sender\":%u,",
 		    ais->type8.dac1fid27.linkage,
 		    ais->type8.dac1fid27.sender);
 		if (scaled)
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"rtype\":\"%s\",",
 			route_type[ais->type8.dac1fid27.rtype]);
 		else
-		    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		    json_wr_printf(&wr,
 			"\"rtype\":%u,",
 			ais->type8.dac1fid27.rtype);
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 			"\"start\":\"%02u-%02uT%02u:%02uZ\",\"duration\":%u,\"waypoints\":[",
 		    ais->type8.dac1fid27.month,
 		    ais->type8.dac1fid27.day,
@@ -2313,22 +2701,21 @@ void json_aivdm_dump(const struct ais_t *ais,
 		    ais->type8.dac1fid27.duration);
 		for (i = 0; i < ais->type8.dac1fid27.waycount; i++) {
 		    if (scaled)
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"lon\":%.4f,\"lat\":%.4f},",
 			    ais->type8.dac1fid27.waypoints[i].lon / AIS_LATLON4_SCALE,
 			    ais->type8.dac1fid27.waypoints[i].lat / AIS_LATLON4_SCALE);
 		    else
-			(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+			json_wr_printf(&wr,
 			    "{\"lon\":%d,\"lat\":%d},",
 			    ais->type8.dac1fid27.waypoints[i].lon,
 			    ais->type8.dac1fid27.waypoints[i].lat);
 		}
-		if (buf[strlen(buf) - 1] == ',')
-		    buf[strlen(buf) - 1] = '\0';
-		(void)strlcat(buf, "]}\r\n,", buflen - strlen(buf));
+		json_wr_trim(&wr, ',');
+		json_wr_puts(&wr, "]}\r\n,");
 		break;
 	    case 29:        /* IMO289 - Text Description - broadcast */
-		(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+		json_wr_printf(&wr,
 		       "\"linkage\":%u,\"text\":\"%s\"}\r\n",
 		       ais->type8.dac1fid29.linkage,
 		       json_stringify(buf1, sizeof(buf1), 
@@ -2337,7 +2724,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	    }
 	}
 	if (!imo)
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"data\":\"%zd:%s\"}\r\n",
 			   ais->type8.bitcount,
 			   gpsd_hexdump((char *)ais->type8.bitdata,
@@ -2372,7 +2759,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 		(void)snprintf(speedlegend, sizeof(speedlegend),
 			       "%u", ais->type1.speed);
 
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"alt\":%s,\"speed\":%s,\"accuracy\":%s,"
 			   "\"lon\":%.4f,\"lat\":%.4f,\"course\":%.1f,"
 			   "\"second\":%u,\"regional\":%u,\"dte\":%u,"
@@ -2388,7 +2775,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   ais->type9.dte,
 			   JSON_BOOL(ais->type9.raim), ais->type9.radio);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"alt\":%u,\"speed\":%u,\"accuracy\":%s,"
 			   "\"lon\":%d,\"lat\":%d,\"course\":%u,"
 			   "\"second\":%u,\"regional\":%u,\"dte\":%u,"
@@ -2406,11 +2793,11 @@ void json_aivdm_dump(const struct ais_t *ais,
 	}
 	break;
     case 10:			/* UTC/Date Inquiry */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"dest_mmsi\":%u}\r\n", ais->type10.dest_mmsi);
 	break;
     case 12:			/* Safety Related Message */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"seqno\":%u,\"dest_mmsi\":%u,\"retransmit\":%s,\"text\":\"%s\"}\r\n",
 		       ais->type12.seqno,
 		       ais->type12.dest_mmsi,
@@ -2418,12 +2805,12 @@ void json_aivdm_dump(const struct ais_t *ais,
 		       json_stringify(buf1, sizeof(buf1), ais->type12.text));
 	break;
     case 14:			/* Safety Related Broadcast Message */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"text\":\"%s\"}\r\n",
 		       json_stringify(buf1, sizeof(buf1), ais->type14.text));
 	break;
     case 15:			/* Interrogation */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"mmsi1\":%u,\"type1_1\":%u,\"offset1_1\":%u,"
 		       "\"type1_2\":%u,\"offset1_2\":%u,\"mmsi2\":%u,"
 		       "\"type2_1\":%u,\"offset2_1\":%u}\r\n",
@@ -2436,7 +2823,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 		       ais->type15.type2_1, ais->type15.offset2_1);
 	break;
     case 16:
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"mmsi1\":%u,\"offset1\":%u,\"increment1\":%u,"
 		       "\"mmsi2\":%u,\"offset2\":%u,\"increment2\":%u}\r\n",
 		       ais->type16.mmsi1,
@@ -2447,7 +2834,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 17:
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"lon\":%.1f,\"lat\":%.1f,\"data\":\"%zd:%s\"}\r\n",
 			   ais->type17.lon / AIS_GNSS_LATLON_SCALE,
 			   ais->type17.lat / AIS_GNSS_LATLON_SCALE,
@@ -2455,7 +2842,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   gpsd_hexdump((char *)ais->type17.bitdata,
 					(ais->type17.bitcount + 7) / 8));
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"lon\":%d,\"lat\":%d,\"data\":\"%zd:%s\"}\r\n",
 			   ais->type17.lon,
 			   ais->type17.lat,
@@ -2466,7 +2853,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 18:
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"reserved\":%u,\"speed\":%.1f,\"accuracy\":%s,"
 			   "\"lon\":%.4f,\"lat\":%.4f,\"course\":%.1f,"
 			   "\"heading\":%u,\"second\":%u,\"regional\":%u,"
@@ -2488,7 +2875,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   JSON_BOOL(ais->type18.msg22),
 			   JSON_BOOL(ais->type18.raim), ais->type18.radio);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"reserved\":%u,\"speed\":%u,\"accuracy\":%s,"
 			   "\"lon\":%d,\"lat\":%d,\"course\":%u,"
 			   "\"heading\":%u,\"second\":%u,\"regional\":%u,"
@@ -2513,14 +2900,11 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 19:
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"reserved\":%u,\"speed\":%.1f,\"accuracy\":%s,"
 			   "\"lon\":%.4f,\"lat\":%.4f,\"course\":%.1f,"
 			   "\"heading\":%u,\"second\":%u,\"regional\":%u,"
-			   "\"shipname\":\"%s\",\"shiptype\":\"%s\","
-			   "\"to_bow\":%u,\"to_stern\":%u,\"to_port\":%u,"
-			   "\"to_starboard\":%u,\"epfd\":\"%s\",\"raim\":%s,"
-			   "\"dte\":%u,\"assigned\":%s}\r\n",
+			   "\"shipname\":\"",
 			   ais->type19.reserved,
 			   ais->type19.speed / 10.0,
 			   JSON_BOOL(ais->type19.accuracy),
@@ -2529,18 +2913,24 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   ais->type19.course / 10.0,
 			   ais->type19.heading,
 			   ais->type19.second,
-			   ais->type19.regional,
-			   ais->type19.shipname,
-			   SHIPTYPE_DISPLAY(ais->type19.shiptype),
+			   ais->type19.regional);
+	    json_wr_puts(&wr, ais->type19.shipname);
+	    json_wr_puts(&wr, "\",\"shiptype\":\"");
+	    json_wr_puts(&wr, SHIPTYPE_DISPLAY(ais->type19.shiptype));
+	    json_wr_printf(&wr,
+			   "\",\"to_bow\":%u,\"to_stern\":%u,\"to_port\":%u,"
+			   "\"to_starboard\":%u,\"epfd\":\"",
 			   ais->type19.to_bow,
 			   ais->type19.to_stern,
 			   ais->type19.to_port,
-			   ais->type19.to_starboard,
-			   epfd_legends[ais->type19.epfd],
+			   ais->type19.to_starboard);
+	    json_wr_puts(&wr, epfd_legends[ais->type19.epfd]);
+	    json_wr_printf(&wr,
+			   "\",\"raim\":%s,\"dte\":%u,\"assigned\":%s}\r\n",
 			   JSON_BOOL(ais->type19.raim),
 			   ais->type19.dte, JSON_BOOL(ais->type19.assigned));
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"reserved\":%u,\"speed\":%u,\"accuracy\":%s,"
 			   "\"lon\":%d,\"lat\":%d,\"course\":%u,"
 			   "\"heading\":%u,\"second\":%u,\"regional\":%u,"
@@ -2569,7 +2959,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	}
 	break;
     case 20:			/* Data Link Management Message */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"offset1\":%u,\"number1\":%u,"
 		       "\"timeout1\":%u,\"increment1\":%u,"
 		       "\"offset2\":%u,\"number2\":%u,"
@@ -2596,7 +2986,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 21:			/* Aid to Navigation */
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"aid_type\":\"%s\",\"name\":\"%s\",\"lon\":%.4f,"
 			   "\"lat\":%.4f,\"accuracy\":%s,\"to_bow\":%u,"
 			   "\"to_stern\":%u,\"to_port\":%u,"
@@ -2618,7 +3008,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   JSON_BOOL(ais->type21.raim),
 			   JSON_BOOL(ais->type21.virtual_aid));
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"aid_type\":%u,\"name\":\"%s\",\"accuracy\":%s,"
 			   "\"lon\":%d,\"lat\":%d,\"to_bow\":%u,"
 			   "\"to_stern\":%u,\"to_port\":%u,\"to_starboard\":%u,"
@@ -2643,18 +3033,18 @@ void json_aivdm_dump(const struct ais_t *ais,
 	}
 	break;
     case 22:			/* Channel Management */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"channel_a\":%u,\"channel_b\":%u,"
 		       "\"txrx\":%u,\"power\":%s,",
 		       ais->type22.channel_a,
 		       ais->type22.channel_b,
 		       ais->type22.txrx, JSON_BOOL(ais->type22.power));
 	if (ais->type22.addressed) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"dest1\":%u,\"dest2\":%u",
 			   ais->type22.mmsi.dest1, ais->type22.mmsi.dest2);
 	} else if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"ne_lon\":\"%f\",\"ne_lat\":\"%f\","
 			   "\"sw_lon\":\"%f\",\"sw_lat\":\"%f\",",
 			   ais->type22.area.ne_lon / AIS_CHANNEL_LATLON_SCALE,
@@ -2663,14 +3053,14 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   ais->type22.area.sw_lat /
 			   AIS_CHANNEL_LATLON_SCALE);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"ne_lon\":%d,\"ne_lat\":%d,"
 			   "\"sw_lon\":%d,\"sw_lat\":%d,",
 			   ais->type22.area.ne_lon,
 			   ais->type22.area.ne_lat,
 			   ais->type22.area.sw_lon, ais->type22.area.sw_lat);
 	}
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"addressed\":%s,\"band_a\":%s,"
 		       "\"band_b\":%s,\"zonesize\":%u}\r\n",
 		       JSON_BOOL(ais->type22.addressed),
@@ -2679,7 +3069,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	break;
     case 23:			/* Group Assignment Command */
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"ne_lon\":\"%f\",\"ne_lat\":\"%f\","
 			   "\"sw_lon\":\"%f\",\"sw_lat\":\"%f\","
 			   "\"stationtype\":\"%s\",\"shiptype\":\"%s\","
@@ -2692,7 +3082,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 			   SHIPTYPE_DISPLAY(ais->type23.shiptype),
 			   ais->type23.interval, ais->type23.quiet);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"ne_lon\":%d,\"ne_lat\":%d,"
 			   "\"sw_lon\":%d,\"sw_lat\":%d,"
 			   "\"stationtype\":%u,\"shiptype\":%u,"
@@ -2707,27 +3097,27 @@ void json_aivdm_dump(const struct ais_t *ais,
 	}
 	break;
     case 24:			/* Class B CS Static Data Report */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"shipname\":\"%s\",",
 		       json_stringify(buf1, sizeof(buf1),
 				      ais->type24.shipname));
 	if (scaled) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"shiptype\":\"%s\",",
 			   SHIPTYPE_DISPLAY(ais->type24.shiptype));
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"shiptype\":%u,", ais->type24.shiptype);
 	}
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"vendorid\":\"%s\",\"callsign\":\"%s\",",
 		       ais->type24.vendorid, ais->type24.callsign);
 	if (AIS_AUXILIARY_MMSI(ais->mmsi)) {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "mothership_\"mmsi\":%u}\r\n",
 			   ais->type24.mothership_mmsi);
 	} else {
-	    (void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	    json_wr_printf(&wr,
 			   "\"to_bow\":%u,\"to_stern\":%u,"
 			   "\"to_port\":%u,\"to_starboard\":%u}\r\n",
 			   ais->type24.dim.to_bow,
@@ -2737,7 +3127,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 	}
 	break;
     case 25:			/* Binary Message, Single Slot */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"addressed\":%s,\"structured\":%s,\"dest_mmsi\":%u,"
 		       "\"app_id\":%u,\"data\":\"%zd:%s\"}\r\n",
 		       JSON_BOOL(ais->type25.addressed),
@@ -2749,7 +3139,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 				    (ais->type25.bitcount + 7) / 8));
 	break;
     case 26:			/* Binary Message, Multiple Slot */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"addressed\":%s,\"structured\":%s,\"dest_mmsi\":%u,"
 		       "\"app_id\":%u,\"data\":\"%zd:%s\"\"radio\":%u}\r\n",
 		       JSON_BOOL(ais->type26.addressed),
@@ -2762,7 +3152,7 @@ void json_aivdm_dump(const struct ais_t *ais,
 		       ais->type26.radio);
 	break;
     case 27:			/* Long Range AIS Broadcast message */
-	(void)snprintf(buf + strlen(buf), buflen - strlen(buf),
+	json_wr_printf(&wr,
 		       "\"status\":\"%s\","
 		       "\"accuracy\":%s,\"lon\":%.1f,\"lat\":%.1f,"
 		       "\"speed\":%u,\"course\":%u,raim\":%s,\"gnss\":%s}\r\n",
@@ -2776,9 +3166,8 @@ void json_aivdm_dump(const struct ais_t *ais,
 		       JSON_BOOL(ais->type27.gnss));
 	break;
     default:
-	if (buf[strlen(buf) - 1] == ',')
-	    buf[strlen(buf) - 1] = '\0';
-	(void)strlcat(buf, "}\r\n", buflen);
+	json_wr_trim(&wr, ',');
+	json_wr_puts(&wr, "}\r\n");
 	break;
     }
     /*@ +formatcode +mustfreefresh @*/
@@ -2790,126 +3179,102 @@ void json_att_dump(const struct gps_data_t *gpsdata,
 		   /*@out@*/ char *reply, size_t replylen)
 /* dump the contents of an attitude_t structure as JSON */
 {
+    struct json_writer_t wr;
     assert(replylen > 2);
-    (void)strlcpy(reply, "{\"class\":\"ATT\",", replylen);
-    (void)snprintf(reply + strlen(reply),
-		   replylen - strlen(reply),
+    json_wr_init(&wr, reply, replylen);
+    json_wr_puts(&wr, "{\"class\":\"ATT\",");
+    json_wr_printf(&wr,
 		   "\"tag\":\"%s\",",
 		   gpsdata->tag[0] != '\0' ? gpsdata->tag : "-");
-    (void)snprintf(reply + strlen(reply),
-		   replylen - strlen(reply),
+    json_wr_printf(&wr,
 		   "\"device\":\"%s\",", gpsdata->dev.path);
     if (isnan(gpsdata->attitude.heading) == 0) {
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"heading\":%.2f,", gpsdata->attitude.heading);
 	if (gpsdata->attitude.mag_st != '\0')
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"mag_st\":\"%c\",", gpsdata->attitude.mag_st);
 
     }
     if (isnan(gpsdata->attitude.pitch) == 0) {
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"pitch\":%.2f,", gpsdata->attitude.pitch);
 	if (gpsdata->attitude.pitch_st != '\0')
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"pitch_st\":\"%c\",",
 			   gpsdata->attitude.pitch_st);
 
     }
     if (isnan(gpsdata->attitude.yaw) == 0) {
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"yaw\":%.2f,", gpsdata->attitude.yaw);
 	if (gpsdata->attitude.yaw_st != '\0')
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"yaw_st\":\"%c\",", gpsdata->attitude.yaw_st);
 
     }
     if (isnan(gpsdata->attitude.roll) == 0) {
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"roll\":%.2f,", gpsdata->attitude.roll);
 	if (gpsdata->attitude.roll_st != '\0')
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"roll_st\":\"%c\",", gpsdata->attitude.roll_st);
 
     }
     if (isnan(gpsdata->attitude.yaw) == 0) {
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"yaw\":%.2f,", gpsdata->attitude.yaw);
 	if (gpsdata->attitude.yaw_st != '\0')
-	    (void)snprintf(reply + strlen(reply),
-			   replylen - strlen(reply),
+	    json_wr_printf(&wr,
 			   "\"yaw_st\":\"%c\",", gpsdata->attitude.yaw_st);
 
     }
     if (isnan(gpsdata->attitude.dip) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"dip\":%.3f,", gpsdata->attitude.dip);
 
     if (isnan(gpsdata->attitude.mag_len) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"mag_len\":%.3f,", gpsdata->attitude.mag_len);
     if (isnan(gpsdata->attitude.mag_x) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"mag_x\":%.3f,", gpsdata->attitude.mag_x);
     if (isnan(gpsdata->attitude.mag_y) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"mag_y\":%.3f,", gpsdata->attitude.mag_y);
     if (isnan(gpsdata->attitude.mag_z) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"mag_z\":%.3f,", gpsdata->attitude.mag_z);
 
     if (isnan(gpsdata->attitude.acc_len) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"acc_len\":%.3f,", gpsdata->attitude.acc_len);
     if (isnan(gpsdata->attitude.acc_x) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"acc_x\":%.3f,", gpsdata->attitude.acc_x);
     if (isnan(gpsdata->attitude.acc_y) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"acc_y\":%.3f,", gpsdata->attitude.acc_y);
     if (isnan(gpsdata->attitude.acc_z) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"acc_z\":%.3f,", gpsdata->attitude.acc_z);
 
     if (isnan(gpsdata->attitude.gyro_x) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"gyro_x\":%.3f,", gpsdata->attitude.gyro_x);
     if (isnan(gpsdata->attitude.gyro_y) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"gyro_y\":%.3f,", gpsdata->attitude.gyro_y);
 
     if (isnan(gpsdata->attitude.temp) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"temp\":%.3f,", gpsdata->attitude.temp);
     if (isnan(gpsdata->attitude.depth) == 0)
-	(void)snprintf(reply + strlen(reply),
-		       replylen - strlen(reply),
+	json_wr_printf(&wr,
 		       "\"depth\":%.3f,", gpsdata->attitude.depth);
 
-    if (reply[strlen(reply) - 1] == ',')
-	reply[strlen(reply) - 1] = '\0';	/* trim trailing comma */
-    (void)strlcat(reply, "}\r\n", replylen);
+    json_wr_trim(&wr, ',');
+    json_wr_puts(&wr, "}\r\n");
 }
 #endif /* COMPASS_ENABLE */
 
@@ -2919,10 +3284,14 @@ void json_data_report(gps_mask_t changed,
 		 /*@out@*/char *buf, size_t buflen)
 /* report a session state in JSON */
 {
+    /* a policy that never selected classes means "no restriction" */
+    if (policy->classmask != 0)
+	changed &= policy->classmask | ~WATCH_CLASSES;
+
     buf[0] = '\0';
- 
+
     if ((changed & REPORT_IS) != 0) {
-	json_tpv_dump(datap, buf+strlen(buf), buflen-strlen(buf));
+	json_tpv_dump_cached(datap, buf+strlen(buf), buflen-strlen(buf));
     }
 
     if ((changed & GST_SET) != 0) {
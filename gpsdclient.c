@@ -11,6 +11,10 @@
 #include <math.h>
 #include <assert.h>
 #include <locale.h>
+#include <time.h>
+#ifndef S_SPLINT_S
+#include <unistd.h>
+#endif /* S_SPLINT_S */
 
 #include "gpsd_config.h"
 #include "gps.h"
@@ -64,7 +68,55 @@
     return str;
 }
 
-/* 
+/*
+ * Change-detecting formatters for the display clients.  cgps and
+ * lcdgps repaint on every sentence received, but between fixes the
+ * underlying values rarely change, and the modf()/snprintf() chains
+ * behind each repaint are visible work on small display hardware.
+ * Each formatter remembers its last input and hands back the
+ * previously formatted text when called with the same value again.
+ */
+
+/*@observer@*/ char *fmt_latlon(enum deg_str_type type, double f, bool is_lat)
+/* degrees with hemisphere suffix, e.g. "40 11.2345' N" */
+{
+    static struct {
+	bool valid;
+	enum deg_str_type type;
+	double value;
+	char text[48];
+    } cache[2];		/* one slot for latitude, one for longitude */
+    int i = is_lat ? 0 : 1;
+
+    if (!cache[i].valid || cache[i].type != type || cache[i].value != f) {
+	(void)snprintf(cache[i].text, sizeof(cache[i].text), "%s %c",
+		       deg_to_str(type, fabs(f)),
+		       is_lat ? ((f < 0) ? 'S' : 'N')
+			      : ((f < 0) ? 'W' : 'E'));
+	cache[i].valid = true;
+	cache[i].type = type;
+	cache[i].value = f;
+    }
+    return cache[i].text;
+}
+
+/*@observer@*/ char *fmt_speed(double speed, double factor, const char *units)
+/* converted speed with unit suffix, e.g. "52.7 mph" */
+{
+    static char text[32];
+    static double oldspeed, oldfactor;
+    static bool valid = false;
+
+    if (!valid || speed != oldspeed || factor != oldfactor) {
+	(void)snprintf(text, sizeof(text), "%.1f %s", speed * factor, units);
+	oldspeed = speed;
+	oldfactor = factor;
+	valid = true;
+    }
+    return text;
+}
+
+/*
  * check the environment to determine proper GPS units
  *
  * clients should only call this if no user preference is specified on 
@@ -175,6 +227,36 @@ void gpsd_source_spec(const char *arg, struct fixsource_t *source)
 
 /*@ +observertrans -statictrans +mustfreeonly +branchstate +kepttrans @*/
 
+void gpsd_reconnect(struct gps_data_t *gpsdata,
+		    const struct fixsource_t *source, unsigned int flags)
+/* reconnect to a restarted daemon, replaying the prior watch policy */
+{
+    static bool seeded = false;
+    useconds_t naptime = 50000;
+
+    if (!seeded) {
+	srandom((unsigned int)getpid() ^ (unsigned int)time(NULL));
+	seeded = true;
+    }
+
+    (void)gps_close(gpsdata);
+    /*@-nullpass@*/
+    while (gps_open(source->server, source->port, gpsdata) != 0) {
+	/*
+	 * Jittered exponential backoff: a fleet of clients bounced
+	 * by the same daemon restart must not stampede it in
+	 * lockstep when it comes back.
+	 */
+	(void)usleep(naptime + (useconds_t)(random() % (long)naptime));
+	if (naptime < 8000000)
+	    naptime *= 2;
+    }
+    if (source->device != NULL)
+	flags |= WATCH_DEVICE;
+    (void)gps_stream(gpsdata, flags, source->device);
+    /*@+nullpass@*/
+}
+
 char *maidenhead(double n, double e)
 /* lat/lon to Maidenhead */
 {
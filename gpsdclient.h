@@ -22,10 +22,17 @@ enum unit gpsd_units(void);
 enum deg_str_type { deg_dd, deg_ddmm, deg_ddmmss };
 
 extern /*@observer@*/ char *deg_to_str( enum deg_str_type type,  double f);
+extern /*@observer@*/ char *fmt_latlon(enum deg_str_type, double, bool);
+extern /*@observer@*/ char *fmt_speed(double, double, const char *);
 
-extern void gpsd_source_spec(/*@null@*/const char *fromstring, 
+extern void gpsd_source_spec(/*@null@*/const char *fromstring,
 			     /*@out@*/struct fixsource_t *source);
 
+struct gps_data_t;
+extern void gpsd_reconnect(struct gps_data_t *gpsdata,
+			   const struct fixsource_t *source,
+			   unsigned int flags);
+
 char *maidenhead(double n,double e);
 
 /* this needs to match JSON_DATE_MAX in gpsd.h */
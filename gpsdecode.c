@@ -7,6 +7,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdarg.h>
+#include <pthread.h>
 #ifndef S_SPLINT_S
 #include <unistd.h>
 #endif /* S_SPLINT_S */
@@ -17,6 +18,7 @@
 static int verbose = 0;
 static bool scaled = true;
 static bool json = true;
+static bool benchmark = false;
 static unsigned int ntypes = 0;
 static unsigned int typelist[32];
 
@@ -391,6 +393,8 @@ static void decode(FILE *fpin, FILE*fpout)
     struct gps_context_t context;
     struct policy_t policy;
     char buf[GPS_JSON_RESPONSE_MAX * 4];
+    unsigned long messages = 0;
+    timestamp_t starttime;
 
     //This looks like a good idea, but it breaks regression tests
     //(void)strlcpy(session.gpsdata.dev.path, "stdin", sizeof(session.gpsdata.dev.path));
@@ -405,6 +409,7 @@ static void decode(FILE *fpin, FILE*fpout)
     session.gpsdata.gps_fd = fileno(fpin);
     session.gpsdata.dev.baudrate = 38400;     /* hack to enable subframes */
 
+    starttime = timestamp();
     for (;;)
     {
 	gps_mask_t changed = gpsd_poll(&session);
@@ -424,20 +429,217 @@ static void decode(FILE *fpin, FILE*fpout)
 		(void)fputs((char *)session.packet.outbuffer, fpout);
 		(void)fputs("\n", fpout);
 	    } else
-		json_data_report(changed, 
-				 &session.gpsdata, &policy, 
+		json_data_report(changed,
+				 &session.gpsdata, &policy,
 				 buf, sizeof(buf));
-	    (void)fputs(buf, fpout);	
+	    messages++;
+	    if (!benchmark)
+		(void)fputs(buf, fpout);
 #ifdef AIVDM_ENABLE
 	} else if (session.packet.type == AIVDM_PACKET) {
 	    if ((changed & AIS_SET)!=0) {
 		aivdm_csv_dump(&session.gpsdata.ais, buf, sizeof(buf));
-		(void)fputs(buf, fpout);
+		messages++;
+		if (!benchmark)
+		    (void)fputs(buf, fpout);
 	    }
 #endif /* AIVDM_ENABLE */
 	}
     }
+
+    if (benchmark) {
+	double elapsed = timestamp() - starttime;
+
+	(void)fprintf(stderr,
+		      "gpsdecode: %lu messages in %.3f seconds, %.0f messages/s\n",
+		      messages, elapsed,
+		      (elapsed > 0.0) ? (double)messages / elapsed : 0.0);
+    }
+}
+
+#ifdef AIVDM_ENABLE
+/*
+ * Parallel batch decode for AIVDM replay.  Captured AIS is
+ * embarrassingly parallel at sentence-group granularity: each worker
+ * carries its own reassembly contexts, so a batch is correct as long
+ * as multi-fragment groups are not split across workers.  Input is
+ * dealt out in contiguous chunks, cut only where no fragment group is
+ * open, and chunk outputs are flushed in input order, so the result
+ * matches the serial decode line for line.
+ */
+
+#define BATCH_LINES	4096	/* input lines per worker per pass */
+#define AIS_LINE_MAX	256
+
+struct batch_worker_t {
+    pthread_t tid;
+    char (*lines)[AIS_LINE_MAX];
+    int nlines;
+    char *out;
+    size_t outlen;
+    size_t outsize;
+    unsigned long messages;
+};
+
+static void worker_append(struct batch_worker_t *wp, const char *s)
+{
+    size_t len = strlen(s);
+
+    while (wp->outlen + len + 1 > wp->outsize) {
+	wp->outsize *= 2;
+	wp->out = realloc(wp->out, wp->outsize);
+	if (wp->out == NULL) {
+	    (void)fputs("gpsdecode: out of memory\n", stderr);
+	    exit(1);
+	}
+    }
+    memcpy(wp->out + wp->outlen, s, len + 1);
+    wp->outlen += len;
+}
+
+static /*@null@*/ void *worker_decode(void *arg)
+{
+    struct batch_worker_t *wp = (struct batch_worker_t *)arg;
+    struct aivdm_context_t contexts[AIVDM_CHANNELS];
+    struct ais_t ais;
+    char dump[GPS_JSON_RESPONSE_MAX * 4];
+    int i;
+
+    memset(contexts, '\0', sizeof(contexts));
+    wp->outlen = 0;
+    wp->out[0] = '\0';
+    for (i = 0; i < wp->nlines; i++) {
+	char *line = wp->lines[i];
+
+	if (strncmp(line, "!AIVDM", 6) != 0
+	    && strncmp(line, "!AIVDO", 6) != 0) {
+	    /*
+	     * Mirror the serial loop: JSON packets pass through,
+	     * comments and unlexable junk are dropped.
+	     */
+	    if (line[0] == '{')
+		worker_append(wp, line);
+	    continue;
+	}
+	if (!aivdm_decode(line, strlen(line), contexts, &ais, verbose))
+	    continue;
+	if (ntypes > 0) {
+	    unsigned int n;
+	    bool wanted = false;
+
+	    for (n = 0; n < ntypes; n++)
+		if (ais.type == typelist[n])
+		    wanted = true;
+	    if (!wanted)
+		continue;
+	}
+	if (json)
+	    /* decode() leaves policy.scaled unset; match it */
+	    json_aivdm_dump(&ais, NULL, false, dump, sizeof(dump));
+	else
+	    aivdm_csv_dump(&ais, dump, sizeof(dump));
+	wp->messages++;
+	if (!benchmark)
+	    worker_append(wp, dump);
+    }
+    return NULL;
+}
+
+static bool fragment_pending(const char *line, bool pending)
+/* track whether an AIVDM fragment group is still open after this line */
+{
+    if (strncmp(line, "!AIVDM", 6) == 0 || strncmp(line, "!AIVDO", 6) == 0) {
+	int nfrags = 0, ifrag = 0;
+	const char *cp = strchr(line, ',');
+
+	if (cp != NULL)
+	    nfrags = atoi(cp + 1);
+	if (cp != NULL && (cp = strchr(cp + 1, ',')) != NULL)
+	    ifrag = atoi(cp + 1);
+	return (nfrags > 1 && ifrag < nfrags);
+    }
+    return pending;
+}
+
+static void decode_parallel(FILE *fpin, FILE *fpout, int nworkers)
+/* sensor data on fpin to dump format on fpout, nworkers threads */
+{
+    struct batch_worker_t *workers;
+    unsigned long messages = 0;
+    timestamp_t starttime;
+    bool eof = false;
+    int w;
+
+    workers = calloc((size_t)nworkers, sizeof(struct batch_worker_t));
+    if (workers == NULL) {
+	(void)fputs("gpsdecode: out of memory\n", stderr);
+	exit(1);
+    }
+    for (w = 0; w < nworkers; w++) {
+	/* slack beyond BATCH_LINES absorbs an open fragment group */
+	workers[w].lines = calloc(BATCH_LINES + 64, AIS_LINE_MAX);
+	workers[w].outsize = BATCH_LINES * 128;
+	workers[w].out = malloc(workers[w].outsize);
+	if (workers[w].lines == NULL || workers[w].out == NULL) {
+	    (void)fputs("gpsdecode: out of memory\n", stderr);
+	    exit(1);
+	}
+    }
+
+    starttime = timestamp();
+    while (!eof) {
+	bool pending = false;
+
+	for (w = 0; w < nworkers; w++)
+	    workers[w].nlines = 0;
+	for (w = 0; w < nworkers; w++) {
+	    while ((workers[w].nlines < BATCH_LINES || pending)
+		   && workers[w].nlines < BATCH_LINES + 64) {
+		char *line = workers[w].lines[workers[w].nlines];
+
+		if (fgets(line, AIS_LINE_MAX, fpin) == NULL) {
+		    eof = true;
+		    break;
+		}
+		workers[w].nlines++;
+		pending = fragment_pending(line, pending);
+	    }
+	    if (eof)
+		break;
+	}
+
+	for (w = 0; w < nworkers; w++)
+	    if (workers[w].nlines > 0
+		&& pthread_create(&workers[w].tid, NULL,
+				  worker_decode, &workers[w]) != 0) {
+		(void)fputs("gpsdecode: thread creation failed\n", stderr);
+		exit(1);
+	    }
+	for (w = 0; w < nworkers; w++)
+	    if (workers[w].nlines > 0) {
+		(void)pthread_join(workers[w].tid, NULL);
+		if (!benchmark)
+		    (void)fputs(workers[w].out, fpout);
+	    }
+    }
+
+    for (w = 0; w < nworkers; w++) {
+	messages += workers[w].messages;
+	free(workers[w].lines);
+	free(workers[w].out);
+    }
+    free(workers);
+
+    if (benchmark) {
+	double elapsed = timestamp() - starttime;
+
+	(void)fprintf(stderr,
+		      "gpsdecode: %lu messages in %.3f seconds, %.0f messages/s\n",
+		      messages, elapsed,
+		      (elapsed > 0.0) ? (double)messages / elapsed : 0.0);
+    }
 }
+#endif /* AIVDM_ENABLE */
 
 static void encode(FILE *fpin, FILE *fpout)
 /* JSON format on fpin to JSON on fpout - idempotency test */
@@ -474,11 +676,19 @@ static void encode(FILE *fpin, FILE *fpout)
 int main(int argc, char **argv)
 {
     int c;
+    int nworkers = 1;
     enum
     { doencode, dodecode } mode = dodecode;
 
-    while ((c = getopt(argc, argv, "cdejpt:uvVD:")) != EOF) {
+    while ((c = getopt(argc, argv, "bcdejpP:t:uvVD:")) != EOF) {
 	switch (c) {
+	case 'b':
+	    /* benchmark the decode/format path: suppress the report
+	     * output, time it, and print a messages/s summary */
+	    benchmark = true;
+	    json = true;
+	    break;
+
 	case 'c':
 	    json = false;
 	    break;
@@ -495,6 +705,12 @@ int main(int argc, char **argv)
 	    json = true;
 	    break;
 
+	case 'P':
+	    nworkers = atoi(optarg);
+	    if (nworkers < 1)
+		nworkers = 1;
+	    break;
+
 	case 't':
 	    /*@-nullpass@*/
 	    typelist[ntypes++] = (unsigned int)atoi(strtok(optarg, ","));
@@ -537,6 +753,10 @@ int main(int argc, char **argv)
 
     if (mode == doencode)
 	encode(stdin, stdout);
+#ifdef AIVDM_ENABLE
+    else if (nworkers > 1)
+	decode_parallel(stdin, stdout, nworkers);
+#endif /* AIVDM_ENABLE */
     else
 	decode(stdin, stdout);
     exit(0);
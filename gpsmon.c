@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include <assert.h>
@@ -52,6 +53,10 @@ static WINDOW *statwin, *cmdwin;
 /*@null@*/ static WINDOW *packetwin;
 /*@null@*/ static FILE *logfile;
 static char *type_name;
+#ifdef RAWSPOOL_ENABLE
+/*@null@*/ static char *spooldir;
+static volatile sig_atomic_t capture_done;
+#endif /* RAWSPOOL_ENABLE */
 
 /* no methods, it's all device window */
 extern const struct gps_type_t json_passthrough;
@@ -113,7 +118,7 @@ static const struct monitor_object_t **active, **fallback;
 
 static jmp_buf terminate;
 
-#define display	(void)mvwprintw
+#define display	monitor_display
 
 /* ternination codes */
 #define TERM_SELECT_FAILED	1
@@ -121,6 +126,56 @@ static jmp_buf terminate;
 #define TERM_EMPTY_READ 	3
 #define TERM_READ_ERROR 	4
 
+/*
+ * Damage-tracked field painting.  Each (window, row, column) cell
+ * remembers the last string drawn there and repeat paints of the same
+ * text are dropped before they reach curses, so a SiRF spewing debug
+ * packets repaints only the fields that actually changed instead of
+ * pushing every legend and stale value through the terminal each time.
+ * Cells hash into a fixed table; a collision merely evicts the other
+ * cell and costs a redraw, never a stale screen.
+ */
+#define DISPLAY_CACHE_SIZE	1024	/* power of two */
+struct display_cell_t {
+    /*@null@*/ WINDOW *win;
+    int y, x;
+    char text[48];
+};
+static struct display_cell_t display_cache[DISPLAY_CACHE_SIZE];
+
+void monitor_display_reset(void)
+/* forget all cached cells, forcing the next paint of each to draw */
+{
+    memset(display_cache, 0, sizeof(display_cache));
+}
+
+void monitor_display(WINDOW *win, int y, int x, const char *fmt, ...)
+/* mvwprintw() with suppression of repeated identical paints */
+{
+    char buf[BUFLEN];
+    struct display_cell_t *cell;
+    unsigned int h;
+    va_list ap;
+
+    va_start(ap, fmt);
+    (void)vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    h = (unsigned int)((uintptr_t)win >> 4) * 2654435761u;
+    h ^= (unsigned int)(y * 197 + x);
+    cell = &display_cache[h & (DISPLAY_CACHE_SIZE - 1)];
+    /* strcmp() against the truncated copy can only match when the
+     * new text fit the cell whole, so long strings always redraw */
+    if (cell->win == win && cell->y == y && cell->x == x
+	&& strcmp(cell->text, buf) == 0)
+	return;
+    cell->win = win;
+    cell->y = y;
+    cell->x = x;
+    (void)strlcpy(cell->text, buf, sizeof(cell->text));
+    (void)mvwaddstr(win, y, x, buf);
+}
+
 void monitor_fixframe(WINDOW * win)
 {
     int ymax, xmax, ycur, xcur;
@@ -385,6 +440,7 @@ static bool switch_type(const struct gps_type_t *devtype)
 	    }
 	    active = newobject;
 	    devicewin = newwin((*active)->min_y, (*active)->min_x, 1, 0);
+	    monitor_display_reset();	/* old windows' cells are stale */
 	    if ((devicewin == NULL) || ((*active)->initialize != NULL && !(*active)->initialize())) {
 		monitor_complain("Internal initialization failure - screen "
 				 "must be at least 80x24. aborting.");
@@ -422,6 +478,14 @@ static void onsig(int sig UNUSED)
     longjmp(assertbuf, 1);
 }
 
+#ifdef RAWSPOOL_ENABLE
+static void capture_sig(int sig UNUSED)
+/* flag a clean shutdown; the interrupted select() bails out for us */
+{
+    capture_done = 1;
+}
+#endif /* RAWSPOOL_ENABLE */
+
 #define WATCHRAW	"?WATCH={\"raw\":2}\r\n"
 #define WATCHRAWDEVICE	"?WATCH={\"raw\":2,\"device\":\"%s\"}\r\n"
 
@@ -437,16 +501,30 @@ int main(int argc, char **argv)
     unsigned char buf[BUFLEN];
     char line[80], *explanation, *p;
     int bailout = 0, matches = 0;
+    double now;
+    volatile double last_refresh = 0.0;
+    volatile double refresh_rate = 10.0;	/* terminal pushes per second */
 
     /*@ -observertrans @*/
     (void)putenv("TZ=UTC");	// for ctime()
     /*@ +observertrans @*/
     /*@ -branchstate @*/
-    while ((option = getopt(argc, argv, "D:LVhl:t:?")) != -1) {
+    while ((option = getopt(argc, argv, "c:D:LVhl:r:t:?")) != -1) {
 	switch (option) {
+	case 'c':		/* headless capture into a raw spool */
+#ifdef RAWSPOOL_ENABLE
+	    spooldir = optarg;
+#else
+	    (void)fprintf(stderr,
+			  "-c ignored, raw spooling not compiled in\n");
+#endif /* RAWSPOOL_ENABLE */
+	    break;
 	case 'D':
 	    context.debug = atoi(optarg);
 	    break;
+	case 'r':		/* maximum repaints per second, 0 = every packet */
+	    refresh_rate = atof(optarg);
+	    break;
 	case 'L':		/* list known device types */
 	    (void)
 		fputs
@@ -522,7 +600,7 @@ int main(int argc, char **argv)
 	default:
 	    (void)
 		fputs
-		("usage:  gpsmon [-?hVl] [-D debuglevel] [-t type] [server[:port:[device]]]\n",
+		("usage:  gpsmon [-?hVl] [-c spooldir] [-D debuglevel] [-r maxfps] [-t type] [server[:port:[device]]]\n",
 		 stderr);
 	    exit(1);
 	}
@@ -589,6 +667,49 @@ int main(int argc, char **argv)
      */
     context.readonly = true;
 
+#ifdef RAWSPOOL_ENABLE
+    if (spooldir != NULL) {
+	/*
+	 * Headless capture: no curses, no per-packet rendering, just
+	 * timestamped raw frames appended to the mmap spool at the
+	 * packet-read boundary.  readpkt() stays on the same code
+	 * path the interactive mode uses, so capture timing matches
+	 * what the monitor would see.
+	 */
+	context.rawspool_dir = spooldir;
+	(void)signal(SIGINT, capture_sig);
+	(void)signal(SIGTERM, capture_sig);
+	if ((bailout = setjmp(terminate)) == 0)
+	    while (capture_done == 0) {
+		len = readpkt();
+		if (len > 0)
+		    rawspool_write(&session,
+				   (const char *)session.packet.outbuffer,
+				   (size_t)len);
+	    }
+	rawspool_close(&session);
+	gpsd_close(&session);
+	if (logfile)
+	    (void)fclose(logfile);
+	explanation = NULL;
+	if (capture_done == 0)
+	    switch (bailout) {
+	    case TERM_SELECT_FAILED:
+		explanation = "select(2) failed\n";
+		break;
+	    case TERM_EMPTY_READ:
+		explanation = "Device went offline\n";
+		break;
+	    case TERM_READ_ERROR:
+		explanation = "Read error from device\n";
+		break;
+	    }
+	if (explanation != NULL)
+	    (void)fputs(explanation, stderr);
+	exit(0);
+    }
+#endif /* RAWSPOOL_ENABLE */
+
     /* quit cleanly if an assertion fails */
     (void)signal(SIGABRT, onsig);
     if (setjmp(assertbuf) > 0) {
@@ -668,13 +789,25 @@ int main(int argc, char **argv)
 		(void)wprintw(packetwin, "(%d) ", session.packet.outbuflen);
 		packet_dump((char *)session.packet.outbuffer,
 			    session.packet.outbuflen);
-		(void)wnoutrefresh(statwin);
-		(void)wnoutrefresh(cmdwin);
-		if (devicewin != NULL)
-		    (void)wnoutrefresh(devicewin);
-		if (packetwin != NULL)
-		    (void)wnoutrefresh(packetwin);
-		(void)doupdate();
+		/*
+		 * Coalesce terminal pushes to the frame rate.  The
+		 * curses windows above are always kept current, but
+		 * at binary debug rates shoving every packet's
+		 * repaint down a slow SSH link just saturates it;
+		 * nobody can read updates faster than this anyway.
+		 */
+		now = timestamp();
+		if (refresh_rate <= 0.0
+		    || now - last_refresh >= 1.0 / refresh_rate) {
+		    (void)wnoutrefresh(statwin);
+		    (void)wnoutrefresh(cmdwin);
+		    if (devicewin != NULL)
+			(void)wnoutrefresh(devicewin);
+		    if (packetwin != NULL)
+			(void)wnoutrefresh(packetwin);
+		    (void)doupdate();
+		    last_refresh = now;
+		}
 	    }
 
 	    /* rest of this invoked only if user has pressed a key */
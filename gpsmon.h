@@ -26,6 +26,8 @@ struct monitor_object_t {
 
 // Device-specific may need these.
 extern bool monitor_control_send(unsigned char *buf, size_t len);
+extern void monitor_display(WINDOW *win, int y, int x, const char *fmt, ...);
+extern void monitor_display_reset(void);
 extern void monitor_fixframe(WINDOW *win);
 extern void monitor_log(const char *fmt, ...);
 extern void monitor_complain(const char *fmt, ...);
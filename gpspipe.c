@@ -16,6 +16,10 @@
  * This will dump the GPSD and the NMEA sentences from gpsd to stdout
  *      gpspipe -wr
  *
+ * This will move raw NMEA from gpsd to stdout without copying it
+ * through userspace (Linux only)
+ *      gpspipe -rZ
+ *
  * Original code by: Gary E. Miller <gem@rellim.com>.  Cleanup by ESR.
  *
  * This file is Copyright (c) 2010 by the GPSD project
@@ -25,6 +29,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -55,6 +60,163 @@ static int fd_out = 1;		/* output initially goes to standard output */
 static char serbuf[255];
 static int debug;
 
+/*
+ * Output sinks.  One daemon subscription can feed several local
+ * consumers - plain files, FIFOs, or tcp://host:port targets - so
+ * three archival jobs need not triple the daemon's client load.  Data
+ * flows through a byte ring; each sink keeps its own read cursor, so
+ * a slow consumer never stalls the socket read or the other sinks.
+ * By default a sink applies backpressure (its write blocks); a
+ * ',drop' suffix on the spec makes it lossy, shedding oldest data
+ * when its backlog exceeds the ring.
+ */
+#define MAX_SINKS	8
+#define RING_SIZE	(256 * 1024)	/* must be a power of two */
+
+struct sink_t {
+    const char *spec;		/* what the user asked for */
+    int fd;
+    size_t tail;		/* ring position of next byte to write */
+    bool lossy;			/* shed oldest data rather than block */
+    bool warned;		/* already complained about overflow */
+};
+
+static struct sink_t sinks[MAX_SINKS];
+static int nsinks = 0;
+static char ring[RING_SIZE];
+static size_t ring_head = 0;
+
+static void sink_open(char *spec)
+/* attach an output sink given its command-line spec */
+{
+    struct sink_t *sink;
+    char *suffix;
+
+    if (nsinks >= MAX_SINKS) {
+	(void)fprintf(stderr, "gpspipe: too many output sinks (max %d).\n",
+		      MAX_SINKS);
+	exit(1);
+    }
+    sink = &sinks[nsinks];
+    sink->spec = strdup(spec);	/* we carve up the working copy below */
+    sink->tail = 0;
+    sink->lossy = false;
+    sink->warned = false;
+
+    suffix = strrchr(spec, ',');
+    if (suffix != NULL) {
+	if (strcmp(suffix, ",drop") == 0) {
+	    sink->lossy = true;
+	    *suffix = '\0';
+	} else if (strcmp(suffix, ",block") == 0)
+	    *suffix = '\0';
+    }
+
+    if (strncmp(spec, "tcp://", 6) == 0) {
+	char *host = spec + 6;
+	char *port = strrchr(host, ':');
+
+	if (port == NULL) {
+	    (void)fprintf(stderr,
+			  "gpspipe: sink %s lacks a port number.\n", spec);
+	    exit(1);
+	}
+	*port++ = '\0';
+	sink->fd = netlib_connectsock(AF_UNSPEC, host, port, "tcp");
+	if (sink->fd < 0) {
+	    (void)fprintf(stderr,
+			  "gpspipe: could not connect to sink %s:%s.\n",
+			  host, port);
+	    exit(1);
+	}
+    } else if (strcmp(spec, "-") == 0)
+	sink->fd = STDOUT_FILENO;
+    else {
+	/* O_TRUNC is a no-op on a FIFO, so both just work here */
+	sink->fd = open(spec, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (sink->fd == -1) {
+	    (void)fprintf(stderr,
+			  "gpspipe: unable to open output file:  %s\n", spec);
+	    exit(1);
+	}
+    }
+
+    /* a lossy sink must never block the ring drain */
+    if (sink->lossy)
+	(void)fcntl(sink->fd, F_SETFL,
+		    fcntl(sink->fd, F_GETFL) | O_NONBLOCK);
+    nsinks++;
+}
+
+static void ring_append(const char *data, size_t len)
+/* stage bytes for all sinks */
+{
+    size_t off, chunk;
+
+    while (len > 0) {
+	off = ring_head & (RING_SIZE - 1);
+	chunk = RING_SIZE - off;
+	if (chunk > len)
+	    chunk = len;
+	memcpy(ring + off, data, chunk);
+	ring_head += chunk;
+	data += chunk;
+	len -= chunk;
+    }
+}
+
+static void ring_drain(void)
+/* push staged bytes to every sink that will take them */
+{
+    int i, alive = 0;
+
+    for (i = 0; i < nsinks; i++) {
+	struct sink_t *sink = &sinks[i];
+
+	if (sink->fd == -1)
+	    continue;
+	if (ring_head - sink->tail > RING_SIZE) {
+	    /* only a lossy sink can fall this far behind */
+	    sink->tail = ring_head - RING_SIZE;
+	    if (!sink->warned) {
+		(void)fprintf(stderr,
+			      "gpspipe: sink %s overflowed, shedding oldest data.\n",
+			      sink->spec);
+		sink->warned = true;
+	    }
+	}
+	while (sink->tail != ring_head) {
+	    size_t off = sink->tail & (RING_SIZE - 1);
+	    size_t chunk = ring_head - sink->tail;
+	    ssize_t n;
+
+	    if (chunk > RING_SIZE - off)
+		chunk = RING_SIZE - off;
+	    n = write(sink->fd, ring + off, chunk);
+	    if (n > 0) {
+		sink->tail += (size_t)n;
+		continue;
+	    }
+	    if (n == -1 && errno == EINTR)
+		continue;
+	    if (n == -1 && errno == EAGAIN && sink->lossy)
+		break;		/* backlog stays in the ring */
+	    (void)fprintf(stderr,
+			  "gpspipe: write error on sink %s, %s(%d)\n",
+			  sink->spec, strerror(errno), errno);
+	    (void)close(sink->fd);
+	    sink->fd = -1;
+	    break;
+	}
+	if (sink->fd != -1)
+	    alive++;
+    }
+    if (alive == 0) {
+	(void)fprintf(stderr, "gpspipe: all output sinks failed.\n");
+	exit(1);
+    }
+}
+
 static void open_serial(char *device)
 /* open the serial port and set it up */
 {
@@ -93,8 +255,10 @@ static void usage(void)
 {
     (void)fprintf(stderr,
 		  "Usage: gpspipe [OPTIONS] [server[:port[:device]]]\n\n"
-		  "-d Run as a daemon.\n" 
-		  "-o [file] Write output to file.\n"
+		  "-d Run as a daemon.\n"
+		  "-o [sink] Write output to sink: a file, a FIFO, or\n"
+		  "   tcp://host:port.  May be repeated; a ',drop' suffix makes\n"
+		  "   that sink lossy instead of applying backpressure.\n"
 		  "-h Show this help.\n" 
 		  "-r Dump raw NMEA.\n"
 		  "-R Dump super-raw mode (GPS binary).\n"
@@ -105,7 +269,11 @@ static void usage(void)
 		  "-s [serial dev] emulate a 4800bps NMEA GPS on serial port (use with '-r').\n"
 		  "-n [count] exit after count packets.\n"
 		  "-v Print a little spinner.\n"
-		  "-V Print version and exit.\n\n"
+		  "-V Print version and exit.\n"
+#ifdef HAVE_SPLICE
+		  "-Z Zero-copy output with splice(2) (excludes -t, -s, -n).\n"
+#endif /* HAVE_SPLICE */
+		  "\n"
 		  "You must specify one, or more, of -r, -R, or -w\n"
 		  "You must use -o if you use -d.\n");
 }
@@ -123,20 +291,24 @@ int main(int argc, char **argv)
     bool new_line = true;
     bool raw = false;
     bool watch = false;
+    bool zerocopy = false;
+#ifdef HAVE_SPLICE
+    int zpipe[2] = {-1, -1};
+#endif /* HAVE_SPLICE */
     long count = -1;
     int option;
     unsigned int vflag = 0, l = 0;
-    FILE *fp;
     unsigned int flags;
     fd_set fds;
 
     struct fixsource_t source;
     char *serialport = NULL;
-    char *outfile = NULL;
+    char *sinkspecs[MAX_SINKS];
+    int nspecs = 0;
 
     /*@-branchstate@*/
     flags = WATCH_ENABLE;
-    while ((option = getopt(argc, argv, "?dD:lhrRwtT:vVn:s:o:")) != -1) {
+    while ((option = getopt(argc, argv, "?dD:lhrRwtT:vVZn:s:o:")) != -1) {
 	switch (option) {
 	case 'D':
 	    debug = atoi(optarg);
@@ -183,11 +355,20 @@ int main(int argc, char **argv)
 	    (void)fprintf(stderr, "%s: %s (revision %s)\n",
 			  argv[0], VERSION, REVISION);
 	    exit(0);
+	case 'Z':
+	    zerocopy = true;
+	    break;
 	case 's':
 	    serialport = optarg;
 	    break;
 	case 'o':
-	    outfile = optarg;
+	    if (nspecs >= MAX_SINKS) {
+		(void)fprintf(stderr,
+			      "gpspipe: too many output sinks (max %d).\n",
+			      MAX_SINKS);
+		exit(1);
+	    }
+	    sinkspecs[nspecs++] = optarg;
 	    break;
 	case '?':
 	case 'h':
@@ -209,8 +390,8 @@ int main(int argc, char **argv)
 	exit(1);
     }
 
-    if (outfile == NULL && daemonize) {
-	(void)fprintf(stderr, "gpspipe: use of '-d' requires '-f'.\n");
+    if (nspecs == 0 && daemonize) {
+	(void)fprintf(stderr, "gpspipe: use of '-d' requires '-o'.\n");
 	exit(1);
     }
 
@@ -220,6 +401,24 @@ int main(int argc, char **argv)
 	exit(1);
     }
 
+    if (zerocopy && (timestamp || serialport != NULL || count > 0)) {
+	(void)fprintf(stderr,
+		      "gpspipe: '-Z' cannot be combined with '-t', '-s' or '-n'.\n");
+	exit(1);
+    }
+    if (zerocopy && nspecs > 1) {
+	(void)fprintf(stderr,
+		      "gpspipe: '-Z' supports only a single output sink.\n");
+	exit(1);
+    }
+#ifndef HAVE_SPLICE
+    if (zerocopy) {
+	(void)fprintf(stderr,
+		      "gpspipe: no splice(2) on this platform, '-Z' ignored.\n");
+	zerocopy = false;
+    }
+#endif /* HAVE_SPLICE */
+
     /* Daemonize if the user requested it. */
     /*@ -unrecog @*/
     if (daemonize)
@@ -233,23 +432,14 @@ int main(int argc, char **argv)
     if (sleepy)
 	(void)sleep(10);
 
-    /* Open the output file if the user requested it.  If the user
-     * requested '-R', we use the 'b' flag in fopen() to "do the right
-     * thing" in non-linux/unix OSes. */
-    if (outfile == NULL) {
-	fp = stdout;
-    } else {
-	if (binary)
-	    fp = fopen(outfile, "wb");
-	else
-	    fp = fopen(outfile, "w");
-
-	if (fp == NULL) {
-	    (void)fprintf(stderr,
-			  "gpspipe: unable to open output file:  %s\n",
-			  outfile);
-	    exit(1);
-	}
+    /* Attach the output sinks; with no -o, just standard output. */
+    if (nspecs == 0)
+	sink_open("-");
+    else {
+	int i;
+
+	for (i = 0; i < nspecs; i++)
+	    sink_open(sinkspecs[i]);
     }
 
     /* Open the serial port and set it up. */
@@ -272,6 +462,19 @@ int main(int argc, char **argv)
     if ((isatty(STDERR_FILENO) == 0) || daemonize)
 	vflag = 0;
 
+#ifdef HAVE_SPLICE
+    /*
+     * splice(2) needs a pipe at one end of each move; the kernel then
+     * shifts page references from the socket to the output fd without
+     * the data ever visiting our address space.
+     */
+    if (zerocopy && pipe(zpipe) != 0) {
+	(void)fprintf(stderr, "gpspipe: pipe creation failed, %s(%d)\n",
+		      strerror(errno), errno);
+	zerocopy = false;
+    }
+#endif /* HAVE_SPLICE */
+
     for (;;) {
 	int i = 0;
 	int j = 0;
@@ -294,35 +497,77 @@ int main(int argc, char **argv)
 	if (vflag)
 	    spinner(vflag, l++);
 
+#ifdef HAVE_SPLICE
+	if (zerocopy) {
+	    /* shift the socket's pages to the output without copying */
+	    ssize_t in, out;
+
+	    errno = 0;
+	    in = splice(gpsdata.gps_fd, NULL, zpipe[1], NULL,
+			sizeof(buf), SPLICE_F_MOVE | SPLICE_F_MORE);
+	    if (in == 0) {
+		if (vflag)
+		    (void)fprintf(stderr, "gpspipe: daemon lost, reconnecting\n");
+		gpsd_reconnect(&gpsdata, &source, flags);
+		continue;
+	    } else if (in == -1) {
+		if (errno == EAGAIN || errno == EINTR)
+		    continue;
+		(void)fprintf(stderr, "gpspipe: splice error %s(%d)\n",
+			      strerror(errno), errno);
+		exit(1);
+	    }
+	    while (in > 0) {
+		out = splice(zpipe[0], NULL, sinks[0].fd, NULL,
+			     (size_t)in, SPLICE_F_MOVE | SPLICE_F_MORE);
+		if (out <= 0) {
+		    (void)fprintf(stderr, "gpspipe: splice error %s(%d)\n",
+				  strerror(errno), errno);
+		    exit(1);
+		}
+		in -= out;
+	    }
+	    continue;
+	}
+#endif /* HAVE_SPLICE */
+
 	/* reading directly from the socket avoids decode overhead */
 	errno = 0;
 	r = (int)read(gpsdata.gps_fd, buf, sizeof(buf));
 	if (r > 0) {
-	    for (i = 0; i < r; i++) {
-		char c = buf[i];
-		if (j < (int)(sizeof(serbuf) - 1)) {
-		    serbuf[j++] = buf[i];
-		}
+	    /*
+	     * Scan and emit whole line segments rather than pushing the
+	     * buffer through stdio a byte at a time; timestamps and the
+	     * serial-port copy only ever need attention at line ends.
+	     */
+	    i = 0;
+	    while (i < r) {
+		char *eol = memchr(buf + i, '\n', (size_t)(r - i));
+		int len = (eol != NULL) ? (int)(eol - (buf + i)) + 1 : r - i;
+
 		if (new_line && timestamp) {
+		    char tsout[32];
 		    time_t now = time(NULL);
 
 		    struct tm *tmp_now = localtime(&now);
 		    (void)strftime(tmstr, sizeof(tmstr), format, tmp_now);
-		    new_line = 0;
-		    if (fprintf(fp, "%.24s :", tmstr) <= 0) {
-			(void)fprintf(stderr,
-				      "gpspipe: write error, %s(%d)\n",
-				      strerror(errno), errno);
-			exit(1);
-		    }
+		    new_line = false;
+		    (void)snprintf(tsout, sizeof(tsout), "%.24s :", tmstr);
+		    ring_append(tsout, strlen(tsout));
 		}
-		if (fputc(c, fp) == EOF) {
-		    fprintf(stderr, "gpspipe: Write Error, %s(%d)\n",
-			    strerror(errno), errno);
-		    exit(1);
+		ring_append(buf + i, (size_t)len);
+		if (serialport != NULL) {
+		    int n = (int)(sizeof(serbuf) - 1) - j;
+
+		    if (n > len)
+			n = len;
+		    if (n > 0) {
+			memcpy(serbuf + j, buf + i, (size_t)n);
+			j += n;
+		    }
 		}
 
-		if (c == '\n') {
+		if (eol != NULL) {
 		    if (serialport != NULL) {
 			if (write(fd_out, serbuf, (size_t) j) == -1) {
 			    fprintf(stderr,
@@ -334,32 +579,28 @@ int main(int argc, char **argv)
 		    }
 
 		    new_line = true;
-		    /* flush after every good line */
-		    if (fflush(fp)) {
-			(void)fprintf(stderr,
-				      "gpspipe: fflush Error, %s(%d)\n",
-				      strerror(errno), errno);
-			exit(1);
-		    }
 		    if (count > 0) {
 			if (0 >= --count) {
 			    /* completed count */
+			    ring_drain();
 			    exit(0);
 			}
 		    }
 		}
+		i += len;
 	    }
+	    /* push each read's worth of lines at once, not per byte */
+	    ring_drain();
 	} else {
-	    if (r == -1) {
-		if (errno == EAGAIN)
-		    continue;
-		else
-		    (void)fprintf(stderr, "gpspipe: read error %s(%d)\n",
+	    if (r == -1 && errno == EAGAIN)
+		continue;
+	    /* daemon died or restarted under us; rejoin when it's back */
+	    if (r == -1)
+		(void)fprintf(stderr, "gpspipe: read error %s(%d)\n",
 			      strerror(errno), errno);
-		exit(1);
-	    } else {
-		exit(0);
-	    }
+	    else if (vflag)
+		(void)fprintf(stderr, "gpspipe: daemon lost, reconnecting\n");
+	    gpsd_reconnect(&gpsdata, &source, flags);
 	}
     }
 
@@ -79,11 +79,91 @@ void gps_merge_fix( /*@ out @*/ struct gps_fix_t *to,
 	to->eps = from->eps;
 }
 
+/* exact powers of ten for the fixed-format parser below */
+static const double pow10d[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+double safe_atof(const char *str)
+/* convert a plain [+-]ddd[.ddd] field without the strtod machinery */
+{
+    const char *p = str;
+    unsigned long long acc = 0;
+    int digits = 0, fracdigits = 0;
+    double result;
+    bool neg = false;
+
+    if (*p == '-') {
+	neg = true;
+	++p;
+    } else if (*p == '+')
+	++p;
+    for (; *p >= '0' && *p <= '9'; ++p) {
+	acc = acc * 10 + (unsigned long long)(*p - '0');
+	digits++;
+    }
+    if (*p == '.')
+	for (++p; *p >= '0' && *p <= '9'; ++p) {
+	    acc = acc * 10 + (unsigned long long)(*p - '0');
+	    digits++;
+	    fracdigits++;
+	}
+    /*
+     * Anything but the rigid sign-digits-dot-digits shape that NMEA
+     * fields and our JSON feeds use -- exponents, whitespace, trailing
+     * junk -- and fields too long for exact integer accumulation take
+     * the locale-aware path.  Within the shape the single division is
+     * correctly rounded, so the result matches strtod() bit for bit.
+     */
+    if (*p != '\0' || digits == 0 || digits > 15)
+	return atof(str);
+    result = (double)acc / pow10d[fracdigits];
+    return neg ? -result : result;
+}
+
 timestamp_t timestamp(void)
 {
-    struct timeval tv;
-    (void)gettimeofday(&tv, NULL);
-    return (timestamp_t)(tv.tv_sec + tv.tv_usec * 1e-6);
+#if defined(HAVE_LIBRT) && defined(CLOCK_REALTIME_COARSE)
+    /*
+     * This function is called on every packet arrival for online and
+     * timeout bookkeeping, so at high update rates with many devices it
+     * turns into thousands of clock reads a second.  The coarse clock
+     * is serviced from the vDSO without a syscall and its tick
+     * resolution is ample for bookkeeping; time service (ntpshm.c, the
+     * PPS thread) reads its own precise clocks and is unaffected.
+     */
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0)
+	return (timestamp_t)(ts.tv_sec + ts.tv_nsec * 1e-9);
+#endif /* HAVE_LIBRT && CLOCK_REALTIME_COARSE */
+    {
+	struct timeval tv;
+	(void)gettimeofday(&tv, NULL);
+	return (timestamp_t)(tv.tv_sec + tv.tv_usec * 1e-6);
+    }
+}
+
+timestamp_t monotime(void)
+/*
+ * Interval clock: full resolution and immune to clock steps, but with
+ * an arbitrary epoch - only differences of two reads mean anything.
+ * The coarse tick that makes timestamp() cheap also makes it useless
+ * for measuring the daemon's own sub-millisecond internals.
+ */
+{
+#if defined(HAVE_LIBRT) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	return (timestamp_t)(ts.tv_sec + ts.tv_nsec * 1e-9);
+#endif /* HAVE_LIBRT && CLOCK_MONOTONIC */
+    {
+	struct timeval tv;
+	(void)gettimeofday(&tv, NULL);
+	return (timestamp_t)(tv.tv_sec + tv.tv_usec * 1e-6);
+    }
 }
 
 time_t mkgmtime(register struct tm * t)
@@ -250,3 +330,51 @@ double earth_distance(double lat1, double lon1, double lat2, double lon2)
 	return earth_distance_and_bearings(lat1, lon1, lat2, lon2, NULL, NULL);
 }
 
+/* Approximate distance in meters between two nearby points.
+ *
+ * Equirectangular projection scaled by the local ellipsoid curvature
+ * radii: no iteration and, once the latitude-dependent scale factors
+ * are cached, no trig at all.  Good to a few parts in 10^5 within the
+ * one-degree window; anything wider (or a date-line crossing) falls
+ * back to an iteration-free haversine on the mean-radius sphere,
+ * good to about 0.3%.  Meant for callers that rank or threshold many
+ * distances from one reference point, like DGPS server selection,
+ * where earth_distance()'s accuracy buys nothing but its trig calls
+ * still show up in a profile.
+ */
+double earth_distance_fast(double lat1, double lon1, double lat2, double lon2)
+{
+    static double cached_lat = 400.0;	/* impossible latitude */
+    static double m_scale, n_scale, t_lat;
+    double dlat = lat2 - lat1, dlon = lon2 - lon1, x, y;
+
+    if (fabs(dlat) > 1.0 || fabs(dlon) > 1.0) {
+	double s_dlat = sin(Deg2Rad(dlat) / 2);
+	double s_dlon = sin(Deg2Rad(dlon) / 2);
+	double h = s_dlat * s_dlat
+	    + cos(Deg2Rad(lat1)) * cos(Deg2Rad(lat2)) * s_dlon * s_dlon;
+
+	if (h > 1.0)	/* rounding near the antipode */
+	    h = 1.0;
+	return 2 * ((2 * WGS84A + WGS84B) / 3) * asin(sqrt(h));
+    }
+
+    if (lat1 != cached_lat) {
+	const double e2 = ((double)WGS84A * WGS84A - WGS84B * WGS84B)
+	    / ((double)WGS84A * WGS84A);
+	double s_lat = sin(Deg2Rad(lat1));
+	double w = sqrt(1 - e2 * s_lat * s_lat);
+
+	/* meridional and prime-vertical radii of curvature at lat1 */
+	m_scale = WGS84A * (1 - e2) / (w * w * w);
+	n_scale = WGS84A / w * cos(Deg2Rad(lat1));
+	t_lat = tan(Deg2Rad(lat1));
+	cached_lat = lat1;
+    }
+
+    /* the parenthesized factor walks cos(lat) out to the midpoint */
+    x = Deg2Rad(dlon) * n_scale * (1 - t_lat * Deg2Rad(dlat) / 2);
+    y = Deg2Rad(dlat) * m_scale;
+    return sqrt(x * x + y * y);
+}
+
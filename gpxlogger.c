@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #include <string.h>
 #include <syslog.h>
 #include <math.h>
@@ -41,72 +42,139 @@ static FILE *logfile;
 static bool intrack = false;
 static time_t timeout = 5;	/* seconds */
 static double minmove = 0;	/* meters */
+static int batchsize = 1;	/* trackpoints per write burst */
+static bool binary = false;	/* log the binary intermediate format */
 #ifdef CLIENTDEBUG_ENABLE
 static int debug;
 #endif /* CLIENTDEBUG_ENABLE */
 
+/*
+ * Trackpoints are formatted into this buffer and pushed to the log in
+ * one write per batch rather than a dozen tiny ones per point; on
+ * flash-backed loggers running at 10Hz the syscall and erase-cycle
+ * difference is substantial.  Track segment boundaries are explicit
+ * sync points, so at most one segment's tail is at risk in a crash.
+ */
+#define BATCHBUF_SIZE	65536
+static char batchbuf[BATCHBUF_SIZE];
+static size_t batchlen = 0;
+static int batched = 0;
+
+static void log_flush(bool sync)
+/* push the batch buffer to the log in a single write */
+{
+    if (batchlen > 0) {
+	(void)fwrite(batchbuf, 1, batchlen, logfile);
+	batchlen = 0;
+	batched = 0;
+	(void)fflush(logfile);
+    }
+    if (sync && logfile != stdout)
+	(void)fsync(fileno(logfile));
+}
+
+static void log_append(const char *fmt, ...)
+/* format into the batch buffer; nothing reaches disk until log_flush() */
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(batchbuf + batchlen, sizeof(batchbuf) - batchlen, fmt, ap);
+    va_end(ap);
+    if (n > 0)
+	batchlen += (size_t)n;
+    /* never let the next trackpoint find the buffer too full */
+    if (sizeof(batchbuf) - batchlen < 1024)
+	log_flush(false);
+}
+
+/*
+ * The binary intermediate format: a magic line followed by fixed-size
+ * records, written when GPX bloat at 10Hz would outrun the medium.
+ * "gpxlogger -x file" replays one into GPX offline, re-deriving track
+ * segmentation from the recorded timestamps.
+ */
+#define BINLOG_MAGIC	"GPXB1\n"
+
+struct binlog_rec_t {
+    double time;
+    double latitude, longitude, altitude;
+    double hdop, vdop, pdop;
+    int mode, status, sats;
+    char tag[MAXTAGLEN + 1];
+};
+
 static void print_gpx_header(void)
 {
     char tbuf[CLIENT_DATE_MAX+1];
 
-    (void)fprintf(logfile,"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
-    (void)fprintf(logfile,"<gpx version=\"1.1\" creator=\"GPSD %s - http://gpsd.berlios.de/\"\n", VERSION);
-    (void)fprintf(logfile,"        xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n");
-    (void)fprintf(logfile,"        xmlns=\"http://www.topografix.com/GPX/1/1\"\n");
-    (void)fprintf(logfile,"        xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1\n");
-    (void)fprintf(logfile,"        http://www.topografix.com/GPX/1/1/gpx.xsd\">\n");
-    (void)fprintf(logfile," <metadata>\n");
-    (void)fprintf(logfile,"  <time>%s</time>\n", unix_to_iso8601((timestamp_t)time(NULL), tbuf, sizeof(tbuf)));
-    (void)fprintf(logfile," </metadata>\n");
-    (void)fflush(logfile);
+    if (binary) {
+	log_append("%s", BINLOG_MAGIC);
+	log_flush(false);
+	return;
+    }
+    log_append("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+    log_append("<gpx version=\"1.1\" creator=\"GPSD %s - http://gpsd.berlios.de/\"\n", VERSION);
+    log_append("        xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n");
+    log_append("        xmlns=\"http://www.topografix.com/GPX/1/1\"\n");
+    log_append("        xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1\n");
+    log_append("        http://www.topografix.com/GPX/1/1/gpx.xsd\">\n");
+    log_append(" <metadata>\n");
+    log_append("  <time>%s</time>\n", unix_to_iso8601((timestamp_t)time(NULL), tbuf, sizeof(tbuf)));
+    log_append(" </metadata>\n");
+    log_flush(false);
 }
 
 static void print_gpx_trk_end(void)
 {
-    (void)fprintf(logfile,"  </trkseg>\n");
-    (void)fprintf(logfile," </trk>\n");
-    (void)fflush(logfile);
+    log_append("  </trkseg>\n");
+    log_append(" </trk>\n");
+    /* segment boundary: make sure the whole segment is on the medium */
+    log_flush(true);
 }
 
 static void print_gpx_footer(void)
 {
-    if (intrack)
-	print_gpx_trk_end();
-    (void)fprintf(logfile,"</gpx>\n");
+    if (!binary) {
+	if (intrack)
+	    print_gpx_trk_end();
+	log_append("</gpx>\n");
+    }
+    log_flush(true);
     (void)fclose(logfile);
 }
 
 static void print_gpx_trk_start(void)
 {
-    (void)fprintf(logfile," <trk>\n");
-    (void)fprintf(logfile,"  <src>GPSD %s</src>\n", VERSION);
-    (void)fprintf(logfile,"  <trkseg>\n");
-    (void)fflush(logfile);
+    log_append(" <trk>\n");
+    log_append("  <src>GPSD %s</src>\n", VERSION);
+    log_append("  <trkseg>\n");
 }
 
 static void print_fix(struct gps_data_t *gpsdata, double time)
 {
     char tbuf[CLIENT_DATE_MAX+1];
 
-    (void)fprintf(logfile,"   <trkpt lat=\"%f\" lon=\"%f\">\n",
-		 gpsdata->fix.latitude, gpsdata->fix.longitude);
+    log_append("   <trkpt lat=\"%f\" lon=\"%f\">\n",
+	       gpsdata->fix.latitude, gpsdata->fix.longitude);
     if ((isnan(gpsdata->fix.altitude) == 0))
-	(void)fprintf(logfile,"    <ele>%f</ele>\n", gpsdata->fix.altitude);
-    (void)fprintf(logfile,"    <time>%s</time>\n",
-		 unix_to_iso8601(time, tbuf, sizeof(tbuf)));
-    (void)fprintf(logfile,"    <src>GPSD tag=\"%s\"</src>\n", gpsdata->tag);
+	log_append("    <ele>%f</ele>\n", gpsdata->fix.altitude);
+    log_append("    <time>%s</time>\n",
+	       unix_to_iso8601(time, tbuf, sizeof(tbuf)));
+    log_append("    <src>GPSD tag=\"%s\"</src>\n", gpsdata->tag);
     if (gpsdata->status == STATUS_DGPS_FIX)
-	(void)fprintf(logfile,"    <fix>dgps</fix>\n");
+	log_append("    <fix>dgps</fix>\n");
     else
 	switch (gpsdata->fix.mode) {
 	case MODE_3D:
-	    (void)fprintf(logfile,"    <fix>3d</fix>\n");
+	    log_append("    <fix>3d</fix>\n");
 	    break;
 	case MODE_2D:
-	    (void)fprintf(logfile,"    <fix>2d</fix>\n");
+	    log_append("    <fix>2d</fix>\n");
 	    break;
 	case MODE_NO_FIX:
-	    (void)fprintf(logfile,"    <fix>none</fix>\n");
+	    log_append("    <fix>none</fix>\n");
 	    break;
 	default:
 	    /* don't print anything if no fix indicator */
@@ -114,16 +182,43 @@ static void print_fix(struct gps_data_t *gpsdata, double time)
 	}
 
     if ((gpsdata->fix.mode > MODE_NO_FIX) && (gpsdata->satellites_used > 0))
-	(void)fprintf(logfile,"    <sat>%d</sat>\n", gpsdata->satellites_used);
+	log_append("    <sat>%d</sat>\n", gpsdata->satellites_used);
     if (isnan(gpsdata->dop.hdop) == 0)
-	(void)fprintf(logfile,"    <hdop>%.1f</hdop>\n", gpsdata->dop.hdop);
+	log_append("    <hdop>%.1f</hdop>\n", gpsdata->dop.hdop);
     if (isnan(gpsdata->dop.vdop) == 0)
-	(void)fprintf(logfile,"    <vdop>%.1f</vdop>\n", gpsdata->dop.vdop);
+	log_append("    <vdop>%.1f</vdop>\n", gpsdata->dop.vdop);
     if (isnan(gpsdata->dop.pdop) == 0)
-	(void)fprintf(logfile,"    <pdop>%.1f</pdop>\n", gpsdata->dop.pdop);
+	log_append("    <pdop>%.1f</pdop>\n", gpsdata->dop.pdop);
 
-    (void)fprintf(logfile,"   </trkpt>\n");
-    (void)fflush(logfile);
+    log_append("   </trkpt>\n");
+    if (++batched >= batchsize)
+	log_flush(false);
+}
+
+static void log_binary_fix(struct gps_data_t *gpsdata, double time)
+/* append one fixed-size record to the batch buffer */
+{
+    struct binlog_rec_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.time = time;
+    rec.latitude = gpsdata->fix.latitude;
+    rec.longitude = gpsdata->fix.longitude;
+    rec.altitude = gpsdata->fix.altitude;
+    rec.hdop = gpsdata->dop.hdop;
+    rec.vdop = gpsdata->dop.vdop;
+    rec.pdop = gpsdata->dop.pdop;
+    rec.mode = gpsdata->fix.mode;
+    rec.status = gpsdata->status;
+    rec.sats = gpsdata->satellites_used;
+    (void)strlcpy(rec.tag, gpsdata->tag, sizeof(rec.tag));
+
+    if (sizeof(batchbuf) - batchlen < sizeof(rec))
+	log_flush(false);
+    memcpy(batchbuf + batchlen, (char *)&rec, sizeof(rec));
+    batchlen += sizeof(rec);
+    if (++batched >= batchsize)
+	log_flush(false);
 }
 
 static void conditionally_log_fix(struct gps_data_t *gpsdata)
@@ -152,13 +247,18 @@ static void conditionally_log_fix(struct gps_data_t *gpsdata)
      */
     /*@-type@*/
     if (fabs(int_time - old_int_time) > timeout && !first) {
-	print_gpx_trk_end();
+	if (binary)
+	    /* the boundary will be re-derived on replay; just sync here */
+	    log_flush(true);
+	else
+	    print_gpx_trk_end();
 	intrack = false;
     }
     /*@+type@*/
 
     if (!intrack) {
-	print_gpx_trk_start();
+	if (!binary)
+	    print_gpx_trk_start();
 	intrack = true;
 	if (first)
 	    first = false;
@@ -169,7 +269,52 @@ static void conditionally_log_fix(struct gps_data_t *gpsdata)
 	old_lat = gpsdata->fix.latitude;
 	old_lon = gpsdata->fix.longitude;
     }
-    print_fix(gpsdata, int_time);
+    if (binary)
+	log_binary_fix(gpsdata, int_time);
+    else
+	print_fix(gpsdata, int_time);
+}
+
+static int binlog_convert(const char *fname)
+/* replay a binary intermediate log as GPX on the output */
+{
+    FILE *in = fopen(fname, "rb");
+    char magic[sizeof(BINLOG_MAGIC) - 1];
+    struct binlog_rec_t rec;
+
+    if (in == NULL) {
+	(void)fprintf(stderr, "%s: could not open %s, %s.\n",
+		      progname, fname, strerror(errno));
+	return 1;
+    }
+    if (fread(magic, 1, sizeof(magic), in) != sizeof(magic)
+	|| memcmp(magic, BINLOG_MAGIC, sizeof(magic)) != 0) {
+	(void)fprintf(stderr, "%s: %s is not a gpxlogger binary log.\n",
+		      progname, fname);
+	(void)fclose(in);
+	return 1;
+    }
+
+    print_gpx_header();
+    while (fread((char *)&rec, sizeof(rec), 1, in) == 1) {
+	gpsdata.fix.time = rec.time;
+	gpsdata.fix.latitude = rec.latitude;
+	gpsdata.fix.longitude = rec.longitude;
+	gpsdata.fix.altitude = rec.altitude;
+	gpsdata.dop.hdop = rec.hdop;
+	gpsdata.dop.vdop = rec.vdop;
+	gpsdata.dop.pdop = rec.pdop;
+	gpsdata.fix.mode = rec.mode;
+	gpsdata.status = rec.status;
+	gpsdata.satellites_used = rec.sats;
+	rec.tag[sizeof(rec.tag) - 1] = '\0';
+	(void)strlcpy(gpsdata.tag, rec.tag, sizeof(gpsdata.tag));
+	/* the usual logic re-derives segment boundaries from timestamps */
+	conditionally_log_fix(&gpsdata);
+    }
+    (void)fclose(in);
+    print_gpx_footer();
+    return 0;
 }
 
 static void quit_handler(int signum)
@@ -320,8 +465,11 @@ static int socket_mainloop(void)
 	    (void)fprintf(stderr, "%s: error while waiting\n", progname);
 	    break;
 	} else {
-	    (void)gps_read(&gpsdata);
-	    conditionally_log_fix(&gpsdata);
+	    if (gps_read(&gpsdata) == -1)
+		/* daemon restarted under us; rejoin and replay the watch */
+		gpsd_reconnect(&gpsdata, &source, flags);
+	    else
+		conditionally_log_fix(&gpsdata);
 	}
     }
     (void)gps_close(&gpsdata);
@@ -393,8 +541,10 @@ static void usage(void)
 {
     fprintf(stderr,
 	    "Usage: %s [-V] [-h] [-d] [-i timeout] [-j casoc] [-f filename] [-m minmove]\n"
-	    "\t[-e exportmethod] [server[:port:[device]]]\n\n"
-	    "defaults to '%s -i 5 -j 0 -e %s localhost:2947'\n",
+	    "\t[-b batch] [-B] [-x binlog] [-e exportmethod] [server[:port:[device]]]\n\n"
+	    "defaults to '%s -i 5 -j 0 -b 1 -e %s localhost:2947'\n"
+	    "-b batches that many trackpoints per log write; -B logs the compact\n"
+	    "binary intermediate format, and -x converts such a log to GPX.\n",
 	    progname, progname, (NITEMS(methods) > 0) ? methods[0].name : "(none)");
     exit(1);
 }
@@ -404,13 +554,25 @@ int main(int argc, char **argv)
 {
     int ch;
     bool daemonize = false;
+    char *convertfile = NULL;
     struct method_t *mp, *method = NULL;
 
     progname = argv[0];
 
     logfile = stdout;
-    while ((ch = getopt(argc, argv, "dD:e:f:hi:lm:V")) != -1) {
+    while ((ch = getopt(argc, argv, "b:BdD:e:f:hi:lm:Vx:")) != -1) {
 	switch (ch) {
+	case 'b':
+	    batchsize = atoi(optarg);
+	    if (batchsize < 1)
+		batchsize = 1;
+	    break;
+	case 'B':
+	    binary = true;
+	    break;
+	case 'x':
+	    convertfile = optarg;
+	    break;
 	case 'd':
 	    openlog(basename(progname), LOG_PID | LOG_PERROR, LOG_DAEMON);
 	    daemonize = true;
@@ -485,6 +647,17 @@ int main(int argc, char **argv)
 	exit(1);
     }
 
+    if (convertfile != NULL) {
+	if (binary) {
+	    (void)fprintf(stderr,
+			  "%s: '-x' and '-B' are mutually exclusive.\n",
+			  progname);
+	    exit(1);
+	}
+	/* offline conversion needs no daemon connection */
+	exit(binlog_convert(convertfile));
+    }
+
     if (optind < argc) {
 	gpsd_source_spec(argv[optind], &source);
     } else
@@ -8,6 +8,83 @@
 
 #include "gpsd.h"
 
+#ifndef S_SPLINT_S
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+#endif /* S_SPLINT_S */
+
+static const char hexchar[] = "0123456789abcdef";
+
+#if defined(__SSE2__) && !defined(S_SPLINT_S)
+static inline __m128i hex_digits128(__m128i nib)
+/* turn 16 nibble values into 16 lowercase hex digits */
+{
+    __m128i gt9 = _mm_cmpgt_epi8(nib, _mm_set1_epi8(9));
+    __m128i adj = _mm_and_si128(gt9, _mm_set1_epi8('a' - '0' - 10));
+
+    return _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')), adj);
+}
+#elif defined(__ARM_NEON__) && !defined(S_SPLINT_S)
+static inline uint8x16_t hex_digits_neon(uint8x16_t nib)
+{
+    uint8x16_t adj = vandq_u8(vcgtq_u8(nib, vdupq_n_u8(9)),
+			      vdupq_n_u8('a' - '0' - 10));
+
+    return vaddq_u8(vaddq_u8(nib, vdupq_n_u8('0')), adj);
+}
+#endif
+
+size_t gpsd_hexdump_buf(const char *binbuf, size_t binbuflen,
+			/*@out@*/ char *dst, size_t dstlen)
+/* hex-encode into a caller-supplied buffer, returning the string length
+ *
+ * The output is truncated to what fits; raw-mode subscribers call this
+ * once per packet, so the bulk of the work goes 16 input bytes at a
+ * time where the instruction set allows.
+ */
+{
+    const unsigned char *ibuf = (const unsigned char *)binbuf;
+    size_t i = 0, j = 0;
+
+    if (binbuf == NULL || dst == NULL || dstlen == 0)
+	return 0;
+    if (binbuflen > (dstlen - 1) / 2)
+	binbuflen = (dstlen - 1) / 2;
+#if defined(__SSE2__) && !defined(S_SPLINT_S)
+    for (; i + 16 <= binbuflen; i += 16, j += 32) {
+	__m128i v = _mm_loadu_si128((const __m128i *)(const void *)(ibuf + i));
+	__m128i mask = _mm_set1_epi8(0x0f);
+	__m128i hic = hex_digits128(_mm_and_si128(_mm_srli_epi16(v, 4), mask));
+	__m128i loc = hex_digits128(_mm_and_si128(v, mask));
+
+	_mm_storeu_si128((__m128i *)(void *)(dst + j),
+			 _mm_unpacklo_epi8(hic, loc));
+	_mm_storeu_si128((__m128i *)(void *)(dst + j + 16),
+			 _mm_unpackhi_epi8(hic, loc));
+    }
+#elif defined(__ARM_NEON__) && !defined(S_SPLINT_S)
+    for (; i + 16 <= binbuflen; i += 16, j += 32) {
+	uint8x16_t v = vld1q_u8(ibuf + i);
+	uint8x16x2_t out;
+
+	out.val[0] = hex_digits_neon(vshrq_n_u8(v, 4));
+	out.val[1] = hex_digits_neon(vandq_u8(v, vdupq_n_u8(0x0f)));
+	vst2q_u8((uint8_t *)(dst + j), out);
+    }
+#endif
+    /*@ -shiftimplementation @*/
+    for (; i < binbuflen; i++) {
+	dst[j++] = hexchar[(ibuf[i] & 0xf0) >> 4];
+	dst[j++] = hexchar[ibuf[i] & 0x0f];
+    }
+    /*@ +shiftimplementation @*/
+    dst[j] = '\0';
+    return j;
+}
+
 char /*@ observer @*/ *gpsd_hexdump(char *binbuf, size_t binbuflen)
 {
     char *cp;
@@ -22,23 +99,9 @@ char /*@ observer @*/ *gpsd_hexdump(char *binbuf, size_t binbuflen)
     else {
 	static char hexbuf[MAX_PACKET_LENGTH * 2 + 1];
 #ifndef SQUELCH_ENABLE
-	size_t i, j = 0;
-	size_t len =
-	    (size_t) ((binbuflen >
-		       MAX_PACKET_LENGTH) ? MAX_PACKET_LENGTH : binbuflen);
-	const char *ibuf = (const char *)binbuf;
-	const char *hexchar = "0123456789abcdef";
-
 	if (NULL == binbuf || 0 == binbuflen)
 	    return "";
-
-	/*@ -shiftimplementation @*/
-	for (i = 0; i < len; i++) {
-	    hexbuf[j++] = hexchar[(ibuf[i] & 0xf0) >> 4];
-	    hexbuf[j++] = hexchar[ibuf[i] & 0x0f];
-	}
-	/*@ +shiftimplementation @*/
-	hexbuf[j] = '\0';
+	(void)gpsd_hexdump_buf(binbuf, binbuflen, hexbuf, sizeof(hexbuf));
 #else /* SQUELCH defined */
 	hexbuf[0] = '\0';
 #endif /* SQUELCH_ENABLE */
@@ -67,31 +130,22 @@ int gpsd_hexpack( /*@in@*/ const char *src, /*@out@ */ char *dst, size_t len)
 }
 
 /*@ +charint -shiftimplementation @*/
-int hex2bin(const char *s)
-{
-    int a, b;
 
-    a = s[0] & 0xff;
-    b = s[1] & 0xff;
+/* nibble value plus one per character; zero marks a non-hex-digit */
+static const unsigned char hexval1[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
 
-    if ((a >= 'a') && (a <= 'f'))
-	a = a + 10 - 'a';
-    else if ((a >= 'A') && (a <= 'F'))
-	a = a + 10 - 'A';
-    else if ((a >= '0') && (a <= '9'))
-	a -= '0';
-    else
-	return -1;
+int hex2bin(const char *s)
+{
+    int a = (int)hexval1[(unsigned char)s[0]] - 1;
+    int b = (int)hexval1[(unsigned char)s[1]] - 1;
 
-    if ((b >= 'a') && (b <= 'f'))
-	b = b + 10 - 'a';
-    else if ((b >= 'A') && (b <= 'F'))
-	b = b + 10 - 'A';
-    else if ((b >= '0') && (b <= '9'))
-	b -= '0';
-    else
+    if (a < 0 || b < 0)
 	return -1;
-
     return ((a << 4) + b);
 }
 
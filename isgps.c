@@ -67,6 +67,8 @@ BSD terms apply: see the file COPYING in the distribution root for details.
 
 #define W_DATA_MASK	0x3fffffc0u
 
+#if !defined(__GNUC__) || defined(S_SPLINT_S)
+/* reference parity table, superseded by __builtin_parity() under GCC */
 /*@ +charint @*/
 static unsigned char parity_array[] = {
     0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
@@ -86,6 +88,7 @@ static unsigned char parity_array[] = {
     1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
     0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0
 };
+#endif /* !__GNUC__ || S_SPLINT_S */
 
 static unsigned int reverse_bits[] = {
     0, 32, 16, 48, 8, 40, 24, 56, 4, 36, 20, 52, 12, 44, 28, 60,
@@ -106,7 +109,9 @@ unsigned int isgps_parity(isgps30bits_t th)
 #define	PARITY_28	0x5763e680u
 #define	PARITY_29	0x6bb1f340u
 #define	PARITY_30	0x8b7a89c0u
+#if !defined(__GNUC__) || defined(S_SPLINT_S)
     isgps30bits_t t;
+#endif
     unsigned int p;
 
     /*
@@ -114,6 +119,21 @@ unsigned int isgps_parity(isgps30bits_t th)
      * th ^= W_DATA_MASK;
      */
 
+#if defined(__GNUC__) && !defined(S_SPLINT_S)
+    /*
+     * Each parity bit is the parity of the word under one fixed mask;
+     * __builtin_parity() compiles to a single popcount (or flag test)
+     * per bit where the hardware has one, replacing four table
+     * lookups and three XORs.  The table code below remains the
+     * reference implementation for other compilers.
+     */
+    p = (unsigned int)__builtin_parity(th & PARITY_25);
+    p = (p << 1) | (unsigned int)__builtin_parity(th & PARITY_26);
+    p = (p << 1) | (unsigned int)__builtin_parity(th & PARITY_27);
+    p = (p << 1) | (unsigned int)__builtin_parity(th & PARITY_28);
+    p = (p << 1) | (unsigned int)__builtin_parity(th & PARITY_29);
+    p = (p << 1) | (unsigned int)__builtin_parity(th & PARITY_30);
+#else
     /*@ +charint @*/
     t = th & PARITY_25;
     p = parity_array[t & 0xff] ^ parity_array[(t >> 8) & 0xff] ^
@@ -139,6 +159,7 @@ unsigned int isgps_parity(isgps30bits_t th)
 		    parity_array[(t >> 16) & 0xff] ^ parity_array[(t >> 24) &
 								  0xff]);
     /*@ -charint @*/
+#endif /* __GNUC__ */
 
     gpsd_report(ISGPS_ERRLEVEL_BASE + 2, "ISGPS parity %u\n", p);
     return (p);
@@ -204,9 +225,17 @@ enum isgpsstat_t isgps_decode(struct gps_packet_t *session,
 		session->isgps.curr_word |=
 		    c >> -(session->isgps.curr_offset);
 	    }
-	    gpsd_report(ISGPS_ERRLEVEL_BASE + 2,
-			"ISGPS syncing at byte %lu: 0x%08x\n",
-			session->char_counter, session->isgps.curr_word);
+	    /*
+	     * This is the resync hunt: six alignment candidates per
+	     * input byte, every byte, until lock.  On a noisy
+	     * marine-beacon link it runs continuously, so don't pay
+	     * for a varargs call per candidate unless someone is
+	     * actually watching.
+	     */
+	    if (session->debug >= ISGPS_ERRLEVEL_BASE + 2)
+		gpsd_report(ISGPS_ERRLEVEL_BASE + 2,
+			    "ISGPS syncing at byte %lu: 0x%08x\n",
+			    session->char_counter, session->isgps.curr_word);
 
 	    if (preamble_match(&session->isgps.curr_word)) {
 		if (isgps_parityok(session->isgps.curr_word)) {
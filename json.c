@@ -61,6 +61,7 @@ PERMISSIONS
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdarg.h>
 #include <locale.h>
@@ -105,6 +106,101 @@ static void json_trace(int errlevel, const char *fmt, ...)
 # define json_debug_trace(args) /*@i1@*/do { } while (0)
 #endif /* CLIENTDEBUG_ENABLE */
 
+/*
+ * Template "compilation".  json_internal_read_object() used to find the
+ * spec for each incoming key by walking the template linearly, an O(n)
+ * strcmp chain per attribute that adds up fast when parsing thousands
+ * of reports per second against the bigger templates.  On first sight
+ * of a template we build a name-sorted index over it and dispatch
+ * subsequent keys by binary search instead.
+ *
+ * Many templates are function-local arrays, so a cache slot can't be
+ * keyed by the template's address alone: the same stack slot may hold
+ * different templates at different times.  The attribute names are
+ * string literals with stable addresses, so a template's identity is
+ * taken from the sequence of those pointers.  Anything that misses or
+ * overflows the cache just gets the old linear scan.
+ */
+#define MAX_TEMPLATE_ATTRS	96
+#define MAX_TEMPLATES		64
+
+static struct template_index_t {
+    unsigned long hash;			/* of the attribute name pointers */
+    const char *firstname, *lastname;
+    int nattrs;				/* 0 marks a free slot */
+    unsigned short order[MAX_TEMPLATE_ATTRS];	/* sorted by name */
+} template_indices[MAX_TEMPLATES];
+
+static /*@null@*/ const struct template_index_t
+    *json_template_index(const struct json_attr_t *attrs)
+/* find or build the sorted index for a template */
+{
+    struct template_index_t *tip;
+    unsigned long hash = 0;
+    unsigned int probe;
+    int i, j, n;
+
+    for (n = 0; attrs[n].attribute != NULL; n++)
+	hash = hash * 31 + (unsigned long)(uintptr_t)attrs[n].attribute;
+    if (n == 0 || n > MAX_TEMPLATE_ATTRS)
+	return NULL;
+    tip = &template_indices[hash % MAX_TEMPLATES];
+    for (probe = 0; probe < 4; probe++) {
+	struct template_index_t *candidate =
+	    &template_indices[(hash + probe) % MAX_TEMPLATES];
+	if (candidate->nattrs == 0) {
+	    tip = candidate;	/* free slot; build the index here */
+	    break;
+	}
+	if (candidate->hash == hash && candidate->nattrs == n
+	    && candidate->firstname == attrs[0].attribute
+	    && candidate->lastname == attrs[n - 1].attribute)
+	    return candidate;
+    }
+    /* insertion sort, stable so attribute spans keep first-match order */
+    for (i = 0; i < n; i++) {
+	for (j = i;
+	     j > 0 && strcmp(attrs[tip->order[j - 1]].attribute,
+			     attrs[i].attribute) > 0; j--)
+	    tip->order[j] = tip->order[j - 1];
+	tip->order[j] = (unsigned short)i;
+    }
+    tip->hash = hash;
+    tip->firstname = attrs[0].attribute;
+    tip->lastname = attrs[n - 1].attribute;
+    tip->nattrs = n;
+    return tip;
+}
+
+static const struct json_attr_t
+    *json_attr_lookup(const struct json_attr_t *attrs, const char *name)
+/* find the first spec for name, or the end-of-template sentinel */
+{
+    const struct template_index_t *tip = json_template_index(attrs);
+    const struct json_attr_t *cursor;
+    int lo, hi;
+
+    if (tip == NULL) {
+	for (cursor = attrs; cursor->attribute != NULL; cursor++)
+	    if (strcmp(cursor->attribute, name) == 0)
+		break;
+	return cursor;
+    }
+    lo = 0;
+    hi = tip->nattrs;
+    while (lo < hi) {		/* leftmost-match binary search */
+	int mid = (lo + hi) / 2;
+	if (strcmp(attrs[tip->order[mid]].attribute, name) < 0)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    if (lo < tip->nattrs
+	&& strcmp(attrs[tip->order[lo]].attribute, name) == 0)
+	return &attrs[tip->order[lo]];
+    return &attrs[tip->nattrs];	/* the NULL-attribute terminator */
+}
+
 /*@-immediatetrans -dependenttrans -usereleased -compdef@*/
 static /*@null@*/ char *json_target_address(const struct json_attr_t *cursor,
 					     /*@null@*/
@@ -128,6 +224,9 @@ static /*@null@*/ char *json_target_address(const struct json_attr_t *cursor,
 	case t_string:
 	    targetaddr = cursor->addr.string;
 	    break;
+	case t_observer:
+	    targetaddr = (char *)&cursor->addr.observer[offset];
+	    break;
 	case t_boolean:
 	    targetaddr = (char *)&cursor->addr.boolean[offset];
 	    break;
@@ -170,6 +269,7 @@ static int json_internal_read_object(const char *cp,
 #endif /* CLIENTDEBUG_ENABLE */
     char attrbuf[JSON_ATTR_MAX + 1], *pattr = NULL;
     char valbuf[JSON_VAL_MAX + 1], *pval = NULL;
+    const char *vstart = NULL;	/* raw start of a quoted value */
     bool value_quoted = false;
     char uescape[5];		/* enough space for 4 hex digits and a NUL */
     const struct json_attr_t *cursor;
@@ -210,6 +310,9 @@ static int json_internal_read_object(const char *cp,
 			return JSON_ERR_NOPARSTR;
 		    lptr[0] = '\0';
 		    break;
+		case t_observer:
+		    *((const char **)lptr) = NULL;
+		    break;
 		case t_boolean:
 		    /* nullbool default says not to set the value at all */
 		    /*@+boolint@*/
@@ -264,12 +367,7 @@ static int json_internal_read_object(const char *cp,
 		*pattr++ = '\0';
 		json_debug_trace((1, "Collected attribute name %s\n",
 				  attrbuf));
-		for (cursor = attrs; cursor->attribute != NULL; cursor++) {
-		    json_debug_trace((2, "Checking against %s\n",
-				      cursor->attribute));
-		    if (strcmp(cursor->attribute, attrbuf) == 0)
-			break;
-		}
+		cursor = json_attr_lookup(attrs, attrbuf);
 		if (cursor->attribute == NULL) {
 		    json_debug_trace((1,
 				      "Unknown attribute name '%s' (attributes begin with '%s').\n",
@@ -279,6 +377,8 @@ static int json_internal_read_object(const char *cp,
 		state = await_value;
 		if (cursor->type == t_string)
 		    maxlen = (int)cursor->len - 1;
+		else if (cursor->type == t_observer)
+		    maxlen = (int)sizeof(valbuf) - 1;
 		else if (cursor->type == t_check)
 		    maxlen = (int)strlen(cursor->dflt.check);
 		else if (cursor->type == t_time)
@@ -313,6 +413,7 @@ static int json_internal_read_object(const char *cp,
 		value_quoted = true;
 		state = in_val_string;
 		pval = valbuf;
+		vstart = cp + 1;
 	    } else {
 		value_quoted = false;
 		state = in_val_token;
@@ -388,7 +489,8 @@ static int json_internal_read_object(const char *cp,
 	     */
 	    for (;;) {
 		int seeking = cursor->type;
-		if (value_quoted && (cursor->type == t_string || cursor->type == t_time))
+		if (value_quoted && (cursor->type == t_string
+		    || cursor->type == t_observer || cursor->type == t_time))
 		    break;
 		if ((strcmp(valbuf, "true")==0 || strcmp(valbuf, "false")==0)
 			&& seeking == t_boolean)
@@ -407,15 +509,17 @@ static int json_internal_read_object(const char *cp,
 		++cursor;
 	    }
 	    if (value_quoted
-		&& (cursor->type != t_string && cursor->type != t_character
-		    && cursor->type != t_check && cursor->type != t_time 
+		&& (cursor->type != t_string && cursor->type != t_observer
+		    && cursor->type != t_character
+		    && cursor->type != t_check && cursor->type != t_time
 		    && cursor->map == 0)) {
 		json_debug_trace((1,
 				  "Saw quoted value when expecting non-string.\n"));
 		return JSON_ERR_QNONSTRING;
 	    }
 	    if (!value_quoted
-		&& (cursor->type == t_string || cursor->type == t_check
+		&& (cursor->type == t_string || cursor->type == t_observer
+		    || cursor->type == t_check
 		    || cursor->type == t_time || cursor->map != 0)) {
 		json_debug_trace((1,
 				  "Didn't see quoted value when expecting string.\n"));
@@ -445,7 +549,7 @@ static int json_internal_read_object(const char *cp,
 		    *((double *)lptr) = iso8601_to_unix(valbuf);
 		    break;
 		case t_real:
-		    *((double *)lptr) = atof(valbuf);
+		    *((double *)lptr) = safe_atof(valbuf);
 		    break;
 		case t_string:
 		    if (parent != NULL
@@ -454,6 +558,28 @@ static int json_internal_read_object(const char *cp,
 			return JSON_ERR_NOPARSTR;
 		    (void)strlcpy(lptr, valbuf, cursor->len);
 		    break;
+		case t_observer:
+		    if (parent != NULL
+			&& parent->element_type != t_structobject
+			&& offset > 0)
+			return JSON_ERR_NOPARSTR;
+		    /*
+		     * Lend out a view of the value in the source
+		     * buffer rather than copying it.  The unescaped
+		     * form can only shrink, so writing it back over
+		     * the raw value (which the state machine has
+		     * already consumed) is safe; the template
+		     * contract makes the caller warrant writability.
+		     */
+		    {
+			char *vp = (char *)vstart;
+			size_t vlen = strlen(valbuf);
+
+			memcpy(vp, valbuf, vlen);
+			vp[vlen] = '\0';
+			*((const char **)lptr) = vp;
+		    }
+		    break;
 		case t_boolean:
 		    *((bool *) lptr) = (strcmp(valbuf, "true") == 0);
 		    break;
@@ -566,6 +692,7 @@ int json_read_array(const char *cp, const struct json_array_t *arr,
 	case t_uinteger:
 	case t_time:
 	case t_real:
+	case t_observer:
 	case t_boolean:
 	case t_character:
 	case t_array:
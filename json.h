@@ -8,7 +8,7 @@
 #include <ctype.h>
 
 typedef enum {t_integer, t_uinteger, t_real,
-	      t_string, t_boolean, t_character,
+	      t_string, t_observer, t_boolean, t_character,
 	      t_time,
 	      t_object, t_structobject, t_array,
 	      t_check} json_type;
@@ -45,6 +45,13 @@ struct json_attr_t {
 	unsigned int *uinteger;
 	double *real;
 	char *string;
+	/*
+	 * A t_observer target receives a borrowed pointer to the
+	 * value inside the buffer being parsed, unescaped and
+	 * NUL-terminated in place; the buffer must be writable and
+	 * the view lives only as long as its contents do.
+	 */
+	/*@null@*/const char **observer;
 	bool *boolean;
 	char *character;
 	struct json_array_t array;
@@ -190,12 +190,12 @@ static void update_lcd(struct gps_data_t *gpsdata)
   /* Fill in the latitude and longitude. */
   if (gpsdata->fix.mode >= MODE_2D) {
 
-    s = deg_to_str(deg_type,  fabs(gpsdata->fix.latitude));
-    snprintf(tmpbuf, 254, "widget_set gpsd one 1 1 {Lat: %s %c}\n", s, (gpsdata->fix.latitude < 0) ? 'S' : 'N');
+    s = fmt_latlon(deg_type, gpsdata->fix.latitude, true);
+    snprintf(tmpbuf, 254, "widget_set gpsd one 1 1 {Lat: %s}\n", s);
     send_lcd(tmpbuf);
 
-    s = deg_to_str(deg_type,  fabs(gpsdata->fix.longitude));
-    snprintf(tmpbuf, 254, "widget_set gpsd two 1 2 {Lon: %s %c}\n", s, (gpsdata->fix.longitude < 0) ? 'W' : 'E');
+    s = fmt_latlon(deg_type, gpsdata->fix.longitude, false);
+    snprintf(tmpbuf, 254, "widget_set gpsd two 1 2 {Lon: %s}\n", s);
     send_lcd(tmpbuf);
 
     /* As a pilot, a heading of "0" gives me the heebie-jeebies (ie, 0
@@ -203,8 +203,8 @@ static void update_lcd(struct gps_data_t *gpsdata)
     track=(int)(gpsdata->fix.track);
     if(track == 0) track = 360;
 
-    snprintf(tmpbuf, 254, "widget_set gpsd three 1 3 {%.1f %s %d deg}\n",
-             gpsdata->fix.speed*speedfactor, speedunits,
+    snprintf(tmpbuf, 254, "widget_set gpsd three 1 3 {%s %d deg}\n",
+             fmt_speed(gpsdata->fix.speed, speedfactor, speedunits),
              track);
     send_lcd(tmpbuf);
 
@@ -16,6 +16,11 @@
 # With -g, generate a plot of the leap-second trend over time. The command
 # you probably want is "leapsecond.py -g leapseconds.cache | gnuplot -persist".
 #
+# With -H, compile the cached history into the compact binary table the
+# daemon maps at startup, e.g. "leapsecond.py -H leapseconds.cache
+# /etc/gpsd.leaps"; pushing a fresh table to a fleet updates leap handling
+# without a rebuild.
+#
 # With the -n option, compute Unix local time for an IERS leap-second event
 # given as a three-letter English Gregorian month abbreviation followed by
 # a 4-digit year.
@@ -148,6 +153,17 @@ def make_leapsecond_include(infile):
     year = time.strftime("%Y", time.localtime(time.time()))
     return ("#define CENTURY_BASE\t%s00\n" % year[:2]) + ("#define LEAPSECOND_NOW\t%d\n" % (len(leapsecs)-2))
 
+def make_leapsecond_blob(infile, outfile):
+    "Compile the leap-second history into the binary table gpsd maps at runtime."
+    import struct
+    leapsecs = fetch_leapsecs(infile)
+    fp = open(outfile, "wb")
+    fp.write("GPSDLEAP")
+    fp.write(struct.pack("=II", len(leapsecs), 0))
+    for epoch in leapsecs:
+        fp.write(struct.pack("=d", epoch))
+    fp.close()
+
 def leastsquares(tuples):
     "Generate coefficients for a least-squares fit to the specified data."
     sum_x=0
@@ -242,7 +258,7 @@ def leapbound(year, month):
 
 if __name__ == '__main__':
     import sys, getopt
-    (options, arguments) = getopt.getopt(sys.argv[1:], "f:g:h:i:n:o:")
+    (options, arguments) = getopt.getopt(sys.argv[1:], "f:g:h:H:i:n:o:")
     for (switch, val) in options:
         if (switch == '-f'):    # Fetch USNO data to cache locally
             save_leapseconds(val)
@@ -253,6 +269,9 @@ if __name__ == '__main__':
         elif (switch == '-h'):  # make leapsecond include
             sys.stdout.write(make_leapsecond_include(val))
             raise SystemExit, 0
+        elif (switch == '-H'):  # make binary leap table for the daemon
+            make_leapsecond_blob(val, arguments and arguments[0] or "gpsd.leaps")
+            raise SystemExit, 0
         elif (switch == '-i'):  # Compute Unix time from RFC822 date
             print rfc822_to_unix(val)
             raise SystemExit, 0
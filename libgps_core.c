@@ -60,6 +60,7 @@ int gps_open(/*@null@*/const char *host,
 	     /*@out@*/ struct gps_data_t *gpsdata)
 {
     int status = -1;
+    bool implicit_shm = false;
 
     /*@ -branchstate @*/
     if (!gpsdata)
@@ -70,11 +71,36 @@ int gps_open(/*@null@*/const char *host,
 	status = gps_shm_open(gpsdata);
 	if (status == -1)
 	    status = SHM_NOSHARED;
-	else if (status == -2)
+	else if (status == -2 || status == -3)
 	    status = SHM_NOATTACH;
     }
+#ifdef SOCKET_EXPORT_ENABLE
+    /*
+     * Local clients don't have to ask: when the daemon on this host
+     * publishes the shared-memory export, prefer it over paying the
+     * JSON encode/parse cycle through loopback.  The export is
+     * read-only, so gps_send() and gps_stream() reopen the socket
+     * transport on demand; a failed attach just falls through to
+     * the socket here.
+     */
+    else if (status == -1
+	     && (host == NULL
+		 || strcmp(host, "localhost") == 0
+		 || strcmp(host, "127.0.0.1") == 0
+		 || strcmp(host, "::1") == 0)
+	     && (port == NULL || strcmp(port, DEFAULT_GPSD_PORT) == 0)
+	     && gps_shm_open(gpsdata) == 0) {
+	implicit_shm = true;
+	status = 0;
+    }
+#endif /* SOCKET_EXPORT_ENABLE */
 #endif /* SHM_EXPORT_ENABLE */
 
+#ifdef DBUS_EXPORT_ENABLE
+    if (host != NULL && strcmp(host, GPSD_DBUS_EXPORT) == 0)
+	status = gps_dbus_open(gpsdata);
+#endif /* DBUS_EXPORT_ENABLE */
+
 #ifdef SOCKET_EXPORT_ENABLE
     if (status == -1) {
         status = gps_sock_open(host, port, gpsdata);
@@ -83,6 +109,12 @@ int gps_open(/*@null@*/const char *host,
 
     gpsdata->set = 0;
     gpsdata->status = STATUS_NO_FIX;
+    gpsdata->string_views = false;
+    gpsdata->device_view = gpsdata->tag_view = NULL;
+    gpsdata->dedupe = false;
+    gpsdata->dedup_time = 0;
+    gpsdata->dedup_device[0] = '\0';
+    gpsdata->shm_implicit = implicit_shm;
     gps_clear_fix(&gpsdata->fix);
 
     return status;
@@ -103,6 +135,13 @@ int gps_close(struct gps_data_t *gpsdata)
     }
 #endif /* SHM_EXPORT_ENABLE */
 
+#ifdef DBUS_EXPORT_ENABLE
+    if ((intptr_t)(gpsdata->gps_fd) == -2) {
+	gps_dbus_close(gpsdata);
+	status = 0;
+    }
+#endif /* DBUS_EXPORT_ENABLE */
+
 #ifdef SOCKET_EXPORT_ENABLE
     if (status == -1) {
         status = gps_sock_close(gpsdata);
@@ -112,6 +151,52 @@ int gps_close(struct gps_data_t *gpsdata)
 	return status;
 }
 
+bool libgps_dedupe(struct gps_data_t *gpsdata)
+/* is this report a replay of the last accepted epoch?
+ *
+ * Aggregated deployments can see one device epoch twice, via the
+ * shared-memory and socket transports.  With dedupe enabled this
+ * remembers the device and timestamp of the last accepted timed
+ * report and flags any exact repeat, so consumers don't pay the
+ * parse and callback costs twice.
+ */
+{
+    const char *path = gpsdata->dev.path;
+
+    if (!gpsdata->dedupe || (gpsdata->set & TIME_SET) == 0)
+	return false;
+    if (gpsdata->string_views && gpsdata->device_view != NULL)
+	path = gpsdata->device_view;
+    if (gpsdata->fix.time == gpsdata->dedup_time
+	&& strcmp(path, gpsdata->dedup_device) == 0)
+	return true;
+    gpsdata->dedup_time = gpsdata->fix.time;
+    (void)strlcpy(gpsdata->dedup_device, path,
+		  sizeof(gpsdata->dedup_device));
+    return false;
+}
+
+int libgps_shm_upgrade(struct gps_data_t *gpsdata)
+/* trade an implicitly chosen SHM transport for the socket transport
+ *
+ * gps_open() prefers the shared-memory export for local sessions,
+ * but that export can't carry commands back to the daemon.  The
+ * first command moves the session onto the socket, invisibly to
+ * the caller.
+ */
+{
+    if (!gpsdata->shm_implicit)
+	return 0;
+#if defined(SHM_EXPORT_ENABLE) && defined(SOCKET_EXPORT_ENABLE)
+    if ((intptr_t)(gpsdata->gps_fd) == -1) {
+	gps_shm_close(gpsdata);
+	gpsdata->shm_implicit = false;
+	return gps_sock_open(NULL, NULL, gpsdata);
+    }
+#endif /* SHM_EXPORT_ENABLE && SOCKET_EXPORT_ENABLE */
+    return 0;
+}
+
 int gps_read(struct gps_data_t *gpsdata)
 /* read from a gpsd connection */
 {
@@ -126,6 +211,12 @@ int gps_read(struct gps_data_t *gpsdata)
     }
 #endif /* SHM_EXPORT_ENABLE */
 
+#ifdef DBUS_EXPORT_ENABLE
+    if ((intptr_t)(gpsdata->gps_fd) == -2) {
+	status = gps_dbus_read(gpsdata);
+    }
+#endif /* DBUS_EXPORT_ENABLE */
+
 #ifdef SOCKET_EXPORT_ENABLE
     if (status == -1) {
         status = gps_sock_read(gpsdata);
@@ -133,9 +224,53 @@ int gps_read(struct gps_data_t *gpsdata)
 #endif /* SOCKET_EXPORT_ENABLE */
     /*@ +usedef +compdef +uniondef @*/
 
+    if (status > 0 && libgps_dedupe(gpsdata))
+	return 0;	/* epoch already seen via another transport */
+
+    return status;
+}
+
+int gps_dispatch(struct gps_data_t *gpsdata,
+		 void (*hook)(struct gps_data_t *, void *),
+		 /*@null@*/ void *context)
+/* drain buffered reports without blocking, calling the hook per report */
+{
+    int status = -1;
+
+    libgps_debug_trace((DEBUG_CALLS, "gps_dispatch()\n"));
+
+    /*@ -usedef -compdef -uniondef @*/
+#ifdef SHM_EXPORT_ENABLE
+    /* the shared-memory export has no socket to drain */
+    if ((intptr_t)(gpsdata->gps_fd) == -1)
+	return -1;
+#endif /* SHM_EXPORT_ENABLE */
+
+#ifdef DBUS_EXPORT_ENABLE
+    /* the D-Bus export delivers per-signal; nothing buffers to drain */
+    if ((intptr_t)(gpsdata->gps_fd) == -2)
+	return -1;
+#endif /* DBUS_EXPORT_ENABLE */
+
+#ifdef SOCKET_EXPORT_ENABLE
+    status = gps_sock_dispatch(gpsdata, hook, context);
+#endif /* SOCKET_EXPORT_ENABLE */
+    /*@ +usedef +compdef +uniondef @*/
+
     return status;
 }
 
+int gps_flush(struct gps_data_t *gpsdata, int timeout)
+/* push any queued command bytes, waiting at most timeout microseconds */
+{
+#ifdef SOCKET_EXPORT_ENABLE
+    if ((intptr_t)(gpsdata->gps_fd) >= 0)
+	return gps_sock_flush(gpsdata, timeout);
+#endif /* SOCKET_EXPORT_ENABLE */
+    /* the non-socket exports carry no commands, so nothing queues */
+    return 0;
+}
+
 extern const char /*@observer@*/ *gps_errstr(const int err)
 {
     /* 
@@ -149,6 +284,10 @@ extern const char /*@observer@*/ *gps_errstr(const int err)
     else if (err == SHM_NOATTACH)
 	return "attach failed for unknown reason";
 #endif /* SHM_EXPORT_ENABLE */
+#ifdef DBUS_EXPORT_ENABLE
+    if (err == DBUS_NOBUS)
+	return "can't subscribe to fixes on the system D-Bus";
+#endif /* DBUS_EXPORT_ENABLE */
     return netlib_errstr(err);
 #else
     static char buf[32];
@@ -0,0 +1,239 @@
+/****************************************************************************
+
+NAME
+   libgps_dbus.c - client access to the D-Bus fix broadcast
+
+DESCRIPTION
+   Receive side of the dbusexport.c signals, wired into the gps_open()
+transport multiplex.  The match rules we register are evaluated inside
+the bus daemon, so a subscribed client is only ever woken for gpsd fix
+traffic -- there is no need to poll a socket just to idle.  Like the
+shared-memory export this carries fix data only; no device or watcher
+notifications.
+
+PERMISSIONS
+   This file is Copyright (c) 2011 by the GPSD project
+   BSD terms apply: see the file COPYING in the distribution root for details.
+
+***************************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "gpsd.h"
+
+#if defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S)
+
+struct privdata_t
+{
+    DBusConnection *connection;	/* shared system-bus connection */
+};
+#define PRIVATE(gpsdata) ((struct privdata_t *)(gpsdata)->privdata)
+
+/* match rules, evaluated daemon-side; keep in sync with dbusexport.c */
+#define DBUS_MATCH_FIX \
+    "type='signal',interface='org.gpsd',member='fix'"
+#define DBUS_MATCH_FIXES \
+    "type='signal',interface='org.gpsd',member='fixes'"
+
+int gps_dbus_open(/*@out@*/struct gps_data_t *gpsdata)
+/* subscribe to the fix broadcast on the system bus */
+{
+    DBusError error;
+    DBusConnection *connection;
+
+    libgps_debug_trace((DEBUG_CALLS, "gps_dbus_open()\n"));
+
+    gpsdata->privdata = NULL;
+    dbus_error_init(&error);
+    connection = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
+    if (dbus_error_is_set(&error) || connection == NULL) {
+	dbus_error_free(&error);
+	return DBUS_NOBUS;
+    }
+    /*
+     * Subscribe narrowly.  The rules are matched in the bus daemon,
+     * which therefore never forwards -- and never wakes us for --
+     * anything but gpsd fix reports.  This is what makes the D-Bus
+     * export cheap to idle on compared to polling the socket export.
+     */
+    dbus_bus_add_match(connection, DBUS_MATCH_FIX, &error);
+    if (!dbus_error_is_set(&error))
+	dbus_bus_add_match(connection, DBUS_MATCH_FIXES, &error);
+    if (dbus_error_is_set(&error)) {
+	dbus_error_free(&error);
+	dbus_connection_unref(connection);
+	return DBUS_NOBUS;
+    }
+    /* get the match registration to the bus daemon before we report open */
+    dbus_connection_flush(connection);
+
+    gpsdata->privdata = malloc(sizeof(struct privdata_t));
+    if (gpsdata->privdata == NULL) {
+	dbus_connection_unref(connection);
+	return DBUS_NOBUS;
+    }
+    PRIVATE(gpsdata)->connection = connection;
+#ifndef USE_QT
+    gpsdata->gps_fd = -2;
+#else
+    gpsdata->gps_fd = (void *)(intptr_t)-2;
+#endif /* USE_QT */
+    return 0;
+}
+
+static bool dbus_get_double(DBusMessageIter *iter, /*@out@*/double *valp)
+/* fetch one double field and step the iterator */
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_DOUBLE)
+	return false;
+    dbus_message_iter_get_basic(iter, valp);
+    (void)dbus_message_iter_next(iter);
+    return true;
+}
+
+static bool dbus_fix_unpack(DBusMessageIter *iter,
+			    struct gps_data_t *gpsdata)
+/* decode one fix payload; field order mirrors dbus_fix_snapshot() */
+{
+    struct gps_fix_t fix;
+    dbus_int32_t mode = 0;
+    const char *devname = NULL;
+    double eph = NAN;
+
+    gps_clear_fix(&fix);
+    if (!dbus_get_double(iter, &fix.time))
+	return false;
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_INT32)
+	return false;
+    dbus_message_iter_get_basic(iter, &mode);
+    (void)dbus_message_iter_next(iter);
+    if (!dbus_get_double(iter, &fix.ept)
+	|| !dbus_get_double(iter, &fix.latitude)
+	|| !dbus_get_double(iter, &fix.longitude)
+	|| !dbus_get_double(iter, &eph)
+	|| !dbus_get_double(iter, &fix.altitude)
+	|| !dbus_get_double(iter, &fix.epv)
+	|| !dbus_get_double(iter, &fix.track)
+	|| !dbus_get_double(iter, &fix.epd)
+	|| !dbus_get_double(iter, &fix.speed)
+	|| !dbus_get_double(iter, &fix.eps)
+	|| !dbus_get_double(iter, &fix.climb)
+	|| !dbus_get_double(iter, &fix.epc))
+	return false;
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING)
+	return false;
+    dbus_message_iter_get_basic(iter, &devname);
+
+    fix.mode = (int)mode;
+    /* the wire format predates the epx/epy split */
+    if (isnan(eph) == 0)
+	fix.epx = fix.epy = eph / sqrt(2);
+    gpsdata->fix = fix;
+    gpsdata->status = (fix.mode >= MODE_2D) ? STATUS_FIX : STATUS_NO_FIX;
+    if (devname != NULL)
+	(void)strlcpy(gpsdata->dev.path, devname, sizeof(gpsdata->dev.path));
+    gpsdata->online = timestamp();
+    gpsdata->set = ONLINE_SET | TIME_SET | LATLON_SET
+	| MODE_SET | STATUS_SET | DEVICE_SET;
+    if (isnan(fix.ept) == 0)
+	gpsdata->set |= TIMERR_SET;
+    if (isnan(eph) == 0)
+	gpsdata->set |= HERR_SET;
+    if (isnan(fix.altitude) == 0)
+	gpsdata->set |= ALTITUDE_SET;
+    if (isnan(fix.epv) == 0)
+	gpsdata->set |= VERR_SET;
+    if (isnan(fix.track) == 0)
+	gpsdata->set |= TRACK_SET;
+    if (isnan(fix.epd) == 0)
+	gpsdata->set |= TRACKERR_SET;
+    if (isnan(fix.speed) == 0)
+	gpsdata->set |= SPEED_SET;
+    if (isnan(fix.eps) == 0)
+	gpsdata->set |= SPEEDERR_SET;
+    if (isnan(fix.climb) == 0)
+	gpsdata->set |= CLIMB_SET;
+    if (isnan(fix.epc) == 0)
+	gpsdata->set |= CLIMBERR_SET;
+    return true;
+}
+
+static int dbus_message_unpack(DBusMessage *message,
+			       struct gps_data_t *gpsdata)
+/* decode a matched signal; returns the number of fixes it carried */
+{
+    DBusMessageIter iter;
+    int fixes = 0;
+
+    if (!dbus_message_iter_init(message, &iter))
+	return 0;
+    if (dbus_message_is_signal(message, "org.gpsd", "fix")) {
+	if (dbus_fix_unpack(&iter, gpsdata))
+	    fixes = 1;
+    } else if (dbus_message_is_signal(message, "org.gpsd", "fixes")
+	       && dbus_message_iter_get_arg_type(&iter) == DBUS_TYPE_ARRAY) {
+	DBusMessageIter array;
+
+	/* a coalesced batch; the last element wins in *gpsdata */
+	dbus_message_iter_recurse(&iter, &array);
+	while (dbus_message_iter_get_arg_type(&array) == DBUS_TYPE_STRUCT) {
+	    DBusMessageIter element;
+
+	    dbus_message_iter_recurse(&array, &element);
+	    if (dbus_fix_unpack(&element, gpsdata))
+		fixes++;
+	    (void)dbus_message_iter_next(&array);
+	}
+    }
+    return fixes;
+}
+
+int gps_dbus_read(struct gps_data_t *gpsdata)
+/* block until the bus daemon forwards the next fix signal */
+{
+    DBusConnection *connection;
+    DBusMessage *message;
+    int fixes;
+
+    if (gpsdata->privdata == NULL)
+	return -1;
+    connection = PRIVATE(gpsdata)->connection;
+
+    /*
+     * Nothing but a matched signal (or a bus hangup) can end this
+     * wait, so an idle consumer burns no cycles at all between
+     * reports -- the entire reason this transport exists.
+     */
+    for (;;) {
+	message = dbus_connection_pop_message(connection);
+	if (message == NULL) {
+	    if (!dbus_connection_read_write(connection, -1))
+		return -1;	/* bus connection lost */
+	    continue;
+	}
+	fixes = dbus_message_unpack(message, gpsdata);
+	dbus_message_unref(message);
+	if (fixes > 0)
+	    return fixes;
+    }
+}
+
+void gps_dbus_close(struct gps_data_t *gpsdata)
+{
+    if (gpsdata->privdata != NULL) {
+	DBusConnection *connection = PRIVATE(gpsdata)->connection;
+
+	/* the bus connection is shared, so unsubscribe rather than close */
+	dbus_bus_remove_match(connection, DBUS_MATCH_FIX, NULL);
+	dbus_bus_remove_match(connection, DBUS_MATCH_FIXES, NULL);
+	dbus_connection_unref(connection);
+	free(gpsdata->privdata);
+	gpsdata->privdata = NULL;
+    }
+}
+
+#endif /* defined(DBUS_EXPORT_ENABLE) && !defined(S_SPLINT_S) */
+
+/* end */
@@ -34,6 +34,20 @@ PERMISSIONS
 static int json_tpv_read(const char *buf, struct gps_data_t *gpsdata,
 			 /*@null@*/ const char **endptr)
 {
+    /*
+     * Binding the parse template to the target structure is a large
+     * aggregate initialization that it pays not to redo on every
+     * response; long-running ingest clients parse into one gps_data_t
+     * for the life of the process.  Keep the bound copy in static
+     * storage and rebuild it only when the target changes, so
+     * gps_unpack() does no setup work at steady state.  (Not
+     * thread-safe, but neither is the generic parser.)
+     */
+    static struct gps_data_t *tpv_target = NULL;
+    static bool tpv_views = false;
+    static struct json_attr_t tpv_bound[20];
+
+    if (tpv_target != gpsdata || tpv_views != gpsdata->string_views) {
     /*@ -fullinitblock @*/
     const struct json_attr_t json_attrs_1[] = {
 	/* *INDENT-OFF* */
@@ -78,13 +92,30 @@ static int json_tpv_read(const char *buf, struct gps_data_t *gpsdata,
 	/* *INDENT-ON* */
     };
     /*@ +fullinitblock @*/
+    (void)memcpy(tpv_bound, json_attrs_1, sizeof(json_attrs_1));
+    if (gpsdata->string_views) {
+	/* borrow views of the hot strings instead of copying them;
+	 * slots 1 and 2 are the device and tag bindings above */
+	tpv_bound[1].type = t_observer;
+	tpv_bound[1].addr.observer = &gpsdata->device_view;
+	tpv_bound[2].type = t_observer;
+	tpv_bound[2].addr.observer = &gpsdata->tag_view;
+    }
+    tpv_target = gpsdata;
+    tpv_views = gpsdata->string_views;
+    }
 
-    return json_read_object(buf, json_attrs_1, endptr);
+    return json_read_object(buf, tpv_bound, endptr);
 }
 
 static int json_noise_read(const char *buf, struct gps_data_t *gpsdata,
                            /*@null@*/ const char **endptr)
 {
+    /* bound-template cache; see json_tpv_read() */
+    static struct gps_data_t *gst_target = NULL;
+    static struct json_attr_t gst_bound[13];
+
+    if (gst_target != gpsdata) {
     /*@ -fullinitblock @*/
     const struct json_attr_t json_attrs_1[] = {
 	/* *INDENT-OFF* */
@@ -115,14 +146,29 @@ static int json_noise_read(const char *buf, struct gps_data_t *gpsdata,
 	/* *INDENT-ON* */
     };
     /*@ +fullinitblock @*/
+    (void)memcpy(gst_bound, json_attrs_1, sizeof(json_attrs_1));
+    gst_target = gpsdata;
+    }
 
-    return json_read_object(buf, json_attrs_1, endptr);
+    return json_read_object(buf, gst_bound, endptr);
 }
 
 static int json_sky_read(const char *buf, struct gps_data_t *gpsdata,
 			 /*@null@*/ const char **endptr)
 {
-    bool usedflags[MAXCHANNELS];
+    /*
+     * Bound-template cache; see json_tpv_read().  The used flags
+     * must live in static storage too, since the bound satellite
+     * subtemplate points at them across calls.
+     */
+    static bool usedflags[MAXCHANNELS];
+    static struct gps_data_t *sky_target = NULL;
+    static bool sky_views = false;
+    static struct json_attr_t sat_bound[6];
+    static struct json_attr_t sky_bound[14];
+    int status, i, j;
+
+    if (sky_target != gpsdata || sky_views != gpsdata->string_views) {
     /*@ -fullinitblock @*/
     const struct json_attr_t json_attrs_2_1[] = {
 	/* *INDENT-OFF* */
@@ -160,21 +206,33 @@ static int json_sky_read(const char *buf, struct gps_data_t *gpsdata,
 	{"gdop",       t_real,    .addr.real    = &gpsdata->dop.gdop,
 	                             .dflt.real = NAN},
 	{"satellites", t_array,   .addr.array.element_type = t_object,
-				     .addr.array.arr.objects.subtype=json_attrs_2_1,
+				     .addr.array.arr.objects.subtype=sat_bound,
 	                             .addr.array.maxlen = MAXCHANNELS,
 	                             .addr.array.count = &gpsdata->satellites_visible},
 	{NULL},
 	/* *INDENT-ON* */
     };
     /*@ +fullinitblock @*/
-    int status, i, j;
+    (void)memcpy(sat_bound, json_attrs_2_1, sizeof(json_attrs_2_1));
+    (void)memcpy(sky_bound, json_attrs_2, sizeof(json_attrs_2));
+    if (gpsdata->string_views) {
+	/* borrow views of the hot strings instead of copying them;
+	 * slots 1 and 2 are the device and tag bindings above */
+	sky_bound[1].type = t_observer;
+	sky_bound[1].addr.observer = &gpsdata->device_view;
+	sky_bound[2].type = t_observer;
+	sky_bound[2].addr.observer = &gpsdata->tag_view;
+    }
+    sky_target = gpsdata;
+    sky_views = gpsdata->string_views;
+    }
 
     for (i = 0; i < MAXCHANNELS; i++) {
 	gpsdata->PRN[i] = 0;
 	usedflags[i] = false;
     }
 
-    status = json_read_object(buf, json_attrs_2, endptr);
+    status = json_read_object(buf, sky_bound, endptr);
     if (status != 0)
 	return status;
 
@@ -196,6 +254,11 @@ static int json_sky_read(const char *buf, struct gps_data_t *gpsdata,
 static int json_att_read(const char *buf, struct gps_data_t *gpsdata,
 			 /*@null@*/ const char **endptr)
 {
+    /* bound-template cache; see json_tpv_read() */
+    static struct gps_data_t *att_target = NULL;
+    static struct json_attr_t att_bound[24];
+
+    if (att_target != gpsdata) {
     /*@ -fullinitblock @*/
     const struct json_attr_t json_attrs_1[] = {
 	/* *INDENT-OFF* */
@@ -246,8 +309,11 @@ static int json_att_read(const char *buf, struct gps_data_t *gpsdata,
 	/* *INDENT-ON* */
     };
     /*@ +fullinitblock @*/
+    (void)memcpy(att_bound, json_attrs_1, sizeof(json_attrs_1));
+    att_target = gpsdata;
+    }
 
-    return json_read_object(buf, json_attrs_1, endptr);
+    return json_read_object(buf, att_bound, endptr);
 }
 
 static int json_devicelist_read(const char *buf, struct gps_data_t *gpsdata,
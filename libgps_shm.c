@@ -15,6 +15,7 @@ PERMISSIONS
 
 ***************************************************************************/
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <sys/time.h>
@@ -25,24 +26,44 @@ PERMISSIONS
 
 #ifdef SHM_EXPORT_ENABLE
 
+/* limit spinning against a 50Hz-or-faster writer; 0 reads mean "retry" */
+#define SHM_MAX_TRIES	8
+
+struct privdata_t
+{
+    void *shmseg;		/* the attached segment */
+    int last_full;		/* seq of the last full-structure copy */
+    unsigned int ring_cursor;	/* next epoch wanted from the ring */
+};
+#define PRIVATE(gpsdata) ((struct privdata_t *)(gpsdata)->privdata)
+
 int gps_shm_open(/*@out@*/struct gps_data_t *gpsdata)
 /* open a shared-memory connection to the daemon */
 {
     int shmid;
+    void *shmseg;
 
     libgps_debug_trace((DEBUG_CALLS, "gps_shm_open()\n"));
 
     gpsdata->privdata = NULL;
-    shmid = shmget((key_t)GPSD_KEY, sizeof(struct gps_data_t), 0);
+    shmid = shmget((key_t)GPSD_KEY, sizeof(struct shmexport_t), 0);
     if (shmid == -1) {
 	/* daemon isn't running or failed to create shared segment */
 	return -1;
     } 
-    gpsdata->privdata = shmat(shmid, 0, 0);
-    if ((int)(long)gpsdata->privdata == -1) {
+    shmseg = shmat(shmid, 0, 0);
+    if ((int)(long)shmseg == -1) {
 	/* attach failed for sume unknown reason */
 	return -2;
     }
+    gpsdata->privdata = malloc(sizeof(struct privdata_t));
+    if (gpsdata->privdata == NULL) {
+	(void)shmdt((const void *)shmseg);
+	return -3;
+    }
+    PRIVATE(gpsdata)->shmseg = shmseg;
+    PRIVATE(gpsdata)->last_full = 0;	/* force a full copy first time */
+    PRIVATE(gpsdata)->ring_cursor = ((struct shmexport_t *)shmseg)->ring_head;
 #ifndef USE_QT
     gpsdata->gps_fd = -1;
 #else
@@ -59,54 +80,175 @@ int gps_shm_read(struct gps_data_t *gpsdata)
 	return -1;
     else
     {
-	int before, after;
+	int before, after, fullseq = 0, tries;
 	void *private_save = gpsdata->privdata;
-	volatile struct shmexport_t *shared = (struct shmexport_t *)gpsdata->privdata;
+	volatile struct shmexport_t *shared =
+	    (struct shmexport_t *)PRIVATE(gpsdata)->shmseg;
 	struct gps_data_t noclobber;
+	bool full = true, good = false;
+	size_t copied = 0;
 
 	/*
-	 * Following block of instructions must not be reordered, otherwise 
-	 * havoc will ensue.  The barrier() call should prevent reordering
-	 * of the data accesses.
+	 * Seqlock read side: take a copy between two reads of the
+	 * sequence counter, and keep it only if the counter was even
+	 * and unchanged -- otherwise the writer was active and the
+	 * copy may be torn.  The retry loop is bounded so a fast
+	 * writer can't livelock us; on exhaustion we report "no fresh
+	 * data" and let the caller come around again.
 	 *
-	 * This is a simple optimistic-concurrency technique.  We wrote
-	 * the second bookend first, then the data, then the first bookend.
-	 * Reader copies what it sees in normal order; that way, if we
-	 * start to write the segment during the read, the second bookend will
-	 * get clobbered first and the data can be detected as bad.
+	 * If the writer hasn't done a whole-structure update since our
+	 * last full copy, only the leading fix slice (and the tag) has
+	 * changed, and that's all we need to move.
 	 */
-	before = shared->bookend1;
-	barrier();
-	(void)memcpy((void *)&noclobber, 
-		     (void *)&shared->gpsdata, 
-		     sizeof(struct gps_data_t));
-	barrier();
-	after = shared->bookend2;
-
-	if (before != after) 
+	for (tries = 0; tries < SHM_MAX_TRIES; tries++) {
+	    before = shared->seq;
+	    barrier();
+	    if ((before & 1) != 0)
+		continue;	/* write in progress */
+	    fullseq = shared->full_seq;
+	    full = (PRIVATE(gpsdata)->last_full != fullseq);
+	    if (full)
+		copied = sizeof(struct gps_data_t);
+	    else
+		copied = FIX_SLICE_LENGTH;
+	    (void)memcpy((void *)&noclobber,
+			 (void *)&shared->gpsdata,
+			 copied);
+	    if (!full)
+		(void)memcpy((void *)noclobber.tag,
+			     (void *)shared->gpsdata.tag,
+			     sizeof(noclobber.tag));
+	    barrier();
+	    after = shared->seq;
+	    if (before == after) {
+		good = true;
+		break;
+	    }
+	}
+	if (!good)
 	    return 0;
-	else {
-	    (void)memcpy((void *)gpsdata, 
-			 (void *)&noclobber, 
+
+	if (full) {
+	    (void)memcpy((void *)gpsdata,
+			 (void *)&noclobber,
 			 sizeof(struct gps_data_t));
 	    /*@i1@*/gpsdata->privdata = private_save;
-	    if ((gpsdata->set & REPORT_IS)!=0) {
-		if (gpsdata->fix.mode >= 2)
-		    gpsdata->status = STATUS_FIX;
-		else
-		    gpsdata->status = STATUS_NO_FIX;
-		gpsdata->set = STATUS_SET;
+	    PRIVATE(gpsdata)->last_full = fullseq;
+	} else {
+	    (void)memcpy((void *)gpsdata,
+			 (void *)&noclobber,
+			 FIX_SLICE_LENGTH);
+	    (void)memcpy((void *)gpsdata->tag,
+			 (void *)noclobber.tag,
+			 sizeof(gpsdata->tag));
+	}
+	if ((gpsdata->set & REPORT_IS)!=0) {
+	    if (gpsdata->fix.mode >= 2)
+		gpsdata->status = STATUS_FIX;
+	    else
+		gpsdata->status = STATUS_NO_FIX;
+	    gpsdata->set = STATUS_SET;
+	}
+	return (int)copied;
+    }
+    /*@ +compdestroy */
+}
+
+int gps_shm_read_next(struct gps_data_t *gpsdata,
+		      /*@null@*/unsigned int *overruns)
+/* read the oldest unconsumed epoch from the export ring */
+{
+    /*@ -compdestroy */
+    if (gpsdata->privdata == NULL)
+	return -1;
+    else
+    {
+	void *private_save = gpsdata->privdata;
+	volatile struct shmexport_t *shared =
+	    (struct shmexport_t *)PRIVATE(gpsdata)->shmseg;
+	struct gps_data_t noclobber;
+	unsigned int head, cursor;
+	int before, after, tries;
+	bool good = false;
+
+	/*
+	 * Unlike gps_shm_read(), which always hands back the latest
+	 * state, this walks the ring so each publication is seen
+	 * exactly once.  A reader lapped by the writer loses the
+	 * oldest epochs; we count those into *overruns and resume at
+	 * the oldest one still live in the ring.
+	 */
+	cursor = PRIVATE(gpsdata)->ring_cursor;
+	head = shared->ring_head;
+	if (overruns != NULL)
+	    *overruns = 0;
+	if (cursor == head)
+	    return 0;		/* nothing new */
+	if (head - cursor > (unsigned int)(SHM_RING_SLOTS - 1)) {
+	    unsigned int oldest = head - (unsigned int)(SHM_RING_SLOTS - 1);
+	    if (overruns != NULL)
+		*overruns = oldest - cursor;
+	    cursor = oldest;
+	}
+
+	for (tries = 0; tries < SHM_MAX_TRIES; tries++) {
+	    volatile struct shm_ring_slot_t *slot =
+		&shared->ring[cursor % SHM_RING_SLOTS];
+
+	    before = slot->seq;
+	    barrier();
+	    if ((before & 1) != 0)
+		continue;	/* slot being rewritten */
+	    if (slot->epoch != cursor) {
+		/* lapped while we looked; skip to the oldest survivor */
+		head = shared->ring_head;
+		if (head - cursor > (unsigned int)(SHM_RING_SLOTS - 1)) {
+		    unsigned int oldest =
+			head - (unsigned int)(SHM_RING_SLOTS - 1);
+		    if (overruns != NULL)
+			*overruns += oldest - cursor;
+		    cursor = oldest;
+		    continue;
+		}
+		return 0;	/* slot not yet published */
+	    }
+	    (void)memcpy((void *)&noclobber,
+			 (void *)&slot->gpsdata,
+			 sizeof(struct gps_data_t));
+	    barrier();
+	    after = slot->seq;
+	    if (before == after && slot->epoch == cursor) {
+		good = true;
+		break;
 	    }
-	    return (int)sizeof(struct gps_data_t);
 	}
+	if (!good)
+	    return 0;
+
+	PRIVATE(gpsdata)->ring_cursor = cursor + 1;
+	(void)memcpy((void *)gpsdata,
+		     (void *)&noclobber,
+		     sizeof(struct gps_data_t));
+	/*@i1@*/gpsdata->privdata = private_save;
+	if ((gpsdata->set & REPORT_IS)!=0) {
+	    if (gpsdata->fix.mode >= 2)
+		gpsdata->status = STATUS_FIX;
+	    else
+		gpsdata->status = STATUS_NO_FIX;
+	    gpsdata->set = STATUS_SET;
+	}
+	return (int)sizeof(struct gps_data_t);
     }
     /*@ +compdestroy */
 }
 
 void gps_shm_close(struct gps_data_t *gpsdata)
 {
-    if (gpsdata->privdata != NULL)
-	(void)shmdt((const void *)gpsdata->privdata);
+    if (gpsdata->privdata != NULL) {
+	(void)shmdt((const void *)PRIVATE(gpsdata)->shmseg);
+	free(gpsdata->privdata);
+	gpsdata->privdata = NULL;
+    }
 }
 
 #endif /* SHM_EXPORT_ENABLE */
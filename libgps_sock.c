@@ -43,7 +43,15 @@ struct privdata_t
     bool newstyle;
     /* data buffered from the last read */
     ssize_t waiting;
-    char buffer[GPS_JSON_RESPONSE_MAX * 2];
+    /* how far terminator scanning has already looked */
+    ssize_t scanpos;
+    /* consumed bytes whose buffer shift is deferred (string views) */
+    ssize_t consumed;
+    /* command bytes the daemon hasn't accepted yet */
+    size_t pending_len;
+    char pending[GPS_JSON_COMMAND_MAX * 4];
+    /* must hold a full binary frame plus buffered JSON text */
+    char buffer[GPS_JSON_RESPONSE_MAX * 2 + sizeof(struct gps_data_t)];
 #ifdef LIBGPS_DEBUG
     int waitcount;
 #endif /* LIBGPS_DEBUG */
@@ -86,6 +94,9 @@ int gps_sock_open(/*@null@*/const char *host, /*@null@*/const char *port,
 	return -1;
     PRIVATE(gpsdata)->newstyle = false;
     PRIVATE(gpsdata)->waiting = 0;
+    PRIVATE(gpsdata)->scanpos = 0;
+    PRIVATE(gpsdata)->consumed = 0;
+    PRIVATE(gpsdata)->pending_len = 0;
 
 #ifdef LIBGPS_DEBUG
     PRIVATE(gpsdata)->waitcount = 0;
@@ -141,6 +152,62 @@ int gps_sock_close(struct gps_data_t *gpsdata)
 /*@+usereleased +compdef@*/
 
 /*@-compdef -usedef -uniondef@*/
+static void gps_shift_buffer(struct gps_data_t *gpsdata)
+/* perform a buffer shift deferred to keep borrowed string views alive */
+{
+    if (PRIVATE(gpsdata)->consumed > 0) {
+	memmove(PRIVATE(gpsdata)->buffer,
+		PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->consumed,
+		PRIVATE(gpsdata)->waiting - PRIVATE(gpsdata)->consumed);
+	PRIVATE(gpsdata)->waiting -= PRIVATE(gpsdata)->consumed;
+	PRIVATE(gpsdata)->consumed = 0;
+	PRIVATE(gpsdata)->scanpos = 0;
+    }
+}
+
+static int gps_binary_read(/*@out@*/struct gps_data_t *gpsdata)
+/* consume a length-delimited binary report from the head of the buffer */
+{
+    struct gps_binary_header_t hdr;
+    size_t total;
+    void *save_privdata = gpsdata->privdata;
+    bool save_views = gpsdata->string_views;
+#ifndef USE_QT
+    socket_t save_fd = gpsdata->gps_fd;
+#else
+    void *save_fd = gpsdata->gps_fd;
+#endif
+
+    if (PRIVATE(gpsdata)->waiting < (ssize_t)sizeof(hdr))
+	return 0;		/* not enough data yet, come back later */
+    memcpy(&hdr, PRIVATE(gpsdata)->buffer, sizeof(hdr));
+    if (memcmp(hdr.magic, GPS_BINARY_MAGIC, sizeof(hdr.magic)) != 0
+	|| hdr.version != GPS_BINARY_VERSION
+	|| hdr.length > sizeof(struct gps_data_t)) {
+	/* stream is desynchronized or from a mismatched daemon; dump it */
+	PRIVATE(gpsdata)->waiting = 0;
+	PRIVATE(gpsdata)->scanpos = 0;
+	return -1;
+    }
+    total = sizeof(hdr) + hdr.length;
+    if (PRIVATE(gpsdata)->waiting < (ssize_t)total)
+	return 0;
+    memcpy(gpsdata, PRIVATE(gpsdata)->buffer + sizeof(hdr), hdr.length);
+    gpsdata->gps_fd = save_fd;
+    gpsdata->privdata = save_privdata;
+    gpsdata->string_views = save_views;
+    /* view pointers from the daemon's address space are meaningless */
+    gpsdata->device_view = gpsdata->tag_view = NULL;
+    memmove(PRIVATE(gpsdata)->buffer,
+	    PRIVATE(gpsdata)->buffer + total,
+	    PRIVATE(gpsdata)->waiting - total);
+    PRIVATE(gpsdata)->waiting -= total;
+    PRIVATE(gpsdata)->scanpos = 0;	/* trailing bytes are unscanned */
+    gpsdata->online = timestamp();
+    gpsdata->set |= PACKET_SET;
+    return (int)total;
+}
+
 int gps_sock_read(/*@out@*/struct gps_data_t *gpsdata)
 /* wait for and read data being streamed from the daemon */
 {
@@ -149,11 +216,51 @@ int gps_sock_read(/*@out@*/struct gps_data_t *gpsdata)
     int status = -1;
 
     gpsdata->set &= ~PACKET_SET;
-    for (eol = PRIVATE(gpsdata)->buffer;
-	 *eol != '\n' && eol < PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting; eol++)
+    gps_shift_buffer(gpsdata);
+    (void)gps_sock_flush(gpsdata, 0);	/* retry any queued commands */
+
+    /* binary frames are length-delimited and may contain newlines */
+    if (PRIVATE(gpsdata)->waiting > 0
+	&& PRIVATE(gpsdata)->buffer[0] == GPS_BINARY_MAGIC[0]) {
+	status = gps_binary_read(gpsdata);
+	if (status != 0)
+	    return status;
+	/* partial frame buffered; pull in more data and retry */
+#ifndef USE_QT
+	status = (int)recv(gpsdata->gps_fd,
+			   PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting,
+			   sizeof(PRIVATE(gpsdata)->buffer) - PRIVATE(gpsdata)->waiting, 0);
+#else
+	status =
+	    ((QTcpSocket *) (gpsdata->gps_fd))->read(PRIVATE(gpsdata)->buffer +
+						     PRIVATE(gpsdata)->waiting,
+						     sizeof(PRIVATE(gpsdata)->buffer) -
+						     PRIVATE(gpsdata)->waiting);
+#endif
+	if (status > 0)
+	    PRIVATE(gpsdata)->waiting += status;
+	else if (status == 0)
+	    return -1;		/* other side is closing the socket */
+#ifndef USE_QT
+	else if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)
+	    return -1;
+#endif
+	return gps_binary_read(gpsdata);
+    }
+
+    /*
+     * The terminator scan resumes where the last one stopped, so
+     * bytes are examined once no matter how many reads a response
+     * is split across.
+     */
+    for (eol = PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->scanpos;
+	 eol < PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting
+	 && *eol != '\n'; eol++)
 	continue;
-    if (*eol != '\n')
+    if (eol >= PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting) {
+	PRIVATE(gpsdata)->scanpos = PRIVATE(gpsdata)->waiting;
 	eol = NULL;
+    }
 
     errno = 0;
 
@@ -193,13 +300,14 @@ int gps_sock_read(/*@out@*/struct gps_data_t *gpsdata)
 		return -1;
 	}
 	/* there's buffered data waiting to be returned */
-	for (eol = PRIVATE(gpsdata)->buffer;
-	     *eol != '\n' && eol < PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting; eol++)
+	for (eol = PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->scanpos;
+	     eol < PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting
+	     && *eol != '\n'; eol++)
 	    continue;
-	if (*eol != '\n')
-	    eol = NULL;
-	if (eol == NULL)
+	if (eol >= PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting) {
+	    PRIVATE(gpsdata)->scanpos = PRIVATE(gpsdata)->waiting;
 	    return 0;
+	}
     }
 
     assert(eol != NULL);
@@ -207,15 +315,126 @@ int gps_sock_read(/*@out@*/struct gps_data_t *gpsdata)
     response_length = eol - PRIVATE(gpsdata)->buffer + 1;
     gpsdata->online = timestamp();
     status = gps_unpack(PRIVATE(gpsdata)->buffer, gpsdata);
-    /*@+matchanyintegral@*/
-    memmove(PRIVATE(gpsdata)->buffer,
-	    PRIVATE(gpsdata)->buffer + response_length, PRIVATE(gpsdata)->waiting - response_length);
-    /*@-matchanyintegral@*/
-    PRIVATE(gpsdata)->waiting -= response_length;
+    if (gpsdata->string_views)
+	/* shifting now would pull the buffer out from under the views */
+	PRIVATE(gpsdata)->consumed = response_length;
+    else {
+	/*@+matchanyintegral@*/
+	memmove(PRIVATE(gpsdata)->buffer,
+		PRIVATE(gpsdata)->buffer + response_length, PRIVATE(gpsdata)->waiting - response_length);
+	/*@-matchanyintegral@*/
+	PRIVATE(gpsdata)->waiting -= response_length;
+	PRIVATE(gpsdata)->scanpos = 0;	/* trailing bytes are unscanned */
+    }
     gpsdata->set |= PACKET_SET;
 
     return (status == 0) ? (int)response_length : status;
 }
+
+int gps_sock_dispatch(struct gps_data_t *gpsdata,
+		      void (*hook)(struct gps_data_t *, void *),
+		      /*@null@*/ void *context)
+/* drain the daemon socket without blocking, calling the hook per report
+ *
+ * Unlike gps_read(), which consumes at most one response per call and
+ * may block waiting for it, this pulls in everything the socket has
+ * buffered and invokes the hook once for each complete report, with
+ * gpsdata->set holding just that report's class flags.  It never
+ * blocks, so one select/poll/epoll loop can service many daemon
+ * connections from a single thread; returns the number of reports
+ * dispatched, or -1 on error or hangup.
+ */
+{
+#ifndef USE_QT
+    char *eol;
+    ssize_t got, response_length;
+    int reports = 0;
+    bool hangup = false;
+
+    gps_shift_buffer(gpsdata);
+    (void)gps_sock_flush(gpsdata, 0);	/* retry any queued commands */
+
+    /* pull in whatever the daemon has sent */
+    for (;;) {
+	size_t space =
+	    sizeof(PRIVATE(gpsdata)->buffer) - 1 - PRIVATE(gpsdata)->waiting;
+
+	if (space == 0)
+	    break;	/* buffer full; dispatch before reading on */
+	got = recv(gpsdata->gps_fd,
+		   PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting,
+		   space, MSG_DONTWAIT);
+	if (got > 0) {
+	    PRIVATE(gpsdata)->waiting += got;
+	    if ((size_t)got < space)
+		break;	/* short read; the queue is empty */
+	} else if (got == 0) {
+	    hangup = true;
+	    break;
+	} else if (errno == EINTR)
+	    continue;
+	else if (errno == EAGAIN || errno == EWOULDBLOCK)
+	    break;
+	else
+	    return -1;
+    }
+
+    /* dispatch every complete report now buffered */
+    while (PRIVATE(gpsdata)->waiting > 0) {
+	/* binary frames are length-delimited and may contain newlines */
+	if (PRIVATE(gpsdata)->buffer[0] == GPS_BINARY_MAGIC[0]) {
+	    int status;
+
+	    gpsdata->set &= ~PACKET_SET;
+	    status = gps_binary_read(gpsdata);
+	    if (status == 0)
+		break;		/* partial frame; wait for the rest */
+	    if (status > 0) {
+		hook(gpsdata, context);
+		reports++;
+	    }
+	    /* on -1 the desynced buffer was dumped; the loop ends */
+	    continue;
+	}
+	for (eol = PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->scanpos;
+	     eol < PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting
+	     && *eol != '\n';
+	     eol++)
+	    continue;
+	if (eol >= PRIVATE(gpsdata)->buffer + PRIVATE(gpsdata)->waiting) {
+	    /* partial line; remember how far we looked */
+	    PRIVATE(gpsdata)->scanpos = PRIVATE(gpsdata)->waiting;
+	    break;
+	}
+	*eol = '\0';
+	response_length = eol - PRIVATE(gpsdata)->buffer + 1;
+	gpsdata->online = timestamp();
+	gpsdata->set = 0;	/* the hook sees only this report's class */
+	(void)gps_unpack(PRIVATE(gpsdata)->buffer, gpsdata);
+	gpsdata->set |= PACKET_SET;
+	/* before the shift, so borrowed string views stay valid in it */
+	if (!libgps_dedupe(gpsdata))
+	    hook(gpsdata, context);
+	/*@+matchanyintegral@*/
+	memmove(PRIVATE(gpsdata)->buffer,
+		PRIVATE(gpsdata)->buffer + response_length,
+		PRIVATE(gpsdata)->waiting - response_length);
+	/*@-matchanyintegral@*/
+	PRIVATE(gpsdata)->waiting -= response_length;
+	PRIVATE(gpsdata)->scanpos = 0;	/* trailing bytes are unscanned */
+	reports++;
+    }
+
+    if (reports == 0 && hangup)
+	return -1;
+    return reports;
+#else
+    (void)gpsdata;
+    (void)hook;
+    (void)context;
+    return -1;
+#endif /* USE_QT */
+}
 /*@+compdef -usedef +uniondef@*/
 
 /*@ -branchstate -usereleased -mustfreefresh -nullstate -usedef @*/
@@ -473,22 +692,92 @@ const char /*@observer@*/ *gps_data(const struct gps_data_t *gpsdata)
     return PRIVATE(gpsdata)->buffer;
 }
 
+int gps_sock_flush(struct gps_data_t *gpsdata, int timeout)
+/* push queued command bytes without wedging the caller
+ *
+ * Never blocks for longer than timeout microseconds; with a zero
+ * timeout it only moves what the socket will take right now.
+ * Returns 0 when the queue is empty, 1 if bytes remain queued (a
+ * stalled daemon; they go out with a later call or the next read),
+ * and -1 on a hard write error.
+ */
+{
+#ifndef USE_QT
+    struct privdata_t *priv = PRIVATE(gpsdata);
+
+    if (priv == NULL)
+	return 0;
+    while (priv->pending_len > 0) {
+	ssize_t sent = send(gpsdata->gps_fd, priv->pending,
+			    priv->pending_len, MSG_DONTWAIT);
+
+	if (sent > 0) {
+	    priv->pending_len -= (size_t)sent;
+	    if (priv->pending_len > 0)
+		memmove(priv->pending, priv->pending + sent,
+			priv->pending_len);
+	    continue;
+	}
+	if (sent == -1 && errno == EINTR)
+	    continue;
+	if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+	    fd_set wfds;
+	    struct timeval tv;
+
+	    if (timeout <= 0)
+		return 1;
+	    FD_ZERO(&wfds);
+	    FD_SET(gpsdata->gps_fd, &wfds);
+	    tv.tv_sec = timeout / 1000000;
+	    tv.tv_usec = timeout % 1000000;
+	    if (select(gpsdata->gps_fd + 1, NULL, &wfds, NULL, &tv) != 1)
+		return 1;	/* latency bound reached */
+	    timeout = 0;	/* at most one wait per call */
+	    continue;
+	}
+	return -1;
+    }
+#else
+    (void)gpsdata;
+    (void)timeout;
+#endif /* USE_QT */
+    return 0;
+}
+
 int gps_send(struct gps_data_t *gpsdata, const char *fmt, ...)
 /* send a command to the gpsd instance */
 {
     char buf[BUFSIZ];
     va_list ap;
 
+    /* a local session reading via implicit SHM needs the socket now */
+    if (libgps_shm_upgrade(gpsdata) != 0)
+	return -1;
+
     va_start(ap, fmt);
     (void)vsnprintf(buf, sizeof(buf) - 2, fmt, ap);
     va_end(ap);
     if (buf[strlen(buf) - 1] != '\n')
 	(void)strlcat(buf, "\n", BUFSIZ);
 #ifndef USE_QT
-    if (write(gpsdata->gps_fd, buf, strlen(buf)) == (ssize_t) strlen(buf))
-	return 0;
-    else
-	return -1;
+    /*
+     * Commands are queued and pushed with non-blocking writes, so a
+     * stalled daemon (restart window, wedged listener) can never
+     * hang the caller's event loop in here.  Unsent bytes drain on
+     * later sends and reads, or explicitly via gps_flush().
+     */
+    {
+	struct privdata_t *priv = PRIVATE(gpsdata);
+	size_t len = strlen(buf);
+
+	if (priv == NULL)
+	    return -1;
+	if (len > sizeof(priv->pending) - priv->pending_len)
+	    return -1;	/* queue full; daemon stalled for too long */
+	memcpy(priv->pending + priv->pending_len, buf, len);
+	priv->pending_len += len;
+	return (gps_sock_flush(gpsdata, 0) == -1) ? -1 : 0;
+    }
 #else
     QTcpSocket *sock = (QTcpSocket *) gpsdata->gps_fd;
     sock->write(buf, strlen(buf));
@@ -510,6 +799,9 @@ int gps_stream(struct gps_data_t *gpsdata, unsigned int flags,
     if ((flags & (WATCH_JSON | WATCH_OLDSTYLE | WATCH_NMEA | WATCH_RAW)) == 0) {
 	flags |= WATCH_JSON;
     }
+    /* deduplication is client-local; nothing goes to the daemon for it */
+    if ((flags & WATCH_DEDUPE) != 0)
+	gpsdata->dedupe = ((flags & WATCH_DISABLE) == 0);
     if ((flags & WATCH_DISABLE) != 0) {
 	if ((flags & WATCH_OLDSTYLE) != 0) {
 	    (void)strlcpy(buf, "w-", sizeof(buf));
@@ -529,6 +821,8 @@ int gps_stream(struct gps_data_t *gpsdata, unsigned int flags,
 		(void)strlcat(buf, "\"scaled\":false,", sizeof(buf));
 	    if (flags & WATCH_TIMING)
 		(void)strlcat(buf, "\"timing\":false,", sizeof(buf));
+	    if (flags & WATCH_BINARY)
+		(void)strlcat(buf, "\"binary\":false,", sizeof(buf));
 	    if (buf[strlen(buf) - 1] == ',')
 		buf[strlen(buf) - 1] = '\0';
 	    (void)strlcat(buf, "};", sizeof(buf));
@@ -555,6 +849,8 @@ int gps_stream(struct gps_data_t *gpsdata, unsigned int flags,
 		(void)strlcat(buf, "\"scaled\":true,", sizeof(buf));
 	    if (flags & WATCH_TIMING)
 		(void)strlcat(buf, "\"timing\":true,", sizeof(buf));
+	    if (flags & WATCH_BINARY)
+		(void)strlcat(buf, "\"binary\":true,", sizeof(buf));
 	    /*@-nullpass@*//* shouldn't be needed, splint has a bug */
 	    if (flags & WATCH_DEVICE)
 		(void)snprintf(buf + strlen(buf), sizeof(buf) - strlen(buf),
@@ -26,6 +26,9 @@
 
 #include "gpsd.h"
 
+/* packets of stable sync before the lexer is narrowed to seen types */
+#define LEXER_LOCK_PACKETS	10
+
 static void gpsd_run_device_hook(char *device_name, char *hook)
 {
     struct stat statbuf;
@@ -63,6 +66,8 @@ int gpsd_switch_driver(struct gps_device_t *session, char *type_name)
 			(*dp)->type_name);
 	    gpsd_assert_sync(session);
 	    /*@i@*/ session->device_type = *dp;
+	    /* re-open the lexer's hunt until the new sync proves stable */
+	    packet_lock(&session->packet, 0);
 #ifdef RECONFIGURE_ENABLE
 	    session->gpsdata.dev.mincycle = session->device_type->min_cycle;
 #endif /* RECONFIGURE_ENABLE */
@@ -88,6 +93,7 @@ void gps_context_init(struct gps_context_t *context)
 	.valid	        = 0,
 	.debug	        = 0,
 	.readonly	= false,
+	.async_settle	= false,
 	.fixcnt	        = 0,
 	.rtcmbytes	= 0,
 	.rtcmbuf	= {'\0'},
@@ -205,7 +211,10 @@ int gpsd_open(struct gps_device_t *session)
     if (netgnss_uri_check(session->gpsdata.dev.path)) {
 	session->gpsdata.gps_fd = netgnss_uri_open(session,
 						   session->gpsdata.dev.path);
-	session->sourcetype = source_tcp;
+	if (strncmp(session->gpsdata.dev.path, "udp://", 6) == 0)
+	    session->sourcetype = source_udp;
+	else
+	    session->sourcetype = source_tcp;
 	gpsd_report(LOG_SPIN,
 		    "netgnss_uri_open(%s) returns socket on fd %d\n",
 		    session->gpsdata.dev.path, session->gpsdata.gps_fd);
@@ -322,6 +331,17 @@ int gpsd_activate(struct gps_device_t *session)
       foundit:
 #endif /* NON_NMEA_ENABLE */
 	gpsd_clear(session);
+	/* datagram sources get the batched receive path in packet_get() */
+	session->packet.dgram = (session->sourcetype == source_udp);
+	if (session->packet_hint > COMMENT_PACKET)
+	    /*
+	     * The protocol cache remembers what this device spoke last
+	     * time; lock the lexer onto it so the first packet syncs.
+	     * If the hint is stale the sniffer reopens the hunt after
+	     * SNIFF_RETRIES characters.
+	     */
+	    packet_lock(&session->packet,
+			PACKET_TYPEMASK(session->packet_hint));
 	gpsd_report(LOG_INF,
 		    "gpsd_activate(): activated GPS (fd %d)\n",
 		    session->gpsdata.gps_fd);
@@ -808,6 +828,21 @@ gps_mask_t gpsd_poll(struct gps_device_t *session)
     ssize_t newlen;
     bool first_sync = false;
 
+    /*
+     * With async_settle set, gpsd_set_speed() marks a settle deadline
+     * instead of sleeping through it.  Until the deadline passes we
+     * report "online, no packet yet" so the event loop keeps the fd
+     * watched; at expiry we issue the second flush of the classic
+     * flush/delay/flush sequence to drop anything garbled by the
+     * speed change, then resume reading normally.
+     */
+    if (session->settle_time > 0) {
+	if (timestamp() < session->settle_time)
+	    return ONLINE_SET;
+	(void)tcflush(session->gpsdata.gps_fd, TCIOFLUSH);
+	session->settle_time = (timestamp_t)0;
+    }
+
     gps_clear_fix(&session->newdata);
 
 #ifdef TIMING_ENABLE
@@ -892,6 +927,7 @@ gps_mask_t gpsd_poll(struct gps_device_t *session)
 
 #ifdef TIMING_ENABLE
 	session->d_recv_time = timestamp();
+	session->m_recv_time = monotime();
 #endif /* TIMING_ENABLE */
 
 	/* track the packet count since achieving sync on the device */
@@ -911,8 +947,18 @@ gps_mask_t gpsd_poll(struct gps_device_t *session)
 		&& session->device_type->event_hook != NULL)
 		session->device_type->event_hook(session, event_identified);
 	    session->packet.counter = 0;
-	} else
+	} else {
 	    session->packet.counter++;
+	    /*
+	     * Sync has survived several packets; narrow the lexer to
+	     * the types this device has actually been seen to emit,
+	     * so stray payload bytes cannot drag it into candidate
+	     * states of protocols the device does not speak.
+	     */
+	    if (session->packet.counter == LEXER_LOCK_PACKETS)
+		packet_lock(&session->packet,
+			    session->observed & GPS_TYPEMASK);
+	}
 
 	/* fire the configure hook */
 	if (session->device_type != NULL
@@ -944,8 +990,27 @@ gps_mask_t gpsd_poll(struct gps_device_t *session)
 	/* Get data from current packet into the fix structure */
 	if (session->packet.type != COMMENT_PACKET)
 	    if (session->device_type != NULL
-		&& session->device_type->parse_packet != NULL)
+		&& session->device_type->parse_packet != NULL) {
+#ifdef TIMING_ENABLE
+		/* the coarse wall clock can't resolve a parse call */
+		timestamp_t parse_start = monotime();
+		double cost;
+#endif /* TIMING_ENABLE */
 		received |= session->device_type->parse_packet(session);
+#ifdef TIMING_ENABLE
+		/* fold the decode cost into the per-device tallies */
+		cost = monotime() - parse_start;
+		if (cost >= 0) {
+		    session->decode.count++;
+		    session->decode.sum += cost;
+		    if (session->decode.count == 1
+			|| cost < session->decode.min)
+			session->decode.min = cost;
+		    if (cost > session->decode.max)
+			session->decode.max = cost;
+		}
+#endif /* TIMING_ENABLE */
+	    }
 
 	session->gpsdata.set = ONLINE_SET | received;
 
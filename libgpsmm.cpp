@@ -19,11 +19,19 @@ struct gps_data_t* gpsmm::gps_inner_open(const char *host, const char *port)
 	return NULL;
     }
     else { // connection successfully opened
-	to_user= new struct gps_data_t;
+	to_user = &user_buffer; //reused for every backup; no heap churn
 	return backup(); //we return the backup of our internal structure
     }
 }
 
+void gpsmm::close_session(void)
+{
+    if ( to_user != NULL ) {
+	gps_close(gps_state());
+	to_user = NULL;
+    }
+}
+
 struct gps_data_t* gpsmm::stream(int flags) 
 {
     if (to_user == NULL)
@@ -59,6 +67,41 @@ struct gps_data_t* gpsmm::read(void)
     }
 }
 
+struct batch_ctx_t {
+    struct gps_data_t *out;
+    int max_n;
+    int count;
+};
+
+static void batch_hook(struct gps_data_t *gpsdata, void *p)
+{
+    struct batch_ctx_t *ctx = (struct batch_ctx_t *)p;
+
+    if (ctx->count < ctx->max_n)
+	ctx->out[ctx->count++] = *gpsdata;
+    // overflow reports still update the session state, they just
+    // don't get a slot in the caller's array
+}
+
+int gpsmm::read_batch(struct gps_data_t *out, int max_n)
+{
+    // Unlike read(), this never blocks: it drains every complete
+    // report the daemon has already sent, one array slot per report,
+    // so a high-rate consumer wakes up once per burst instead of
+    // once per report.  Returns the number of reports stored, or -1
+    // on error or hangup.
+    struct batch_ctx_t ctx;
+
+    if (to_user == NULL || out == NULL || max_n <= 0)
+	return -1;
+    ctx.out = out;
+    ctx.max_n = max_n;
+    ctx.count = 0;
+    if (gps_dispatch(gps_state(), batch_hook, &ctx) == -1)
+	return -1;
+    return ctx.count;
+}
+
 bool gpsmm::waiting(int timeout)
 {
     return gps_waiting(gps_state(), timeout);
@@ -83,9 +126,6 @@ void gpsmm::enable_debug(int level, FILE *fp)
 
 gpsmm::~gpsmm()
 {
-    if ( to_user != NULL ) {
-	gps_close(gps_state());
-	delete to_user;
-    }
+    close_session();
 }
 #endif /* S_SPLINT_S */
@@ -21,6 +21,23 @@ class LIBQGPSMMSHARED_EXPORT gpsmm {
 		gpsmm(const char *host, const char *port) : to_user(0) {
 			gps_inner_open(host, port);
 		}
+#if __cplusplus >= 201103L
+		//moving transfers the open session; the source is left closed
+		//so its destructor won't tear down the connection
+		gpsmm(gpsmm &&other) noexcept : to_user(0) {
+			steal(other);
+		}
+		gpsmm& operator=(gpsmm &&other) noexcept {
+			if (this != &other) {
+				close_session();
+				steal(other);
+			}
+			return *this;
+		}
+		//copying would double-close the daemon socket
+		gpsmm(const gpsmm &) = delete;
+		gpsmm& operator=(const gpsmm &) = delete;
+#endif
 #ifdef __UNUSED__
 		gpsmm(void) : to_user(0) 
 		{
@@ -31,17 +48,32 @@ class LIBQGPSMMSHARED_EXPORT gpsmm {
 		struct gps_data_t* send(const char *request); //put a command to gpsd and return the updated struct
 		struct gps_data_t* stream(int); //set watcher and policy flags
 		struct gps_data_t* read(void); //block until gpsd returns new data, then return the updated struct
+		int read_batch(struct gps_data_t *out, int max_n); //drain all buffered reports into out[] without blocking; returns count or -1
 		const char *data(void);	// return the client data buffer
 		bool waiting(int);	// blocking check for data waiting
 		void clear_fix(void);
 		void enable_debug(int, FILE*);
 	private:
 		struct gps_data_t *to_user;	//we return the user a copy of the internal structure. This way she can modify it without
-						//integrity loss for the entire class
+						//integrity loss for the entire class.
+						//Points at user_buffer when the session is open, NULL otherwise;
+						//reusing the member buffer keeps the steady state allocation-free.
 		struct gps_data_t* gps_inner_open(const char *host,
 						  const char *port);
 		struct gps_data_t _gps_state;
+		struct gps_data_t user_buffer;
 		struct gps_data_t * gps_state() { return &_gps_state; }
 		struct gps_data_t* backup(void) { *to_user=*gps_state(); return to_user;}; //return the backup copy
+		void close_session(void);
+#if __cplusplus >= 201103L
+		void steal(gpsmm &other) noexcept {
+			if (other.to_user != NULL) {
+				_gps_state = other._gps_state;
+				user_buffer = other.user_buffer;
+				to_user = &user_buffer;
+				other.to_user = NULL;
+			}
+		}
+#endif
 };
 #endif // _GPSD_GPSMM_H_
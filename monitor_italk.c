@@ -19,7 +19,7 @@
 extern const struct gps_type_t italk_binary;
 static WINDOW *satwin, *navfixwin;
 
-#define display	(void)mvwprintw
+#define display	monitor_display
 static bool italk_initialize(void)
 {
     int i;
@@ -59,63 +59,63 @@ static bool nmea_initialize(void)
     satwin = derwin(devicewin, MAXSATS + 3, 20, 6, 0);
     (void)wborder(satwin, 0, 0, 0, 0, 0, 0, 0, 0), (void)syncok(satwin, true);
     (void)wattrset(satwin, A_BOLD);
-    (void)mvwprintw(satwin, 1, 1, "Ch PRN  Az El S/N");
+    monitor_display(satwin, 1, 1, "Ch PRN  Az El S/N");
     for (i = 0; i < MAXSATS; i++)
-	(void)mvwprintw(satwin, (int)(i + 2), 1, "%2d", i);
-    (void)mvwprintw(satwin, 14, 7, " GSV ");
+	monitor_display(satwin, (int)(i + 2), 1, "%2d", i);
+    monitor_display(satwin, 14, 7, " GSV ");
     (void)wattrset(satwin, A_NORMAL);
 
     gprmcwin = derwin(devicewin, 9, 30, 6, 20);
     (void)wborder(gprmcwin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)syncok(gprmcwin, true);
     (void)wattrset(gprmcwin, A_BOLD);
-    (void)mvwprintw(gprmcwin, 1, 1, "Time: ");
-    (void)mvwprintw(gprmcwin, 2, 1, "Latitude: ");
-    (void)mvwprintw(gprmcwin, 3, 1, "Longitude: ");
-    (void)mvwprintw(gprmcwin, 4, 1, "Speed: ");
-    (void)mvwprintw(gprmcwin, 5, 1, "Course: ");
-    (void)mvwprintw(gprmcwin, 6, 1, "Status:            FAA: ");
-    (void)mvwprintw(gprmcwin, 7, 1, "MagVar: ");
-    (void)mvwprintw(gprmcwin, 8, 12, " RMC ");
+    monitor_display(gprmcwin, 1, 1, "Time: ");
+    monitor_display(gprmcwin, 2, 1, "Latitude: ");
+    monitor_display(gprmcwin, 3, 1, "Longitude: ");
+    monitor_display(gprmcwin, 4, 1, "Speed: ");
+    monitor_display(gprmcwin, 5, 1, "Course: ");
+    monitor_display(gprmcwin, 6, 1, "Status:            FAA: ");
+    monitor_display(gprmcwin, 7, 1, "MagVar: ");
+    monitor_display(gprmcwin, 8, 12, " RMC ");
     (void)wattrset(gprmcwin, A_NORMAL);
 
     gpgsawin = derwin(devicewin, 5, 30, 15, 20);
     (void)wborder(gpgsawin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)syncok(gpgsawin, true);
     (void)wattrset(gpgsawin, A_BOLD);
-    (void)mvwprintw(gpgsawin, 1, 1, "Mode: ");
-    (void)mvwprintw(gpgsawin, 2, 1, "Sats: ");
-    (void)mvwprintw(gpgsawin, 3, 1, "DOP: H=      V=      P=");
-    (void)mvwprintw(gpgsawin, 4, 12, " GSA ");
+    monitor_display(gpgsawin, 1, 1, "Mode: ");
+    monitor_display(gpgsawin, 2, 1, "Sats: ");
+    monitor_display(gpgsawin, 3, 1, "DOP: H=      V=      P=");
+    monitor_display(gpgsawin, 4, 12, " GSA ");
     (void)wattrset(gpgsawin, A_NORMAL);
 
     gpggawin = derwin(devicewin, 9, 30, 6, 50);
     (void)wborder(gpggawin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)syncok(gpggawin, true);
     (void)wattrset(gpggawin, A_BOLD);
-    (void)mvwprintw(gpggawin, 1, 1, "Time: ");
-    (void)mvwprintw(gpggawin, 2, 1, "Latitude: ");
-    (void)mvwprintw(gpggawin, 3, 1, "Longitude: ");
-    (void)mvwprintw(gpggawin, 4, 1, "Altitude: ");
-    (void)mvwprintw(gpggawin, 5, 1, "Quality:       Sats: ");
-    (void)mvwprintw(gpggawin, 6, 1, "HDOP: ");
-    (void)mvwprintw(gpggawin, 7, 1, "Geoid: ");
-    (void)mvwprintw(gpggawin, 8, 12, " GGA ");
+    monitor_display(gpggawin, 1, 1, "Time: ");
+    monitor_display(gpggawin, 2, 1, "Latitude: ");
+    monitor_display(gpggawin, 3, 1, "Longitude: ");
+    monitor_display(gpggawin, 4, 1, "Altitude: ");
+    monitor_display(gpggawin, 5, 1, "Quality:       Sats: ");
+    monitor_display(gpggawin, 6, 1, "HDOP: ");
+    monitor_display(gpggawin, 7, 1, "Geoid: ");
+    monitor_display(gpggawin, 8, 12, " GGA ");
     (void)wattrset(gpggawin, A_NORMAL);
 
     gpgstwin = derwin(devicewin, 6, 30, 15, 50);
     (void)wborder(gpgstwin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)syncok(gpgstwin, true);
     (void)wattrset(gpgstwin, A_BOLD);
-    (void)mvwprintw(gpgstwin, 1,  1, "UTC: ");
-    (void)mvwprintw(gpgstwin, 1, 16, "RMS: ");
-    (void)mvwprintw(gpgstwin, 2,  1, "MAJ: ");
-    (void)mvwprintw(gpgstwin, 2, 16, "MIN: ");
-    (void)mvwprintw(gpgstwin, 3,  1, "ORI: ");
-    (void)mvwprintw(gpgstwin, 3, 16, "LAT: ");
-    (void)mvwprintw(gpgstwin, 4,  1, "LON: ");
-    (void)mvwprintw(gpgstwin, 4, 16, "ALT: ");
-    (void)mvwprintw(gpgstwin, 5, 12, " GST ");
+    monitor_display(gpgstwin, 1,  1, "UTC: ");
+    monitor_display(gpgstwin, 1, 16, "RMS: ");
+    monitor_display(gpgstwin, 2,  1, "MAJ: ");
+    monitor_display(gpgstwin, 2, 16, "MIN: ");
+    monitor_display(gpgstwin, 3,  1, "ORI: ");
+    monitor_display(gpgstwin, 3, 16, "LAT: ");
+    monitor_display(gpgstwin, 4,  1, "LON: ");
+    monitor_display(gpgstwin, 4, 16, "ALT: ");
+    monitor_display(gpgstwin, 5, 12, " GST ");
     (void)wattrset(gpgstwin, A_NORMAL);
 
 
@@ -134,7 +134,7 @@ static void cooked_pvt(void)
 	(void)unix_to_iso8601(session.gpsdata.fix.time, scr, sizeof(scr));
     } else
 	(void)snprintf(scr, sizeof(scr), "n/a");
-    (void)mvwprintw(cookedwin, 1, 7, "%-24s", scr);
+    monitor_display(cookedwin, 1, 7, "%-24s", scr);
 
 
     if (session.gpsdata.fix.mode >= MODE_2D
@@ -145,7 +145,7 @@ static void cooked_pvt(void)
 		       (session.gpsdata.fix.latitude < 0) ? 'S' : 'N');
     } else
 	(void)snprintf(scr, sizeof(scr), "n/a");
-    (void)mvwprintw(cookedwin, 1, 37, "%-17s", scr);
+    monitor_display(cookedwin, 1, 37, "%-17s", scr);
 
     if (session.gpsdata.fix.mode >= MODE_2D
 	&& isnan(session.gpsdata.fix.longitude) == 0) {
@@ -155,7 +155,7 @@ static void cooked_pvt(void)
 		       (session.gpsdata.fix.longitude < 0) ? 'W' : 'E');
     } else
 	(void)snprintf(scr, sizeof(scr), "n/a");
-    (void)mvwprintw(cookedwin, 1, 60, "%-17s", scr);
+    monitor_display(cookedwin, 1, 60, "%-17s", scr);
 }
 
 
@@ -238,14 +238,14 @@ static void nmea_update(void)
 	    || strcmp(fields[0], "GLRMC") == 0) {
 	    /* time, lat, lon, course, speed */
 	    (void)mvwaddstr(gprmcwin, 1, 12, fields[1]);
-	    (void)mvwprintw(gprmcwin, 2, 12, "%12s %s", fields[3], fields[4]);
-	    (void)mvwprintw(gprmcwin, 3, 12, "%12s %s", fields[5], fields[6]);
+	    monitor_display(gprmcwin, 2, 12, "%12s %s", fields[3], fields[4]);
+	    monitor_display(gprmcwin, 3, 12, "%12s %s", fields[5], fields[6]);
 	    (void)mvwaddstr(gprmcwin, 4, 12, fields[7]);
 	    (void)mvwaddstr(gprmcwin, 5, 12, fields[8]);
 	    /* the status field, FAA code, and magnetic variation */
 	    (void)mvwaddstr(gprmcwin, 6, 12, fields[2]);
 	    (void)mvwaddstr(gprmcwin, 6, 25, fields[12]);
-	    (void)mvwprintw(gprmcwin, 7, 12, "%-5s%s", fields[10],
+	    monitor_display(gprmcwin, 7, 12, "%-5s%s", fields[10],
 			    fields[11]);
 
 	    cooked_pvt();	/* cooked version of PVT */
@@ -256,7 +256,7 @@ static void nmea_update(void)
 	    || strcmp(fields[0], "GLGSA") == 0) {
 	    char scr[128];
 	    int i;
-	    (void)mvwprintw(gpgsawin, 1, 7, "%1s %s", fields[1], fields[2]);
+	    monitor_display(gpgsawin, 1, 7, "%1s %s", fields[1], fields[2]);
 	    (void)wmove(gpgsawin, 2, 7);
 	    (void)wclrtoeol(gpgsawin);
 	    scr[0] = '\0';
@@ -272,32 +272,32 @@ static void nmea_update(void)
 		(void)mvwaddch(gpgsawin, 2, xmax - 4 - 7, (chtype) '.');
 	    }
 	    monitor_fixframe(gpgsawin);
-	    (void)mvwprintw(gpgsawin, 3, 8, "%-5s", fields[16]);
-	    (void)mvwprintw(gpgsawin, 3, 16, "%-5s", fields[17]);
-	    (void)mvwprintw(gpgsawin, 3, 24, "%-5s", fields[15]);
+	    monitor_display(gpgsawin, 3, 8, "%-5s", fields[16]);
+	    monitor_display(gpgsawin, 3, 16, "%-5s", fields[17]);
+	    monitor_display(gpgsawin, 3, 24, "%-5s", fields[15]);
 	    monitor_fixframe(gpgsawin);
 	}
 	if (strcmp(fields[0], "GPGGA") == 0
 	    || strcmp(fields[0], "GNGGA") == 0
 	    || strcmp(fields[0], "GLGGA") == 0) {
-	    (void)mvwprintw(gpggawin, 1, 12, "%-17s", fields[1]);
-	    (void)mvwprintw(gpggawin, 2, 12, "%-17s", fields[2]);
-	    (void)mvwprintw(gpggawin, 3, 12, "%-17s", fields[4]);
-	    (void)mvwprintw(gpggawin, 4, 12, "%-17s", fields[9]);
-	    (void)mvwprintw(gpggawin, 5, 12, "%1.1s", fields[6]);
-	    (void)mvwprintw(gpggawin, 5, 22, "%2.2s", fields[7]);
-	    (void)mvwprintw(gpggawin, 6, 12, "%-5.5s", fields[8]);
-	    (void)mvwprintw(gpggawin, 7, 12, "%-5.5s", fields[11]);
+	    monitor_display(gpggawin, 1, 12, "%-17s", fields[1]);
+	    monitor_display(gpggawin, 2, 12, "%-17s", fields[2]);
+	    monitor_display(gpggawin, 3, 12, "%-17s", fields[4]);
+	    monitor_display(gpggawin, 4, 12, "%-17s", fields[9]);
+	    monitor_display(gpggawin, 5, 12, "%1.1s", fields[6]);
+	    monitor_display(gpggawin, 5, 22, "%2.2s", fields[7]);
+	    monitor_display(gpggawin, 6, 12, "%-5.5s", fields[8]);
+	    monitor_display(gpggawin, 7, 12, "%-5.5s", fields[11]);
 	}
 	if (strcmp(fields[0], "GPGST") == 0) {
-	    (void)mvwprintw(gpgstwin, 1,  6, "%-10s", fields[1]);
-	    (void)mvwprintw(gpgstwin, 1, 21,  "%-8s", fields[2]);
-	    (void)mvwprintw(gpgstwin, 2,  6, "%-10s", fields[3]);
-	    (void)mvwprintw(gpgstwin, 2, 21,  "%-8s", fields[4]);
-	    (void)mvwprintw(gpgstwin, 3,  6, "%-10s", fields[5]);
-	    (void)mvwprintw(gpgstwin, 3, 21,  "%-8s", fields[6]);
-	    (void)mvwprintw(gpgstwin, 4,  6, "%-10s", fields[7]);
-	    (void)mvwprintw(gpgstwin, 4, 21,  "%-8s", fields[8]);
+	    monitor_display(gpgstwin, 1,  6, "%-10s", fields[1]);
+	    monitor_display(gpgstwin, 1, 21,  "%-8s", fields[2]);
+	    monitor_display(gpgstwin, 2,  6, "%-10s", fields[3]);
+	    monitor_display(gpgstwin, 2, 21,  "%-8s", fields[4]);
+	    monitor_display(gpgstwin, 3,  6, "%-10s", fields[5]);
+	    monitor_display(gpgstwin, 3, 21,  "%-8s", fields[6]);
+	    monitor_display(gpgstwin, 4,  6, "%-10s", fields[7]);
+	    monitor_display(gpgstwin, 4, 21,  "%-8s", fields[8]);
 	}
     }
 }
@@ -109,61 +109,61 @@ static bool oncore_initialize(void)
 		    "Antenna:             DOP:                 Speed:            Course:");
     (void)mvwaddstr(Ea1win, 3, 1,
 		    "SV/vis:        Status:                                      Alt:");
-    (void)mvwprintw(Ea1win, 4, 4, " @@Ea (pos) ");
+    monitor_display(Ea1win, 4, 4, " @@Ea (pos) ");
     (void)wattrset(Ea1win, A_NORMAL);
 
     (void)wborder(Eawin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Eawin, A_BOLD);
-    (void)mvwprintw(Eawin, 1, 1, "Ch PRN mode S/N ????????");
-    (void)mvwprintw(Eawin, 10, 4, " @@Ea (sat) ");
+    monitor_display(Eawin, 1, 1, "Ch PRN mode S/N ????????");
+    monitor_display(Eawin, 10, 4, " @@Ea (sat) ");
     for (i = 0; i < 8; i++) {
-	(void)mvwprintw(Eawin, (int)(i + 2), 1, "%2d", i);
+	monitor_display(Eawin, (int)(i + 2), 1, "%2d", i);
     }
     (void)wattrset(Eawin, A_NORMAL);
 
     (void)wborder(Bbwin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Bbwin, A_BOLD);
-    (void)mvwprintw(Bbwin, 1, 1, "PRN  Az El doppl ??");
-    (void)mvwprintw(Bbwin, 14, 4, " @@Bb ");
+    monitor_display(Bbwin, 1, 1, "PRN  Az El doppl ??");
+    monitor_display(Bbwin, 14, 4, " @@Bb ");
     (void)wattrset(Bbwin, A_NORMAL);
 
     (void)wborder(Enwin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Enwin, A_BOLD);
-    (void)mvwprintw(Enwin, 1, 1, "Time RAIM: ");
-    (void)mvwprintw(Enwin, 2, 1, "Alarm limit:");
-    (void)mvwprintw(Enwin, 3, 1, "PPS ctrl:");
-    (void)mvwprintw(Enwin, 4, 1, "Pulse:");
-    (void)mvwprintw(Enwin, 5, 1, "PPS sync:");
-    (void)mvwprintw(Enwin, 6, 1, "TRAIM sol stat:");
-    (void)mvwprintw(Enwin, 7, 1, "Status:");
-    (void)mvwprintw(Enwin, 8, 1, "Time sol sigma:");
-    (void)mvwprintw(Enwin, 9, 4, " @@En ");
+    monitor_display(Enwin, 1, 1, "Time RAIM: ");
+    monitor_display(Enwin, 2, 1, "Alarm limit:");
+    monitor_display(Enwin, 3, 1, "PPS ctrl:");
+    monitor_display(Enwin, 4, 1, "Pulse:");
+    monitor_display(Enwin, 5, 1, "PPS sync:");
+    monitor_display(Enwin, 6, 1, "TRAIM sol stat:");
+    monitor_display(Enwin, 7, 1, "Status:");
+    monitor_display(Enwin, 8, 1, "Time sol sigma:");
+    monitor_display(Enwin, 9, 4, " @@En ");
     (void)wattrset(Enwin, A_NORMAL);
 
     (void)wborder(Bowin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Bowin, A_BOLD);
-    (void)mvwprintw(Bowin, 1, 1, "UTC:");
-    (void)mvwprintw(Bowin, 3, 2, " @@Bo ");
+    monitor_display(Bowin, 1, 1, "UTC:");
+    monitor_display(Bowin, 3, 2, " @@Bo ");
     (void)wattrset(Bowin, A_NORMAL);
 
     (void)wborder(Aywin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Aywin, A_BOLD);
-    (void)mvwprintw(Aywin, 1, 1, "PPS offset:");
-    (void)mvwprintw(Aywin, 3, 4, " @@Ay ");
+    monitor_display(Aywin, 1, 1, "PPS offset:");
+    monitor_display(Aywin, 3, 4, " @@Ay ");
     (void)wattrset(Aywin, A_NORMAL);
 
     (void)wborder(Atwin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Atwin, A_BOLD);
-    (void)mvwprintw(Atwin, 1, 1, "PHold:");
-    (void)mvwprintw(Atwin, 4, 1, " @@At ");
+    monitor_display(Atwin, 1, 1, "PHold:");
+    monitor_display(Atwin, 4, 1, " @@At ");
     (void)wattrset(Atwin, A_NORMAL);
 
     (void)wborder(Aswin, 0, 0, 0, 0, 0, 0, 0, 0),
 	(void)wattrset(Aswin, A_BOLD);
-    (void)mvwprintw(Aswin, 1, 1, "Lat:");
-    (void)mvwprintw(Aswin, 2, 1, "Lon:");
-    (void)mvwprintw(Aswin, 3, 1, "Alt:");
-    (void)mvwprintw(Aswin, 4, 4, " @@As ");
+    monitor_display(Aswin, 1, 1, "Lat:");
+    monitor_display(Aswin, 2, 1, "Lon:");
+    monitor_display(Aswin, 3, 1, "Alt:");
+    monitor_display(Aswin, 4, 4, " @@As ");
     (void)wattrset(Aswin, A_NORMAL);
 
     memset(EaSVlines, 0, sizeof(EaSVlines));
@@ -211,16 +211,16 @@ static void oncore_update(void)
 	nsat = (unsigned char)getub(buf, 39);
 	status = (unsigned char)getub(buf, 72);
 
-	(void)mvwprintw(Ea1win, 1, 7, "%04d-%02d-%02d %02d:%02d:%02d.%09d",
+	monitor_display(Ea1win, 1, 7, "%04d-%02d-%02d %02d:%02d:%02d.%09d",
 			year, mon, day, hour, min, sec, nsec);
-	(void)mvwprintw(Ea1win, 1, 47, "%10.6lf %c",
+	monitor_display(Ea1win, 1, 47, "%10.6lf %c",
 			fabs(lat), lat < 0 ? 'S' : lat > 0 ? 'N' : ' ');
-	(void)mvwprintw(Ea1win, 1, 66, "%10.6lf %c",
+	monitor_display(Ea1win, 1, 66, "%10.6lf %c",
 			fabs(lon), lon < 0 ? 'W' : lon > 0 ? 'E' : ' ');
 
-	(void)mvwprintw(Ea1win, 2, 50, "%6.2f m/s", speed);
-	(void)mvwprintw(Ea1win, 2, 70, "%5.1f", track);
-	(void)mvwprintw(Ea1win, 3, 68, "%8.2f m", alt);
+	monitor_display(Ea1win, 2, 50, "%6.2f m/s", speed);
+	monitor_display(Ea1win, 2, 70, "%5.1f", track);
+	monitor_display(Ea1win, 3, 68, "%8.2f m", alt);
 
 	/*@ -predboolothers @*/
 	(void)snprintf(statusbuf, sizeof(statusbuf), "%s%s%s%s%s%s%s%s%s",
@@ -235,16 +235,16 @@ static void oncore_update(void)
 		       dopt   & 0x20 ? "survey " : "");
 	/*@ +predboolothers @*/
 
-	(void)mvwprintw(Ea1win, 3, 24, "%-37s", statusbuf);
+	monitor_display(Ea1win, 3, 24, "%-37s", statusbuf);
 
-	(void)mvwprintw(Ea1win, 2, 10, "%-10s", antenna[dopt >> 6]);
+	monitor_display(Ea1win, 2, 10, "%-10s", antenna[dopt >> 6]);
 
 	/*@ -predboolothers @*/
-	(void)mvwprintw(Ea1win, 2, 27, "%s %4.1f",
+	monitor_display(Ea1win, 2, 27, "%s %4.1f",
 			dopt & 1 ? "hdop" : "pdop", dop);
 	/*@ +predboolothers @*/
 
-	(void)mvwprintw(Ea1win, 3, 10, "%d/%d ", nsat, nvis);
+	monitor_display(Ea1win, 3, 10, "%d/%d ", nsat, nvis);
     }
 
 	for (i = 0; i < 8; i++) {
@@ -358,14 +358,14 @@ static void oncore_update(void)
 	sigma = (float)(getbeu16(buf, 23));
 
 	/*@ -predboolothers @*/
-	(void)mvwprintw(Enwin, 1, 24, "%3s", traim ? "on" : "off");
-	(void)mvwprintw(Enwin, 2, 18, "%6.1f us", alarm);
-	(void)mvwprintw(Enwin, 3, 13, "%14s", pps_ctrl[ctrl]);
-	(void)mvwprintw(Enwin, 4, 24, "%3s", pulse ? "on" : "off");
-	(void)mvwprintw(Enwin, 5, 24, "%3s", pps_sync[sync]);
-	(void)mvwprintw(Enwin, 6, 20, "%7s", traim_sol[sol_stat]);
-	(void)mvwprintw(Enwin, 7, 11, "%16s", traim_status[status]);
-	(void)mvwprintw(Enwin, 8, 18, "%6.3f us", sigma * 0.001);
+	monitor_display(Enwin, 1, 24, "%3s", traim ? "on" : "off");
+	monitor_display(Enwin, 2, 18, "%6.1f us", alarm);
+	monitor_display(Enwin, 3, 13, "%14s", pps_ctrl[ctrl]);
+	monitor_display(Enwin, 4, 24, "%3s", pulse ? "on" : "off");
+	monitor_display(Enwin, 5, 24, "%3s", pps_sync[sync]);
+	monitor_display(Enwin, 6, 20, "%7s", traim_sol[sol_stat]);
+	monitor_display(Enwin, 7, 11, "%16s", traim_status[status]);
+	monitor_display(Enwin, 8, 18, "%6.3f us", sigma * 0.001);
 	/*@ +predboolothers @*/
     }
 
@@ -379,9 +379,9 @@ static void oncore_update(void)
 	utc_offset = (unsigned char)getub(buf, 4);
 
 	if (utc_offset != (unsigned char)0)
-	    (void)mvwprintw(Bowin, 2, 2, "GPS%+4d", utc_offset);
+	    monitor_display(Bowin, 2, 2, "GPS%+4d", utc_offset);
 	else
-	    (void)mvwprintw(Bowin, 2, 2, "unknown", utc_offset);
+	    monitor_display(Bowin, 2, 2, "unknown", utc_offset);
     }
 
 	monitor_log("Bo =");
@@ -393,7 +393,7 @@ static void oncore_update(void)
 
 	pps_offset = (double)getbes32(buf, 4) / 1000000.0;
 
-	(void)mvwprintw(Aywin, 2, 2, " %7.3f ms", pps_offset);
+	monitor_display(Aywin, 2, 2, " %7.3f ms", pps_offset);
     }
 
 	monitor_log("Ay =");
@@ -405,7 +405,7 @@ static void oncore_update(void)
 
 	mode = (unsigned char)getub(buf, 4);
 
-	(void)mvwprintw(Atwin, 2, 1, "%6s", pos_hold_mode[mode]);
+	monitor_display(Atwin, 2, 1, "%6s", pos_hold_mode[mode]);
     }
 
 	monitor_log("At =");
@@ -419,11 +419,11 @@ static void oncore_update(void)
 	lon = (double)getbes32(buf, 8) / 3600000.0;
 	alt = (double)getbes32(buf, 12) / 100.0;
 
-	(void)mvwprintw(Aswin, 1, 5, "%10.6lf %c",
+	monitor_display(Aswin, 1, 5, "%10.6lf %c",
 			fabs(lat), lat < 0 ? 'S' : lat > 0 ? 'N' : ' ');
-	(void)mvwprintw(Aswin, 2, 5, "%10.6lf %c",
+	monitor_display(Aswin, 2, 5, "%10.6lf %c",
 			fabs(lon), lon < 0 ? 'W' : lon > 0 ? 'E' : ' ');
-	(void)mvwprintw(Aswin, 3, 7, "%8.2f m", alt);
+	monitor_display(Aswin, 3, 7, "%8.2f m", alt);
     }
 
 	monitor_log("As =");
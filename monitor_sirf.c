@@ -57,7 +57,7 @@ static char *dgpsvec[] = {
  *
  *****************************************************************************/
 
-#define display	(void)mvwprintw
+#define display	monitor_display
 
 #define MAXSATS 	12	/* the most satellites we can dump data on */
 
@@ -21,10 +21,10 @@ static bool superstar2_initialize(void)
 	return false;
     (void)wborder(satwin, 0, 0, 0, 0, 0, 0, 0, 0), (void)syncok(satwin, true);
     (void)wattrset(satwin, A_BOLD);
-    (void)mvwprintw(satwin, 1, 1, "Ch PRN  Az El S/N Fl U");
+    monitor_display(satwin, 1, 1, "Ch PRN  Az El S/N Fl U");
     for (i = 0; i < 12; i++)
-	(void)mvwprintw(satwin, (int)(i + 2), 1, "%2d", i);
-    (void)mvwprintw(satwin, 14, 1, " Satellite Data & Status ");
+	monitor_display(satwin, (int)(i + 2), 1, "%2d", i);
+    monitor_display(satwin, 14, 1, " Satellite Data & Status ");
     (void)wattrset(satwin, A_NORMAL);
     /*@ +onlytrans @*/
 
@@ -14,7 +14,7 @@
 extern const struct gps_type_t ubx_binary;
 static WINDOW *satwin, *navsolwin, *dopwin;
 
-#define display	(void)mvwprintw
+#define display	monitor_display
 static bool ubx_initialize(void)
 {
     int i;
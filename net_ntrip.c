@@ -15,6 +15,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <netdb.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #endif /* S_SPLINT_S */
@@ -30,6 +31,8 @@
 #define NTRIP_BR		"\r\n"
 #define NTRIP_QSC		"\";\""
 #define NTRIP_ICY		"ICY 200 OK"
+#define NTRIP_HTTP		"HTTP/1.1 200 OK"
+#define NTRIP_CHUNKED		"Transfer-Encoding: chunked"
 #define NTRIP_UNAUTH		"401 Unauthorized"
 
 /*@ -temptrans -mustfreefresh @*/
@@ -154,6 +157,66 @@ static void ntrip_str_parse(char *str, size_t len,
     while ((s = ntrip_field_iterate(NULL, s, eol)));
 }
 
+/*
+ * Sourcetable cache.  Casters ship the whole table (often hundreds of
+ * kilobytes) just so we can match one mountpoint; remembering the match
+ * lets a reconnect skip the probe transaction entirely.
+ */
+#define NTRIP_CACHE_SIZE	8	/* casters we remember streams from */
+#define NTRIP_CACHE_TTL		1800	/* seconds before an entry goes stale */
+
+struct ntrip_cache_t {
+    struct ntrip_stream_t stream;
+    timestamp_t fetched;	/* 0 = slot empty */
+};
+static struct ntrip_cache_t ntrip_cache[NTRIP_CACHE_SIZE];
+
+static /*@null@*/ struct ntrip_stream_t *ntrip_cache_lookup(const struct
+							    ntrip_stream_t
+							    *stream)
+/* find a fresh cached description of this caster's mountpoint */
+{
+    int i;
+
+    for (i = 0; i < NTRIP_CACHE_SIZE; i++) {
+	struct ntrip_cache_t *entry = &ntrip_cache[i];
+
+	if (entry->fetched == 0)
+	    continue;
+	if (timestamp() - entry->fetched > NTRIP_CACHE_TTL) {
+	    entry->fetched = (timestamp_t)0;
+	    continue;
+	}
+	if (strcmp(entry->stream.url, stream->url) == 0
+	    && strcmp(entry->stream.port, stream->port) == 0
+	    && strcmp(entry->stream.mountpoint, stream->mountpoint) == 0)
+	    return &entry->stream;
+    }
+    return NULL;
+}
+
+static void ntrip_cache_store(const struct ntrip_stream_t *stream)
+/* remember a sourcetable match, evicting the oldest entry when full */
+{
+    int i, oldest = 0;
+
+    for (i = 0; i < NTRIP_CACHE_SIZE; i++) {
+	if (ntrip_cache[i].fetched == 0) {
+	    oldest = i;
+	    break;
+	}
+	if (ntrip_cache[i].fetched < ntrip_cache[oldest].fetched)
+	    oldest = i;
+    }
+    ntrip_cache[oldest].stream = *stream;
+    /* no reason to hold credentials in module-global state */
+    memset(ntrip_cache[oldest].stream.credentials, 0,
+	   sizeof(ntrip_cache[oldest].stream.credentials));
+    memset(ntrip_cache[oldest].stream.authStr, 0,
+	   sizeof(ntrip_cache[oldest].stream.authStr));
+    ntrip_cache[oldest].fetched = timestamp();
+}
+
 static int ntrip_sourcetable_parse(struct gps_device_t *device)
 {
     struct ntrip_stream_t hold;
@@ -269,6 +332,7 @@ static int ntrip_sourcetable_parse(struct gps_device_t *device)
 		    device->ntrip.stream.bitrate = hold.bitrate;
 		    device->ntrip.stream.set = true;
 		    match = true;
+		    ntrip_cache_store(&device->ntrip.stream);
 		}
 		/* todo: compare stream location to own location to
 		 * find nearest stream if user hasn't provided one */
@@ -298,17 +362,53 @@ done:
     return match ? 1 : -1;
 }
 
-static int ntrip_stream_req_probe(const struct ntrip_stream_t *stream)
+static int ntrip_stream_connect(const struct ntrip_stream_t *stream)
+/* start a nonblocking connect to the caster; completion is polled for */
 {
     int dsock;
-    ssize_t r;
-    char buf[BUFSIZ];
 
-    dsock = netlib_connectsock(AF_UNSPEC, stream->url, stream->port, "tcp");
+    dsock = netlib_connectsock_nonblock(AF_UNSPEC, stream->url, stream->port,
+					"tcp");
     if (dsock < 0) {
-	gpsd_report(LOG_ERROR, "ntrip stream connect error %d in req probe\n", dsock);
+	gpsd_report(LOG_ERROR, "ntrip stream connect error %d\n", dsock);
+	return -1;
+    }
+    gpsd_report(LOG_SPIN, "ntrip stream connect in progress on fd %d\n",
+		dsock);
+    return dsock;
+}
+
+static int ntrip_stream_ready(int dsock)
+/* poll a pending connect; 1 = connected, 0 = in progress, -1 = failed */
+{
+    fd_set wfds;
+    struct timeval tv;
+    int err = 0;
+    socklen_t elen = (socklen_t) sizeof(err);
+
+    FD_ZERO(&wfds);
+    FD_SET(dsock, &wfds);
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+    if (select(dsock + 1, NULL, &wfds, NULL, &tv) == -1)
+	return -1;
+    if (!FD_ISSET(dsock, &wfds))
+	return 0;
+    if (getsockopt(dsock, SOL_SOCKET, SO_ERROR, &err, &elen) == -1
+	|| err != 0) {
+	gpsd_report(LOG_ERROR, "ntrip stream connect failed: %s\n",
+		    strerror(err));
 	return -1;
     }
+    return 1;
+}
+
+static int ntrip_stream_send_probe(const struct ntrip_stream_t *stream,
+				   int dsock)
+{
+    ssize_t r;
+    char buf[BUFSIZ];
+
     gpsd_report(LOG_SPIN, "ntrip stream for req probe connected on fd %d\n", dsock);
     (void)snprintf(buf, sizeof(buf),
 	    "GET / HTTP/1.1\r\n"
@@ -322,7 +422,7 @@ static int ntrip_stream_req_probe(const struct ntrip_stream_t *stream)
 		errno, dsock, r);
 	return -1;
     }
-    return dsock;
+    return 0;
 }
 
 static int ntrip_auth_encode(const struct ntrip_stream_t *stream,
@@ -351,20 +451,11 @@ static int ntrip_auth_encode(const struct ntrip_stream_t *stream,
 
 /* *INDENT-ON* */
 
-static int ntrip_stream_get_req(const struct ntrip_stream_t *stream)
+static int ntrip_stream_send_get(const struct ntrip_stream_t *stream,
+				 int dsock)
 {
-    int dsock;
     char buf[BUFSIZ];
 
-    dsock = netlib_connectsock(AF_UNSPEC, stream->url, stream->port, "tcp");
-    if (dsock == -1) {
-	gpsd_report(LOG_ERROR, "ntrip stream connect error %d\n", dsock);
-	return -1;
-    }
-
-    gpsd_report(LOG_SPIN, "netlib_connectsock() returns socket on fd %d\n",
-	    dsock);
-
     (void)snprintf(buf, sizeof(buf),
 	    "GET /%s HTTP/1.1\r\n"
 	    "User-Agent: NTRIP gpsd/%s\r\n"
@@ -376,21 +467,26 @@ static int ntrip_stream_get_req(const struct ntrip_stream_t *stream)
     if (write(dsock, buf, strlen(buf)) != (ssize_t) strlen(buf)) {
 	gpsd_report(LOG_ERROR, "ntrip stream write error %d on fd %d during get request\n", errno,
 		dsock);
-	(void)close(dsock);
 	return -1;
     }
-    return dsock;
+    return 0;
 }
 
-static int ntrip_stream_get_parse(const struct ntrip_stream_t *stream, int dsock)
+static int ntrip_stream_get_parse(struct gps_device_t *device, int dsock)
+/* parse the stream request reply; 1 = accepted, 0 = no data yet, -1 = error */
 {
 /*@-nullpass@*/
+    const struct ntrip_stream_t *stream = &device->ntrip.stream;
     char buf[BUFSIZ];
-    int opts;
+    char *body;
+    ssize_t rlen;
     memset(buf, 0, sizeof(buf));
-    while (read(dsock, buf, sizeof(buf) - 1) == -1) {
+    while ((rlen = read(dsock, buf, sizeof(buf) - 1)) == -1) {
 	if (errno == EINTR)
 	    continue;
+	/* the socket is nonblocking; wait for the reply to arrive */
+	if (errno == EAGAIN || errno == EWOULDBLOCK)
+	    return 0;
 	gpsd_report(LOG_ERROR, "ntrip stream read error %d on fd %d during get rsp\n", errno,
 		dsock);
 	goto close;
@@ -410,19 +506,48 @@ static int ntrip_stream_get_parse(const struct ntrip_stream_t *stream, int dsock
 		stream->url, stream->port, stream->mountpoint);
 	goto close;
     }
-    /* parse ICY 200 OK */
-    if (strstr(buf, NTRIP_ICY)==NULL) {
+    /* parse ICY 200 OK (Ntrip v1) or HTTP/1.1 200 OK (Ntrip v2) */
+    if (strstr(buf, NTRIP_ICY)==NULL && strstr(buf, NTRIP_HTTP)==NULL) {
 	gpsd_report(LOG_ERROR,
 		"Unknown reply %s from Ntrip service %s:%s/%s\n", buf,
 		stream->url, stream->port, stream->mountpoint);
 	goto close;
     }
-    opts = fcntl(dsock, F_GETFL);
-
-    if (opts >= 0)
-	(void)fcntl(dsock, F_SETFL, opts | O_NONBLOCK);
-
-    return dsock;
+    /*
+     * Ntrip v2 wraps the correction stream in HTTP chunked transfer
+     * encoding; arm the lexer's in-place dechunker so the framing is
+     * stripped as the bytes land, without a side-buffer copy.
+     */
+    if (strstr(buf, NTRIP_CHUNKED) != NULL) {
+	device->packet.chunked = true;
+	device->packet.chunk_state = 0;
+	device->packet.chunk_remaining = 0;
+    }
+    /* correction bytes may already ride in behind the headers */
+    if ((body = strstr(buf, "\r\n\r\n")) != NULL) {
+	size_t n = (size_t)(rlen - (body + 4 - buf));
+
+	if (n > 0) {
+	    size_t avail;
+
+	    if (device->packet.chunked)
+		n = packet_dechunk(&device->packet,
+				   (unsigned char *)(body + 4), n);
+	    /*
+	     * The lexer buffer is much smaller than an HTTP read can
+	     * be; never let a caster that sends a fat first burst
+	     * write past it.  Excess bytes are dropped and the
+	     * correction stream resyncs on the next read.
+	     */
+	    avail = sizeof(device->packet.inbuffer) - device->packet.inbuflen;
+	    if (n > avail)
+		n = avail;
+	    memcpy(device->packet.inbuffer + device->packet.inbuflen,
+		   body + 4, n);
+	    device->packet.inbuflen += n;
+	}
+    }
+    return 1;
 close:
     (void)close(dsock);
     return -1;
@@ -438,6 +563,7 @@ int ntrip_open(struct gps_device_t *device, char *caster)
     char *port = NULL;
     char *stream = NULL;
     char *url = NULL;
+    struct ntrip_stream_t *cached;
     int ret = -1;
     char t[strlen(caster + 1)];
     char *tmp = t;
@@ -497,18 +623,62 @@ int ntrip_open(struct gps_device_t *device, char *caster)
 	    (void)strlcpy(device->ntrip.stream.url, 
 		    url, 
 		    sizeof(device->ntrip.stream.url));
-	    (void)strlcpy(device->ntrip.stream.port, 
-		    port, 
+	    (void)strlcpy(device->ntrip.stream.port,
+		    port,
 		    sizeof(device->ntrip.stream.port));
 
-	    ret = ntrip_stream_req_probe(&device->ntrip.stream);
+	    /* a fresh sourcetable match on file lets us skip the probe */
+	    if ((cached = ntrip_cache_lookup(&device->ntrip.stream)) != NULL) {
+		gpsd_report(LOG_INF,
+			"Ntrip stream %s:%s/%s known from cached sourcetable\n",
+			device->ntrip.stream.url, device->ntrip.stream.port,
+			device->ntrip.stream.mountpoint);
+		device->ntrip.stream.format = cached->format;
+		device->ntrip.stream.carrier = cached->carrier;
+		device->ntrip.stream.latitude = cached->latitude;
+		device->ntrip.stream.longitude = cached->longitude;
+		device->ntrip.stream.nmea = cached->nmea;
+		device->ntrip.stream.compr_encryp = cached->compr_encryp;
+		device->ntrip.stream.authentication = cached->authentication;
+		device->ntrip.stream.fee = cached->fee;
+		device->ntrip.stream.bitrate = cached->bitrate;
+		device->ntrip.stream.set = true;
+		if (ntrip_auth_encode(&device->ntrip.stream, device->ntrip.stream.credentials, device->ntrip.stream.authStr, 128) != 0) {
+		    device->ntrip.conn_state = ntrip_conn_err;
+		    return -1;
+		}
+		ret = ntrip_stream_connect(&device->ntrip.stream);
+		if (ret == -1) {
+		    device->ntrip.conn_state = ntrip_conn_err;
+		    return -1;
+		}
+		device->gpsdata.gps_fd = ret;
+		device->ntrip.conn_state = ntrip_conn_connecting_get;
+		return ret;
+	    }
+
+	    ret = ntrip_stream_connect(&device->ntrip.stream);
 	    if (ret == -1) {
 		device->ntrip.conn_state = ntrip_conn_err;
 		return -1;
 	    }
 	    device->gpsdata.gps_fd = ret;
-	    device->ntrip.conn_state = ntrip_conn_sent_probe;
+	    device->ntrip.conn_state = ntrip_conn_connecting_probe;
 	    return ret;
+	case ntrip_conn_connecting_probe:
+	    ret = ntrip_stream_ready(device->gpsdata.gps_fd);
+	    if (ret == 0)
+		return device->gpsdata.gps_fd;
+	    if (ret == -1
+		|| ntrip_stream_send_probe(&device->ntrip.stream,
+					   device->gpsdata.gps_fd) == -1) {
+		(void)close(device->gpsdata.gps_fd);
+		device->gpsdata.gps_fd = -1;
+		device->ntrip.conn_state = ntrip_conn_err;
+		return -1;
+	    }
+	    device->ntrip.conn_state = ntrip_conn_sent_probe;
+	    return device->gpsdata.gps_fd;
 	case ntrip_conn_sent_probe:
 	    ret = ntrip_sourcetable_parse(device);
 	    if (ret == -1) {
@@ -523,23 +693,40 @@ int ntrip_open(struct gps_device_t *device, char *caster)
 		device->ntrip.conn_state = ntrip_conn_err;
 		return -1;
 	    }
-	    ret = ntrip_stream_get_req(&device->ntrip.stream);
+	    ret = ntrip_stream_connect(&device->ntrip.stream);
 	    if (ret == -1) {
 		device->ntrip.conn_state = ntrip_conn_err;
 		return -1;
 	    }
 	    device->gpsdata.gps_fd = ret;
+	    device->ntrip.conn_state = ntrip_conn_connecting_get;
+	    break;
+	case ntrip_conn_connecting_get:
+	    ret = ntrip_stream_ready(device->gpsdata.gps_fd);
+	    if (ret == 0)
+		return device->gpsdata.gps_fd;
+	    if (ret == -1
+		|| ntrip_stream_send_get(&device->ntrip.stream,
+					 device->gpsdata.gps_fd) == -1) {
+		(void)close(device->gpsdata.gps_fd);
+		device->gpsdata.gps_fd = -1;
+		device->ntrip.conn_state = ntrip_conn_err;
+		return -1;
+	    }
 	    device->ntrip.conn_state = ntrip_conn_sent_get;
 	    break;
 	case ntrip_conn_sent_get:
-	    ret = ntrip_stream_get_parse(&device->ntrip.stream,
-					 device->gpsdata.gps_fd);
+	    ret = ntrip_stream_get_parse(device, device->gpsdata.gps_fd);
 	    if (ret == -1) {
 		device->ntrip.conn_state = ntrip_conn_err;
 		return -1;
 	    }
+	    if (ret == 0)
+		/* no reply yet; the main loop will call us again */
+		return device->gpsdata.gps_fd;
 	    device->ntrip.conn_state = ntrip_conn_established;
 	    device->ntrip.works = true; // we know, this worked.
+	    device->ntrip.retry_backoff = 0; // reset reconnect holdoff
 	    break;
 	case ntrip_conn_established:
 	case ntrip_conn_err:
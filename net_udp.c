@@ -39,6 +39,9 @@ int udp_open(struct gps_device_t *device, const char *bcastport)
     if (bind(sock, (struct sockaddr *) &broadcastAddr, sizeof(broadcastAddr)))
       return 0;
 
+    /* the batched drain in packet_get() must never hang on an empty queue */
+    (void)fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+
     return sock;
 }
 
@@ -4,8 +4,10 @@
  */
 #include <string.h>
 #include <fcntl.h>
+#include <errno.h>
 #ifndef S_SPLINT_S
 #include <netdb.h>
+#include <sys/select.h>
 #ifndef AF_UNSPEC
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -22,9 +24,106 @@
 #include "gpsd.h"
 #include "sockaddr.h"
 
+#define NL_STAGGER		300000	/* usec head start per address */
+#define NL_CONNECT_TIMEOUT	15	/* seconds before we give up entirely */
+#define NL_MAXPENDING		8	/* simultaneous connect attempts */
+
 /*@-mustfreefresh -usedef@*/
-socket_t netlib_connectsock(int af, const char *host, const char *service,
-			    const char *protocol)
+static socket_t netlib_connect_parallel(struct addrinfo *result, int *ret)
+/* happy-eyeballs connect: staggered parallel attempts, first success wins
+ *
+ * getaddrinfo() orders IPv6 first, so a dead IPv6 route used to cost a
+ * full TCP timeout before we even tried the IPv4 address.  Here each
+ * address gets a short head start rather than exclusive ownership of
+ * the wire, and whichever connect completes first is kept.
+ */
+{
+    socket_t pending[NL_MAXPENDING];
+    socket_t s, winner = -1;
+    struct addrinfo *rp = result;
+    timestamp_t deadline = timestamp() + NL_CONNECT_TIMEOUT;
+    int npending = 0, one = 1;
+
+    *ret = NL_NOCONNECT;
+    while ((rp != NULL || npending > 0) && winner == -1) {
+	/* launch the next candidate */
+	if (rp != NULL && npending < NL_MAXPENDING) {
+	    if ((s = socket(rp->ai_family, rp->ai_socktype,
+			    rp->ai_protocol)) < 0) {
+		*ret = NL_NOSOCK;
+		rp = rp->ai_next;
+		continue;
+	    }
+	    if (setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (char *)&one,
+			   sizeof(one)) == -1) {
+		(void)close(s);
+		*ret = NL_NOSOCKOPT;
+		rp = rp->ai_next;
+		continue;
+	    }
+	    (void)fcntl(s, F_SETFL, fcntl(s, F_GETFL) | O_NONBLOCK);
+	    if (connect(s, rp->ai_addr, rp->ai_addrlen) == 0) {
+		winner = s;
+		break;
+	    } else if (errno == EINPROGRESS)
+		pending[npending++] = s;
+	    else
+		(void)close(s);
+	    rp = rp->ai_next;
+	}
+	if (npending > 0) {
+	    fd_set wfds;
+	    struct timeval tv;
+	    int i, maxfd = 0, rc;
+
+	    FD_ZERO(&wfds);
+	    for (i = 0; i < npending; i++) {
+		FD_SET(pending[i], &wfds);
+		if (pending[i] > maxfd)
+		    maxfd = pending[i];
+	    }
+	    if (rp != NULL) {
+		/* wait only the stagger, then launch the next address */
+		tv.tv_sec = 0;
+		tv.tv_usec = NL_STAGGER;
+	    } else {
+		timestamp_t remaining = deadline - timestamp();
+		tv.tv_sec = (remaining > 0) ? (time_t)remaining : 0;
+		tv.tv_usec = 0;
+	    }
+	    rc = select(maxfd + 1, NULL, &wfds, NULL, &tv);
+	    if (rc == -1 && errno != EINTR)
+		break;
+	    for (i = 0; i < npending && winner == -1;) {
+		if (rc > 0 && FD_ISSET(pending[i], &wfds)) {
+		    int err = 0;
+		    socklen_t elen = (socklen_t) sizeof(err);
+
+		    if (getsockopt(pending[i], SOL_SOCKET, SO_ERROR,
+				   &err, &elen) == 0 && err == 0)
+			winner = pending[i];
+		    else
+			(void)close(pending[i]);
+		    pending[i] = pending[--npending];
+		    continue;
+		}
+		i++;
+	    }
+	}
+	if (timestamp() >= deadline)
+	    break;
+    }
+    /* losers don't get to keep their sockets */
+    while (npending > 0)
+	(void)close(pending[--npending]);
+    if (winner != -1)
+	*ret = 0;
+    return winner;
+}
+
+static socket_t netlib_connectsock1(int af, const char *host,
+				    const char *service,
+				    const char *protocol, bool nonblock)
 {
     struct protoent *ppe;
     struct addrinfo hints;
@@ -70,34 +169,49 @@ socket_t netlib_connectsock(int af, const char *host, const char *service,
      * Thus, with the default parameters, we get IPv6 addresses first.
      */
     /*@-type@*/
-    for (rp = result; rp != NULL; rp = rp->ai_next) {
-	ret = NL_NOCONNECT;
-	if ((s = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol)) < 0)
-	    ret = NL_NOSOCK;
-	else if (setsockopt
-		 (s, SOL_SOCKET, SO_REUSEADDR, (char *)&one,
-		  sizeof(one)) == -1) {
-	    if (s > -1)
-		(void)close(s);
-	    ret = NL_NOSOCKOPT;
-	} else {
-	    if (bind_me) {
-		if (bind(s, rp->ai_addr, rp->ai_addrlen) == 0) {
-		    ret = 0;
-		    break;
-		}
+    if (!bind_me && !nonblock)
+	/* blocking stream connects race the whole address list */
+	s = netlib_connect_parallel(result, &ret);
+    else
+	for (rp = result; rp != NULL; rp = rp->ai_next) {
+	    ret = NL_NOCONNECT;
+	    if ((s = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol)) < 0)
+		ret = NL_NOSOCK;
+	    else if (setsockopt
+		     (s, SOL_SOCKET, SO_REUSEADDR, (char *)&one,
+		      sizeof(one)) == -1) {
+		if (s > -1)
+		    (void)close(s);
+		ret = NL_NOSOCKOPT;
 	    } else {
-		if (connect(s, rp->ai_addr, rp->ai_addrlen) == 0) {
-		    ret = 0;
-		    break;
+		if (bind_me) {
+		    if (bind(s, rp->ai_addr, rp->ai_addrlen) == 0) {
+			ret = 0;
+			break;
+		    }
+		} else {
+		    (void)fcntl(s, F_SETFL, fcntl(s, F_GETFL) | O_NONBLOCK);
+		    if (connect(s, rp->ai_addr, rp->ai_addrlen) == 0) {
+			ret = 0;
+			break;
+		    }
+		    /*
+		     * A nonblocking connect in progress is success here; the
+		     * caller polls for completion.  We can't fall through to
+		     * the next address, but a slow first address is exactly
+		     * the case the caller doesn't want to wait out.
+		     */
+		    if (errno == EINPROGRESS) {
+			ret = 0;
+			break;
+		    }
 		}
 	    }
-	}
 
-	if (s > -1) {
-	    (void)close(s);
+	    if (s > -1) {
+		(void)close(s);
+	    }
 	}
-    }
     /*@+type@*/
 #ifndef S_SPLINT_S
     freeaddrinfo(result);
@@ -125,6 +239,20 @@ socket_t netlib_connectsock(int af, const char *host, const char *service,
     /*@ +type +mustfreefresh @*/
 }
 
+socket_t netlib_connectsock(int af, const char *host, const char *service,
+			    const char *protocol)
+{
+    return netlib_connectsock1(af, host, service, protocol, false);
+}
+
+socket_t netlib_connectsock_nonblock(int af, const char *host,
+				     const char *service,
+				     const char *protocol)
+/* as netlib_connectsock(), but connect() may still be in progress */
+{
+    return netlib_connectsock1(af, host, service, protocol, true);
+}
+
 /*@+mustfreefresh +usedef@*/
 
 char /*@observer@*/ *netlib_errstr(const int err)
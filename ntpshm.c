@@ -36,6 +36,56 @@
 #define NTPD_BASE	0x4e545030	/* "NTP0" */
 #define SHM_UNIT	0	/* SHM driver unit number (0..3) */
 
+/*
+ * Staging ring between the time sources and the SHM writer.  Samples
+ * are queued here by the source -- the packet path for a device's
+ * coarse segment, that device's PPS thread for its PPS segment -- and
+ * drained into the segments by ntpshm_flush() from the main loop.
+ * Each segment thus has exactly one producer and one consumer, so the
+ * ring needs no locking, and neither source can stall on the other or
+ * on the segment write itself.
+ */
+#define NTPSHM_RING_SIZE	16	/* must be a power of two */
+#define NTPSHM_NO_PRECISION	-99	/* leave segment precision alone */
+
+struct ntpshm_sample_t
+{
+    time_t clockSec;
+    int clockUSec;
+    time_t recvSec;
+    int recvUSec;
+    int precision;
+};
+
+struct ntpshm_ring_t
+{
+    volatile unsigned int head;	/* written only by the producer */
+    volatile unsigned int tail;	/* written only by the consumer */
+    unsigned int drops;		/* producer: samples lost to a full ring */
+    unsigned int drops_logged;	/* consumer: drops already reported */
+    unsigned int overwrites;	/* consumer: samples ntpd never read */
+    unsigned int overwrites_logged;
+    struct ntpshm_sample_t samples[NTPSHM_RING_SIZE];
+};
+
+static struct ntpshm_ring_t ntpshm_rings[NTPSHMSEGS];
+
+static bool ntpshm_enqueue(int segment, const struct ntpshm_sample_t *sample)
+/* stage a sample for a segment; false means the ring was full */
+{
+    struct ntpshm_ring_t *ring = &ntpshm_rings[segment];
+    unsigned int head = ring->head;
+
+    if (head - ring->tail >= (unsigned int)NTPSHM_RING_SIZE) {
+	ring->drops++;
+	return false;
+    }
+    ring->samples[head % NTPSHM_RING_SIZE] = *sample;
+    barrier();		/* sample body must land before the head moves */
+    ring->head = head + 1;
+    return true;
+}
+
 struct shmTime
 {
     int mode;			/* 0 - if valid set
@@ -181,6 +231,8 @@ static int ntpshm_alloc(struct gps_context_t *context)
 	    context->shmTime[i]->mode = 1;
 	    context->shmTime[i]->precision = -1;	/* initially 0.5 sec */
 	    context->shmTime[i]->nsamples = 3;	/* stages of median filter */
+	    /* discard anything a previous user left staged */
+	    ntpshm_rings[i].tail = ntpshm_rings[i].head;
 
 	    return i;
 	}
@@ -201,16 +253,13 @@ static bool ntpshm_free(struct gps_context_t * context, int segment)
 int ntpshm_put(struct gps_device_t *session, double fixtime, double fudge)
 /* put a received fix time into shared memory for NTP */
 {
-    /* shmTime is volatile to try to prevent C compiler from reordering
-     * writes, or optimizing some 'dead code'.  but CPU cache may still 
-     *write out of order since we do not use memory barriers, yet */
-    volatile struct shmTime *shmTime = NULL;
+    struct ntpshm_sample_t sample;
     struct timeval tv;
     double seconds, microseconds;
 
     // gpsd_report(LOG_PROG, "NTP: doing ntpshm_put(,%g, %g)\n", fixtime, fudge);
     if (session->shmindex < 0 ||
-	(shmTime = session->context->shmTime[session->shmindex]) == NULL) {
+	session->context->shmTime[session->shmindex] == NULL) {
 	gpsd_report(LOG_RAW, "NTPD missing shm\n");
 	return 0;
     }
@@ -218,42 +267,19 @@ int ntpshm_put(struct gps_device_t *session, double fixtime, double fudge)
     (void)gettimeofday(&tv, NULL);
     fixtime += fudge;
     microseconds = 1000000.0 * modf(fixtime, &seconds);
-    if (shmTime->clockTimeStampSec == (time_t) seconds) {
-	gpsd_report(LOG_RAW, "NTPD ntpshm_put: skipping duplicate second\n");
-	return 0;
-    }
 
-    /* we use the shmTime mode 1 protocol
-     *
-     * ntpd does this:
-     *
-     * reads valid.  
-     * IFF valid is 1
-     *    reads count
-     *    reads values
-     *    reads count
-     *    IFF count unchanged
-     *        use values
-     *    clear valid
-     *    
-     */
-    shmTime->valid = 0;
-    shmTime->count++;
-    /* FIXME need a memory barrier here to prevent write reordering by
-     * the compiler or CPU cache */
-    shmTime->clockTimeStampSec = (time_t) seconds;
-    shmTime->clockTimeStampUSec = (int)microseconds;
-    shmTime->receiveTimeStampSec = (time_t) tv.tv_sec;
-    shmTime->receiveTimeStampUSec = (int)tv.tv_usec;
+    sample.clockSec = (time_t) seconds;
+    sample.clockUSec = (int)microseconds;
+    sample.recvSec = (time_t) tv.tv_sec;
+    sample.recvUSec = (int)tv.tv_usec;
     /* setting the precision here does not seem to help anything, too
      * hard to calculate properly anyway.  Let ntpd figure it out.
      * Any NMEA will be about -1 or -2. 
      * Garmin GPS-18/USB is around -6 or -7.
      */
-    /* FIXME need a memory barrier here to prevent write reordering by
-     * the compiler or CPU cache */
-    shmTime->count++;
-    shmTime->valid = 1;
+    sample.precision = NTPSHM_NO_PRECISION;
+    if (!ntpshm_enqueue(session->shmindex, &sample))
+	return 0;
 
     gpsd_report(LOG_RAW,
 		"NTPD ntpshm_put: Clock: %lu.%06lu @ %lu.%06lu, fudge: %0.3f\n",
@@ -263,6 +289,74 @@ int ntpshm_put(struct gps_device_t *session, double fixtime, double fudge)
     return 1;
 }
 
+void ntpshm_flush(struct gps_context_t *context)
+/* drain staged samples into the segments; called only by the main loop */
+{
+    int i;
+
+    for (i = 0; i < NTPSHMSEGS; i++) {
+	struct ntpshm_ring_t *ring = &ntpshm_rings[i];
+	volatile struct shmTime *shmTime = context->shmTime[i];
+
+	while (ring->tail != ring->head) {
+	    struct ntpshm_sample_t sample =
+		ring->samples[ring->tail % NTPSHM_RING_SIZE];
+
+	    barrier();	/* copy out before freeing the slot */
+	    ring->tail++;
+	    if (shmTime == NULL)
+		continue;
+	    if (shmTime->clockTimeStampSec == sample.clockSec) {
+		gpsd_report(LOG_RAW,
+			    "NTPD ntpshm_flush: skipping duplicate second\n");
+		continue;
+	    }
+	    if (shmTime->valid != 0)
+		ring->overwrites++;	/* ntpd never read the last one */
+
+	    /* we use the shmTime mode 1 protocol
+	     *
+	     * ntpd does this:
+	     *
+	     * reads valid.  
+	     * IFF valid is 1
+	     *    reads count
+	     *    reads values
+	     *    reads count
+	     *    IFF count unchanged
+	     *        use values
+	     *    clear valid
+	     *    
+	     */
+	    shmTime->valid = 0;
+	    shmTime->count++;
+	    barrier();
+	    shmTime->clockTimeStampSec = sample.clockSec;
+	    shmTime->clockTimeStampUSec = sample.clockUSec;
+	    shmTime->receiveTimeStampSec = sample.recvSec;
+	    shmTime->receiveTimeStampUSec = sample.recvUSec;
+	    if (sample.precision != NTPSHM_NO_PRECISION)
+		shmTime->precision = sample.precision;
+	    barrier();
+	    shmTime->count++;
+	    shmTime->valid = 1;
+	}
+	if (ring->drops != ring->drops_logged) {
+	    gpsd_report(LOG_WARN,
+			"NTPD segment %d dropped %u staged samples (%u total)\n",
+			i, ring->drops - ring->drops_logged, ring->drops);
+	    ring->drops_logged = ring->drops;
+	}
+	if (ring->overwrites != ring->overwrites_logged) {
+	    gpsd_report(LOG_INF,
+			"NTPD segment %d: %u samples unread by ntpd (%u total)\n",
+			i, ring->overwrites - ring->overwrites_logged,
+			ring->overwrites);
+	    ring->overwrites_logged = ring->overwrites;
+	}
+    }
+}
+
 #ifdef PPS_ENABLE
 /* put NTP shared memory info based on received PPS pulse
  *
@@ -272,6 +366,7 @@ int ntpshm_put(struct gps_device_t *session, double fixtime, double fudge)
 static int ntpshm_pps(struct gps_device_t *session, struct timeval *tv)
 {
     volatile struct shmTime *shmTime = NULL, *shmTimeP = NULL;
+    struct ntpshm_sample_t sample;
     time_t seconds;
     /* FIX-ME, microseconds needs to be set for 5Hz PPS */
     int microseconds = 0;
@@ -311,31 +406,15 @@ static int ntpshm_pps(struct gps_device_t *session, struct timeval *tv)
     /*@-relaxtypes@*/
 
 
-    /* we use the shmTime mode 1 protocol
-     *
-     * ntpd does this:
-     *
-     * reads valid.  
-     * IFF valid is 1
-     *    reads count
-     *    reads values
-     *    reads count
-     *    IFF count unchanged
-     *        use values
-     *    clear valid
-     *    
-     */
-    shmTimeP->valid = 0;
-    shmTimeP->count++;
-    shmTimeP->clockTimeStampSec = seconds;
-    shmTimeP->clockTimeStampUSec = (int)microseconds;
-    shmTimeP->receiveTimeStampSec = (time_t) tv->tv_sec;
-    shmTimeP->receiveTimeStampUSec = (int)tv->tv_usec;
+    sample.clockSec = seconds;
+    sample.clockUSec = (int)microseconds;
+    sample.recvSec = (time_t) tv->tv_sec;
+    sample.recvUSec = (int)tv->tv_usec;
     /* precision is a placebo, ntpd does not really use it
      * real world accuracty is around 16uS, thus -16 precision */
-    shmTimeP->precision = -16;
-    shmTimeP->count++;
-    shmTimeP->valid = 1;
+    sample.precision = -16;
+    if (!ntpshm_enqueue(session->shmTimeP, &sample))
+	return 0;
 
     /* this is more an offset jitter/dispersion than precision, 
      * but still useful for debug */
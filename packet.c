@@ -36,6 +36,7 @@ PERMISSIONS
 #ifndef S_SPLINT_S
 #include <netinet/in.h>
 #include <arpa/inet.h>		/* for htons() */
+#include <sys/socket.h>		/* for recvmmsg() */
 #include <unistd.h>
 #endif /* S_SPLINT_S */
 
@@ -173,6 +174,84 @@ static void character_pushback(struct gps_packet_t *lexer)
 		lexer->char_counter);
 }
 
+/*
+ * After the daemon has identified a device, packet_lock() narrows the
+ * set of packet types the lexer will hunt for; a zero mask admits
+ * everything (the sniffing state).  Gating happens where GROUND_STATE
+ * dispatches on leader characters, so binary payload bytes can no
+ * longer wander into candidate states of protocols the device is
+ * known not to speak and trigger pushback-driven rescans.
+ */
+#define lexer_admits(t) (lexer->acceptmask == 0 \
+			 || (lexer->acceptmask & PACKET_TYPEMASK(t)) != 0)
+
+/*
+ * GROUND_STATE leader dispatch.  Hunting used to be a chain of
+ * per-protocol compares, mispredicted branches on every garbage byte;
+ * now the common transitions are one table lookup.  Each entry names
+ * the state a leader byte starts and the PACKET_TYPEMASK() bits that
+ * admit it once packet_lock() has narrowed the hunt.  Entries whose
+ * transition needs side effects (TripMate/EarthMate trigger probes,
+ * the RTCM3 CRC seed, JSON pushback) keep nextstate code and appear
+ * here with next == GROUND_STATE so ground_skip() still stops on
+ * them; the configured protocol set selects rows via cpp, so the
+ * table is built at compile time for exactly this configuration.
+ */
+static const struct ground_entry_t {
+    unsigned short next;	/* state the leader byte starts */
+    unsigned int admit;		/* packet type bits that enable it */
+} ground_dispatch[256] = {
+    ['#'] = { COMMENT_BODY, PACKET_TYPEMASK(COMMENT_PACKET) },
+#ifdef NMEA_ENABLE
+    ['$'] = { NMEA_DOLLAR, PACKET_TYPEMASK(NMEA_PACKET) },
+    ['!'] = { NMEA_BANG, PACKET_TYPEMASK(NMEA_PACKET)
+			 | PACKET_TYPEMASK(AIVDM_PACKET) },
+#endif /* NMEA_ENABLE */
+#if defined(TNT_ENABLE) || defined(GARMINTXT_ENABLE) || defined(ONCORE_ENABLE)
+    ['@'] = { AT1_LEADER, PACKET_TYPEMASK(NMEA_PACKET)
+			  | PACKET_TYPEMASK(GARMINTXT_PACKET)
+			  | PACKET_TYPEMASK(ONCORE_PACKET) },
+#endif
+#ifdef SIRF_ENABLE
+    [0xa0] = { SIRF_LEADER_1, PACKET_TYPEMASK(SIRF_PACKET) },
+#endif /* SIRF_ENABLE */
+#ifdef SUPERSTAR2_ENABLE
+    [SOH] = { SUPERSTAR2_LEADER, PACKET_TYPEMASK(SUPERSTAR2_PACKET) },
+#endif /* SUPERSTAR2_ENABLE */
+#if defined(TSIP_ENABLE) || defined(EVERMORE_ENABLE) || defined(GARMIN_ENABLE)
+    [DLE] = { DLE_LEADER, PACKET_TYPEMASK(TSIP_PACKET)
+			  | PACKET_TYPEMASK(EVERMORE_PACKET)
+			  | PACKET_TYPEMASK(GARMIN_PACKET) },
+#endif /* TSIP_ENABLE || EVERMORE_ENABLE || GARMIN_ENABLE */
+#ifdef TRIPMATE_ENABLE
+    ['A'] = { GROUND_STATE, PACKET_TYPEMASK(NMEA_PACKET) },
+#endif /* TRIPMATE_ENABLE */
+#ifdef EARTHMATE_ENABLE
+    ['E'] = { GROUND_STATE, PACKET_TYPEMASK(ZODIAC_PACKET) },
+#endif /* EARTHMATE_ENABLE */
+#ifdef ZODIAC_ENABLE
+    [0xff] = { ZODIAC_LEADER_1, PACKET_TYPEMASK(ZODIAC_PACKET) },
+#endif /* ZODIAC_ENABLE */
+#ifdef UBX_ENABLE
+    [0xb5] = { UBX_LEADER_1, PACKET_TYPEMASK(UBX_PACKET) },
+#endif /* UBX_ENABLE */
+#ifdef ITRAX_ENABLE
+    ['<'] = { ITALK_LEADER_1, PACKET_TYPEMASK(ITALK_PACKET) },
+#endif /* ITRAX_ENABLE */
+#ifdef NAVCOM_ENABLE
+    [0x02] = { NAVCOM_LEADER_1, PACKET_TYPEMASK(NAVCOM_PACKET) },
+#endif /* NAVCOM_ENABLE */
+#ifdef GEOSTAR_ENABLE
+    ['P'] = { GEOSTAR_LEADER_1, PACKET_TYPEMASK(GEOSTAR_PACKET) },
+#endif /* GEOSTAR_ENABLE */
+#ifdef RTCM104V3_ENABLE
+    [0xD3] = { GROUND_STATE, PACKET_TYPEMASK(RTCM3_PACKET) },
+#endif /* RTCM104V3_ENABLE */
+#ifdef PASSTHROUGH_ENABLE
+    ['{'] = { GROUND_STATE, PACKET_TYPEMASK(JSON_PACKET) },
+#endif /* PASSTHROUGH_ENABLE */
+};
+
 static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 {
     static int n = 0;
@@ -187,46 +266,8 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
     switch (lexer->state) {
     case GROUND_STATE:
 	n = 0;
-	if (c == '#') {
-	    lexer->state = COMMENT_BODY;
-	    break;
-	}
-#ifdef NMEA_ENABLE
-	if (c == '$') {
-	    lexer->state = NMEA_DOLLAR;
-	    break;
-	}
-	if (c == '!') {
-	    lexer->state = NMEA_BANG;
-	    break;
-	}
-#endif /* NMEA_ENABLE */
-#if defined(TNT_ENABLE) || defined(GARMINTXT_ENABLE) || defined(ONCORE_ENABLE)
-	if (c == '@') {
-	    lexer->state = AT1_LEADER;
-	    break;
-	}
-#endif
-#ifdef SIRF_ENABLE
-	if (c == 0xa0) {
-	    lexer->state = SIRF_LEADER_1;
-	    break;
-	}
-#endif /* SIRF_ENABLE */
-#ifdef SUPERSTAR2_ENABLE
-	if (c == SOH) {
-	    lexer->state = SUPERSTAR2_LEADER;
-	    break;
-	}
-#endif /* SUPERSTAR2_ENABLE */
-#if defined(TSIP_ENABLE) || defined(EVERMORE_ENABLE) || defined(GARMIN_ENABLE)
-	if (c == DLE) {
-	    lexer->state = DLE_LEADER;
-	    break;
-	}
-#endif /* TSIP_ENABLE || EVERMORE_ENABLE || GARMIN_ENABLE */
 #ifdef TRIPMATE_ENABLE
-	if (c == 'A') {
+	if (c == 'A' && lexer->acceptmask == 0) {
 #ifdef RTCM104V2_ENABLE
 	    if (rtcm2_decode(lexer, c) == ISGPS_MESSAGE) {
 		lexer->state = RTCM2_RECOGNIZED;
@@ -238,7 +279,7 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	}
 #endif /* TRIPMATE_ENABLE */
 #ifdef EARTHMATE_ENABLE
-	if (c == 'E') {
+	if (c == 'E' && lexer->acceptmask == 0) {
 #ifdef RTCM104V2_ENABLE
 	    if (rtcm2_decode(lexer, c) == ISGPS_MESSAGE) {
 		lexer->state = RTCM2_RECOGNIZED;
@@ -249,53 +290,37 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	    break;
 	}
 #endif /* EARTHMATE_ENABLE */
-#ifdef ZODIAC_ENABLE
-	if (c == 0xff) {
-	    lexer->state = ZODIAC_LEADER_1;
-	    break;
-	}
-#endif /* ZODIAC_ENABLE */
-#ifdef UBX_ENABLE
-	if (c == 0xb5) {
-	    lexer->state = UBX_LEADER_1;
-	    break;
-	}
-#endif /* UBX_ENABLE */
-#ifdef ITRAX_ENABLE
-	if (c == '<') {
-	    lexer->state = ITALK_LEADER_1;
-	    break;
-	}
-#endif /* ITRAX_ENABLE */
-#ifdef NAVCOM_ENABLE
-	if (c == 0x02) {
-	    lexer->state = NAVCOM_LEADER_1;
-	    break;
-	}
-#endif /* NAVCOM_ENABLE */
-#ifdef GEOSTAR_ENABLE
-	if (c == 'P') {
-	    lexer->state = GEOSTAR_LEADER_1;
-	    break;
+	/* common leaders are one table lookup (GROUND_STATE == no entry) */
+	{
+	    const struct ground_entry_t *ge = &ground_dispatch[c];
+
+	    if (ge->next != GROUND_STATE
+		&& (lexer->acceptmask == 0
+		    || (lexer->acceptmask & ge->admit) != 0)) {
+		lexer->state = ge->next;
+		break;
+	    }
 	}
-#endif /* GEOSTAR_ENABLE */
 #ifdef RTCM104V2_ENABLE
-	if ((isgpsstat = rtcm2_decode(lexer, c)) == ISGPS_SYNC) {
-	    lexer->state = RTCM2_SYNC_STATE;
-	    break;
-	} else if (isgpsstat == ISGPS_MESSAGE) {
-	    lexer->state = RTCM2_RECOGNIZED;
-	    break;
+	if (lexer_admits(RTCM2_PACKET)) {
+	    if ((isgpsstat = rtcm2_decode(lexer, c)) == ISGPS_SYNC) {
+		lexer->state = RTCM2_SYNC_STATE;
+		break;
+	    } else if (isgpsstat == ISGPS_MESSAGE) {
+		lexer->state = RTCM2_RECOGNIZED;
+		break;
+	    }
 	}
 #endif /* RTCM104V2_ENABLE */
 #ifdef RTCM104V3_ENABLE
-	if (c == 0xD3) {
+	if (c == 0xD3 && lexer_admits(RTCM3_PACKET)) {
+	    lexer->cksum = crc24q_resume(0, &c, 1);
 	    lexer->state = RTCM3_LEADER_1;
 	    break;
 	}
 #endif /* RTCM104V3_ENABLE */
 #ifdef PASSTHROUGH_ENABLE
-	if (c == '{') {
+	if (c == '{' && lexer_admits(JSON_PACKET)) {
 	    lexer->state = JSON_LEADER;
 	    character_pushback(lexer);
 	}
@@ -671,12 +696,14 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	break;
     case SIRF_LENGTH_1:
 	lexer->length += c + 2;
-	if (lexer->length <= MAX_PACKET_LENGTH)
+	if (lexer->length <= MAX_PACKET_LENGTH) {
+	    lexer->cksum = 0;
 	    lexer->state = SIRF_PAYLOAD;
-	else
+	} else
 	    lexer->state = GROUND_STATE;
 	break;
     case SIRF_PAYLOAD:
+	lexer->cksum += c;
 	if (--lexer->length == 0)
 	    lexer->state = SIRF_DELIVERED;
 	break;
@@ -829,15 +856,15 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	break;
     case NAVCOM_PAYLOAD:
     {
-	unsigned char csum = lexer->inbuffer[3];
+	unsigned char csum = packet_inbase(lexer)[3];
 	for (n = 4;
-	     (unsigned char *)(lexer->inbuffer + n) < lexer->inbufptr - 1;
+	     (packet_inbase(lexer) + n) < lexer->inbufptr - 1;
 	     n++)
-	    csum ^= lexer->inbuffer[n];
+	    csum ^= packet_inbase(lexer)[n];
 	if (csum != c) {
 	    gpsd_report(LOG_IO,
 			"Navcom packet type 0x%hhx bad checksum 0x%hhx, expecting 0x%hx\n",
-			lexer->inbuffer[3], csum, c);
+			packet_inbase(lexer)[3], csum, c);
 	    lexer->state = GROUND_STATE;
 	    break;
 	}
@@ -863,6 +890,7 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	/* high 6 bits must be zero, low 2 bits are MSB of a 10-bit length */
 	if ((c & 0xFC) == 0) {
 	    lexer->length = (size_t) (c << 8);
+	    lexer->cksum = crc24q_resume(lexer->cksum, &c, 1);
 	    lexer->state = RTCM3_LEADER_2;
 	    break;
 	} else
@@ -872,9 +900,11 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	/* third byte is the low 8 bits of the RTCM3 packet length */
 	lexer->length |= c;
 	lexer->length += 3;	/* to get the three checksum bytes */
+	lexer->cksum = crc24q_resume(lexer->cksum, &c, 1);
 	lexer->state = RTCM3_PAYLOAD;
 	break;
     case RTCM3_PAYLOAD:
+	lexer->cksum = crc24q_resume(lexer->cksum, &c, 1);
 	if (--lexer->length == 0)
 	    lexer->state = RTCM3_RECOGNIZED;
 	break;
@@ -918,7 +948,7 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	break;
     case ZODIAC_HSUM_1:
     {
-#define getword(i) (short)(lexer->inbuffer[2*(i)] | (lexer->inbuffer[2*(i)+1] << 8))
+#define getword(i) (short)(packet_inbase(lexer)[2*(i)] | (packet_inbase(lexer)[2*(i)+1] << 8))
 	short sum = getword(0) + getword(1) + getword(2) + getword(3);
 	sum *= -1;
 	if (sum != getword(4)) {
@@ -951,34 +981,50 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 #endif /* ZODIAC_ENABLE */
 #ifdef UBX_ENABLE
     case UBX_LEADER_1:
-	if (c == 0x62)
+	if (c == 0x62) {
+	    lexer->cksum = lexer->cksum2 = 0;
 	    lexer->state = UBX_LEADER_2;
-	else
+	} else
 	    lexer->state = GROUND_STATE;
 	break;
     case UBX_LEADER_2:
+	lexer->cksum += c;
+	lexer->cksum2 += lexer->cksum;
 	lexer->state = UBX_CLASS_ID;
 	break;
     case UBX_CLASS_ID:
+	lexer->cksum += c;
+	lexer->cksum2 += lexer->cksum;
 	lexer->state = UBX_MESSAGE_ID;
 	break;
     case UBX_MESSAGE_ID:
 	lexer->length = (size_t) c;
+	lexer->cksum += c;
+	lexer->cksum2 += lexer->cksum;
 	lexer->state = UBX_LENGTH_1;
 	break;
     case UBX_LENGTH_1:
 	lexer->length += (c << 8);
-	if (lexer->length <= MAX_PACKET_LENGTH)
+	if (lexer->length <= MAX_PACKET_LENGTH) {
+	    lexer->cksum += c;
+	    lexer->cksum2 += lexer->cksum;
 	    lexer->state = UBX_LENGTH_2;
-	else
+	} else
 	    lexer->state = GROUND_STATE;
 	break;
     case UBX_LENGTH_2:
+	lexer->cksum += c;
+	lexer->cksum2 += lexer->cksum;
 	lexer->state = UBX_PAYLOAD;
 	break;
     case UBX_PAYLOAD:
+	/* the last counted byte is CK_A itself, outside the sum */
 	if (--lexer->length == 0)
 	    lexer->state = UBX_CHECKSUM_A;
+	else {
+	    lexer->cksum += c;
+	    lexer->cksum2 += lexer->cksum;
+	}
 	/* else stay in payload state */
 	break;
     case UBX_CHECKSUM_A:
@@ -1042,7 +1088,7 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 	    lexer->state = GROUND_STATE;
 	break;
     case ITALK_LEADER_2:
-	lexer->length = (size_t) (lexer->inbuffer[6] & 0xff);
+	lexer->length = (size_t) (packet_inbase(lexer)[6] & 0xff);
 	lexer->state = ITALK_LENGTH;
 	break;
     case ITALK_LENGTH:
@@ -1287,13 +1333,23 @@ static void nextstate(struct gps_packet_t *lexer, unsigned char c)
 }
 
 static void packet_accept(struct gps_packet_t *lexer, int packet_type)
-/* packet grab succeeded, move to output buffer */
+/* packet grab succeeded, expose it through the output pointer */
 {
-    size_t packetlen = lexer->inbufptr - lexer->inbuffer;
-    if (packetlen < sizeof(lexer->outbuffer)) {
-	memcpy(lexer->outbuffer, lexer->inbuffer, packetlen);
+    size_t packetlen = lexer->inbufptr - packet_inbase(lexer);
+    if (packetlen < sizeof(lexer->outstash)) {
+	if (packet_type == COMMENT_PACKET || TEXTUAL_PACKET_TYPE(packet_type)) {
+	    /*
+	     * The text parsers expect NUL termination and some of them
+	     * scribble on the sentence in place, so these still get
+	     * copied out of the input buffer.
+	     */
+	    memcpy(lexer->outstash, packet_inbase(lexer), packetlen);
+	    lexer->outstash[packetlen] = '\0';
+	    lexer->outbuffer = lexer->outstash;
+	} else
+	    /* binary frames are handed to the drivers in place, no copy */
+	    lexer->outbuffer = packet_inbase(lexer);
 	lexer->outbuflen = packetlen;
-	lexer->outbuffer[packetlen] = '\0';
 	lexer->type = packet_type;
 	if (lexer->debug >= LOG_RAW+1)
 	    gpsd_report(LOG_RAW+1, "Packet type %d accepted %zu = %s\n",
@@ -1305,33 +1361,86 @@ static void packet_accept(struct gps_packet_t *lexer, int packet_type)
     }
 }
 
+static void packet_compact(struct gps_packet_t *lexer)
+/* slide live data down so the whole input buffer is usable again */
+{
+    size_t live = lexer->inbuflen - lexer->inbufstart;
+
+    memmove(lexer->inbuffer, packet_inbase(lexer), live);
+    lexer->inbufptr -= lexer->inbufstart;
+    lexer->inbuflen = live;
+    lexer->inbufstart = 0;
+}
+
 static void packet_discard(struct gps_packet_t *lexer)
-/* shift the input buffer to discard all data up to current input pointer */
+/* bump the start offset to discard all data up to current input pointer */
 {
-    size_t discard = lexer->inbufptr - lexer->inbuffer;
-    size_t remaining = lexer->inbuflen - discard;
-    lexer->inbufptr = memmove(lexer->inbuffer, lexer->inbufptr, remaining);
-    lexer->inbuflen = remaining;
+    size_t discard = lexer->inbufptr - packet_inbase(lexer);
+    size_t remaining;
+
+    /*
+     * Accepting a packet is just a pointer bump; the dead prefix is
+     * reclaimed when the buffer drains (the common case, handled
+     * here) or by packet_compact() when free space runs short.
+     */
+    lexer->inbufstart = (size_t)(lexer->inbufptr - lexer->inbuffer);
+    remaining = lexer->inbuflen - lexer->inbufstart;
+    if (remaining == 0) {
+	lexer->inbufstart = 0;
+	lexer->inbuflen = 0;
+	lexer->inbufptr = lexer->inbuffer;
+    }
     if (lexer->debug >= LOG_RAW+1)
 	gpsd_report(LOG_RAW + 1,
 		    "Packet discard of %zu, chars remaining is %zu = %s\n",
 		    discard, remaining,
-		    gpsd_hexdump((char *)lexer->inbuffer, lexer->inbuflen));
+		    gpsd_hexdump((char *)packet_inbase(lexer), remaining));
 }
 
 static void character_discard(struct gps_packet_t *lexer)
-/* shift the input buffer to discard one character and reread data */
+/* bump the start offset to discard one character and reread data */
 {
-    memmove(lexer->inbuffer, lexer->inbuffer + 1, (size_t)-- lexer->inbuflen);
-    lexer->inbufptr = lexer->inbuffer;
+    lexer->inbufstart++;
+    if (lexer->inbufstart == lexer->inbuflen) {
+	lexer->inbufstart = 0;
+	lexer->inbuflen = 0;
+    }
+    lexer->inbufptr = packet_inbase(lexer);
     if (lexer->debug >= LOG_RAW+1)
 	gpsd_report(LOG_RAW + 1, "Character discarded, buffer %zu chars = %s\n",
-		    lexer->inbuflen,
-		    gpsd_hexdump((char *)lexer->inbuffer, lexer->inbuflen));
+		    lexer->inbuflen - lexer->inbufstart,
+		    gpsd_hexdump((char *)packet_inbase(lexer),
+				 lexer->inbuflen - lexer->inbufstart));
+}
+
+#ifndef RTCM104V2_ENABLE
+/*
+ * Fast skip of inter-packet garbage.
+ *
+ * In GROUND_STATE every byte that cannot begin a packet just falls
+ * through nextstate() and then costs a call into character_discard().
+ * Instead, scan ahead for the next byte with a ground_dispatch entry
+ * and shift the whole garbage run out in one go; the plain
+ * table-driven loop is simple for the compiler to vectorize.
+ *
+ * When RTCM104V2 is configured we cannot do this at all: the ISGPS
+ * bitstream has no byte-aligned leader, so rtcm2_decode() must see
+ * every byte that passes through GROUND_STATE.
+ */
+static size_t ground_skip(struct gps_packet_t *lexer)
+/* count leading buffered bytes that cannot begin any packet */
+{
+    unsigned char *cp = lexer->inbufptr;
+    unsigned char *end = lexer->inbuffer + lexer->inbuflen;
+
+    while (cp < end && ground_dispatch[*cp].admit == 0)
+	cp++;
+    return (size_t)(cp - lexer->inbufptr);
 }
+#endif /* RTCM104V2_ENABLE */
 
 /* get 0-origin big-endian words relative to start of packet buffer */
-#define getword(i) (short)(lexer->inbuffer[2*(i)] | (lexer->inbuffer[2*(i)+1] << 8))
+#define getword(i) (short)(packet_inbase(lexer)[2*(i)] | (packet_inbase(lexer)[2*(i)+1] << 8))
 
 /* entry points begin here */
 
@@ -1339,6 +1448,13 @@ void packet_init( /*@out@*/ struct gps_packet_t *lexer)
 {
     lexer->char_counter = 0;
     lexer->retry_counter = 0;
+    lexer->dgram = false;
+    lexer->chunked = false;
+    lexer->chunk_state = 0;
+    lexer->chunk_remaining = 0;
+    lexer->cksum = lexer->cksum2 = 0;
+    lexer->outbuffer = lexer->outstash;
+    lexer->outbuflen = 0;
 #ifdef PASSTHROUGH_ENABLE
     lexer->json_depth = 0;
 #endif /* PASSTHROUGH_ENABLE */
@@ -1350,6 +1466,103 @@ void packet_parse(struct gps_packet_t *lexer)
 {
     lexer->outbuflen = 0;
     while (packet_buffered_input(lexer) > 0) {
+#ifndef RTCM104V2_ENABLE
+	/*
+	 * Hunting for a packet leader; drop runs of garbage in bulk.
+	 * Disabled at LOG_RAW+2 so the per-character trace below still
+	 * shows every byte when someone is debugging the lexer.
+	 */
+	if (lexer->state == GROUND_STATE
+	    && lexer->inbufptr == packet_inbase(lexer)
+	    && lexer->debug < LOG_RAW + 2) {
+	    size_t garbage = ground_skip(lexer);
+	    if (garbage > 0) {
+		lexer->char_counter += (unsigned long)garbage;
+		lexer->inbufptr += garbage;
+		packet_discard(lexer);
+		continue;
+	    }
+	}
+#endif /* RTCM104V2_ENABLE */
+	/*
+	 * Bulk consume for binary payloads.  Once a header with a
+	 * trusted length field has been parsed, the payload states
+	 * named below just count bytes down; stepping the state
+	 * machine for each one is pure overhead on high-rate streams
+	 * like uBlox raw measurement dumps.  Swallow all buffered
+	 * payload except the final byte in one motion and let
+	 * nextstate() make the transition out of the payload state.
+	 * Only states with no per-byte side effects may appear here;
+	 * the DLE-stuffed protocols (TSIP, EverMore, Garmin) and
+	 * iTalk with its runt-packet lookahead must still see every
+	 * byte.
+	 */
+	switch (lexer->state) {
+#ifdef SIRF_ENABLE
+	case SIRF_PAYLOAD:
+#endif /* SIRF_ENABLE */
+#ifdef SUPERSTAR2_ENABLE
+	case SUPERSTAR2_PAYLOAD:
+#endif /* SUPERSTAR2_ENABLE */
+#ifdef ONCORE_ENABLE
+	case ONCORE_PAYLOAD:
+#endif /* ONCORE_ENABLE */
+#ifdef ZODIAC_ENABLE
+	case ZODIAC_PAYLOAD:
+#endif /* ZODIAC_ENABLE */
+#ifdef UBX_ENABLE
+	case UBX_PAYLOAD:
+#endif /* UBX_ENABLE */
+#ifdef NAVCOM_ENABLE
+	case NAVCOM_LENGTH_2:	/* counts down the Navcom payload */
+#endif /* NAVCOM_ENABLE */
+#ifdef GEOSTAR_ENABLE
+	case GEOSTAR_PAYLOAD:
+#endif /* GEOSTAR_ENABLE */
+#ifdef RTCM104V3_ENABLE
+	case RTCM3_PAYLOAD:
+#endif /* RTCM104V3_ENABLE */
+	    if (lexer->length > 1 && lexer->debug < LOG_RAW + 2) {
+		size_t bulk = lexer->length - 1;
+		size_t buffered = (size_t)packet_buffered_input(lexer);
+		size_t i;
+
+		if (bulk > buffered)
+		    bulk = buffered;
+		/* checksums still see every byte, just in one pass */
+		switch (lexer->state) {
+#ifdef SIRF_ENABLE
+		case SIRF_PAYLOAD:
+		    for (i = 0; i < bulk; i++)
+			lexer->cksum += lexer->inbufptr[i];
+		    break;
+#endif /* SIRF_ENABLE */
+#ifdef UBX_ENABLE
+		case UBX_PAYLOAD:
+		    for (i = 0; i < bulk; i++) {
+			lexer->cksum += lexer->inbufptr[i];
+			lexer->cksum2 += lexer->cksum;
+		    }
+		    break;
+#endif /* UBX_ENABLE */
+#ifdef RTCM104V3_ENABLE
+		case RTCM3_PAYLOAD:
+		    lexer->cksum = crc24q_resume(lexer->cksum,
+						 lexer->inbufptr, (int)bulk);
+		    break;
+#endif /* RTCM104V3_ENABLE */
+		default:
+		    break;
+		}
+		lexer->inbufptr += bulk;
+		lexer->length -= bulk;
+		lexer->char_counter += (unsigned long)bulk;
+		continue;
+	    }
+	    break;
+	default:
+	    break;
+	}
 	/*@ -modobserver @*/
 	unsigned char c = *lexer->inbufptr++;
 	/*@ +modobserver @*/
@@ -1377,7 +1590,7 @@ void packet_parse(struct gps_packet_t *lexer)
 	     * $PASHR packets have no checksum. Avoid the possibility
 	     * that random garbage might make it look like they do.
 	     */
-	    if (strncmp((const char *)lexer->inbuffer, "$PASHR,", 7) != 0)
+	    if (strncmp((const char *)packet_inbase(lexer), "$PASHR,", 7) != 0)
 	    {
 		bool checksum_ok = true;
 		char csum[3] = { '0', '0', '0' };
@@ -1392,8 +1605,8 @@ void packet_parse(struct gps_packet_t *lexer)
 		    --end;
 		if (*end == '*') {
 		    unsigned int n, crc = 0;
-		    for (n = 1; (char *)lexer->inbuffer + n < end; n++)
-			crc ^= lexer->inbuffer[n];
+		    for (n = 1; (char *)packet_inbase(lexer) + n < end; n++)
+			crc ^= packet_inbase(lexer)[n];
 		    (void)snprintf(csum, sizeof(csum), "%02X", crc);
 		    checksum_ok = (csum[0] == toupper(end[1])
 				   && csum[1] == toupper(end[2]));
@@ -1412,9 +1625,9 @@ void packet_parse(struct gps_packet_t *lexer)
 	    }
 	    /* checksum passed or not present */
 #ifdef AIVDM_ENABLE
-	    if (strncmp((char *)lexer->inbuffer, "!AIVDM", 6) == 0)
+	    if (strncmp((char *)packet_inbase(lexer), "!AIVDM", 6) == 0)
 		packet_accept(lexer, AIVDM_PACKET);
-	    else if (strncmp((char *)lexer->inbuffer, "!AIVDO", 6) == 0)
+	    else if (strncmp((char *)packet_inbase(lexer), "!AIVDO", 6) == 0)
 		packet_accept(lexer, AIVDM_PACKET);
 	    else
 #endif /* AIVDM_ENABLE */
@@ -1428,10 +1641,12 @@ void packet_parse(struct gps_packet_t *lexer)
 	    unsigned char *trailer = lexer->inbufptr - 4;
 	    unsigned int checksum =
 		(unsigned)((trailer[0] << 8) | trailer[1]);
-	    unsigned int n, crc = 0;
-	    for (n = 4; n < (unsigned)(trailer - lexer->inbuffer); n++)
-		crc += (int)lexer->inbuffer[n];
-	    crc &= 0x7fff;
+	    /*
+	     * The running sum from the payload states also swallowed the
+	     * two checksum bytes; addition commutes, so just back them out.
+	     */
+	    unsigned int crc =
+		(lexer->cksum - trailer[0] - trailer[1]) & 0x7fff;
 	    if (checksum == crc)
 		packet_accept(lexer, SIRF_PACKET);
 	    else {
@@ -1446,16 +1661,16 @@ void packet_parse(struct gps_packet_t *lexer)
 	else if (lexer->state == SUPERSTAR2_RECOGNIZED) {
 	    unsigned a = 0, b;
 	    size_t n;
-	    lexer->length = 4 + (size_t) lexer->inbuffer[3] + 2;
+	    lexer->length = 4 + (size_t) packet_inbase(lexer)[3] + 2;
 	    for (n = 0; n < lexer->length - 2; n++)
-		a += (unsigned)lexer->inbuffer[n];
-	    b = (unsigned)getleu16(lexer->inbuffer, lexer->length - 2);
+		a += (unsigned)packet_inbase(lexer)[n];
+	    b = (unsigned)getleu16(packet_inbase(lexer), lexer->length - 2);
 	    gpsd_report(LOG_IO, "SuperStarII pkt dump: type %u len %u\n",
-			lexer->inbuffer[1], (unsigned int)lexer->length);
+			packet_inbase(lexer)[1], (unsigned int)lexer->length);
 	    if (a != b) {
 		gpsd_report(LOG_IO, "REJECT SuperStarII packet type 0x%02x"
 			    "%zd bad checksum 0x%04x, expecting 0x%04x\n",
-			    lexer->inbuffer[1], lexer->length, a, b);
+			    packet_inbase(lexer)[1], lexer->length, a, b);
 		packet_accept(lexer, BAD_PACKET);
 		lexer->state = GROUND_STATE;
 	    } else {
@@ -1470,18 +1685,18 @@ void packet_parse(struct gps_packet_t *lexer)
 	    char a, b;
 	    int i, len;
 
-	    len = lexer->inbufptr - lexer->inbuffer;
-	    a = (char)(lexer->inbuffer[len - 3]);
+	    len = lexer->inbufptr - packet_inbase(lexer);
+	    a = (char)(packet_inbase(lexer)[len - 3]);
 	    b = '\0';
 	    for (i = 2; i < len - 3; i++)
-		b ^= lexer->inbuffer[i];
+		b ^= packet_inbase(lexer)[i];
 	    if (a == b) {
 		gpsd_report(LOG_IO, "Accept OnCore packet @@%c%c len %d\n",
-			    lexer->inbuffer[2], lexer->inbuffer[3], len);
+			    packet_inbase(lexer)[2], packet_inbase(lexer)[3], len);
 		packet_accept(lexer, ONCORE_PACKET);
 	    } else {
 		gpsd_report(LOG_IO, "REJECT OnCore packet @@%c%c len %d\n",
-			    lexer->inbuffer[2], lexer->inbuffer[3], len);
+			    packet_inbase(lexer)[2], packet_inbase(lexer)[3], len);
 		packet_accept(lexer, BAD_PACKET);
 		lexer->state = GROUND_STATE;
 	    }
@@ -1491,13 +1706,13 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif /* ONCORE_ENABLE */
 #if defined(TSIP_ENABLE) || defined(GARMIN_ENABLE)
 	else if (lexer->state == TSIP_RECOGNIZED) {
-	    size_t packetlen = lexer->inbufptr - lexer->inbuffer;
+	    size_t packetlen = lexer->inbufptr - packet_inbase(lexer);
 #ifdef TSIP_ENABLE
 	    unsigned int pos, dlecnt;
 	    /* don't count stuffed DLEs in the length */
 	    dlecnt = 0;
 	    for (pos = 0; pos < (unsigned int)packetlen; pos++)
-		if (lexer->inbuffer[pos] == DLE)
+		if (packet_inbase(lexer)[pos] == DLE)
 		    dlecnt++;
 	    if (dlecnt > 2) {
 		dlecnt -= 2;
@@ -1521,33 +1736,33 @@ void packet_parse(struct gps_packet_t *lexer)
 		if (TSIP_PACKET == lexer->type)
 		    goto not_garmin;
 #endif /* TSIP_ENABLE */
-		if (lexer->inbuffer[n++] != DLE)
+		if (packet_inbase(lexer)[n++] != DLE)
 		    goto not_garmin;
-		pkt_id = lexer->inbuffer[n++];	/* packet ID */
-		len = lexer->inbuffer[n++];
+		pkt_id = packet_inbase(lexer)[n++];	/* packet ID */
+		len = packet_inbase(lexer)[n++];
 		chksum = len + pkt_id;
 		if (len == DLE) {
-		    if (lexer->inbuffer[n++] != DLE)
+		    if (packet_inbase(lexer)[n++] != DLE)
 			goto not_garmin;
 		}
 		for (; len > 0; len--) {
-		    chksum += lexer->inbuffer[n];
-		    if (lexer->inbuffer[n++] == DLE) {
-			if (lexer->inbuffer[n++] != DLE)
+		    chksum += packet_inbase(lexer)[n];
+		    if (packet_inbase(lexer)[n++] == DLE) {
+			if (packet_inbase(lexer)[n++] != DLE)
 			    goto not_garmin;
 		    }
 		}
 		/* check sum byte */
-		ch = lexer->inbuffer[n++];
+		ch = packet_inbase(lexer)[n++];
 		chksum += ch;
 		if (ch == DLE) {
-		    if (lexer->inbuffer[n++] != DLE)
+		    if (packet_inbase(lexer)[n++] != DLE)
 			goto not_garmin;
 		}
-		if (lexer->inbuffer[n++] != DLE)
+		if (packet_inbase(lexer)[n++] != DLE)
 		    goto not_garmin;
 		/* we used to say n++ here, but scan-build complains */
-		if (lexer->inbuffer[n] != ETX)
+		if (packet_inbase(lexer)[n] != ETX)
 		    goto not_garmin;
 		/*@ +charint */
 		chksum &= 0xff;
@@ -1592,7 +1807,7 @@ void packet_parse(struct gps_packet_t *lexer)
 		 * <DLE>[pkt id] [data] <DLE><ETX>
 		 */
 		/*@ +charint @*/
-		pkt_id = lexer->inbuffer[1];	/* packet ID */
+		pkt_id = packet_inbase(lexer)[1];	/* packet ID */
                 /* *INDENT-OFF* */
 		if (!((0x13 == pkt_id) || (0xbb == pkt_id) || (0xbc == pkt_id))
 		    && ((0x41 > pkt_id) || (0x8f < pkt_id))) {
@@ -1690,14 +1905,18 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif /* TSIP_ENABLE || GARMIN_ENABLE */
 #ifdef RTCM104V3_ENABLE
 	else if (lexer->state == RTCM3_RECOGNIZED) {
-	    if (crc24q_check(lexer->inbuffer,
-			     lexer->inbufptr - lexer->inbuffer)) {
+	    /*
+	     * The CRC was fed a byte at a time during lexing; a frame
+	     * whose trailing parity matches leaves a zero residual, so
+	     * no second pass over the buffer is needed.
+	     */
+	    if (lexer->cksum == 0) {
 		packet_accept(lexer, RTCM3_PACKET);
 	    } else {
 		gpsd_report(LOG_IO, "RTCM3 data checksum failure, "
 			    "%0x against %02x %02x %02x\n",
-			    crc24q_hash(lexer->inbuffer,
-					lexer->inbufptr - lexer->inbuffer -
+			    crc24q_hash(packet_inbase(lexer),
+					lexer->inbufptr - packet_inbase(lexer) -
 					3), lexer->inbufptr[-3],
 			    lexer->inbufptr[-2], lexer->inbufptr[-1]);
 		packet_accept(lexer, BAD_PACKET);
@@ -1729,18 +1948,14 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif /* ZODIAC_ENABLE */
 #ifdef UBX_ENABLE
 	else if (lexer->state == UBX_RECOGNIZED) {
-	    /* UBX use a TCP like checksum */
-	    int n, len;
-	    unsigned char ck_a = (unsigned char)0;
-	    unsigned char ck_b = (unsigned char)0;
-	    len = lexer->inbufptr - lexer->inbuffer;
+	    /* UBX use a TCP like checksum, accumulated during lexing */
+	    int len;
+	    unsigned char ck_a = (unsigned char)lexer->cksum;
+	    unsigned char ck_b = (unsigned char)lexer->cksum2;
+	    len = lexer->inbufptr - packet_inbase(lexer);
 	    gpsd_report(LOG_IO, "UBX: len %d\n", len);
-	    for (n = 2; n < (len - 2); n++) {
-		ck_a += lexer->inbuffer[n];
-		ck_b += ck_a;
-	    }
-	    if (ck_a == lexer->inbuffer[len - 2] &&
-		ck_b == lexer->inbuffer[len - 1])
+	    if (ck_a == packet_inbase(lexer)[len - 2] &&
+		ck_b == packet_inbase(lexer)[len - 1])
 		packet_accept(lexer, UBX_PACKET);
 	    else {
 		gpsd_report(LOG_IO,
@@ -1749,9 +1964,9 @@ void packet_parse(struct gps_packet_t *lexer)
 			    ck_a,
 			    ck_b,
 			    len,
-			    lexer->inbuffer[len - 2],
-			    lexer->inbuffer[len - 1],
-			    lexer->inbuffer[2], lexer->inbuffer[3]);
+			    packet_inbase(lexer)[len - 2],
+			    packet_inbase(lexer)[len - 1],
+			    packet_inbase(lexer)[2], packet_inbase(lexer)[3]);
 		packet_accept(lexer, BAD_PACKET);
 		lexer->state = GROUND_STATE;
 	    }
@@ -1764,33 +1979,33 @@ void packet_parse(struct gps_packet_t *lexer)
 	    unsigned int n, crc, checksum, len;
 	    n = 0;
 	    /*@ +charint */
-	    if (lexer->inbuffer[n++] != DLE)
+	    if (packet_inbase(lexer)[n++] != DLE)
 		goto not_evermore;
-	    if (lexer->inbuffer[n++] != STX)
+	    if (packet_inbase(lexer)[n++] != STX)
 		goto not_evermore;
-	    len = lexer->inbuffer[n++];
+	    len = packet_inbase(lexer)[n++];
 	    if (len == DLE) {
-		if (lexer->inbuffer[n++] != DLE)
+		if (packet_inbase(lexer)[n++] != DLE)
 		    goto not_evermore;
 	    }
 	    len -= 2;
 	    crc = 0;
 	    for (; len > 0; len--) {
-		crc += lexer->inbuffer[n];
-		if (lexer->inbuffer[n++] == DLE) {
-		    if (lexer->inbuffer[n++] != DLE)
+		crc += packet_inbase(lexer)[n];
+		if (packet_inbase(lexer)[n++] == DLE) {
+		    if (packet_inbase(lexer)[n++] != DLE)
 			goto not_evermore;
 		}
 	    }
-	    checksum = lexer->inbuffer[n++];
+	    checksum = packet_inbase(lexer)[n++];
 	    if (checksum == DLE) {
-		if (lexer->inbuffer[n++] != DLE)
+		if (packet_inbase(lexer)[n++] != DLE)
 		    goto not_evermore;
 	    }
-	    if (lexer->inbuffer[n++] != DLE)
+	    if (packet_inbase(lexer)[n++] != DLE)
 		goto not_evermore;
 	    /* we used to say n++ here, but scan-build complains */
-	    if (lexer->inbuffer[n] != ETX)
+	    if (packet_inbase(lexer)[n] != ETX)
 		goto not_evermore;
 	    crc &= 0xff;
 	    if (crc != checksum) {
@@ -1812,14 +2027,14 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif /* EVERMORE_ENABLE */
 /* XXX CSK */
 #ifdef ITRAX_ENABLE
-#define getib(j) ((uint8_t)lexer->inbuffer[(j)])
+#define getib(j) ((uint8_t)packet_inbase(lexer)[(j)])
 #define getiw(i) ((uint16_t)(((uint16_t)getib((i)+1) << 8) | (uint16_t)getib((i))))
 
 	else if (lexer->state == ITALK_RECOGNIZED) {
 	    volatile uint16_t len, n, csum, xsum;
 
 	    /* number of words */
-	    len = (uint16_t) (lexer->inbuffer[6] & 0xff);
+	    len = (uint16_t) (packet_inbase(lexer)[6] & 0xff);
 
 	    /*@ -type @*/
 	    /* expected checksum */
@@ -1839,7 +2054,7 @@ void packet_parse(struct gps_packet_t *lexer)
 		gpsd_report(LOG_IO,
 			    "ITALK: checksum failed - "
 			    "type 0x%02x expected 0x%04x got 0x%04x\n",
-			    lexer->inbuffer[4], xsum, csum);
+			    packet_inbase(lexer)[4], xsum, csum);
 		packet_accept(lexer, BAD_PACKET);
 		lexer->state = GROUND_STATE;
 	    }
@@ -1862,11 +2077,11 @@ void packet_parse(struct gps_packet_t *lexer)
 	    /* GeoStar uses a XOR 32bit checksum */
 	    int n, len;
 	    unsigned int cs = 0L;
-	    len = lexer->inbufptr - lexer->inbuffer;
+	    len = lexer->inbufptr - packet_inbase(lexer);
 
 	    /* Calculate checksum */
 	    for (n = 0; n < len; n += 4) {
-		cs ^= getleu32(lexer->inbuffer, n);
+		cs ^= getleu32(packet_inbase(lexer), n);
 	    }
 
 	    if (cs == 0)
@@ -1896,7 +2111,7 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif /* RTCM104V2_ENABLE */
 #ifdef GARMINTXT_ENABLE
 	else if (lexer->state == GTXT_RECOGNIZED) {
-	    size_t packetlen = lexer->inbufptr - lexer->inbuffer;
+	    size_t packetlen = lexer->inbufptr - packet_inbase(lexer);
 	    if (57 <= packetlen) {
 		packet_accept(lexer, GARMINTXT_PACKET);
 		packet_discard(lexer);
@@ -1910,7 +2125,7 @@ void packet_parse(struct gps_packet_t *lexer)
 #endif
 #ifdef PASSTHROUGH_ENABLE
 	else if (lexer->state == JSON_RECOGNIZED) {
-	    size_t packetlen = lexer->inbufptr - lexer->inbuffer;
+	    size_t packetlen = lexer->inbufptr - packet_inbase(lexer);
 	    if (packetlen >= 11)
 		/* {"class": } */
 		packet_accept(lexer, JSON_PACKET);
@@ -1926,33 +2141,206 @@ void packet_parse(struct gps_packet_t *lexer)
 
 #undef getword
 
+/* HTTP chunked-transfer framing parser states */
+#define CHUNK_SIZE	0	/* accumulating the hex chunk length */
+#define CHUNK_EXT	1	/* discarding a chunk extension */
+#define CHUNK_LF	2	/* expecting the LF ending the size line */
+#define CHUNK_DATA	3	/* passing chunk_remaining payload bytes */
+#define CHUNK_CR	4	/* expecting the CR after the payload */
+#define CHUNK_CRLF	5	/* expecting the LF after that CR */
+
+size_t packet_dechunk(struct gps_packet_t *lexer,
+		      unsigned char *buf, size_t len)
+/* strip HTTP chunked-transfer framing in place, return payload length
+ *
+ * NTRIP v2 casters wrap the correction stream in chunked encoding.
+ * The payload is compacted within the region just read, so correction
+ * bytes reach the lexer states without a pass through a side buffer.
+ * Framing may be split across reads; the parse state lives in the
+ * lexer and picks up where the last read left off.
+ */
+{
+    unsigned char *sp, *dp = buf;
+
+    for (sp = buf; sp < buf + len; sp++) {
+	switch (lexer->chunk_state) {
+	case CHUNK_DATA:
+	    {
+		size_t n = (size_t)(buf + len - sp);
+
+		if (n > (size_t)lexer->chunk_remaining)
+		    n = (size_t)lexer->chunk_remaining;
+		memmove(dp, sp, n);
+		dp += n;
+		sp += n - 1;
+		lexer->chunk_remaining -= (int)n;
+		if (lexer->chunk_remaining == 0)
+		    lexer->chunk_state = CHUNK_CR;
+	    }
+	    break;
+	case CHUNK_CR:
+	    /* tolerate a bare LF from sloppy casters */
+	    lexer->chunk_state = (*sp == '\n') ? CHUNK_SIZE : CHUNK_CRLF;
+	    break;
+	case CHUNK_CRLF:
+	    if (*sp == '\n')
+		lexer->chunk_state = CHUNK_SIZE;
+	    break;
+	case CHUNK_EXT:
+	case CHUNK_LF:
+	case CHUNK_SIZE:
+	default:
+	    if (lexer->chunk_state == CHUNK_SIZE && isxdigit(*sp)) {
+		lexer->chunk_remaining = lexer->chunk_remaining * 16
+		    + (isdigit(*sp) ? *sp - '0' : (tolower(*sp) - 'a') + 10);
+		break;
+	    }
+	    if (*sp == ';')
+		lexer->chunk_state = CHUNK_EXT;
+	    else if (*sp == '\r')
+		lexer->chunk_state = CHUNK_LF;
+	    else if (*sp == '\n')
+		/*
+		 * A zero-length chunk ends the stream; parsing any
+		 * trailers as size lines is harmless, the caster is
+		 * about to close the connection anyway.
+		 */
+		lexer->chunk_state = (lexer->chunk_remaining > 0)
+		    ? CHUNK_DATA : CHUNK_SIZE;
+	    break;
+	}
+    }
+    return (size_t)(dp - buf);
+}
+
+#if defined(__linux__) && !defined(S_SPLINT_S)
+#define DGRAM_BATCH	16	/* max datagrams drained per syscall */
+#endif
+
+static ssize_t packet_recv_dgram(int fd, struct gps_packet_t *lexer,
+				 size_t space)
+/* drain waiting datagrams into the input buffer; semantics match read() */
+{
+#if defined(__linux__) && !defined(S_SPLINT_S)
+    struct mmsghdr msgs[DGRAM_BATCH];
+    struct iovec iovs[DGRAM_BATCH];
+    unsigned char bufs[DGRAM_BATCH][MAX_PACKET_LENGTH];
+    unsigned int i, vlen;
+    int nread;
+    ssize_t appended = 0;
+
+    /*
+     * Admit only as many messages as are guaranteed to fit even if
+     * every datagram has the worst-case length; a message the kernel
+     * has already handed over cannot be pushed back.
+     */
+    vlen = (unsigned int)(space / MAX_PACKET_LENGTH);
+    if (vlen == 0)
+	return read(fd, lexer->inbuffer + lexer->inbuflen, space);
+    if (vlen > DGRAM_BATCH)
+	vlen = DGRAM_BATCH;
+    memset(msgs, 0, sizeof(msgs));
+    for (i = 0; i < vlen; i++) {
+	iovs[i].iov_base = bufs[i];
+	iovs[i].iov_len = sizeof(bufs[i]);
+	msgs[i].msg_hdr.msg_iov = &iovs[i];
+	msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    nread = recvmmsg(fd, msgs, vlen, MSG_DONTWAIT, NULL);
+    if (nread <= 0)
+	return (ssize_t)nread;
+    for (i = 0; i < (unsigned int)nread; i++) {
+	memcpy(lexer->inbuffer + lexer->inbuflen + appended,
+	       bufs[i], (size_t)msgs[i].msg_len);
+	appended += (ssize_t)msgs[i].msg_len;
+    }
+    return appended;
+#else
+    /*
+     * No batch receive on this platform; a plain read() returns one
+     * datagram and the drain loop in packet_get() does the rest.
+     */
+    return read(fd, lexer->inbuffer + lexer->inbuflen, space);
+#endif /* __linux__ */
+}
+
 ssize_t packet_get(int fd, struct gps_packet_t *lexer)
 /* grab a packet; return -1=>I/O error, 0=>EOF, BAD_PACKET or a length */
 {
     ssize_t recvd;
+    size_t space;
+    bool firstread = true;
 
     /*@ -modobserver @*/
-    errno = 0;
-    recvd = read(fd, lexer->inbuffer + lexer->inbuflen,
-		 sizeof(lexer->inbuffer) - (lexer->inbuflen));
-    /*@ +modobserver @*/
-    if (recvd == -1) {
-	if ((errno == EAGAIN) || (errno == EINTR)) {
-	    gpsd_report(LOG_RAW + 2, "no bytes ready\n");
-	    recvd = 0;
-	    /* fall through, input buffer may be nonempty */
+    /*
+     * If the dead prefix left behind by accepted packets has eaten
+     * into the free space, slide the live data down before reading.
+     */
+    if (lexer->inbufstart > 0
+	&& sizeof(lexer->inbuffer) - lexer->inbuflen
+	   < sizeof(lexer->inbuffer) / 2)
+	packet_compact(lexer);
+    for (;;) {
+	errno = 0;
+	space = sizeof(lexer->inbuffer) - lexer->inbuflen;
+	if (lexer->dgram)
+	    recvd = packet_recv_dgram(fd, lexer, space);
+	else
+	    recvd = read(fd, lexer->inbuffer + lexer->inbuflen, space);
+	if (recvd == -1) {
+	    if ((errno == EAGAIN) || (errno == EINTR)) {
+		gpsd_report(LOG_RAW + 2, "no bytes ready\n");
+		recvd = 0;
+		/* fall through, input buffer may be nonempty */
+	    } else if (firstread) {
+		gpsd_report(LOG_RAW + 2, "errno: %s\n", strerror(errno));
+		return -1;
+	    } else {
+		/* consume what we have; the error returns on the next call */
+		recvd = 0;
+	    }
+	    break;
 	} else {
-	    gpsd_report(LOG_RAW + 2, "errno: %s\n", strerror(errno));
-	    return -1;
+	    ssize_t kept = recvd;
+
+	    if (lexer->chunked && recvd > 0)
+		/*
+		 * Strip the HTTP chunk framing in place.  The raw
+		 * count keeps driving the EOF and short-read logic; a
+		 * framing-only read must not look like a hangup.
+		 */
+		kept = (ssize_t)packet_dechunk(lexer,
+					       lexer->inbuffer + lexer->inbuflen,
+					       (size_t)recvd);
+	    if (lexer->debug >= LOG_RAW+1)
+		gpsd_report(LOG_RAW + 1,
+			    "Read %zd chars to buffer offset %zd (total %zd): %s\n",
+			    kept, lexer->inbuflen, lexer->inbuflen + kept,
+			    gpsd_hexdump((char *)lexer->inbufptr,
+					 (size_t) kept));
+	    lexer->inbuflen += kept;
 	}
-    } else {
-	if (lexer->debug >= LOG_RAW+1)
-	    gpsd_report(LOG_RAW + 1,
-			"Read %zd chars to buffer offset %zd (total %zd): %s\n",
-			recvd, lexer->inbuflen, lexer->inbuflen + recvd,
-			gpsd_hexdump((char *)lexer->inbufptr, (size_t) recvd));
-	lexer->inbuflen += recvd;
+	/*
+	 * A burst from a fast device (USB CDC, UDP-tunneled serial)
+	 * often queues several packets between wakeups.  If the read
+	 * filled everything we asked for, more is probably waiting,
+	 * so drain it now instead of paying a poll cycle per packet.
+	 * A short read means the queue is empty, and on a blocking
+	 * descriptor another read() would hang - so we stop there.
+	 */
+	if (lexer->dgram) {
+	    /* a datagram read is always "short"; only EAGAIN ends the burst */
+	    if (recvd == 0)
+		break;
+	} else if (recvd == 0 || (size_t)recvd < space)
+	    break;
+	if (lexer->inbufstart > 0)
+	    packet_compact(lexer);
+	if (sizeof(lexer->inbuffer) == lexer->inbuflen)
+	    break;		/* no room left; parse before reading on */
+	firstread = false;
     }
+    /*@ +modobserver @*/
     gpsd_report(LOG_SPIN, "packet_get() fd %d -> %zd (%d)\n",
 		fd, recvd, errno);
 
@@ -1967,10 +2355,15 @@ ssize_t packet_get(int fd, struct gps_packet_t *lexer)
     /* Otherwise, consume from the packet input buffer */
     packet_parse(lexer);
 
-    /* if input buffer is full, discard */
+    /* if input buffer is full, reclaim dead space or discard */
     if (sizeof(lexer->inbuffer) == (lexer->inbuflen)) {
-	packet_discard(lexer);
-	lexer->state = GROUND_STATE;
+	packet_retain(lexer);	/* compaction would slide the frame away */
+	if (lexer->inbufstart > 0)
+	    packet_compact(lexer);
+	else {
+	    packet_discard(lexer);
+	    lexer->state = GROUND_STATE;
+	}
     }
 
     /*
@@ -2002,13 +2395,40 @@ ssize_t packet_get(int fd, struct gps_packet_t *lexer)
 	return recvd;
 }
 
+void packet_retain(struct gps_packet_t *lexer)
+/* copy the current packet out so it survives the next buffer read */
+{
+    if (lexer->outbuffer != lexer->outstash && lexer->outbuflen > 0) {
+	memcpy(lexer->outstash, lexer->outbuffer, lexer->outbuflen);
+	lexer->outstash[lexer->outbuflen] = '\0';
+	lexer->outbuffer = lexer->outstash;
+    }
+}
+
+void packet_lock(struct gps_packet_t *lexer, unsigned int typemask)
+/* restrict the lexer to the given packet types; 0 re-opens the hunt */
+{
+    if (typemask != 0)
+	/*
+	 * Never lock out the textual types: mixed NMEA/binary devices
+	 * (e.g. a LEA-5H) are common, comments appear in logfiles and
+	 * JSON frames carry remote-gpsd passthrough.
+	 */
+	typemask |= PACKET_TYPEMASK(COMMENT_PACKET)
+	    | PACKET_TYPEMASK(NMEA_PACKET) | PACKET_TYPEMASK(AIVDM_PACKET)
+	    | PACKET_TYPEMASK(JSON_PACKET);
+    lexer->acceptmask = typemask;
+}
+
 void packet_reset( /*@out@*/ struct gps_packet_t *lexer)
 /* return the packet machine to the ground state */
 {
     lexer->type = BAD_PACKET;
     lexer->state = GROUND_STATE;
+    lexer->acceptmask = 0;
     lexer->inbuflen = 0;
     lexer->inbufptr = lexer->inbuffer;
+    lexer->inbufstart = 0;
 #ifdef BINARY_ENABLE
     isgps_init(lexer);
 #endif /* BINARY_ENABLE */
@@ -2019,6 +2439,9 @@ void packet_reset( /*@out@*/ struct gps_packet_t *lexer)
 void packet_pushback(struct gps_packet_t *lexer)
 /* push back the last packet grabbed */
 {
+    packet_retain(lexer);
+    if (lexer->inbufstart > 0)
+	packet_compact(lexer);
     if (lexer->outbuflen + lexer->inbuflen < MAX_PACKET_LENGTH) {
 	memmove(lexer->inbuffer + lexer->outbuflen,
 		lexer->inbuffer, lexer->inbuflen);
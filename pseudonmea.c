@@ -28,6 +28,68 @@ static double degtodm(double angle)
     return floor(angle) * 100 + fraction * 60;
 }
 
+/*
+ * Between epochs the GPGGA and GPRMC sentences normally differ only in
+ * their time/position prefixes, which the format strings pin to fixed
+ * widths; the quality and motion fields behind them move rarely.  So
+ * each device keeps its last rendered copy of both sentences, and when
+ * the trailing fields are unchanged just the prefix bytes are
+ * rewritten and the checksum redone.
+ */
+#define PNMEA_CACHE_SLOTS	4
+#define GGA_PREFIX_LEN		39	/* "$GPGGA," + time, lat, lon */
+#define RMC_PREFIX_LEN		41	/* "$GPRMC," + time, status, lat, lon */
+
+struct gga_tail_t
+{
+    int status;
+    int satellites_used;
+    double hdop;
+    double altitude;
+    double separation;
+    double mag_var;
+};
+
+struct rmc_tail_t
+{
+    double speed;
+    double track;
+    int mday;
+    int mon;
+    int year;
+};
+
+struct pnmea_cache_t
+{
+    char path[GPS_PATH_MAX];
+    bool gga_valid;
+    struct gga_tail_t gga_tail;
+    char gga[NMEA_BIG_BUF];
+    bool rmc_valid;
+    struct rmc_tail_t rmc_tail;
+    char rmc[NMEA_BIG_BUF];
+};
+
+static struct pnmea_cache_t pnmea_caches[PNMEA_CACHE_SLOTS];
+
+static /*@null@*/ struct pnmea_cache_t *pnmea_cache_slot(const char *path)
+/* find or claim the sentence cache slot for a device */
+{
+    struct pnmea_cache_t *cache;
+
+    for (cache = pnmea_caches;
+	 cache < pnmea_caches + PNMEA_CACHE_SLOTS; cache++)
+	if (strcmp(cache->path, path) == 0)
+	    return cache;
+    for (cache = pnmea_caches;
+	 cache < pnmea_caches + PNMEA_CACHE_SLOTS; cache++)
+	if (cache->path[0] == '\0') {
+	    (void)strlcpy(cache->path, path, sizeof(cache->path));
+	    return cache;
+	}
+    return NULL;	/* more devices than slots; those render in full */
+}
+
 /*@ -mustdefine @*/
 void gpsd_position_fix_dump(struct gps_device_t *session,
 			    /*@out@*/ char bufp[], size_t len)
@@ -35,9 +97,44 @@ void gpsd_position_fix_dump(struct gps_device_t *session,
     struct tm tm;
     time_t intfixtime;
 
+    struct pnmea_cache_t *cache = NULL;
+    struct gga_tail_t tail;
+
     intfixtime = (time_t) session->gpsdata.fix.time;
     (void)gmtime_r(&intfixtime, &tm);
     if (session->gpsdata.fix.mode > MODE_NO_FIX) {
+	if (session->gpsdata.dev.path[0] != '\0')
+	    cache = pnmea_cache_slot(session->gpsdata.dev.path);
+	if (cache != NULL) {
+	    memset(&tail, 0, sizeof(tail));
+	    tail.status = session->gpsdata.status;
+	    tail.satellites_used = session->gpsdata.satellites_used;
+	    tail.hdop = session->gpsdata.dop.hdop;
+	    tail.altitude = session->gpsdata.fix.altitude;
+	    tail.separation = session->gpsdata.separation;
+	    tail.mag_var = session->mag_var;
+	    /* bytewise compare so NaNs count as equal */
+	    if (cache->gga_valid
+		&& memcmp(&tail, &cache->gga_tail, sizeof(tail)) == 0) {
+		char prefix[GGA_PREFIX_LEN + 8];
+
+		(void)snprintf(prefix, sizeof(prefix),
+			       "$GPGGA,%02d%02d%02d,%09.4f,%c,%010.4f,%c,",
+			       tm.tm_hour,
+			       tm.tm_min,
+			       tm.tm_sec,
+			       degtodm(fabs(session->gpsdata.fix.latitude)),
+			       ((session->gpsdata.fix.latitude > 0) ? 'N' : 'S'),
+			       degtodm(fabs(session->gpsdata.fix.longitude)),
+			       ((session->gpsdata.fix.longitude > 0) ? 'E' : 'W'));
+		if (strlen(prefix) == (size_t)GGA_PREFIX_LEN) {
+		    memcpy(cache->gga, prefix, (size_t)GGA_PREFIX_LEN);
+		    nmea_add_checksum(cache->gga);
+		    (void)strlcpy(bufp, cache->gga, len);
+		    return;
+		}
+	    }
+	}
 	(void)snprintf(bufp, len,
 		       "$GPGGA,%02d%02d%02d,%09.4f,%c,%010.4f,%c,%d,%02d,",
 		       tm.tm_hour,
@@ -73,6 +170,11 @@ void gpsd_position_fix_dump(struct gps_device_t *session,
 	    (void)strlcat(bufp, (session->mag_var > 0) ? "E" : "W", len);
 	}
 	nmea_add_checksum(bufp);
+	if (cache != NULL && strlen(bufp) < sizeof(cache->gga)) {
+	    (void)strlcpy(cache->gga, bufp, sizeof(cache->gga));
+	    cache->gga_tail = tail;
+	    cache->gga_valid = true;
+	}
     }
 }
 
@@ -83,6 +185,8 @@ static void gpsd_transit_fix_dump(struct gps_device_t *session,
 {
     struct tm tm;
     time_t intfixtime;
+    struct pnmea_cache_t *cache = NULL;
+    struct rmc_tail_t tail;
 
     tm.tm_mday = tm.tm_mon = tm.tm_year = tm.tm_hour = tm.tm_min = tm.tm_sec =
 	0;
@@ -94,6 +198,38 @@ static void gpsd_transit_fix_dump(struct gps_device_t *session,
     }
 #define ZEROIZE(x)	(isnan(x)!=0 ? 0.0 : x)
     /*@ -usedef @*/
+    if (session->gpsdata.dev.path[0] != '\0')
+	cache = pnmea_cache_slot(session->gpsdata.dev.path);
+    if (cache != NULL) {
+	memset(&tail, 0, sizeof(tail));
+	tail.speed = session->gpsdata.fix.speed;
+	tail.track = session->gpsdata.fix.track;
+	tail.mday = tm.tm_mday;
+	tail.mon = tm.tm_mon;
+	tail.year = tm.tm_year;
+	/* bytewise compare so NaNs count as equal */
+	if (cache->rmc_valid
+	    && memcmp(&tail, &cache->rmc_tail, sizeof(tail)) == 0) {
+	    char prefix[RMC_PREFIX_LEN + 8];
+
+	    (void)snprintf(prefix, sizeof(prefix),
+			   "$GPRMC,%02d%02d%02d,%c,%09.4f,%c,%010.4f,%c,",
+			   tm.tm_hour,
+			   tm.tm_min,
+			   tm.tm_sec,
+			   session->gpsdata.status ? 'A' : 'V',
+			   ZEROIZE(degtodm(fabs(session->gpsdata.fix.latitude))),
+			   ((session->gpsdata.fix.latitude > 0) ? 'N' : 'S'),
+			   ZEROIZE(degtodm(fabs(session->gpsdata.fix.longitude))),
+			   ((session->gpsdata.fix.longitude > 0) ? 'E' : 'W'));
+	    if (strlen(prefix) == (size_t)RMC_PREFIX_LEN) {
+		memcpy(cache->rmc, prefix, (size_t)RMC_PREFIX_LEN);
+		nmea_add_checksum(cache->rmc);
+		(void)strlcpy(bufp, cache->rmc, len);
+		return;
+	    }
+	}
+    }
     (void)snprintf(bufp, len,
 		   "$GPRMC,%02d%02d%02d,%c,%09.4f,%c,%010.4f,%c,%.4f,%.3f,%02d%02d%02d,,",
 		   tm.tm_hour,
@@ -108,8 +244,13 @@ static void gpsd_transit_fix_dump(struct gps_device_t *session,
 		   ZEROIZE(session->gpsdata.fix.track),
 		   tm.tm_mday, tm.tm_mon, tm.tm_year);
     /*@ +usedef @*/
-#undef ZEROIZE
     nmea_add_checksum(bufp);
+    if (cache != NULL && strlen(bufp) < sizeof(cache->rmc)) {
+	(void)strlcpy(cache->rmc, bufp, sizeof(cache->rmc));
+	cache->rmc_tail = tail;
+	cache->rmc_valid = true;
+    }
+#undef ZEROIZE
 }
 
 static void gpsd_binary_satellite_dump(struct gps_device_t *session,
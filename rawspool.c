@@ -0,0 +1,162 @@
+/****************************************************************************
+
+NAME
+   rawspool.c - mmap-backed raw packet archiving
+
+DESCRIPTION
+   Appends every accepted lexer frame for a device to a spool file
+mapped into memory, so archiving a packet is a memcpy into a page
+rather than a second daemon (gpspipe -R) pulling the same bytes back
+through a socket.  Records are a small binary header -- receive
+timestamp and frame length -- followed by the frame bytes.  When a
+segment fills it is rotated to a single .0 predecessor, so the spool
+holds at most two segments per device.  A segment is trimmed to its
+real length on rotation and shutdown; after a crash a reader should
+stop at the first zero-length record.
+
+PERMISSIONS
+   This file is Copyright (c) 2010 by the GPSD project
+   BSD terms apply: see the file COPYING in the distribution root for details.
+
+***************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef S_SPLINT_S
+#include <unistd.h>
+#endif /* S_SPLINT_S */
+
+#include "gpsd.h"
+
+#ifdef RAWSPOOL_ENABLE
+#include <sys/mman.h>
+#include <fcntl.h>
+
+#ifndef RAWSPOOL_SEGMENT_SIZE
+#define RAWSPOOL_SEGMENT_SIZE	(4 * 1024 * 1024)
+#endif
+
+struct rawspool_record_t
+/* on-disk record header; frame bytes follow immediately */
+{
+    double timestamp;		/* receive time, seconds since Unix epoch */
+    unsigned int length;	/* frame length in bytes; 0 = end of data */
+    unsigned int pad;
+};
+
+static bool rawspool_map(struct gps_device_t *session)
+/* create a fresh segment for this device and map it */
+{
+    void *base;
+
+    session->rawspool.fd = open(session->rawspool.path,
+				O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (session->rawspool.fd == -1) {
+	gpsd_report(LOG_ERROR, "rawspool: can't create %s: %s\n",
+		    session->rawspool.path, strerror(errno));
+	return false;
+    }
+    if (ftruncate(session->rawspool.fd,
+		  (off_t)RAWSPOOL_SEGMENT_SIZE) == -1) {
+	gpsd_report(LOG_ERROR, "rawspool: can't size %s: %s\n",
+		    session->rawspool.path, strerror(errno));
+	(void)close(session->rawspool.fd);
+	return false;
+    }
+    base = mmap(NULL, (size_t)RAWSPOOL_SEGMENT_SIZE,
+		PROT_READ | PROT_WRITE, MAP_SHARED,
+		session->rawspool.fd, (off_t)0);
+    if (base == MAP_FAILED) {
+	gpsd_report(LOG_ERROR, "rawspool: mmap of %s failed: %s\n",
+		    session->rawspool.path, strerror(errno));
+	(void)close(session->rawspool.fd);
+	return false;
+    }
+    session->rawspool.base = (char *)base;
+    session->rawspool.size = (size_t)RAWSPOOL_SEGMENT_SIZE;
+    session->rawspool.off = 0;
+    gpsd_report(LOG_PROG, "rawspool: spooling %s to %s\n",
+		session->gpsdata.dev.path, session->rawspool.path);
+    return true;
+}
+
+static void rawspool_unmap(struct gps_device_t *session)
+/* trim the segment to its written length and drop the mapping */
+{
+    (void)munmap((void *)session->rawspool.base, session->rawspool.size);
+    (void)ftruncate(session->rawspool.fd, (off_t)session->rawspool.off);
+    (void)close(session->rawspool.fd);
+    session->rawspool.base = NULL;
+}
+
+static bool rawspool_open(struct gps_device_t *session)
+/* start spooling a device; existing spool data rotates to .0 */
+{
+    const char *base = strrchr(session->gpsdata.dev.path, '/');
+    char oldpath[sizeof(session->rawspool.path) + 2];
+
+    (void)snprintf(session->rawspool.path, sizeof(session->rawspool.path),
+		   "%s/%s.rawspool",
+		   session->context->rawspool_dir,
+		   base != NULL ? base + 1 : session->gpsdata.dev.path);
+    (void)snprintf(oldpath, sizeof(oldpath), "%s.0",
+		   session->rawspool.path);
+    (void)rename(session->rawspool.path, oldpath);
+    return rawspool_map(session);
+}
+
+static bool rawspool_rotate(struct gps_device_t *session)
+/* full segment becomes the .0 predecessor; start a fresh one */
+{
+    char oldpath[sizeof(session->rawspool.path) + 2];
+
+    rawspool_unmap(session);
+    (void)snprintf(oldpath, sizeof(oldpath), "%s.0",
+		   session->rawspool.path);
+    (void)rename(session->rawspool.path, oldpath);
+    return rawspool_map(session);
+}
+
+void rawspool_write(struct gps_device_t *session,
+		    const char *buf, size_t len)
+/* append one accepted frame to the device's spool */
+{
+    struct rawspool_record_t record;
+    size_t need = sizeof(record) + len;
+
+    if (session->context->rawspool_dir == NULL || session->rawspool.failed)
+	return;
+    if (session->rawspool.base == NULL && !rawspool_open(session)) {
+	session->rawspool.failed = true;	/* don't retry every packet */
+	return;
+    }
+    if (need > session->rawspool.size)
+	return;		/* can't happen with sane segment sizes */
+    if (session->rawspool.off + need > session->rawspool.size
+	&& !rawspool_rotate(session)) {
+	session->rawspool.failed = true;
+	return;
+    }
+    record.timestamp = timestamp();
+    record.length = (unsigned int)len;
+    record.pad = 0;
+    memcpy(session->rawspool.base + session->rawspool.off,
+	   &record, sizeof(record));
+    memcpy(session->rawspool.base + session->rawspool.off + sizeof(record),
+	   buf, len);
+    session->rawspool.off += need;
+}
+
+void rawspool_close(struct gps_device_t *session)
+/* stop spooling a device */
+{
+    if (session->rawspool.base != NULL)
+	rawspool_unmap(session);
+    session->rawspool.failed = false;
+}
+
+#endif /* RAWSPOOL_ENABLE */
+
+/* end */
@@ -114,6 +114,7 @@ void gpsd_tty_init(struct gps_device_t *session)
     /* mark GPS fd closed and its baud rate unknown */
     session->gpsdata.gps_fd = -1;
     session->saved_baud = -1;
+    session->packet_hint = BAD_PACKET;
 #ifdef NTPSHM_ENABLE
     /* mark NTPD shared memory segments as unused */
     session->shmindex = -1;
@@ -178,36 +179,42 @@ bool gpsd_set_raw(struct gps_device_t * session)
     return true;
 }
 
-void gpsd_set_speed(struct gps_device_t *session,
-		    speed_t speed, char parity, unsigned int stopbits)
+static speed_t gpsd_speed_code(speed_t speed)
+/* map a numeric baud rate to its termios speed code */
 {
-    speed_t rate;
-
-    /*
-     * Yes, you can set speeds that aren't in the hunt loop.  If you
-     * do this, and you aren't on Linux where baud rate is preserved
-     * across port closings, you've screwed yourself. Don't do that!
-     */
     if (speed < 300)
-	rate = B0;
+	return B0;
     else if (speed < 1200)
-	rate = B300;
+	return B300;
     else if (speed < 2400)
-	rate = B1200;
+	return B1200;
     else if (speed < 4800)
-	rate = B2400;
+	return B2400;
     else if (speed < 9600)
-	rate = B4800;
+	return B4800;
     else if (speed < 19200)
-	rate = B9600;
+	return B9600;
     else if (speed < 38400)
-	rate = B19200;
+	return B19200;
     else if (speed < 57600)
-	rate = B38400;
+	return B38400;
     else if (speed < 115200)
-	rate = B57600;
+	return B57600;
     else
-	rate = B115200;
+	return B115200;
+}
+
+void gpsd_set_speed(struct gps_device_t *session,
+		    speed_t speed, char parity, unsigned int stopbits)
+{
+    speed_t rate;
+
+    /*
+     * Yes, you can set speeds that aren't in the hunt loop.  If you
+     * do this, and you aren't on Linux where baud rate is preserved
+     * across port closings, you've screwed yourself. Don't do that!
+     */
+    rate = gpsd_speed_code(speed);
 
     if (rate != cfgetispeed(&session->ttyset)
 	|| parity != session->gpsdata.dev.parity
@@ -298,8 +305,18 @@ void gpsd_set_speed(struct gps_device_t *session,
 	 * occasional failure to lock.
 	 */
 	(void)tcflush(session->gpsdata.gps_fd, TCIOFLUSH);
-	(void)usleep(200000);
-	(void)tcflush(session->gpsdata.gps_fd, TCIOFLUSH);
+	if (session->context->async_settle)
+	    /*
+	     * The daemon can't afford to sleep here -- it would stall
+	     * every connected client while a flaky device is probed.
+	     * Mark the settle deadline instead; gpsd_poll() defers
+	     * reading until it passes, then does the second flush.
+	     */
+	    session->settle_time = timestamp() + 0.200;
+	else {
+	    (void)usleep(200000);
+	    (void)tcflush(session->gpsdata.gps_fd, TCIOFLUSH);
+	}
     }
     gpsd_report(LOG_INF, "speed %u, %d%c%d\n",
 		gpsd_get_speed(&session->ttyset), 9 - stopbits, parity,
@@ -334,6 +351,142 @@ void gpsd_set_speed(struct gps_device_t *session,
     packet_reset(&session->packet);
 }
 
+/*
+ * Learned-protocol cache.  One line per device:
+ *
+ *	path baudrate parity stopbits packet-type
+ *
+ * Looking this up on open lets a warm restart reacquire a device at its
+ * last known line settings and packet type in one try instead of running
+ * the whole baud/protocol hunt; on a rack of receivers that cuts restart
+ * time from seconds per port to near zero.  Any failure here just means
+ * we fall back to hunting.  On systems where gpsd drops privileges the
+ * file must be writable by the daemon's user or updates will be skipped.
+ */
+
+#ifndef FIXED_PORT_SPEED
+/* every rate we're likely to see on a GPS, canonical hunt order */
+static const unsigned int hunt_ladder[MAX_HUNT_RATES] =
+    { 0, 4800, 9600, 19200, 38400, 57600, 115200 };
+
+static void gpsd_hunt_order(struct gps_device_t *session)
+/* build this session's speed ladder, most likely candidates first */
+{
+    char line[GPS_PATH_MAX + 40], cpath[GPS_PATH_MAX];
+    int baud, ptype;
+    char parity;
+    unsigned int stopbits;
+    unsigned int votes[MAX_HUNT_RATES];
+    unsigned int i, j;
+    FILE *fp;
+
+    memset(votes, 0, sizeof(votes));
+    /*
+     * Rack-mount concentrators tend to carry dozens of identical
+     * receivers.  Counting which speeds the protocol cache has seen
+     * lets a freshly plugged port try its neighbors' known-good rate
+     * before the long shots, instead of always climbing the ladder
+     * from the bottom at a character timeout per rung.
+     */
+    fp = fopen(PROTOCACHE_PATH, "r");
+    if (fp != NULL) {
+	while (fgets(line, (int)sizeof(line), fp) != NULL) {
+	    if (sscanf(line, "%63s %d %c %u %d",
+		       cpath, &baud, &parity, &stopbits, &ptype) != 5)
+		continue;
+	    for (i = 1; i < MAX_HUNT_RATES; i++)
+		if ((unsigned int)baud == hunt_ladder[i]) {
+		    votes[i]++;
+		    break;
+		}
+	}
+	(void)fclose(fp);
+    }
+
+    /* slot 0 stays "hold current speed" - that's the preset one */
+    session->hunt_rates[0] = hunt_ladder[0];
+    for (i = 1; i < MAX_HUNT_RATES; i++) {
+	unsigned int best = 0;
+	for (j = 1; j < MAX_HUNT_RATES; j++)
+	    if (votes[j] != (unsigned int)-1
+		&& (best == 0 || votes[j] > votes[best]))
+		best = j;
+	session->hunt_rates[i] = hunt_ladder[best];
+	votes[best] = (unsigned int)-1;
+    }
+}
+#endif /* FIXED_PORT_SPEED */
+
+static bool gpsd_protocache_lookup(struct gps_device_t *session)
+/* preset line parameters from the cache; returns true on a hit */
+{
+    char line[GPS_PATH_MAX + 40], cpath[GPS_PATH_MAX];
+    int baud, ptype;
+    char parity;
+    unsigned int stopbits;
+    bool hit = false;
+    FILE *fp = fopen(PROTOCACHE_PATH, "r");
+
+    if (fp == NULL)
+	return false;
+    while (fgets(line, (int)sizeof(line), fp) != NULL) {
+	if (sscanf(line, "%63s %d %c %u %d",
+		   cpath, &baud, &parity, &stopbits, &ptype) != 5)
+	    continue;
+	if (strcmp(cpath, session->gpsdata.dev.path) != 0)
+	    continue;
+	if (baud < 300 || (parity != 'N' && parity != 'O' && parity != 'E')
+	    || stopbits < 1 || stopbits > 2)
+	    break;
+	session->saved_baud = (int)gpsd_speed_code((speed_t)baud);
+	session->gpsdata.dev.parity = parity;
+	session->gpsdata.dev.stopbits = stopbits;
+	session->packet_hint = ptype;
+	gpsd_report(LOG_PROG, "%s: protocol cache hit: %d%c%u, type %d\n",
+		    session->gpsdata.dev.path, baud, parity, stopbits, ptype);
+	hit = true;
+	break;
+    }
+    (void)fclose(fp);
+    return hit;
+}
+
+static void gpsd_protocache_update(struct gps_device_t *session)
+/* record the synced line settings for the next restart */
+{
+    char line[GPS_PATH_MAX + 40], cpath[GPS_PATH_MAX];
+    FILE *ifp, *ofp;
+
+    /* regression-test ptys would only pollute the cache */
+    if (session->sourcetype == source_pty
+	|| isatty(session->gpsdata.gps_fd) == 0)
+	return;
+    ofp = fopen(PROTOCACHE_PATH ".tmp", "w");
+    if (ofp == NULL) {
+	gpsd_report(LOG_PROG, "can't update protocol cache %s: %s\n",
+		    PROTOCACHE_PATH, strerror(errno));
+	return;
+    }
+    ifp = fopen(PROTOCACHE_PATH, "r");
+    if (ifp != NULL) {
+	/* carry over everyone else's entries */
+	while (fgets(line, (int)sizeof(line), ifp) != NULL)
+	    if (sscanf(line, "%63s", cpath) == 1
+		&& strcmp(cpath, session->gpsdata.dev.path) != 0)
+		(void)fputs(line, ofp);
+	(void)fclose(ifp);
+    }
+    (void)fprintf(ofp, "%s %u %c %u %d\n",
+		  session->gpsdata.dev.path,
+		  gpsd_get_speed(&session->ttyset),
+		  session->gpsdata.dev.parity,
+		  session->gpsdata.dev.stopbits, session->packet.type);
+    (void)fclose(ofp);
+    if (rename(PROTOCACHE_PATH ".tmp", PROTOCACHE_PATH) != 0)
+	gpsd_report(LOG_PROG, "can't update protocol cache %s: %s\n",
+		    PROTOCACHE_PATH, strerror(errno));
+}
+
 int gpsd_serial_open(struct gps_device_t *session)
 /* open a device for access to its data */
 {
@@ -431,6 +584,9 @@ int gpsd_serial_open(struct gps_device_t *session)
     session->saved_baud = FIXED_PORT_SPEED;
 #endif
 
+    if (session->saved_baud == -1)
+	(void)gpsd_protocache_lookup(session);
+
     if (session->saved_baud != -1) {
 	/*@i@*/ (void)
 	    cfsetispeed(&session->ttyset, (speed_t) session->saved_baud);
@@ -467,6 +623,7 @@ int gpsd_serial_open(struct gps_device_t *session)
 
 #ifndef FIXED_PORT_SPEED
 	session->baudindex = 0;
+	gpsd_hunt_order(session);
 #endif /* FIXED_PORT_SPEED */
 	gpsd_set_speed(session, gpsd_get_speed(&session->ttyset_old), 'N', 1);
     }
@@ -475,7 +632,8 @@ int gpsd_serial_open(struct gps_device_t *session)
     return session->gpsdata.gps_fd;
 }
 
-ssize_t gpsd_write(struct gps_device_t * session, const char *buf, size_t len)
+static ssize_t gpsd_write1(struct gps_device_t *session,
+			   const char *buf, size_t len, bool drain)
 {
     ssize_t status;
     bool ok;
@@ -484,7 +642,8 @@ ssize_t gpsd_write(struct gps_device_t * session, const char *buf, size_t len)
 	return 0;
     status = write(session->gpsdata.gps_fd, buf, len);
     ok = (status == (ssize_t) len);
-    (void)tcdrain(session->gpsdata.gps_fd);
+    if (drain)
+	(void)tcdrain(session->gpsdata.gps_fd);
     /* extra guard prevents expensive hexdump calls */
     if (session->context->debug >= LOG_IO)
 	gpsd_report(LOG_IO, "=> GPS: %s%s\n",
@@ -492,6 +651,18 @@ ssize_t gpsd_write(struct gps_device_t * session, const char *buf, size_t len)
     return status;
 }
 
+ssize_t gpsd_write(struct gps_device_t * session, const char *buf, size_t len)
+{
+    return gpsd_write1(session, buf, len, true);
+}
+
+ssize_t gpsd_write_rtcm(struct gps_device_t * session, const char *buf, size_t len)
+/* ship a correction without waiting for the tty to drain; a slow or
+ * wedged port must not stall delivery to other attached receivers */
+{
+    return gpsd_write1(session, buf, len, false);
+}
+
 /*
  * This constant controls how long the packet sniffer will spend looking
  * for a packet leader before it gives up.  It *must* be larger than
@@ -503,23 +674,18 @@ ssize_t gpsd_write(struct gps_device_t * session, const char *buf, size_t len)
 bool gpsd_next_hunt_setting(struct gps_device_t * session)
 /* advance to the next hunt setting  */
 {
-#ifndef FIXED_PORT_SPEED
-    /* every rate we're likely to see on a GPS */
-    static unsigned int rates[] =
-	{ 0, 4800, 9600, 19200, 38400, 57600, 115200 };
-#endif /* FIXED_PORT_SPEED defined */
-
     /* don't waste time in the hunt loop if this is not actually a tty */
     if (isatty(session->gpsdata.gps_fd) == 0)
 	return false;
 
     if (session->packet.retry_counter++ >= SNIFF_RETRIES) {
 	session->packet.retry_counter = 0;
+	/* a cached or learned packet type may be stale; reopen the hunt */
+	packet_lock(&session->packet, 0);
 #ifdef FIXED_PORT_SPEED
 	return false;
 #else
-	if (session->baudindex++ >=
-	    (unsigned int)(sizeof(rates) / sizeof(rates[0])) - 1) {
+	if (session->baudindex++ >= (unsigned int)MAX_HUNT_RATES - 1) {
 	    session->baudindex = 0;
 #ifdef FIXED_STOP_BITS
 	    return false;	/* hunt is over, no sync */
@@ -533,7 +699,7 @@ bool gpsd_next_hunt_setting(struct gps_device_t * session)
 #ifdef FIXED_PORT_SPEED
 		       FIXED_PORT_SPEED,
 #else
-		       rates[session->baudindex],
+		       session->hunt_rates[session->baudindex],
 #endif /* FIXED_PORT_SPEED */
 		       session->gpsdata.dev.parity,
 #ifdef FIXED_STOP_BITS
@@ -558,6 +724,11 @@ void gpsd_assert_sync(struct gps_device_t *session)
      */
     if (session->saved_baud == -1)
 	session->saved_baud = (int)cfgetispeed(&session->ttyset);
+    if (session->packet.type > COMMENT_PACKET
+	&& session->packet.type != session->packet_hint) {
+	session->packet_hint = session->packet.type;
+	gpsd_protocache_update(session);
+    }
 }
 
 void gpsd_close(struct gps_device_t *session)
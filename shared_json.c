@@ -81,11 +81,13 @@ int json_watch_read(const char *buf,
 		    /*@out@*/ struct policy_t *ccp,
 		    /*@null@*/ const char **endptr)
 {
+    bool tpv = true, gst = true, sky = true, subframes = true;
+    bool attitude = true, rtcm2 = true, rtcm3 = true, ais = true;
     /*@ -fullinitblock @*/
     /* *INDENT-OFF* */
     struct json_attr_t chanconfig_attrs[] = {
 	{"class",          t_check,    .dflt.check = "WATCH"},
-	
+
 	{"enable",         t_boolean,  .addr.boolean = &ccp->watcher,
                                           .dflt.boolean = true},
 	{"json",           t_boolean,  .addr.boolean = &ccp->json,
@@ -96,6 +98,25 @@ int json_watch_read(const char *buf,
 	                                  .nodefault = true},
 	{"scaled",         t_boolean,  .addr.boolean = &ccp->scaled},
 	{"timing",         t_boolean,  .addr.boolean = &ccp->timing},
+	{"binary",         t_boolean,  .addr.boolean = &ccp->binary},
+	{"interval",       t_real,     .addr.real = &ccp->interval,
+                                          .dflt.real = 0.0},
+	{"tpv",            t_boolean,  .addr.boolean = &tpv,
+                                          .dflt.boolean = true},
+	{"gst",            t_boolean,  .addr.boolean = &gst,
+                                          .dflt.boolean = true},
+	{"sky",            t_boolean,  .addr.boolean = &sky,
+                                          .dflt.boolean = true},
+	{"subframes",      t_boolean,  .addr.boolean = &subframes,
+                                          .dflt.boolean = true},
+	{"attitude",       t_boolean,  .addr.boolean = &attitude,
+                                          .dflt.boolean = true},
+	{"rtcm2",          t_boolean,  .addr.boolean = &rtcm2,
+                                          .dflt.boolean = true},
+	{"rtcm3",          t_boolean,  .addr.boolean = &rtcm3,
+                                          .dflt.boolean = true},
+	{"ais",            t_boolean,  .addr.boolean = &ais,
+                                          .dflt.boolean = true},
 	{"device",         t_string,   .addr.string = ccp->devpath,
 	                                  .len = sizeof(ccp->devpath)},
 	{"remote",         t_string,   .addr.string = ccp->remote,
@@ -107,6 +128,30 @@ int json_watch_read(const char *buf,
     int status;
 
     status = json_read_object(buf, chanconfig_attrs, endptr);
+    if (status == 0) {
+	/*
+	 * Fold the per-class booleans into a mask the daemon can
+	 * test in one AND per report.  All classes default to on,
+	 * so an old-style WATCH yields the full set.
+	 */
+	ccp->classmask = 0;
+	if (tpv)
+	    ccp->classmask |= REPORT_IS;
+	if (gst)
+	    ccp->classmask |= GST_SET;
+	if (sky)
+	    ccp->classmask |= SATELLITE_SET;
+	if (subframes)
+	    ccp->classmask |= SUBFRAME_SET;
+	if (attitude)
+	    ccp->classmask |= ATTITUDE_SET;
+	if (rtcm2)
+	    ccp->classmask |= RTCM2_SET;
+	if (rtcm3)
+	    ccp->classmask |= RTCM3_SET;
+	if (ais)
+	    ccp->classmask |= AIS_SET;
+    }
     return status;
 }
 
@@ -32,11 +32,11 @@ bool shm_acquire(struct gps_context_t *context)
 {
     int shmid;
 
-    shmid = shmget((key_t)GPSD_KEY, sizeof(struct gps_data_t), (int)(IPC_CREAT|0666));
+    shmid = shmget((key_t)GPSD_KEY, sizeof(struct shmexport_t), (int)(IPC_CREAT|0666));
     if (shmid == -1) {
 	gpsd_report(LOG_ERROR, "shmget(%ld, %zd, 0666) failed: %s\n",
 		    (long int)GPSD_KEY, 
-		    sizeof(struct gps_data_t),
+		    sizeof(struct shmexport_t),
 		    strerror(errno));
 	return false;
     } 
@@ -57,6 +57,38 @@ void shm_release(struct gps_context_t *context)
 	(void)shmdt((const void *)context->shmexport);
 }
 
+static void shm_copy_live(volatile char *dst, struct gps_data_t *gpsdata)
+/* copy everything a reader may look at, skipping cold channel tails
+ *
+ * The satellite arrays are sized for MAXCHANNELS but only the leading
+ * satellites_used/satellites_visible entries are defined to be valid,
+ * and that is all any well-behaved reader dereferences.  An 8-satellite
+ * fix thus moves 8 channels' worth of sky data per epoch instead of 72;
+ * whatever tail entries the segment holds are simply left in place.
+ */
+{
+#define LIVE_SLICE(from, to) \
+	memcpy((void *)(dst + (from)), (char *)gpsdata + (from), (to) - (from))
+    size_t nused = (size_t)gpsdata->satellites_used;
+    size_t nvis = (size_t)gpsdata->satellites_visible;
+
+    if (nused > MAXCHANNELS)
+	nused = MAXCHANNELS;	/* catches negative counts too */
+    if (nvis > MAXCHANNELS)
+	nvis = MAXCHANNELS;
+    LIVE_SLICE(0, offsetof(struct gps_data_t, used) + nused * sizeof(int));
+    LIVE_SLICE(offsetof(struct gps_data_t, dop),
+	       offsetof(struct gps_data_t, PRN) + nvis * sizeof(int));
+    LIVE_SLICE(offsetof(struct gps_data_t, elevation),
+	       offsetof(struct gps_data_t, elevation) + nvis * sizeof(int));
+    LIVE_SLICE(offsetof(struct gps_data_t, azimuth),
+	       offsetof(struct gps_data_t, azimuth) + nvis * sizeof(int));
+    LIVE_SLICE(offsetof(struct gps_data_t, ss),
+	       offsetof(struct gps_data_t, ss) + nvis * sizeof(double));
+    LIVE_SLICE(offsetof(struct gps_data_t, dev), sizeof(struct gps_data_t));
+#undef LIVE_SLICE
+}
+
 void shm_update(struct gps_context_t *context, struct gps_data_t *gpsdata)
 /* export an update to all listeners */
 {
@@ -64,24 +96,40 @@ void shm_update(struct gps_context_t *context, struct gps_data_t *gpsdata)
     {
 	static int tick;
 	volatile struct shmexport_t *shared = (struct shmexport_t *)context->shmexport;
+	bool fixonly, first;
 
-	++tick;
 	/*
-	 * Following block of instructions must not be reordered, otherwise 
-	 * havoc will ensue.  asm volatile("sfence") is a GCCism intended
-	 * to prevent reordering.
+	 * Orthodox seqlock.  The counter is bumped to an odd value
+	 * before the data is touched and to an even one afterward; a
+	 * reader that sees an odd count, or different counts around
+	 * its copy, knows it raced the writer and must discard.  The
+	 * barrier() calls keep the counter updates from being
+	 * reordered with the data writes.
 	 *
-	 * This is a simple optimistic-concurrency technique.  We write
-	 * the second bookend first, then the data, then the first bookend.
-	 * Reader copies what it sees in normal order; that way, if we
-	 * start to write the segment during the read, the second bookend will
-	 * get clobbered first and the data can be detected as bad.
+	 * When the update only changed TPV-class data, just the
+	 * leading fix slice (and the tag) is rewritten, and full_seq
+	 * is left alone so readers know the rest of their last full
+	 * copy is still good.
 	 */
-	shared->bookend2 = tick;
+	first = (tick == 0);
+	fixonly = !first && (gpsdata->set & ~(gps_mask_t)FIX_CLASS_SET) == 0;
+	shared->seq = ++tick;		/* odd: write in progress */
 	barrier();
-	memcpy((void *)(context->shmexport + offsetof(struct shmexport_t, gpsdata)),
-	       (void *)gpsdata,
-	       sizeof(struct gps_data_t)); 
+	if (fixonly) {
+	    memcpy((void *)(context->shmexport + offsetof(struct shmexport_t, gpsdata)),
+		   (void *)gpsdata,
+		   FIX_SLICE_LENGTH);
+	    memcpy((void *)shared->gpsdata.tag,
+		   (void *)gpsdata->tag,
+		   sizeof(shared->gpsdata.tag));
+	} else if (first)
+	    /* first update: populate the whole segment, tails and all */
+	    memcpy((void *)(context->shmexport + offsetof(struct shmexport_t, gpsdata)),
+		   (void *)gpsdata,
+		   sizeof(struct gps_data_t));
+	else
+	    shm_copy_live(context->shmexport
+			  + offsetof(struct shmexport_t, gpsdata), gpsdata);
 	barrier();
 #ifndef USE_QT
 	shared->gpsdata.gps_fd = -1;
@@ -89,7 +137,36 @@ void shm_update(struct gps_context_t *context, struct gps_data_t *gpsdata)
 	shared->gpsdata.gps_fd = (void *)(intptr_t)-1;
 #endif /* USE_QT */
 	barrier();
-	shared->bookend1 = tick;
+	if (!fixonly)
+	    shared->full_seq = tick + 1;
+	barrier();
+	shared->seq = ++tick;		/* even again: consistent */
+
+	/*
+	 * Publish the epoch to the ring as well.  Each slot has its
+	 * own seqlock so a slow reader copying an old slot can detect
+	 * being lapped; ring_head moves only after the slot is
+	 * consistent.
+	 */
+	{
+	    unsigned int head = shared->ring_head;
+	    volatile struct shm_ring_slot_t *slot =
+		&shared->ring[head % SHM_RING_SLOTS];
+
+	    slot->seq |= 1;		/* odd: slot being rewritten */
+	    barrier();
+	    shm_copy_live((volatile char *)&slot->gpsdata, gpsdata);
+#ifndef USE_QT
+	    slot->gpsdata.gps_fd = -1;
+#else
+	    slot->gpsdata.gps_fd = (void *)(intptr_t)-1;
+#endif /* USE_QT */
+	    slot->epoch = head;
+	    barrier();
+	    slot->seq = (slot->seq | 1) + 1;	/* even: consistent */
+	    barrier();
+	    shared->ring_head = head + 1;
+	}
     }
 }
 
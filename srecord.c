@@ -28,6 +28,8 @@
  */
 #define MAX_BYTES_PER_RECORD	16
 
+static const char hexchar[17] = "0123456789ABCDEF";
+
 /*
  * bin2srec: turn a chunk of binary into an S-record
  * offset: used to specify load address
@@ -38,19 +40,32 @@ int
 bin2srec(unsigned int type, unsigned int offset, unsigned int num,
 	 unsigned char *bbuf, unsigned char *sbuf)
 {
-    unsigned char abuf[MAX_BYTES_PER_RECORD * 2 + 2], sum;
+    unsigned char abuf[MAX_BYTES_PER_RECORD * 2 + 2];
+    unsigned int i, sum;
     size_t len;
 
     if ((num < 1) || (num > MAX_BYTES_PER_RECORD))
 	return -1;
 
     len = (size_t) (4 + num + 1);
-    memset(abuf, 0, sizeof(abuf));
-    hexdump((size_t) num, bbuf, abuf);
-    sum = sr_sum((unsigned int)len, offset, bbuf);
+    /*
+     * One pass over the payload: hex-expand through the lookup table
+     * and accumulate the checksum as we go, instead of a nibble
+     * switch per character plus a second walk in sr_sum().  Firmware
+     * uploads push megabytes through here.
+     */
+    sum = (unsigned int)len + (offset & 0xff) + ((offset >> 8) & 0xff)
+	+ ((offset >> 16) & 0xff) + ((offset >> 24) & 0xff);
+    for (i = 0; i < num; i++) {
+	abuf[i * 2] = (unsigned char)hexchar[(bbuf[i] & 0xf0) >> 4];
+	abuf[i * 2 + 1] = (unsigned char)hexchar[bbuf[i] & 0x0f];
+	sum += bbuf[i];
+    }
+    abuf[num * 2] = '\0';
     (void)snprintf((char *)sbuf, MAX_BYTES_PER_RECORD * 2 + 17,
 		   "S%u%02X%08X%s%02X\r\n",
-		   type, (unsigned)len, offset, (char *)abuf, (unsigned)sum);
+		   type, (unsigned)len, offset, (char *)abuf,
+		   (unsigned)(unsigned char)~sum);
     return 0;
 }
 
@@ -82,37 +97,15 @@ void hexdump(size_t len, unsigned char *bbuf, unsigned char *abuf)
 	len = MAX_BYTES_PER_RECORD * 2;
 
     for (i = 0; i < len; i++) {
-	abuf[i * 2] = hc((bbuf[i] & 0xf0) >> 4);
-	abuf[i * 2 + 1] = hc(bbuf[i] & 0x0f);
+	abuf[i * 2] = (unsigned char)hexchar[(bbuf[i] & 0xf0) >> 4];
+	abuf[i * 2 + 1] = (unsigned char)hexchar[bbuf[i] & 0x0f];
     }
 }
 
 /*@ -type @*/
 unsigned char hc(unsigned char x)
 {
-    switch (x) {
-    case 15:
-    case 14:
-    case 13:
-    case 12:
-    case 11:
-    case 10:
-	return ('A' + x - 10);
-    case 9:
-    case 8:
-    case 7:
-    case 6:
-    case 5:
-    case 4:
-    case 3:
-    case 2:
-    case 1:
-    case 0:
-	return ('0' + x);
-
-    default:
-	return '0';
-    }
+    return (unsigned char)hexchar[x & 0x0f];
 }
 
 /*@ -type @*/
@@ -4,6 +4,7 @@
  * BSD terms apply: see the file COPYING in the distribution root for details.
  */
 #include <math.h>
+#include <string.h>
 
 #include "gpsd.h"
 
@@ -43,10 +44,11 @@ gps_mask_t gpsd_interpret_subframe_raw(struct gps_device_t *session,
      * word is inverted.
      *
      */
-    gpsd_report(LOG_IO, "50B: gpsd_interpret_subframe_raw: "
-		"%08x %08x %08x %08x %08x %08x %08x %08x %08x %08x\n",
-		words[0], words[1], words[2], words[3], words[4],
-		words[5], words[6], words[7], words[8], words[9]);
+    if (session->context->debug >= LOG_IO)
+	gpsd_report(LOG_IO, "50B: gpsd_interpret_subframe_raw: "
+		    "%08x %08x %08x %08x %08x %08x %08x %08x %08x %08x\n",
+		    words[0], words[1], words[2], words[3], words[4],
+		    words[5], words[6], words[7], words[8], words[9]);
 
     preamble = (uint8_t)((words[0] >> 22) & 0xFF);
     if (preamble == 0x8b) {	/* preamble is inverted */
@@ -162,11 +164,12 @@ gps_mask_t gpsd_interpret_subframe(struct gps_device_t *session,
     uint8_t preamble;
     int i = 0;   /* handy loop counter */
     struct subframe_t *subp = &session->gpsdata.subframe;
-    gpsd_report(LOG_IO,
-		"50B: gpsd_interpret_subframe: (%d) "
-		"%06x %06x %06x %06x %06x %06x %06x %06x %06x %06x\n",
-		tSVID, words[0], words[1], words[2], words[3], words[4],
-		words[5], words[6], words[7], words[8], words[9]);
+    if (session->context->debug >= LOG_IO)
+	gpsd_report(LOG_IO,
+		    "50B: gpsd_interpret_subframe: (%d) "
+		    "%06x %06x %06x %06x %06x %06x %06x %06x %06x %06x\n",
+		    tSVID, words[0], words[1], words[2], words[3], words[4],
+		    words[5], words[6], words[7], words[8], words[9]);
 
     preamble = (uint8_t)((words[0] >> 16) & 0x0FF);
     if (preamble == 0x8b) {
@@ -201,6 +204,38 @@ gps_mask_t gpsd_interpret_subframe(struct gps_device_t *session,
     subp->data_id = (words[2] >> 22) & 0x3;      /* only in frames 4 & 5 */
     subp->is_almanac = 0;
 
+    /*
+     * The ephemeris subframes repeat verbatim every 30 seconds until
+     * their IODC/IODE rolls, and the almanac pages every 12.5 minutes;
+     * when the data words match what we already decoded from this key,
+     * don't redo the field extraction and the reporting for it.
+     */
+    {
+	uint32_t *cachep = NULL;
+
+	if (subp->subframe_num >= 1 && subp->subframe_num <= 3) {
+	    if (tSVID < 33)
+		cachep = session->eph_cache[tSVID][subp->subframe_num - 1];
+	} else if (subp->subframe_num == 4 || subp->subframe_num == 5) {
+	    /*
+	     * The transmitting SV is part of the key; the same almanac
+	     * page relayed by different satellites must be reported
+	     * once for each of them.
+	     */
+	    if (tSVID < 33 && subp->pageid < 64)
+		cachep = session->alm_cache[tSVID][subp->subframe_num - 4][subp->pageid];
+	}
+	if (cachep != NULL) {
+	    if (memcmp(cachep, &words[2], 8 * sizeof(uint32_t)) == 0) {
+		gpsd_report(LOG_PROG,
+			    "50B: SF:%d SV:%2u page %u repeats held data\n",
+			    subp->subframe_num, subp->tSVID, subp->pageid);
+		return 0;
+	    }
+	    memcpy(cachep, &words[2], 8 * sizeof(uint32_t));
+	}
+    }
+
     switch (subp->subframe_num) {
     case 1:
 	/* subframe 1: clock parameters for transmitting SV */
@@ -202,5 +202,54 @@ int main(void)
 		     res == up->expected ? "succeeded" : "FAILED");
     }
 
+    (void)printf("Testing the bit cursor against ubits()/sbits():\n");
+    {
+	struct bits_cursor_t bc;
+	unsigned int start, width;
+	int failures = 0;
+
+	/* random access must agree with ubits()/sbits() everywhere */
+	bits_cursor_open(&bc, buf, 0);
+	for (start = 0; start < 40; start++)
+	    for (width = 1; width <= 57 && start + width <= 64; width++) {
+		if (bits_cursor_uget(&bc, start, width)
+		    != ubits((char *)buf, start, width)) {
+		    (void)printf("bits_cursor_uget(%u, %u) FAILED\n",
+				 start, width);
+		    failures++;
+		}
+		if (bits_cursor_sget(&bc, start, width)
+		    != sbits((char *)buf, start, width)) {
+		    (void)printf("bits_cursor_sget(%u, %u) FAILED\n",
+				 start, width);
+		    failures++;
+		}
+	    }
+
+	/* sequential takes must walk the same stream */
+	for (width = 1; width <= 13; width++) {
+	    bits_cursor_open(&bc, buf, 0);
+	    for (start = 0; start + width <= 64; start += width) {
+		if (bits_cursor_utake(&bc, width)
+		    != ubits((char *)buf, start, width)) {
+		    (void)printf("bits_cursor_utake(%u) at %u FAILED\n",
+				 width, start);
+		    failures++;
+		}
+	    }
+	    bits_cursor_open(&bc, buf, 0);
+	    for (start = 0; start + width <= 64; start += width) {
+		if (bits_cursor_stake(&bc, width)
+		    != sbits((char *)buf, start, width)) {
+		    (void)printf("bits_cursor_stake(%u) at %u FAILED\n",
+				 width, start);
+		    failures++;
+		}
+	    }
+	}
+	(void)printf("bit cursor %s\n",
+		     failures == 0 ? "succeeded" : "FAILED");
+    }
+
     exit(0);
 }
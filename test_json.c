@@ -206,6 +206,17 @@ static const struct json_attr_t json_attrs_8[] = {
     {"foe",  t_integer, .addr.integer = &foe, .map=enum_table},
     {NULL},
 };
+
+/* Case 9: test borrowed string views into a writable buffer */
+
+static char json_str9[] = "{\"name\":\"Foo\\\"bar\",\"other\":\"plain\"}";
+
+static const char *nameview, *otherview;
+static const struct json_attr_t json_attrs_9[] = {
+    {"name",  t_observer, .addr.observer = &nameview},
+    {"other", t_observer, .addr.observer = &otherview},
+    {NULL},
+};
 /*@ +fullinitblock @*/
 /* *INDENT-ON* */
 
@@ -303,6 +314,14 @@ int main(int argc UNUSED, char *argv[]UNUSED)
     assert_integer("fie", fie, 6);
     assert_integer("foe", foe, 14);
 
+    status = json_read_object(json_str9, json_attrs_9, NULL);
+    assert_case(9, status);
+    assert(nameview != NULL && strcmp(nameview, "Foo\"bar") == 0);
+    assert(otherview != NULL && strcmp(otherview, "plain") == 0);
+    /* views borrow the parse buffer rather than copying out of it */
+    assert(nameview > json_str9
+	   && otherview < json_str9 + sizeof(json_str9));
+
     (void)fprintf(stderr, "succeeded.\n");
 
     exit(0);
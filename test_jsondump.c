@@ -0,0 +1,193 @@
+/* test_jsondump.c - microbenchmark for the JSON report generators
+ *
+ * Loads canned fixtures and times each json_*_dump() function in
+ * isolation, reporting ns/report and reports/s so encoding regressions
+ * show up here instead of in production flamegraphs.
+ *
+ * This file is Copyright (c) 2010 by the GPSD project
+ * BSD terms apply: see the file COPYING in the distribution root for details.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <getopt.h>
+
+#include "gpsd.h"
+#include "gps_json.h"
+
+static int verbose = 0;
+
+void gpsd_report(int errlevel, const char *fmt, ...)
+/* assemble command in printf(3) style, use stderr or syslog */
+{
+    if (errlevel <= verbose) {
+	char buf[BUFSIZ];
+	va_list ap;
+
+	buf[0] = '\0';
+	va_start(ap, fmt);
+	(void)vsnprintf(buf + strlen(buf), sizeof(buf) - strlen(buf), fmt,
+			ap);
+	va_end(ap);
+
+	(void)fputs(buf, stderr);
+    }
+}
+
+static struct gps_data_t fixdata;
+
+/*
+ * Real-looking AIVDM sentences; a type 1 position report and a type 5
+ * static-voyage pair, the two classes that dominate coastal feeds.
+ */
+static const char *aivdm_fixtures[] = {
+    "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C\r\n",
+    "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C\r\n",
+    "!AIVDM,2,2,1,A,88888888880,2*25\r\n",
+};
+
+static void load_fixtures(void)
+/* build a plausible 3D fix with a 12-satellite skyview */
+{
+    int i;
+
+    memset(&fixdata, 0, sizeof(fixdata));
+    (void)strlcpy(fixdata.dev.path, "/dev/ttyUSB0",
+		  sizeof(fixdata.dev.path));
+    (void)strlcpy(fixdata.tag, "MID2", sizeof(fixdata.tag));
+    fixdata.fix.time = 1260000000.5;
+    fixdata.fix.mode = MODE_3D;
+    fixdata.fix.ept = 0.005;
+    fixdata.fix.latitude = 40.035093;
+    fixdata.fix.epy = 15.319;
+    fixdata.fix.longitude = -75.519748;
+    fixdata.fix.epx = 17.054;
+    fixdata.fix.altitude = 124.533;
+    fixdata.fix.epv = 35.316;
+    fixdata.fix.track = 99.4319;
+    fixdata.fix.epd = NAN;
+    fixdata.fix.speed = 0.091;
+    fixdata.fix.eps = 34.11;
+    fixdata.fix.climb = -0.085;
+    fixdata.fix.epc = NAN;
+    fixdata.skyview_time = 1260000000.5;
+    fixdata.satellites_visible = 12;
+    fixdata.satellites_used = 8;
+    for (i = 0; i < fixdata.satellites_visible; i++) {
+	fixdata.PRN[i] = 2 + i * 3;
+	fixdata.elevation[i] = 10 + (i * 7) % 80;
+	fixdata.azimuth[i] = (i * 31) % 360;
+	fixdata.ss[i] = (double)(20 + (i * 5) % 30);
+    }
+    for (i = 0; i < fixdata.satellites_used; i++)
+	fixdata.used[i] = fixdata.PRN[i];
+    fixdata.dop.xdop = 1.61;
+    fixdata.dop.ydop = 1.72;
+    fixdata.dop.pdop = 2.26;
+    fixdata.dop.hdop = 1.38;
+    fixdata.dop.vdop = 1.79;
+    fixdata.dop.tdop = 2.5;
+    fixdata.dop.gdop = 3.37;
+    fixdata.epe = 32.32;
+}
+
+static void report(const char *name, int reps, double elapsed,
+		   const char *sample)
+{
+    (void)printf("%-22s %8.0f ns/report %10.0f reports/s  (%zu bytes)\n",
+		 name, elapsed * 1e9 / reps, reps / elapsed,
+		 strlen(sample));
+}
+
+/* bench the common prologue: the timed call must leave output in buf */
+#define BENCH(name, call)					\
+    do {							\
+	int i_;							\
+	double started_ = timestamp();				\
+	for (i_ = 0; i_ < reps; i_++) {				\
+	    call;						\
+	}							\
+	report(name, reps, timestamp() - started_, buf);	\
+    } while (0)
+
+static void json_benchmark(int reps)
+{
+    char buf[GPS_JSON_RESPONSE_MAX * 2];
+    struct policy_t policy;
+    static struct aivdm_context_t ctx[AIVDM_CHANNELS];
+    struct ais_t ais1, ais5;
+    unsigned int n;
+    bool got1 = false, got5 = false;
+
+    load_fixtures();
+    memset(&policy, 0, sizeof(policy));
+    policy.watcher = true;
+    policy.json = true;
+    policy.scaled = true;
+
+    BENCH("json_tpv_dump", json_tpv_dump(&fixdata, buf, sizeof(buf)));
+    /* invalidate the sky cache each pass so rendering is measured */
+    BENCH("json_sky_dump",
+	  (fixdata.ss[0] += 1.0,
+	   json_sky_dump(&fixdata, buf, sizeof(buf))));
+    BENCH("json_sky_dump/cached", json_sky_dump(&fixdata, buf, sizeof(buf)));
+    fixdata.gst.utctime = 1260000000.5;
+    fixdata.gst.rms_deviation = 1.5;
+    fixdata.gst.smajor_deviation = 2.1;
+    fixdata.gst.sminor_deviation = 1.1;
+    fixdata.gst.smajor_orientation = 22.5;
+    fixdata.gst.lat_err_deviation = 1.3;
+    fixdata.gst.lon_err_deviation = 1.2;
+    fixdata.gst.alt_err_deviation = 2.1;
+    BENCH("json_noise_dump", json_noise_dump(&fixdata, buf, sizeof(buf)));
+    BENCH("json_watch_dump", json_watch_dump(&policy, buf, sizeof(buf)));
+    BENCH("json_version_dump", json_version_dump(buf, sizeof(buf)));
+
+    for (n = 0; n < (unsigned int)NITEMS(aivdm_fixtures); n++) {
+	struct ais_t decoded;
+
+	if (aivdm_decode(aivdm_fixtures[n], strlen(aivdm_fixtures[n]),
+			 ctx, &decoded, 0)) {
+	    if (decoded.type == 1) {
+		ais1 = decoded;
+		got1 = true;
+	    } else if (decoded.type == 5) {
+		ais5 = decoded;
+		got5 = true;
+	    }
+	}
+    }
+    if (got1)
+	BENCH("json_aivdm_dump/t1",
+	      json_aivdm_dump(&ais1, NULL, true, buf, sizeof(buf)));
+    if (got5) {
+	BENCH("json_aivdm_dump/t5",
+	      json_aivdm_dump(&ais5, NULL, true, buf, sizeof(buf)));
+	BENCH("json_aivdm_dump/t5raw",
+	      json_aivdm_dump(&ais5, NULL, false, buf, sizeof(buf)));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int option;
+    int reps = 1000000;
+
+    while ((option = getopt(argc, argv, "hn:?")) != -1) {
+	switch (option) {
+	case 'n':
+	    reps = atoi(optarg);
+	    break;
+	case '?':
+	case 'h':
+	default:
+	    (void)fputs("usage: test_jsondump [-n reps]\n", stderr);
+	    exit(1);
+	}
+    }
+
+    json_benchmark(reps);
+    exit(0);
+}
@@ -27,22 +27,93 @@ static void onsig(int sig)
 /* must start zeroed, otherwise the unit test will try to chase garbage pointer fields. */
 static struct gps_data_t gpsdata;
 
+#define BENCH_MAX_LINES	4096
+
+static void unpack_benchmark(const char *filename, int reps)
+/* replay a canned response corpus through gps_unpack(), report throughput */
+{
+    static char *corpus[BENCH_MAX_LINES];
+    static size_t lens[BENCH_MAX_LINES];
+    char line[BUFSIZ], buf[BUFSIZ];
+    unsigned long total = 0, errors = 0;
+    size_t bytes = 0;
+    timestamp_t started, elapsed;
+    int nlines = 0, i, rep;
+    FILE *fp = fopen(filename, "r");
+
+    if (fp == NULL) {
+	(void)fprintf(stderr, "test_libgps: can't read %s\n", filename);
+	exit(1);
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+	if (line[0] != '{' && !isalpha((unsigned char)line[0]))
+	    continue;		/* comments and blank lines */
+	if (nlines >= BENCH_MAX_LINES) {
+	    (void)fprintf(stderr, "test_libgps: %s has too many lines\n",
+			  filename);
+	    exit(1);
+	}
+	lens[nlines] = strlen(line);
+	corpus[nlines] = strdup(line);
+	if (corpus[nlines] == NULL) {
+	    (void)fputs("test_libgps: out of memory\n", stderr);
+	    exit(1);
+	}
+	bytes += lens[nlines];
+	nlines++;
+    }
+    (void)fclose(fp);
+    if (nlines == 0) {
+	(void)fprintf(stderr, "test_libgps: no responses in %s\n", filename);
+	exit(1);
+    }
+
+    /* the copy into buf is part of the measured cost, as in real reads */
+    started = timestamp();
+    for (rep = 0; rep < reps; rep++)
+	for (i = 0; i < nlines; i++) {
+	    memcpy(buf, corpus[i], lens[i] + 1);
+	    if (gps_unpack(buf, &gpsdata) < 0)
+		errors++;
+	    total++;
+	}
+    elapsed = timestamp() - started;
+
+    (void)printf("%s: %.2f MB in %.3f sec = %.2f MB/s, %lu reports (%.0f/s)\n",
+		 filename,
+		 (double)bytes * reps / 1e6, elapsed,
+		 (double)bytes * reps / 1e6 / elapsed,
+		 total, (double)total / elapsed);
+    if (errors > 0)
+	(void)printf("    %lu reports failed to unpack\n", errors);
+    for (i = 0; i < nlines; i++)
+	free(corpus[i]);
+}
+
 int main(int argc, char *argv[])
 {
     struct gps_data_t collect;
     char buf[BUFSIZ];
     int option;
     bool batchmode = false;
+    char *bench = NULL;
+    int reps = 1000;
     int debug = 0;
 
     (void)signal(SIGSEGV, onsig);
     (void)signal(SIGBUS, onsig);
 
-    while ((option = getopt(argc, argv, "bhsD:?")) != -1) {
+    while ((option = getopt(argc, argv, "bB:hn:sD:?")) != -1) {
 	switch (option) {
 	case 'b':
 	    batchmode = true;
 	    break;
+	case 'B':
+	    bench = optarg;
+	    break;
+	case 'n':
+	    reps = atoi(optarg);
+	    break;
 	case 's':
 	    (void)
 		printf
@@ -60,13 +131,16 @@ int main(int argc, char *argv[])
 	case '?':
 	case 'h':
 	default:
-	    (void)fputs("usage: test_libgps [-b] [-D lvl] [-s]\n", stderr);
+	    (void)fputs("usage: test_libgps [-b] [-B file] [-n reps] [-D lvl] [-s]\n",
+			stderr);
 	    exit(1);
 	}
     }
 
     gps_enable_debug(debug, stdout);
-    if (batchmode) {
+    if (bench != NULL) {
+	unpack_benchmark(bench, reps);
+    } else if (batchmode) {
 	while (fgets(buf, sizeof(buf), stdin) != NULL) {
 	    if (buf[0] == '{' || isalpha(buf[0])) {
 		gps_unpack(buf, &gpsdata);
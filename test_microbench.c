@@ -0,0 +1,139 @@
+/* microbenchmarks for the utility kernels
+ *
+ * Times ubits()/sbits(), the bits.h accessor macros, crc24q_hash(),
+ * wgs84_separation(), earth_distance()/earth_distance_fast() and
+ * safe_atof() over realistic inputs, reporting cycles and throughput
+ * per operation.  The correctness of these kernels is covered by
+ * test_bits, test_geoid and friends; this harness exists so changes
+ * to them can be accepted or rejected on numbers.
+ *
+ * This file is Copyright (c) 2010 by the GPSD project
+ * BSD terms apply: see the file COPYING in the distribution root for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "gpsd.h"
+#include "bits.h"
+#include "crc24q.h"
+
+#define DATA_LEN	1024
+#define SAMPLES		256
+
+static unsigned char data[DATA_LEN];
+static volatile uint64_t sink;
+static volatile double dsink;
+
+static uint64_t cycle_counter(void)
+/* cycle counter where the hardware offers one, nanoseconds elsewhere */
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int lo, hi;
+
+    __asm__ __volatile__("rdtsc":"=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void report(const char *name, uint64_t ticks, double seconds,
+		   unsigned long ops)
+{
+    (void)printf("%-24s %8.2f %s/op  %10.1f ns/op  %8.2f Mops/s\n",
+		 name, (double)ticks / ops,
+#if defined(__x86_64__) || defined(__i386__)
+		 "cycles",
+#else
+		 "ns    ",
+#endif
+		 seconds * 1e9 / ops, ops / seconds / 1e6);
+}
+
+static double walltime(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#define BENCH(name, reps, body) \
+    do { \
+	unsigned long r; \
+	uint64_t t0; \
+	double w0; \
+	w0 = walltime(); \
+	t0 = cycle_counter(); \
+	for (r = 0; r < (reps); r++) { body; } \
+	report(name, cycle_counter() - t0, walltime() - w0, (reps)); \
+    } while (0)
+
+int main(void)
+{
+    unsigned int starts[SAMPLES], widths[SAMPLES];
+    /* the shapes NMEA and our JSON feeds actually ship */
+    static const char *fields[8] = {
+	"4124.8963", "-121.93", "0.5", "225.4",
+	"12", "-0.031", "1665.425", "46.9",
+    };
+    unsigned int seed = 12345;
+    int i;
+
+    for (i = 0; i < DATA_LEN; i++) {
+	seed = seed * 1103515245 + 12345;
+	data[i] = (unsigned char)(seed >> 16);
+    }
+    /* field shapes typical of AIS/subframe decoding */
+    for (i = 0; i < SAMPLES; i++) {
+	seed = seed * 1103515245 + 12345;
+	starts[i] = (seed >> 16) % ((DATA_LEN - 8) * 8);
+	seed = seed * 1103515245 + 12345;
+	widths[i] = 1 + (seed >> 16) % 30;
+    }
+
+    BENCH("ubits", 20000000UL,
+	  sink += ubits((char *)data,
+			starts[r % SAMPLES], widths[r % SAMPLES]));
+    BENCH("sbits", 20000000UL,
+	  sink += (uint64_t)sbits((char *)data,
+				  starts[r % SAMPLES], widths[r % SAMPLES]));
+    BENCH("getbeu16", 50000000UL,
+	  sink += getbeu16(data, r % (DATA_LEN - 2)));
+    BENCH("getbeu32", 50000000UL,
+	  sink += getbeu32(data, r % (DATA_LEN - 4)));
+    BENCH("getbeu64", 50000000UL,
+	  sink += getbeu64(data, r % (DATA_LEN - 8)));
+    BENCH("getleu32", 50000000UL,
+	  sink += getleu32(data, r % (DATA_LEN - 4)));
+    BENCH("crc24q_hash/1KB", 100000UL,
+	  sink += crc24q_hash(data, DATA_LEN));
+    /* stationary receiver: every call hits the cached cell */
+    BENCH("wgs84_separation/still", 10000000UL,
+	  dsink += wgs84_separation(37.371192, -122.014965));
+    /* roaming: walk the cell cache out from under itself */
+    BENCH("wgs84_separation/roam", 2000000UL,
+	  dsink += wgs84_separation(((double)(r % 177) - 88.0),
+				    ((double)(r % 355) - 177.0)));
+    BENCH("earth_distance", 200000UL,
+	  dsink += earth_distance(40.0, -75.0,
+				  40.0 + (double)(r % 100) * 0.008,
+				  -75.0 + (double)(r % 100) * 0.008));
+    BENCH("earth_distance_fast", 2000000UL,
+	  dsink += earth_distance_fast(40.0, -75.0,
+				       40.0 + (double)(r % 100) * 0.008,
+				       -75.0 + (double)(r % 100) * 0.008));
+    BENCH("safe_atof", 10000000UL, dsink += safe_atof(fields[r % 8]));
+
+    /* shut up, compiler */
+    (void)fprintf(stderr, "# checksums: %llu %f\n",
+		  (unsigned long long)sink, (double)dsink);
+    return 0;
+}
@@ -316,20 +316,120 @@ static void runon_test(struct map *mp)
     /*@ +compdef +uniondef +usedef +formatcode @*/
 }
 
+static void packet_benchmark(const char *filename, int reps)
+/* replay a whole capture through the lexer and report throughput */
+{
+    static const char *typenames[] = {
+	"BAD", "COMMENT", "NMEA", "AIVDM", "GARMINTXT", "SIRF", "ZODIAC",
+	"TSIP", "EVERMORE", "ITALK", "GARMIN", "NAVCOM", "UBX",
+	"SUPERSTAR2", "ONCORE", "GEOSTAR", "RTCM2", "RTCM3", "JSON",
+    };
+    unsigned long counts[sizeof(typenames) / sizeof(typenames[0])];
+    struct gps_packet_t packet;
+    unsigned long total = 0;
+    unsigned char *corpus;
+    size_t corpuslen, i;
+    long filelen;
+    timestamp_t started, elapsed;
+    int rep;
+    FILE *fp = fopen(filename, "rb");
+
+    if (fp == NULL || fseek(fp, 0L, SEEK_END) != 0
+	|| (filelen = ftell(fp)) <= 0) {
+	(void)fprintf(stderr, "test_packet: can't read %s\n", filename);
+	exit(1);
+    }
+    corpuslen = (size_t)filelen;
+    corpus = malloc(corpuslen);
+    rewind(fp);
+    if (corpus == NULL || fread(corpus, 1, corpuslen, fp) != corpuslen) {
+	(void)fprintf(stderr, "test_packet: can't read %s\n", filename);
+	exit(1);
+    }
+    (void)fclose(fp);
+
+    memset(counts, 0, sizeof(counts));
+    packet_init(&packet);
+    packet.debug = verbose;
+    started = timestamp();
+    for (rep = 0; rep < reps; rep++) {
+	size_t off = 0;
+
+	packet_reset(&packet);
+	while (off < corpuslen || packet_buffered_input(&packet) > 0) {
+	    if (off < corpuslen) {
+		size_t space;
+
+		/* reclaim the dead prefix the way packet_get() does */
+		if (packet.inbufstart > 0
+		    && sizeof(packet.inbuffer) - packet.inbuflen
+		       < sizeof(packet.inbuffer) / 2) {
+		    size_t live = packet.inbuflen - packet.inbufstart;
+
+		    memmove(packet.inbuffer, packet_inbase(&packet), live);
+		    packet.inbufptr -= packet.inbufstart;
+		    packet.inbuflen = live;
+		    packet.inbufstart = 0;
+		}
+		space = sizeof(packet.inbuffer) - packet.inbuflen;
+		if (space > corpuslen - off)
+		    space = corpuslen - off;
+		memcpy(packet.inbuffer + packet.inbuflen, corpus + off,
+		       space);
+		packet.inbuflen += space;
+		off += space;
+	    }
+	    packet_parse(&packet);
+	    if (packet.outbuflen > 0) {
+		counts[packet.type + 1]++;
+		total++;
+	    } else if (packet_buffered_input(&packet) == 0) {
+		if (off >= corpuslen)
+		    break;	/* only a trailing fragment is left */
+		if (sizeof(packet.inbuffer) == packet.inbuflen) {
+		    /* one oversized run; drop it like packet_get() */
+		    packet.inbuflen = 0;
+		    packet.inbufstart = 0;
+		    packet.inbufptr = packet.inbuffer;
+		    packet.state = 0;	/* GROUND_STATE */
+		}
+	    }
+	}
+    }
+    elapsed = timestamp() - started;
+
+    (void)printf("%s: %.2f MB in %.3f sec = %.2f MB/s, %lu packets (%.0f/s)\n",
+		 filename,
+		 (double)corpuslen * reps / 1e6, elapsed,
+		 (double)corpuslen * reps / 1e6 / elapsed,
+		 total, (double)total / elapsed);
+    for (i = 0; i < sizeof(typenames) / sizeof(typenames[0]); i++)
+	if (counts[i] > 0)
+	    (void)printf("    %-10s %lu\n", typenames[i], counts[i]);
+    free(corpus);
+}
+
 int main(int argc, char *argv[])
 {
     struct map *mp;
+    char *bench = NULL;
     int failcount = 0;
-    int option, singletest = 0;
+    int option, singletest = 0, reps = 1000;
 
     verbose = 0;
-    while ((option = getopt(argc, argv, "e:t:v:")) != -1) {
+    while ((option = getopt(argc, argv, "b:e:n:t:v:")) != -1) {
 	switch (option) {
+	case 'b':
+	    bench = optarg;
+	    break;
 	case 'e':
 	    mp = singletests + atoi(optarg) - 1;
 	    (void)fwrite(mp->test, mp->testlen, sizeof(char), stdout);
 	    (void)fflush(stdout);
 	    exit(0);
+	case 'n':
+	    reps = atoi(optarg);
+	    break;
 	case 't':
 	    singletest = atoi(optarg);
 	    break;
@@ -339,6 +439,11 @@ int main(int argc, char *argv[])
 	}
     }
 
+    if (bench != NULL) {
+	packet_benchmark(bench, reps);
+	exit(0);
+    }
+
     if (singletest)
 	failcount += packet_test(singletests + singletest - 1);
     else {
@@ -80,6 +80,13 @@ BSD terms apply: see the file COPYING in the distribution root for details.
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#ifndef S_SPLINT_S
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif /* S_SPLINT_S */
 
 #include "gpsd.h"
 #include "timebase.h"
@@ -87,6 +94,82 @@ BSD terms apply: see the file COPYING in the distribution root for details.
 #define SECS_PER_WEEK	(60*60*24*7)	/* seconds per week */
 #define GPS_ROLLOVER	(1024*SECS_PER_WEEK)	/* rollover period */
 
+/*
+ * Optional binary leap table, generated from leapseconds.cache by
+ * "leapsecond.py -H".  Layout: 8-byte magic, 32-bit entry count,
+ * 32 bits of padding, then the Unix epochs of the post-1980 leap
+ * insertions as native-order doubles - the same list that
+ * make_leapsecond_include() burns into gpsd_config.h as a count.
+ * Pushing a fresh file and restarting the daemon updates the leap
+ * history without a rebuild; if no table is present we fall back to
+ * the compiled-in LEAPSECOND_NOW.
+ */
+#define LEAPTABLE_MAGIC	"GPSDLEAP"
+
+/*@null@*/ static const double *leap_epochs;
+static unsigned int leap_entries;
+
+static void gpsd_leaptable_load(void)
+/* map the leap table read-only; it stays mapped for the daemon's life */
+{
+    struct stat sb;
+    void *base;
+    size_t header = sizeof(LEAPTABLE_MAGIC) - 1 + 2 * sizeof(uint32_t);
+    uint32_t count;
+    int fd = open(LEAPTABLE_PATH, O_RDONLY);
+
+    if (fd == -1)
+	return;
+    if (fstat(fd, &sb) == -1 || (size_t)sb.st_size < header) {
+	(void)close(fd);
+	return;
+    }
+    base = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    (void)close(fd);	/* the mapping holds its own reference */
+    if (base == MAP_FAILED)
+	return;
+    memcpy(&count, (const char *)base + sizeof(LEAPTABLE_MAGIC) - 1,
+	   sizeof(count));
+    if (memcmp(base, LEAPTABLE_MAGIC, sizeof(LEAPTABLE_MAGIC) - 1) != 0
+	|| count == 0
+	|| (size_t)sb.st_size < header + count * sizeof(double)) {
+	gpsd_report(LOG_WARN, "malformed leap table %s, using built-in count.\n",
+		    LEAPTABLE_PATH);
+	(void)munmap(base, (size_t)sb.st_size);
+	return;
+    }
+    leap_epochs = (const double *)((const char *)base + header);
+    leap_entries = (unsigned int)count;
+    gpsd_report(LOG_PROG, "leap table %s: %u entries.\n",
+		LEAPTABLE_PATH, leap_entries);
+}
+
+int gpsd_leap_seconds(time_t when)
+/* GPS-UTC offset at a given time; one compare once the interval is cached */
+{
+    static time_t c_lo, c_hi;
+    static int c_offset = LEAPSECOND_NOW;
+    unsigned int n;
+
+    if (leap_epochs == NULL)
+	return LEAPSECOND_NOW;
+    if (when >= c_lo && when < c_hi)
+	return c_offset;
+    for (n = 0; n < leap_entries; n++)
+	if ((double)when < leap_epochs[n])
+	    break;
+    /*
+     * The file lists leap boundaries starting with the one at GPS
+     * launch, when the GPS-UTC offset was zero; thus the offset is one
+     * less than the count of boundaries passed, the same convention
+     * make_leapsecond_include() uses for LEAPSECOND_NOW.
+     */
+    c_offset = (int)n - 1;
+    c_lo = (n > 0) ? (time_t)leap_epochs[n - 1] : (time_t)0;
+    c_hi = (n < leap_entries) ? (time_t)leap_epochs[n] : when + SECS_PER_WEEK;
+    return c_offset;
+}
+
 void gpsd_time_init(struct gps_context_t *context, time_t starttime)
 /* initialize the GPS context's time fields */
 {
@@ -97,7 +180,8 @@ void gpsd_time_init(struct gps_context_t *context, time_t starttime)
      * just before a century mark, but that case is probably doomed
      * anyhow because of 2-digit years.
      */
-    context->leap_seconds = LEAPSECOND_NOW;
+    gpsd_leaptable_load();
+    context->leap_seconds = gpsd_leap_seconds(starttime);
     context->century = CENTURY_BASE;
     context->start_time = starttime;
 
@@ -150,9 +234,29 @@ timestamp_t gpsd_utc_resolve(/*@in@*/struct gps_device_t *session)
      * allow us to compute the device's epoch assumption.  In practice,
      * this will be hairy and risky.
      */
+    /*
+     * Cache of the midnight epoch for the date currently in play.
+     * Successive sentences nearly always carry the same date, so the
+     * full calendar conversion runs once a day and the per-fix cost
+     * is three integer multiply-adds.
+     */
+    static int c_year = -1, c_mon = -1, c_mday = -1;
+    static time_t c_midnight;
+    struct tm *date = &session->driver.nmea.date;
     timestamp_t t;
 
-    t = (timestamp_t)mkgmtime(&session->driver.nmea.date) +
+    if (date->tm_year != c_year || date->tm_mon != c_mon
+	|| date->tm_mday != c_mday) {
+	struct tm midnight = *date;
+
+	midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+	c_midnight = mkgmtime(&midnight);
+	c_year = date->tm_year;
+	c_mon = date->tm_mon;
+	c_mday = date->tm_mday;
+    }
+    t = (timestamp_t)(c_midnight + date->tm_hour * 3600
+		      + date->tm_min * 60 + date->tm_sec) +
 	session->driver.nmea.subseconds;
     session->context->valid &=~ GPS_TIME_VALID;
 
@@ -211,8 +315,36 @@ timestamp_t gpsd_gpstime_resolve(/*@in@*/struct gps_device_t *session,
     if (week < 1024)
 	week += session->context->rollovers * 1024;
 
-    t = GPS_EPOCH + (week * SECS_PER_WEEK) + tow;
-    t -= session->context->leap_seconds;
+    /*
+     * Until the receiver broadcasts its own count, keep the offset
+     * current from the leap table; the cached interval in the lookup
+     * makes this a single compare at the full fix rate, and covers a
+     * leap insertion happening while the daemon is running.
+     */
+    if ((session->context->valid & LEAP_SECOND_VALID) == 0)
+	session->context->leap_seconds =
+	    gpsd_leap_seconds(GPS_EPOCH + (time_t)week * SECS_PER_WEEK
+			      + (time_t)tow);
+
+    /*
+     * The week epoch, leap-second correction folded in, is cached and
+     * recomputed only when the week number or the leap-second count
+     * changes (the latter on subframe updates), leaving one addition
+     * per call at the full fix rate.
+     */
+    {
+	static int c_week = -1, c_leap = 9999;
+	static time_t c_week_epoch;
+
+	if ((int)week != c_week
+	    || session->context->leap_seconds != c_leap) {
+	    c_week = (int)week;
+	    c_leap = session->context->leap_seconds;
+	    c_week_epoch = GPS_EPOCH + (time_t)week * SECS_PER_WEEK
+		- (time_t)c_leap;
+	}
+	t = c_week_epoch + tow;
+    }
 
     session->context->gps_week = week;
     session->context->gps_tow = tow;